@@ -10,10 +10,15 @@
 #endif
 #define MAX_PATH_LENGTH PATH_MAX
 #define IGNORE_FILE ".gitignore"
+#define IGNORE_EXCLUDE_FILE ".git/info/exclude"
 #define DEFAULT_OUTPUT_FILE "_export.md"
+#define CLASSIFY_CACHE_NAME "classify.cache"
+#define WALK_CACHE_NAME "walk.cache"
 #define DEFAULT_WARN_TOKENS 200000
+#define FUORI_MAX_JOBS 256
 
 struct IgnorePattern;
+struct ClassifyCache;
 
 typedef struct {
     int verbose;
@@ -21,13 +26,20 @@ typedef struct {
     int output_is_stdout;
     int show_tree;
     int allow_sensitive;
+    int use_mmap;
+    int stream_bodies;
     size_t max_file_size;
+    size_t jobs;
     size_t tree_depth;
     size_t warn_tokens;
     size_t max_tokens;
     const char* output_path;
-    struct IgnorePattern* ignore_patterns;
+    struct IgnorePattern* ignore_patterns;  // Defaults and IGNORE_EXCLUDE_FILE; .gitignore files load per directory.
     size_t ignore_count;
+    time_t collect_started;  // Files stamped at or after this second may change again within their stamp.
+    struct IgnoreMatcher* ignore_matcher;  // Compiled from ignore_patterns.
+    struct ClassifyCache* classify_cache;  // NULL unless --cache is set.
+    struct WalkCache* walk_cache;  // NULL unless --cache is set in filesystem mode.
     struct stat temp_stat;
     struct stat final_stat;
     int have_temp;
@@ -47,6 +59,7 @@ typedef enum {
     FILE_SELECTION_GIT_STAGED,
     FILE_SELECTION_GIT_UNSTAGED,
     FILE_SELECTION_GIT_DIFF,
+    FILE_SELECTION_GIT_REV,
     FILE_SELECTION_STDIN
 } FileSelectionMode;
 
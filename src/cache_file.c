@@ -0,0 +1,558 @@
+#include "cache_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CACHE_FILE_BYTE_ORDER 0x01020304u
+
+/* Fixed-width and native-endian; byte_order rejects files from other hosts. */
+typedef struct {
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t record_count;
+    uint64_t blob_length;
+} CacheRecordHeader;
+
+struct CacheRecordFile {
+    char* path;
+    CacheRecordFormat format;
+    void* mapping;
+    size_t mapping_len;
+    const unsigned char* records;  // Sorted by key; points into mapping.
+    size_t record_count;
+    const char* blob;
+    size_t blob_length;
+    unsigned char* pending;  // Blob refs index pending_blob.
+    size_t pending_count;
+    size_t pending_capacity;
+    char* pending_blob;
+    size_t pending_blob_length;
+    size_t pending_blob_capacity;
+    size_t hits;
+    time_t opened_at;
+    pthread_mutex_t lock;
+};
+
+int prepare_cache_directory(const char* directory) {
+    if (!directory || directory[0] == '\0') {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        return -1;
+    }
+    return 0;
+}
+
+int default_cache_directory(char* buffer, size_t buffer_size) {
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    int len;
+
+    if (!buffer || buffer_size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* The XDG spec ignores relative paths. */
+    if (xdg && xdg[0] == '/') {
+        len = snprintf(buffer, buffer_size, "%s", xdg);
+    } else if (home && home[0] != '\0') {
+        len = snprintf(buffer, buffer_size, "%s/.cache", home);
+    } else {
+        errno = ENOENT;
+        return -1;
+    }
+    if (len < 0 || (size_t)len + sizeof("/fuori") > buffer_size) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    if (prepare_cache_directory(buffer) != 0) {
+        return -1;
+    }
+    strcat(buffer, "/fuori");
+    return prepare_cache_directory(buffer);
+}
+
+int map_cache_file(const char* path, size_t min_length, void** mapping_out, size_t* length_out) {
+    struct stat st;
+    void* mapping;
+    size_t length;
+    int open_flags = O_RDONLY;
+    int fd;
+
+    if (!path || !mapping_out || !length_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *mapping_out = NULL;
+    *length_out = 0;
+
+#ifdef O_CLOEXEC
+    open_flags |= O_CLOEXEC;
+#endif
+    fd = open(path, open_flags);
+    if (fd == -1) {
+        return (errno == ENOENT || errno == ENOTDIR) ? 0 : -1;
+    }
+    if (fstat(fd, &st) != 0) {
+        int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode) || (uintmax_t)st.st_size < min_length || (uintmax_t)st.st_size > SIZE_MAX ||
+        st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    length = (size_t)st.st_size;
+    mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+
+    *mapping_out = mapping;
+    *length_out = length;
+    return 0;
+}
+
+void unmap_cache_file(void* mapping, size_t length) {
+    if (mapping) {
+        munmap(mapping, length);
+    }
+}
+
+int replace_cache_file(const char* path, const CacheFilePart* parts, size_t part_count) {
+    char temp_path[4096];
+    FILE* file = NULL;
+    int temp_fd;
+    int saved_errno;
+    int len;
+
+    if (!path || (!parts && part_count > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    len = snprintf(temp_path, sizeof(temp_path), "%s.XXXXXX", path);
+    if (len < 0 || (size_t)len >= sizeof(temp_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    temp_fd = mkstemp(temp_path);
+    if (temp_fd == -1) {
+        return -1;
+    }
+    file = fdopen(temp_fd, "wb");
+    if (!file) {
+        saved_errno = errno;
+        close(temp_fd);
+        goto fail_saved;
+    }
+
+    for (size_t i = 0; i < part_count; i++) {
+        if (parts[i].length > 0 && fwrite(parts[i].data, 1, parts[i].length, file) != parts[i].length) {
+            goto fail;
+        }
+    }
+    if (fclose(file) != 0) {
+        file = NULL;
+        goto fail;
+    }
+    file = NULL;
+
+    /* Readers holding the old mapping keep a consistent view of the replaced file. */
+    if (rename(temp_path, path) != 0) {
+        goto fail;
+    }
+    return 0;
+
+fail:
+    saved_errno = errno;
+    if (file) {
+        fclose(file);
+    }
+fail_saved:
+    unlink(temp_path);
+    errno = saved_errno;
+    return -1;
+}
+
+static int compare_record_keys(const void* lhs, const void* rhs) {
+    const CacheRecordKey* left = lhs;
+    const CacheRecordKey* right = rhs;
+
+    if (left->dev != right->dev) {
+        return (left->dev < right->dev) ? -1 : 1;
+    }
+    if (left->ino != right->ino) {
+        return (left->ino < right->ino) ? -1 : 1;
+    }
+    return 0;
+}
+
+static const CacheBlobRef* record_blob_ref(const void* record) {
+    return (const CacheBlobRef*)((const CacheRecordKey*)record + 1);
+}
+
+/* Maps an existing cache file; anything unusable leaves the file empty. */
+static void load_cache_records(CacheRecordFile* file) {
+    const CacheRecordFormat* format = &file->format;
+    const CacheRecordHeader* header;
+    const unsigned char* records;
+    void* mapping = NULL;
+    size_t length = 0;
+    size_t records_length;
+
+    if (map_cache_file(file->path, sizeof(CacheRecordHeader), &mapping, &length) != 0 || !mapping) {
+        return;
+    }
+
+    header = mapping;
+    records = (const unsigned char*)(header + 1);
+    if (memcmp(header->magic, format->magic, sizeof(header->magic)) != 0 ||
+        header->byte_order != CACHE_FILE_BYTE_ORDER ||
+        header->version != format->version ||
+        header->record_size != format->record_size ||
+        header->record_count > (length - sizeof(*header)) / format->record_size) {
+        unmap_cache_file(mapping, length);
+        return;
+    }
+    records_length = (size_t)header->record_count * format->record_size;
+    if (header->blob_length != length - sizeof(*header) - records_length ||
+        (!format->has_blob && header->blob_length != 0)) {
+        unmap_cache_file(mapping, length);
+        return;
+    }
+    /* Lookups bisect the records, so a file written out of order is useless. */
+    for (size_t i = 0; i < header->record_count; i++) {
+        const unsigned char* record = records + i * format->record_size;
+
+        if (i > 0 && compare_record_keys(record - format->record_size, record) >= 0) {
+            unmap_cache_file(mapping, length);
+            return;
+        }
+        if (format->has_blob && (record_blob_ref(record)->offset > header->blob_length ||
+                                 record_blob_ref(record)->length > header->blob_length - record_blob_ref(record)->offset)) {
+            unmap_cache_file(mapping, length);
+            return;
+        }
+    }
+
+    file->mapping = mapping;
+    file->mapping_len = length;
+    file->records = records;
+    file->record_count = (size_t)header->record_count;
+    file->blob = (const char*)records + records_length;
+    file->blob_length = (size_t)header->blob_length;
+}
+
+int open_cache_record_file(const char* path, const CacheRecordFormat* format, CacheRecordFile** file_out) {
+    CacheRecordFile* file;
+    size_t min_record_size;
+    int rc;
+
+    if (!path || !format || !file_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *file_out = NULL;
+    min_record_size = sizeof(CacheRecordKey) + (format->has_blob ? sizeof(CacheBlobRef) : 0);
+    if (format->record_size < min_record_size || format->record_size % sizeof(uint64_t) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    file = calloc(1, sizeof(*file));
+    if (!file) {
+        return -1;
+    }
+    file->path = strdup(path);
+    if (!file->path) {
+        free(file);
+        return -1;
+    }
+    rc = pthread_mutex_init(&file->lock, NULL);
+    if (rc != 0) {
+        free(file->path);
+        free(file);
+        errno = rc;
+        return -1;
+    }
+    file->format = *format;
+    file->opened_at = time(NULL);
+    load_cache_records(file);
+
+    *file_out = file;
+    return 0;
+}
+
+void fill_cache_record_key(CacheRecordKey* key, const struct stat* st) {
+    key->dev = (uint64_t)st->st_dev;
+    key->ino = (uint64_t)st->st_ino;
+}
+
+const void* find_cache_record(const CacheRecordFile* file, const struct stat* st, const char** blob_out) {
+    CacheRecordKey key;
+    const unsigned char* record;
+
+    if (blob_out) {
+        *blob_out = NULL;
+    }
+    if (!file || !st || file->record_count == 0) {
+        return NULL;
+    }
+
+    fill_cache_record_key(&key, st);
+    record = bsearch(&key, file->records, file->record_count, file->format.record_size, compare_record_keys);
+    if (record && file->format.has_blob && blob_out) {
+        *blob_out = file->blob + record_blob_ref(record)->offset;
+    }
+    return record;
+}
+
+void count_cache_record_hit(CacheRecordFile* file) {
+    pthread_mutex_lock(&file->lock);
+    file->hits++;
+    pthread_mutex_unlock(&file->lock);
+}
+
+int cache_stamp_settled(const CacheRecordFile* file, const struct stat* st) {
+    return st->st_mtime < file->opened_at && st->st_ctime < file->opened_at;
+}
+
+static int reserve_pending_blob(CacheRecordFile* file, size_t needed) {
+    size_t new_capacity = (file->pending_blob_capacity == 0) ? 4096 : file->pending_blob_capacity;
+    char* new_blob;
+
+    if (file->pending_blob_capacity - file->pending_blob_length >= needed) {
+        return 0;
+    }
+    while (new_capacity - file->pending_blob_length < needed) {
+        if (new_capacity > SIZE_MAX / 2) {
+            errno = ENOMEM;
+            return -1;
+        }
+        new_capacity *= 2;
+    }
+    new_blob = realloc(file->pending_blob, new_capacity);
+    if (!new_blob) {
+        return -1;
+    }
+    file->pending_blob = new_blob;
+    file->pending_blob_capacity = new_capacity;
+    return 0;
+}
+
+int queue_cache_record(CacheRecordFile* file, const void* record, const void* blob, size_t blob_length) {
+    size_t record_size;
+    int status = 0;
+
+    if (!file || !record || (!blob && blob_length > 0) || (!file->format.has_blob && blob_length > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    record_size = file->format.record_size;
+
+    pthread_mutex_lock(&file->lock);
+    if (file->pending_count == file->pending_capacity) {
+        size_t new_capacity = (file->pending_capacity == 0) ? 64 : file->pending_capacity * 2;
+        unsigned char* new_pending = realloc(file->pending, new_capacity * record_size);
+        if (!new_pending) {
+            status = -1;
+        } else {
+            file->pending = new_pending;
+            file->pending_capacity = new_capacity;
+        }
+    }
+    if (status == 0 && file->format.has_blob) {
+        status = reserve_pending_blob(file, blob_length);
+    }
+    if (status == 0) {
+        unsigned char* slot = file->pending + file->pending_count * record_size;
+
+        memcpy(slot, record, record_size);
+        if (file->format.has_blob) {
+            CacheBlobRef* ref = (CacheBlobRef*)((CacheRecordKey*)slot + 1);
+
+            ref->offset = (uint64_t)file->pending_blob_length;
+            ref->length = (uint64_t)blob_length;
+            if (blob_length > 0) {
+                memcpy(file->pending_blob + file->pending_blob_length, blob, blob_length);
+            }
+            file->pending_blob_length += blob_length;
+        }
+        file->pending_count++;
+    }
+    pthread_mutex_unlock(&file->lock);
+    return status;
+}
+
+void cache_record_counts(CacheRecordFile* file, size_t* hits_out, size_t* stored_out) {
+    size_t hits = 0;
+    size_t stored = 0;
+
+    if (file) {
+        pthread_mutex_lock(&file->lock);
+        hits = file->hits;
+        stored = file->pending_count;
+        pthread_mutex_unlock(&file->lock);
+    }
+    if (hits_out) *hits_out = hits;
+    if (stored_out) *stored_out = stored;
+}
+
+/*
+ * Merges the sorted pending records over the mapped ones into merged and a
+ * fresh blob block. New records win on equal keys; once the cap is reached,
+ * old records are dropped first.
+ */
+static size_t merge_cache_records(const CacheRecordFile* file,
+                                  size_t pending_count,
+                                  unsigned char* merged,
+                                  char* blob,
+                                  size_t* blob_length_out) {
+    size_t record_size = file->format.record_size;
+    size_t max_records = file->format.max_records;
+    size_t old_budget = (pending_count < max_records) ? max_records - pending_count : 0;
+    size_t old_index = 0;
+    size_t new_index = 0;
+    size_t count = 0;
+    size_t blob_length = 0;
+
+    while (old_index < file->record_count || new_index < pending_count) {
+        const unsigned char* source;
+        const char* source_blob;
+        unsigned char* target;
+        int order;
+
+        if (old_index == file->record_count) {
+            order = 1;
+        } else if (new_index == pending_count) {
+            order = -1;
+        } else {
+            order = compare_record_keys(file->records + old_index * record_size,
+                                        file->pending + new_index * record_size);
+        }
+
+        if (order < 0) {
+            source = file->records + old_index++ * record_size;
+            source_blob = file->blob;
+            if (old_budget == 0) {
+                continue;
+            }
+            old_budget--;
+        } else {
+            if (order == 0) {
+                old_index++;
+            }
+            source = file->pending + new_index++ * record_size;
+            source_blob = file->pending_blob;
+        }
+
+        target = merged + count * record_size;
+        memcpy(target, source, record_size);
+        if (file->format.has_blob) {
+            const CacheBlobRef* source_ref = record_blob_ref(source);
+            CacheBlobRef* target_ref = (CacheBlobRef*)((CacheRecordKey*)target + 1);
+
+            memcpy(blob + blob_length, source_blob + source_ref->offset, (size_t)source_ref->length);
+            target_ref->offset = (uint64_t)blob_length;
+            blob_length += (size_t)source_ref->length;
+        }
+        count++;
+    }
+    *blob_length_out = blob_length;
+    return count;
+}
+
+int save_cache_record_file(CacheRecordFile* file) {
+    CacheRecordHeader header;
+    unsigned char* merged = NULL;
+    char* blob = NULL;
+    CacheFilePart parts[3];
+    size_t record_size;
+    size_t pending_count = 0;
+    size_t merged_count;
+    size_t blob_length;
+    int status;
+
+    if (!file) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (file->pending_count == 0) {
+        return 0;
+    }
+    record_size = file->format.record_size;
+
+    /* An identity reached twice (hard links, bind mounts) keeps one record. */
+    qsort(file->pending, file->pending_count, record_size, compare_record_keys);
+    for (size_t i = 0; i < file->pending_count; i++) {
+        unsigned char* record = file->pending + i * record_size;
+
+        if (pending_count > 0 && compare_record_keys(file->pending + (pending_count - 1) * record_size, record) == 0) {
+            memcpy(file->pending + (pending_count - 1) * record_size, record, record_size);
+            continue;
+        }
+        if (pending_count != i) {
+            memcpy(file->pending + pending_count * record_size, record, record_size);
+        }
+        pending_count++;
+    }
+    if (pending_count > file->format.max_records) {
+        pending_count = file->format.max_records;
+    }
+
+    merged = malloc((file->record_count + pending_count) * record_size);
+    blob = malloc(file->blob_length + file->pending_blob_length + 1);
+    if (!merged || !blob) {
+        free(merged);
+        free(blob);
+        return -1;
+    }
+    merged_count = merge_cache_records(file, pending_count, merged, blob, &blob_length);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, file->format.magic, sizeof(header.magic));
+    header.byte_order = CACHE_FILE_BYTE_ORDER;
+    header.version = file->format.version;
+    header.record_size = (uint32_t)record_size;
+    header.record_count = (uint64_t)merged_count;
+    header.blob_length = (uint64_t)blob_length;
+    parts[0].data = &header;
+    parts[0].length = sizeof(header);
+    parts[1].data = merged;
+    parts[1].length = merged_count * record_size;
+    parts[2].data = blob;
+    parts[2].length = blob_length;
+
+    status = replace_cache_file(file->path, parts, 3);
+    free(merged);
+    free(blob);
+    return status;
+}
+
+void close_cache_record_file(CacheRecordFile* file) {
+    if (!file) return;
+    unmap_cache_file(file->mapping, file->mapping_len);
+    pthread_mutex_destroy(&file->lock);
+    free(file->pending);
+    free(file->pending_blob);
+    free(file->path);
+    free(file);
+}
@@ -0,0 +1,90 @@
+#ifndef CACHE_FILE_H
+#define CACHE_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+/*
+ * Storage shared by the on-disk caches. Each cache is one file that is mapped
+ * read-only when opened and replaced whole by rename(), so concurrent runs
+ * never see a partial file (the last writer wins).
+ */
+typedef struct {
+    const void* data;
+    size_t length;
+} CacheFilePart;
+
+/* $XDG_CACHE_HOME/fuori, else ~/.cache/fuori; creates the directories. */
+int default_cache_directory(char* buffer, size_t buffer_size);
+/* Creates directory if it is missing; its parent must exist. */
+int prepare_cache_directory(const char* directory);
+/*
+ * Maps path read-only. Returns 0 with *mapping_out NULL when the file is
+ * missing, not a regular file, or shorter than min_length.
+ */
+int map_cache_file(const char* path, size_t min_length, void** mapping_out, size_t* length_out);
+void unmap_cache_file(void* mapping, size_t length);
+/* Writes the parts to a temporary sibling of path and renames it over path. */
+int replace_cache_file(const char* path, const CacheFilePart* parts, size_t part_count);
+
+/* Leading fields of every cache record: the identity it is filed under. */
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;
+} CacheRecordKey;
+
+/* Follows the key in records of formats with a blob block. */
+typedef struct {
+    uint64_t offset;
+    uint64_t length;
+} CacheBlobRef;
+
+/*
+ * A sorted-record cache file is a header, record_size-byte records that start
+ * with a CacheRecordKey and are sorted by it, and, with has_blob, a block of
+ * variable-length data that each record addresses through its CacheBlobRef.
+ * Caches differ only in this format and the fields after the key.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;  // Bump when the record layout or its meaning changes.
+    size_t record_size;
+    size_t max_records;
+    int has_blob;
+} CacheRecordFormat;
+
+/*
+ * An opened sorted-record file plus the records queued for its next save. A
+ * missing, foreign, or damaged file reads as empty. Lookups and queueing may
+ * run on any thread.
+ */
+typedef struct CacheRecordFile CacheRecordFile;
+
+int open_cache_record_file(const char* path, const CacheRecordFormat* format, CacheRecordFile** file_out);
+void fill_cache_record_key(CacheRecordKey* key, const struct stat* st);
+/*
+ * Returns the stored record for st's identity, or NULL. For formats with a
+ * blob block, *blob_out points at the record's data; the caller still
+ * checks the record's stamp and, when it accepts it, counts the hit.
+ */
+const void* find_cache_record(const CacheRecordFile* file, const struct stat* st, const char** blob_out);
+void count_cache_record_hit(CacheRecordFile* file);
+/*
+ * Returns 1 when st's mtime and ctime are older than the second the file was
+ * opened. Anything newer must not be stored: a later edit within the same
+ * second would keep the same stamp.
+ */
+int cache_stamp_settled(const CacheRecordFile* file, const struct stat* st);
+/* Queues a copy of record, and of blob_length bytes at blob, for the next save. */
+int queue_cache_record(CacheRecordFile* file, const void* record, const void* blob, size_t blob_length);
+void cache_record_counts(CacheRecordFile* file, size_t* hits_out, size_t* stored_out);
+/*
+ * Merges the queued records over the stored ones and replaces the file. New
+ * records win on equal keys; past max_records, old records are dropped
+ * first. Does nothing when none were queued.
+ */
+int save_cache_record_file(CacheRecordFile* file);
+void close_cache_record_file(CacheRecordFile* file);
+
+#endif
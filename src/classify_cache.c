@@ -0,0 +1,136 @@
+#include "classify_cache.h"
+
+#include "cache_file.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Bump when classification rules change so records from older builds are dropped. */
+#define CLASSIFY_CACHE_VERSION 4u
+#define CLASSIFY_CACHE_MAX_RECORDS ((size_t)1 << 18)
+
+/* Fixed-width and native-endian, like the rest of the file. */
+typedef struct {
+    CacheRecordKey key;
+    uint64_t size;
+    int64_t mtime;
+    int64_t ctime;
+    uint64_t line_count;
+    uint64_t max_backtick_run;
+    uint8_t binary;
+    uint8_t sensitivity;
+    uint8_t ends_with_newline;
+    char lang[13];
+} ClassifyCacheRecord;
+
+static const CacheRecordFormat CLASSIFY_CACHE_FORMAT = {
+    {'f', 'u', 'o', 'r', 'i', 'c', 'c', '\n'},
+    CLASSIFY_CACHE_VERSION,
+    sizeof(ClassifyCacheRecord),
+    CLASSIFY_CACHE_MAX_RECORDS,
+    0
+};
+
+struct ClassifyCache {
+    CacheRecordFile* records;
+};
+
+int open_classify_cache(const char* path, ClassifyCache** cache_out) {
+    ClassifyCache* cache;
+
+    if (!path || !cache_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *cache_out = NULL;
+
+    cache = calloc(1, sizeof(*cache));
+    if (!cache) {
+        return -1;
+    }
+    if (open_cache_record_file(path, &CLASSIFY_CACHE_FORMAT, &cache->records) != 0) {
+        free(cache);
+        return -1;
+    }
+
+    *cache_out = cache;
+    return 0;
+}
+
+int lookup_classify_cache(ClassifyCache* cache, const struct stat* st, ClassifyResult* result) {
+    const ClassifyCacheRecord* record;
+
+    if (!cache || !st || !result) {
+        return 0;
+    }
+
+    record = find_cache_record(cache->records, st, NULL);
+    if (!record || record->size != (uint64_t)st->st_size || record->mtime != (int64_t)st->st_mtime ||
+        record->ctime != (int64_t)st->st_ctime ||
+        record->sensitivity > CLASSIFY_SENSITIVITY_FOUND ||
+        memchr(record->lang, '\0', sizeof(record->lang)) == NULL) {
+        return 0;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->binary = record->binary != 0;
+    result->sensitivity = (ClassifySensitivity)record->sensitivity;
+    memcpy(result->lang, record->lang, sizeof(record->lang));
+    result->line_count = (size_t)record->line_count;
+    result->max_backtick_run = (size_t)record->max_backtick_run;
+    result->ends_with_newline = record->ends_with_newline != 0;
+
+    count_cache_record_hit(cache->records);
+    return 1;
+}
+
+int store_classify_cache(ClassifyCache* cache, const struct stat* st, const ClassifyResult* result) {
+    ClassifyCacheRecord record;
+    size_t lang_len;
+
+    if (!cache || !st || !result) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!cache_stamp_settled(cache->records, st)) {
+        return 0;
+    }
+    lang_len = strlen(result->lang);
+    if (lang_len >= sizeof(record.lang)) {
+        return 0;
+    }
+
+    memset(&record, 0, sizeof(record));
+    fill_cache_record_key(&record.key, st);
+    record.size = (uint64_t)st->st_size;
+    record.mtime = (int64_t)st->st_mtime;
+    record.ctime = (int64_t)st->st_ctime;
+    record.line_count = (uint64_t)result->line_count;
+    record.max_backtick_run = (uint64_t)result->max_backtick_run;
+    record.binary = (uint8_t)(result->binary != 0);
+    record.sensitivity = (uint8_t)result->sensitivity;
+    record.ends_with_newline = (uint8_t)(result->ends_with_newline != 0);
+    memcpy(record.lang, result->lang, lang_len);
+
+    return queue_cache_record(cache->records, &record, NULL, 0);
+}
+
+void classify_cache_counts(ClassifyCache* cache, size_t* hits_out, size_t* stored_out) {
+    cache_record_counts(cache ? cache->records : NULL, hits_out, stored_out);
+}
+
+int save_classify_cache(ClassifyCache* cache) {
+    if (!cache) {
+        errno = EINVAL;
+        return -1;
+    }
+    return save_cache_record_file(cache->records);
+}
+
+void close_classify_cache(ClassifyCache* cache) {
+    if (!cache) return;
+    close_cache_record_file(cache->records);
+    free(cache);
+}
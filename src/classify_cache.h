@@ -0,0 +1,50 @@
+#ifndef CLASSIFY_CACHE_H
+#define CLASSIFY_CACHE_H
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+typedef enum {
+    CLASSIFY_SENSITIVITY_UNCHECKED = 0,  // Classified under --allow-sensitive; content never scanned.
+    CLASSIFY_SENSITIVITY_CLEAN,
+    CLASSIFY_SENSITIVITY_FOUND
+} ClassifySensitivity;
+
+/*
+ * What classifying one file body found. lang is what the body alone says
+ * (its shebang), "" when nothing does; the file name is the caller's concern.
+ */
+typedef struct {
+    int binary;
+    ClassifySensitivity sensitivity;
+    char lang[16];
+    size_t line_count;
+    size_t max_backtick_run;
+    int ends_with_newline;
+} ClassifyResult;
+
+/*
+ * On-disk classification results keyed by file identity (dev, ino) and
+ * checked against size, mtime, and ctime. The file is a header plus records
+ * sorted by identity, stored through cache_file.h. A missing, foreign, or
+ * damaged file reads as an empty cache.
+ *
+ * Lookups and stores may run on any thread.
+ */
+typedef struct ClassifyCache ClassifyCache;
+
+int open_classify_cache(const char* path, ClassifyCache** cache_out);
+/* Returns 1 and fills *result when st still matches a cached record. */
+int lookup_classify_cache(ClassifyCache* cache, const struct stat* st, ClassifyResult* result);
+/*
+ * Queues a record for the next save. Files whose mtime or ctime is not older
+ * than the second the cache was opened are skipped, since a later edit within
+ * that second would keep the same stamp.
+ */
+int store_classify_cache(ClassifyCache* cache, const struct stat* st, const ClassifyResult* result);
+void classify_cache_counts(ClassifyCache* cache, size_t* hits_out, size_t* stored_out);
+/* Merges queued records into the file; does nothing when none were queued. */
+int save_classify_cache(ClassifyCache* cache);
+void close_classify_cache(ClassifyCache* cache);
+
+#endif
@@ -1,18 +1,29 @@
+/* dirent d_type hints (DT_*) are a BSD extension glibc hides under strict POSIX. */
+#define _DEFAULT_SOURCE
+/* Darwin names the nanosecond stat fields st_*timespec, and only outside strict POSIX. */
+#define _DARWIN_C_SOURCE
+
 #include "collect.h"
 
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <fnmatch.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
+#include "classify_cache.h"
 #include "ignore.h"
 #include "sensitive.h"
+#include "text_scan.h"
+#include "walk_cache.h"
 
 typedef struct {
     const char* const extension;
@@ -56,10 +67,37 @@ static const LanguageMapping lang_map[] = {
     {NULL, NULL}
 };
 
-static int compare_names(const void* lhs, const void* rhs) {
-    const char* const* left = lhs;
-    const char* const* right = rhs;
-    return strcmp(*left, *right);
+#define WALK_MAX_OPEN_DIRS 1024
+#define MMAP_MIN_FILE_BYTES (16 * 1024)
+#define MMAP_MAX_MAPPINGS 16384
+
+#ifdef __APPLE__
+#define STAT_MTIME_NSEC(st) ((st)->st_mtimespec.tv_nsec)
+#define STAT_CTIME_NSEC(st) ((st)->st_ctimespec.tv_nsec)
+#else
+#define STAT_MTIME_NSEC(st) ((st)->st_mtim.tv_nsec)
+#define STAT_CTIME_NSEC(st) ((st)->st_ctim.tv_nsec)
+#endif
+
+/*
+ * Size plus mtime and ctime to the nanosecond, so a same-size rewrite within
+ * one second (an editor save, a formatter, `touch -r`) still reads as changed.
+ */
+static int file_stamp_matches(const struct stat* a, const struct stat* b) {
+    return a->st_size == b->st_size &&
+           a->st_mtime == b->st_mtime && STAT_MTIME_NSEC(a) == STAT_MTIME_NSEC(b) &&
+           a->st_ctime == b->st_ctime && STAT_CTIME_NSEC(a) == STAT_CTIME_NSEC(b);
+}
+
+typedef struct {
+    char* name;
+    int type;
+} WalkDirent;
+
+static int compare_walk_dirents(const void* lhs, const void* rhs) {
+    const WalkDirent* left = lhs;
+    const WalkDirent* right = rhs;
+    return strcmp(left->name, right->name);
 }
 
 static int compare_export_entries(const void* lhs, const void* rhs) {
@@ -72,12 +110,47 @@ static int compare_export_entries(const void* lhs, const void* rhs) {
     return strcmp(left->open_path, right->open_path);
 }
 
-static void free_names(char** names, size_t count) {
-    if (!names) return;
+static void free_walk_dirents(WalkDirent* dirents, size_t count) {
+    if (!dirents) return;
     for (size_t i = 0; i < count; i++) {
-        free(names[i]);
+        free(dirents[i].name);
+    }
+    free(dirents);
+}
+
+/*
+ * Live file mappings, capped well below the kernel's per-process map limit
+ * so a huge export degrades to heap reads instead of failing mmap().
+ */
+static pthread_mutex_t file_mapping_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t file_mapping_count = 0;
+
+static int reserve_file_mapping(void) {
+    int reserved = 0;
+
+    pthread_mutex_lock(&file_mapping_lock);
+    if (file_mapping_count < MMAP_MAX_MAPPINGS) {
+        file_mapping_count++;
+        reserved = 1;
+    }
+    pthread_mutex_unlock(&file_mapping_lock);
+    return reserved;
+}
+
+static void release_file_mapping(void) {
+    pthread_mutex_lock(&file_mapping_lock);
+    file_mapping_count--;
+    pthread_mutex_unlock(&file_mapping_lock);
+}
+
+static void release_file_buffer(unsigned char* buf, size_t buf_len, int mapped) {
+    if (!buf) return;
+    if (mapped) {
+        munmap(buf, buf_len);
+        release_file_mapping();
+        return;
     }
-    free(names);
+    free(buf);
 }
 
 void free_export_plan(ExportPlan* plan) {
@@ -85,7 +158,7 @@ void free_export_plan(ExportPlan* plan) {
     for (size_t i = 0; i < plan->count; i++) {
         free(plan->entries[i].open_path);
         free(plan->entries[i].display_path);
-        free(plan->entries[i].buf);
+        release_file_buffer(plan->entries[i].buf, plan->entries[i].buf_len, plan->entries[i].buf_mapped);
     }
     free(plan->entries);
     plan->entries = NULL;
@@ -93,84 +166,6 @@ void free_export_plan(ExportPlan* plan) {
     plan->capacity = 0;
 }
 
-static int is_likely_utf8(const unsigned char* s, size_t n) {
-    size_t i = 0;
-    while (i < n) {
-        unsigned char c = s[i];
-        if (c < 0x80) {
-            i++;
-            continue;
-        }
-        if ((c & 0xE0) == 0xC0) {
-            if (i + 1 >= n) return 0;
-            if ((s[i + 1] & 0xC0) != 0x80) return 0;
-            if (c < 0xC2) return 0;
-            i += 2;
-            continue;
-        }
-        if ((c & 0xF0) == 0xE0) {
-            unsigned char b1;
-            unsigned char b2;
-            if (i + 2 >= n) return 0;
-            b1 = s[i + 1];
-            b2 = s[i + 2];
-            if ((b1 & 0xC0) != 0x80 || (b2 & 0xC0) != 0x80) return 0;
-            if (c == 0xE0 && b1 < 0xA0) return 0;
-            if (c == 0xED && b1 >= 0xA0) return 0;
-            i += 3;
-            continue;
-        }
-        if ((c & 0xF8) == 0xF0) {
-            unsigned char b1;
-            unsigned char b2;
-            unsigned char b3;
-            if (i + 3 >= n) return 0;
-            b1 = s[i + 1];
-            b2 = s[i + 2];
-            b3 = s[i + 3];
-            if ((b1 & 0xC0) != 0x80 ||
-                (b2 & 0xC0) != 0x80 ||
-                (b3 & 0xC0) != 0x80) {
-                return 0;
-            }
-            if (c == 0xF0 && b1 < 0x90) return 0;
-            if (c > 0xF4) return 0;
-            if (c == 0xF4 && b1 >= 0x90) return 0;
-            i += 4;
-            continue;
-        }
-        return 0;
-    }
-    return 1;
-}
-
-static int is_binary_file(const unsigned char* buffer, size_t bytes_read) {
-    /* Empty files are filtered by the caller; this helper only classifies non-empty content. */
-    if (bytes_read == 0) return 0;
-
-    for (size_t i = 0; i < bytes_read; i++) {
-        if (buffer[i] == '\0') {
-            return 1;
-        }
-    }
-
-    if (!is_likely_utf8(buffer, bytes_read)) {
-        return 1;
-    }
-
-    size_t ctrl = 0;
-    for (size_t i = 0; i < bytes_read; i++) {
-        unsigned char c = buffer[i];
-        if (c < 0x20 && c != '\n' && c != '\r' && c != '\t') {
-            ctrl++;
-        }
-    }
-    size_t whole_hundreds = bytes_read / 100;
-    size_t remainder = bytes_read % 100;
-    size_t threshold = whole_hundreds * 3 + ((remainder * 3 + 99) / 100);
-    return ctrl >= threshold;
-}
-
 static const char* classify_shebang_interpreter(const char* name) {
     if (!name || *name == '\0') return NULL;
 
@@ -250,43 +245,134 @@ static const char* detect_shebang(const unsigned char* buffer, size_t buffer_len
     return classify_shebang_interpreter(interp_base);
 }
 
-static const char* get_language_identifier(const char* filepath,
-                                           const unsigned char* buffer,
-                                           size_t buffer_len) {
+/* Returns 1 when the file name alone settles the language; 0 leaves it to the shebang. */
+static int get_path_language(const char* filepath, const char** lang_out) {
     const char* base = filepath;
     const char* slash = strrchr(filepath, '/');
     if (slash) base = slash + 1;
 
-    if (strcasecmp(base, "Dockerfile") == 0) return "dockerfile";
-    if (strcasecmp(base, "Makefile") == 0 || strcasecmp(base, "GNUmakefile") == 0) return "makefile";
+    *lang_out = NULL;
+    if (strcasecmp(base, "Dockerfile") == 0) {
+        *lang_out = "dockerfile";
+        return 1;
+    }
+    if (strcasecmp(base, "Makefile") == 0 || strcasecmp(base, "GNUmakefile") == 0) {
+        *lang_out = "makefile";
+        return 1;
+    }
 
     const char* dot = strrchr(base, '.');
     if (!dot || dot == base) {
-        return detect_shebang(buffer, buffer_len);
+        return 0;
     }
 
     dot++;
     for (int i = 0; lang_map[i].extension != NULL; i++) {
         if (strcasecmp(dot, lang_map[i].extension) == 0) {
-            return lang_map[i].language;
+            *lang_out = lang_map[i].language;
+            break;
         }
     }
+    return 1;
+}
 
-    return NULL;
+static const char* get_language_identifier(const char* filepath,
+                                           const unsigned char* buffer,
+                                           size_t buffer_len) {
+    const char* lang;
+
+    if (get_path_language(filepath, &lang)) {
+        return lang;
+    }
+    return detect_shebang(buffer, buffer_len);
 }
 
-static int read_file_buffer(const char* filepath,
-                            const struct stat* st,
+/* Maps a cached language name back to the static identifier it was recorded from. */
+static int resolve_cached_language(const char* name, const char** lang_out) {
+    const char* shebang_lang;
+
+    if (name[0] == '\0') {
+        *lang_out = NULL;
+        return 0;
+    }
+    for (int i = 0; lang_map[i].extension != NULL; i++) {
+        if (strcmp(name, lang_map[i].language) == 0) {
+            *lang_out = lang_map[i].language;
+            return 0;
+        }
+    }
+    shebang_lang = classify_shebang_interpreter(name);
+    if (shebang_lang && strcmp(name, shebang_lang) == 0) {
+        *lang_out = shebang_lang;
+        return 0;
+    }
+    return -1;
+}
+
+typedef enum {
+    READ_FILE_ERROR = -1,
+    READ_FILE_OK = 0,
+    READ_FILE_TOO_LARGE = 1,
+    READ_FILE_CHANGED = 2
+} ReadFileStatus;
+
+/*
+ * Maps an opened regular file read-only. Returns -1 whenever the mapping is
+ * unavailable or the file no longer matches the size it was opened with; the
+ * caller then falls back to copying the file into the heap.
+ */
+static int map_file_buffer(int fd, const struct stat* opened_st, unsigned char** buffer_out) {
+    size_t length = (size_t)opened_st->st_size;
+    struct stat mapped_st;
+    void* mapping;
+
+    if (!reserve_file_mapping()) {
+        return -1;
+    }
+    mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        release_file_mapping();
+        return -1;
+    }
+    if (fstat(fd, &mapped_st) == -1 || !file_stamp_matches(&mapped_st, opened_st)) {
+        munmap(mapping, length);
+        release_file_mapping();
+        return -1;
+    }
+    posix_madvise(mapping, length, POSIX_MADV_SEQUENTIAL);
+
+    *buffer_out = mapping;
+    return 0;
+}
+
+/* Opens a path for reading without following a final symlink. O_NONBLOCK
+ * keeps a FIFO that replaced a listed file from stalling the open. */
+static int open_file_nofollow(int dir_fd, const char* filepath) {
+    int open_flags = O_RDONLY;
+#ifdef O_NOFOLLOW
+    open_flags |= O_NOFOLLOW;
+#endif
+#ifdef O_CLOEXEC
+    open_flags |= O_CLOEXEC;
+#endif
+#ifdef O_NONBLOCK
+    open_flags |= O_NONBLOCK;
+#endif
+    return openat(dir_fd, filepath, open_flags);
+}
+
+/*
+ * Reads an already opened regular file and always consumes fd. opened_st is
+ * the fstat() taken right after opening.
+ */
+static int read_opened_file(int fd,
+                            const struct stat* opened_st,
                             size_t max_file_size,
+                            int allow_mmap,
                             unsigned char** buffer_out,
-                            size_t* bytes_read_out) {
-    enum {
-        READ_FILE_ERROR = -1,
-        READ_FILE_OK = 0,
-        READ_FILE_TOO_LARGE = 1,
-        READ_FILE_CHANGED = 2
-    };
-    int fd = -1;
+                            size_t* bytes_read_out,
+                            int* mapped_out,
+                            const char** error_label) {
     FILE* file = NULL;
     unsigned char* buffer = NULL;
     size_t buffer_size = 0;
@@ -294,66 +380,44 @@ static int read_file_buffer(const char* filepath,
     size_t extra_read = 0;
     size_t bytes_read = 0;
     unsigned char extra_chunk[4096];
-    struct stat opened_st;
 
     *buffer_out = NULL;
     *bytes_read_out = 0;
+    *mapped_out = 0;
+    *error_label = NULL;
 
-    if (st->st_size < 0) {
-        errno = EINVAL;
-        perror("Invalid file size");
-        return READ_FILE_ERROR;
-    }
-
-    int open_flags = O_RDONLY;
-#ifdef O_NOFOLLOW
-    open_flags |= O_NOFOLLOW;
-#endif
-    fd = open(filepath, open_flags);
-    if (fd == -1) {
-        perror("Error opening file");
-        return READ_FILE_ERROR;
-    }
-    if (fstat(fd, &opened_st) == -1) {
-        close(fd);
-        perror("Error stating opened file");
-        return READ_FILE_ERROR;
-    }
-    if (!S_ISREG(opened_st.st_mode)) {
+    if (opened_st->st_size < 0) {
         close(fd);
         errno = EINVAL;
-        perror("Opened path is not a regular file");
+        *error_label = "Invalid opened file size";
         return READ_FILE_ERROR;
     }
-    if (opened_st.st_dev != st->st_dev || opened_st.st_ino != st->st_ino) {
-        close(fd);
-        return READ_FILE_CHANGED;
-    }
-    if (opened_st.st_size < 0) {
+    if ((size_t)opened_st->st_size > max_file_size) {
         close(fd);
-        errno = EINVAL;
-        perror("Invalid opened file size");
-        return READ_FILE_ERROR;
+        return READ_FILE_TOO_LARGE;
     }
-    if ((size_t)opened_st.st_size > max_file_size) {
+    if (allow_mmap && (size_t)opened_st->st_size >= MMAP_MIN_FILE_BYTES &&
+        map_file_buffer(fd, opened_st, buffer_out) == 0) {
         close(fd);
-        return READ_FILE_TOO_LARGE;
+        *bytes_read_out = (size_t)opened_st->st_size;
+        *mapped_out = 1;
+        return READ_FILE_OK;
     }
 
     file = fdopen(fd, "rb");
     if (!file) {
         close(fd);
-        perror("Error converting file descriptor to stream");
+        *error_label = "Error converting file descriptor to stream";
         return READ_FILE_ERROR;
     }
     fd = -1;
 
-    buffer_size = (size_t)opened_st.st_size;
+    buffer_size = (size_t)opened_st->st_size;
     buffer_capacity = (buffer_size > 0) ? buffer_size : sizeof(extra_chunk);
     buffer = malloc(buffer_capacity);
     if (!buffer) {
         fclose(file);
-        perror("Error allocating memory");
+        *error_label = "Error allocating memory";
         return READ_FILE_ERROR;
     }
 
@@ -364,7 +428,7 @@ static int read_file_buffer(const char* filepath,
             free(buffer);
             fclose(file);
             if (read_failed) {
-                perror("Error reading file");
+                *error_label = "Error reading file";
                 return READ_FILE_ERROR;
             }
             return READ_FILE_CHANGED;
@@ -376,7 +440,7 @@ static int read_file_buffer(const char* filepath,
             free(buffer);
             fclose(file);
             errno = EOVERFLOW;
-            perror("File too large");
+            *error_label = "File too large";
             return READ_FILE_ERROR;
         }
         size_t needed = bytes_read + extra_read;
@@ -399,7 +463,7 @@ static int read_file_buffer(const char* filepath,
             if (!new_buffer) {
                 free(buffer);
                 fclose(file);
-                perror("Error growing file buffer");
+                *error_label = "Error growing file buffer";
                 return READ_FILE_ERROR;
             }
             buffer = new_buffer;
@@ -411,12 +475,12 @@ static int read_file_buffer(const char* filepath,
     if (ferror(file)) {
         free(buffer);
         fclose(file);
-        perror("Error reading file");
+        *error_label = "Error reading file";
         return READ_FILE_ERROR;
     }
     if (fclose(file) != 0) {
         free(buffer);
-        perror("Error closing file");
+        *error_label = "Error closing file";
         return READ_FILE_ERROR;
     }
 
@@ -425,19 +489,75 @@ static int read_file_buffer(const char* filepath,
     return READ_FILE_OK;
 }
 
-static int append_export_entry(ExportPlan* plan,
+/*
+ * Reads run on ingestion workers, so failures are reported back through
+ * error_label (plus errno) and printed by the collecting thread in plan order.
+ * filepath is resolved relative to dir_fd (AT_FDCWD for plain paths). With
+ * allow_mmap, larger files may come back as a read-only mapping (*mapped_out).
+ * verify_stamp additionally requires st's size, mtime, and ctime to still match.
+ */
+static int read_file_buffer(int dir_fd,
+                            const char* filepath,
+                            const struct stat* st,
+                            size_t max_file_size,
+                            int allow_mmap,
+                            int verify_stamp,
+                            unsigned char** buffer_out,
+                            size_t* bytes_read_out,
+                            int* mapped_out,
+                            const char** error_label) {
+    int fd = -1;
+    struct stat opened_st;
+
+    *buffer_out = NULL;
+    *bytes_read_out = 0;
+    *mapped_out = 0;
+    *error_label = NULL;
+
+    if (st->st_size < 0) {
+        errno = EINVAL;
+        *error_label = "Invalid file size";
+        return READ_FILE_ERROR;
+    }
+
+    fd = open_file_nofollow(dir_fd, filepath);
+    if (fd == -1) {
+        *error_label = "Error opening file";
+        return READ_FILE_ERROR;
+    }
+    if (fstat(fd, &opened_st) == -1) {
+        close(fd);
+        *error_label = "Error stating opened file";
+        return READ_FILE_ERROR;
+    }
+    if (!S_ISREG(opened_st.st_mode)) {
+        close(fd);
+        errno = EINVAL;
+        *error_label = "Opened path is not a regular file";
+        return READ_FILE_ERROR;
+    }
+    if (opened_st.st_dev != st->st_dev || opened_st.st_ino != st->st_ino ||
+        (verify_stamp && !file_stamp_matches(&opened_st, st))) {
+        close(fd);
+        return READ_FILE_CHANGED;
+    }
+    return read_opened_file(fd, &opened_st, max_file_size, allow_mmap, buffer_out, bytes_read_out, mapped_out, error_label);
+}
+
+static ExportEntry* append_export_entry(ExportPlan* plan,
                                const char* open_path,
                                const char* display_path,
                                const struct stat* st,
                                unsigned char* buffer,
                                size_t buf_len,
+                               int buf_mapped,
                                const char* lang) {
     if (plan->count == plan->capacity) {
         size_t new_capacity = (plan->capacity == 0) ? 32 : plan->capacity * 2;
         ExportEntry* new_entries = realloc(plan->entries, new_capacity * sizeof(*new_entries));
         if (!new_entries) {
             perror("Error growing export plan");
-            return -1;
+            return NULL;
         }
         plan->entries = new_entries;
         plan->capacity = new_capacity;
@@ -452,313 +572,2068 @@ static int append_export_entry(ExportPlan* plan,
     entry->open_path = strdup(open_path);
     if (!entry->open_path) {
         perror("Error duplicating export path");
-        return -1;
+        return NULL;
     }
     entry->display_path = strdup(normalized_display ? normalized_display : open_path);
     if (!entry->display_path) {
         perror("Error duplicating display path");
         free(entry->open_path);
         entry->open_path = NULL;
-        return -1;
+        return NULL;
     }
     entry->st = *st;
     entry->buf = buffer;
     entry->buf_len = buf_len;
+    entry->buf_mapped = buf_mapped;
     entry->lang = lang;
+    entry->line_count = 0;
+    entry->max_backtick_run = 0;
+    entry->ends_with_newline = 0;
+    entry->stamp_settled = 0;
+    entry->sensitive_checked = 0;
     plan->count++;
-    return 0;
+    return entry;
 }
 
-static int collect_exportable_file(const char* open_path,
-                                   const char* display_path,
-                                   const struct stat* st,
-                                   AppContext* ctx,
-                                   int ancestor_ignored,
-                                   int respect_ignore,
-                                   ExportPlan* plan) {
-    unsigned char* buffer = NULL;
-    size_t bytes_read = 0;
+typedef enum {
+    INGEST_PENDING = 0,
+    INGEST_ACCEPTED,
+    INGEST_SKIP_SILENT,
+    INGEST_SKIP_SYMLINK,
+    INGEST_STAT_FAILED,
+    INGEST_TOO_LARGE,
+    INGEST_IGNORED,
+    INGEST_SENSITIVE,
+    INGEST_CHANGED,
+    INGEST_READ_FAILED,
+    INGEST_BINARY
+} IngestOutcome;
+
+/*
+ * One file travelling through the read-and-classify pipeline. Workers only
+ * fill in the outcome fields; counters, diagnostics, and plan appends happen
+ * afterwards on the collecting thread, in queue order.
+ */
+typedef struct {
+    const char* open_path;
+    const char* display_path;
+    char* owned_path;
+    int dir_fd;
+    const char* open_name;
+    struct stat st;
+    int have_stat;
+    int open_first;
+    const char* blob_oid;        // Read from git's object store instead of open_path.
+    unsigned blob_mode;
+    GitBlobReader* blob_reader;  // Shared by every worker; serializes its own requests.
+    int ignored;  // Matched the ignore rules while the directory was walked.
+    int cache_hit;  // cached is a usable text classification for this file's stamp.
+    ClassifyResult cached;
+    IngestOutcome outcome;
+    unsigned char* buf;
+    size_t buf_len;
+    int buf_mapped;
+    size_t line_count;
+    size_t max_backtick_run;
+    int ends_with_newline;
+    const char* lang;
+    const char* error_label;
+    int error_errno;
+} IngestCandidate;
 
-    if (!S_ISREG(st->st_mode)) {
-        return 0;
+typedef struct {
+    IngestCandidate* items;
+    size_t count;
+    size_t capacity;
+    int* dir_fds;
+    size_t dir_fd_count;
+    size_t dir_fd_capacity;
+} IngestQueue;
+
+typedef struct {
+    IngestQueue* queue;
+    const AppContext* ctx;
+    size_t next;
+    pthread_mutex_t lock;
+} IngestPool;
+
+static void release_ingest_candidate(IngestCandidate* candidate) {
+    free(candidate->owned_path);
+    release_file_buffer(candidate->buf, candidate->buf_len, candidate->buf_mapped);
+}
+
+static void free_ingest_queue(IngestQueue* queue) {
+    if (!queue) return;
+    for (size_t i = 0; i < queue->count; i++) {
+        release_ingest_candidate(&queue->items[i]);
     }
-    if ((ctx->have_temp &&
-         st->st_dev == ctx->temp_stat.st_dev && st->st_ino == ctx->temp_stat.st_ino) ||
-        (ctx->have_final &&
-         st->st_dev == ctx->final_stat.st_dev && st->st_ino == ctx->final_stat.st_ino)) {
-        return 0;
+    for (size_t i = 0; i < queue->dir_fd_count; i++) {
+        close(queue->dir_fds[i]);
     }
+    free(queue->items);
+    free(queue->dir_fds);
+    memset(queue, 0, sizeof(*queue));
+}
 
-    if (respect_ignore) {
-        if (st->st_size < 0) {
-            return 0;
-        }
-        if ((size_t)st->st_size > ctx->max_file_size) {
-            ctx->skipped_too_large++;
-            if (ctx->verbose) {
-                fprintf(stderr, "Skipping oversized file: %s\n", display_path);
-            }
-            return 0;
-        }
-        if (resolve_ignore_state(open_path,
-                                 ctx->ignore_patterns,
-                                 ctx->ignore_count,
-                                 0,
-                                 ancestor_ignored)) {
-            ctx->skipped_ignored++;
-            if (ctx->verbose) {
-                fprintf(stderr, "Skipping ignored file: %s\n", display_path);
-            }
-            return 0;
+/* Takes ownership of a directory fd that queued candidates open files relative to. */
+static int adopt_ingest_dir_fd(IngestQueue* queue, int dir_fd) {
+    if (queue->dir_fd_count == queue->dir_fd_capacity) {
+        size_t new_capacity = (queue->dir_fd_capacity == 0) ? 16 : queue->dir_fd_capacity * 2;
+        int* new_fds = realloc(queue->dir_fds, new_capacity * sizeof(*new_fds));
+        if (!new_fds) {
+            perror("Error growing ingestion queue");
+            return -1;
         }
-    } else if (st->st_size < 0 || (size_t)st->st_size > ctx->max_file_size) {
-        if (st->st_size >= 0 && (size_t)st->st_size > ctx->max_file_size) {
-            ctx->skipped_too_large++;
-            if (ctx->verbose) {
-                fprintf(stderr, "Skipping oversized file: %s\n", display_path);
-            }
+        queue->dir_fds = new_fds;
+        queue->dir_fd_capacity = new_capacity;
+    }
+    queue->dir_fds[queue->dir_fd_count++] = dir_fd;
+    return 0;
+}
+
+static IngestCandidate* push_ingest_candidate(IngestQueue* queue) {
+    if (queue->count == queue->capacity) {
+        size_t new_capacity = (queue->capacity == 0) ? 64 : queue->capacity * 2;
+        IngestCandidate* new_items = realloc(queue->items, new_capacity * sizeof(*new_items));
+        if (!new_items) {
+            perror("Error growing ingestion queue");
+            return NULL;
         }
-        return 0;
+        queue->items = new_items;
+        queue->capacity = new_capacity;
     }
 
-    if (!ctx->allow_sensitive && fuori_is_sensitive_filename(open_path)) {
-        ctx->skipped_sensitive++;
-        fprintf(stderr, "Warning: Skipping sensitive file %s\n", display_path);
-        return 0;
+    IngestCandidate* candidate = &queue->items[queue->count++];
+    memset(candidate, 0, sizeof(*candidate));
+    candidate->dir_fd = AT_FDCWD;
+    return candidate;
+}
+
+static int is_output_file(const AppContext* ctx, const struct stat* st) {
+    return (ctx->have_temp &&
+            st->st_dev == ctx->temp_stat.st_dev && st->st_ino == ctx->temp_stat.st_ino) ||
+           (ctx->have_final &&
+            st->st_dev == ctx->final_stat.st_dev && st->st_ino == ctx->final_stat.st_ino);
+}
+
+/*
+ * Paths the git index lists as regular files are opened straight away; the
+ * fstat() of that no-follow descriptor is what lstat() would have reported,
+ * so clean tracked files skip the separate lstat round trip. Anything else
+ * (a symlink, a vanished or replaced path) drops back to the lstat route.
+ */
+static int open_listed_regular_file(IngestCandidate* candidate) {
+    int fd = open_file_nofollow(candidate->dir_fd, candidate->open_name);
+
+    if (fd == -1) {
+        return -1;
+    }
+    if (fstat(fd, &candidate->st) == -1 || !S_ISREG(candidate->st.st_mode)) {
+        close(fd);
+        return -1;
     }
+    candidate->have_stat = 1;
+    return fd;
+}
 
-    /* Cache accepted file contents in memory to avoid re-reading at render time. */
-    int read_result = read_file_buffer(open_path, st, ctx->max_file_size, &buffer, &bytes_read);
-    if (read_result == 1) {
-        ctx->skipped_too_large++;
-        if (ctx->verbose) {
-            fprintf(stderr, "Skipping oversized file: %s\n", display_path);
+/* Runs the stat-based admission checks; leaves the outcome pending on success. */
+static void admit_ingest_candidate(IngestCandidate* candidate, const AppContext* ctx) {
+    const struct stat* st = &candidate->st;
+
+    if (!candidate->have_stat) {
+        if (lstat(candidate->open_path, &candidate->st) == -1) {
+            if (errno == ENOENT) {
+                candidate->outcome = INGEST_SKIP_SILENT;
+                return;
+            }
+            candidate->error_label = "Error getting selected file status";
+            candidate->error_errno = errno;
+            candidate->outcome = INGEST_STAT_FAILED;
+            return;
+        }
+        candidate->have_stat = 1;
+        if (S_ISLNK(st->st_mode)) {
+            candidate->outcome = INGEST_SKIP_SYMLINK;
+            return;
         }
-        return 0;
     }
-    if (read_result == 2) {
-        fprintf(stderr, "Warning: File changed while being processed %s\n", display_path);
-        return 0;
+
+    if (!S_ISREG(st->st_mode) || is_output_file(ctx, st) || st->st_size < 0) {
+        candidate->outcome = INGEST_SKIP_SILENT;
+        return;
     }
-    if (read_result != 0) {
-        fprintf(stderr, "Warning: Failed to process file %s\n", display_path);
-        return 0;
+    if ((size_t)st->st_size > ctx->max_file_size) {
+        candidate->outcome = INGEST_TOO_LARGE;
+        return;
     }
-    if (bytes_read == 0) {
-        ctx->skipped_binary++;
-        if (ctx->verbose) {
-            fprintf(stderr, "Skipping binary/empty file: %s\n", display_path);
-        }
-        free(buffer);
-        return 0;
+    if (candidate->ignored) {
+        candidate->outcome = INGEST_IGNORED;
+        return;
     }
-    if (is_binary_file(buffer, bytes_read)) {
-        ctx->skipped_binary++;
-        if (ctx->verbose) {
-            fprintf(stderr, "Skipping binary/empty file: %s\n", display_path);
-        }
-        free(buffer);
-        return 0;
+    if (!ctx->allow_sensitive && fuori_is_sensitive_filename(candidate->open_path)) {
+        candidate->outcome = INGEST_SENSITIVE;
+        return;
     }
-    if (!ctx->allow_sensitive && fuori_contains_sensitive_content(buffer, bytes_read)) {
-        ctx->skipped_sensitive++;
-        fprintf(stderr, "Warning: Skipping sensitive file %s\n", display_path);
-        free(buffer);
-        return 0;
+}
+
+/*
+ * Staged and revision entries are read from git's object store. The blob's
+ * mode and size stand in for the file's stat so the usual admission checks
+ * (and their precedence) still apply. Returns -1 once an outcome is set.
+ */
+static int read_blob_candidate(IngestCandidate* candidate,
+                               const AppContext* ctx,
+                               unsigned char** buffer_out,
+                               size_t* bytes_read_out) {
+    size_t blob_size = 0;
+
+    memset(&candidate->st, 0, sizeof(candidate->st));
+    candidate->st.st_mode = (mode_t)candidate->blob_mode;
+    candidate->have_stat = 1;
+    if (S_ISLNK(candidate->st.st_mode)) {
+        candidate->outcome = INGEST_SKIP_SYMLINK;
+        return -1;
+    }
+    if (!S_ISREG(candidate->st.st_mode)) {
+        candidate->outcome = INGEST_SKIP_SILENT;
+        return -1;
     }
 
-    const char* lang = get_language_identifier(open_path, buffer, bytes_read);
-    if (ctx->verbose) {
-        fprintf(stderr, "Queued file: %s\n", display_path);
+    if (read_git_blob(candidate->blob_reader, candidate->blob_oid, ctx->max_file_size, buffer_out, &blob_size) < 0) {
+        candidate->error_label = "Error reading git blob";
+        candidate->error_errno = errno;
+        candidate->outcome = INGEST_READ_FAILED;
+        return -1;
     }
-    if (append_export_entry(plan, open_path, display_path, st, buffer, bytes_read, lang) != 0) {
-        free(buffer);
+    candidate->st.st_size = (off_t)blob_size;
+    admit_ingest_candidate(candidate, ctx);
+    if (candidate->outcome != INGEST_PENDING) {
+        free(*buffer_out);
+        *buffer_out = NULL;
         return -1;
     }
+    *bytes_read_out = blob_size;
     return 0;
 }
 
-static int collect_recursive_paths(const char* base_path,
-                                   AppContext* ctx,
-                                   int ancestor_ignored,
-                                   ExportPlan* plan) {
-    DIR* dir = NULL;
-    struct dirent* entry;
-    char path[MAX_PATH_LENGTH];
-    char** names = NULL;
-    size_t name_count = 0;
-    size_t name_capacity = 0;
-    int status = 0;
-
-    if (ctx->verbose) {
-        fprintf(stderr, "Processing directory: %s\n", base_path);
+/*
+ * Settles a candidate from the classification cache when its stamp matches:
+ * rejected files get their outcome, and text files get cache_hit so their
+ * classification is not redone. Records are keyed by inode, which hard links
+ * share, so only the shebang half of the language comes from the cache.
+ */
+static void apply_cached_classification(IngestCandidate* candidate, const AppContext* ctx) {
+    ClassifyResult* cached = &candidate->cached;
+
+    if (!ctx->classify_cache || candidate->st.st_size <= 0 ||
+        !lookup_classify_cache(ctx->classify_cache, &candidate->st, cached)) {
+        return;
     }
-
-    dir = opendir(base_path);
-    if (!dir) {
-        if (strcmp(base_path, ".") != 0 &&
-            (errno == EACCES || errno == EPERM)) {
-            ctx->skipped_unreadable_dirs++;
-            fprintf(stderr, "Warning: Failed to process directory %s\n", base_path);
-            return 0;
-        }
-        perror("Error opening directory");
-        return -1;
+    if (cached->binary) {
+        candidate->outcome = INGEST_BINARY;
+    } else if (cached->sensitivity == CLASSIFY_SENSITIVITY_FOUND && !ctx->allow_sensitive) {
+        candidate->outcome = INGEST_SENSITIVE;
+    } else if ((cached->sensitivity != CLASSIFY_SENSITIVITY_UNCHECKED || ctx->allow_sensitive) &&
+               (get_path_language(candidate->open_path, &candidate->lang) ||
+                resolve_cached_language(cached->lang, &candidate->lang) == 0)) {
+        candidate->cache_hit = 1;
     }
+}
 
-    while (1) {
-        errno = 0;
-        entry = readdir(dir);
-        if (!entry) {
-            if (errno != 0) {
-                perror("Error reading directory entries");
-                status = -1;
-            }
-            break;
+/*
+ * Opens, admits, and reads a file from the filesystem. Returns -1 once an
+ * outcome is set. A cache hit without keep_body returns no buffer and the
+ * stat size as *bytes_read_out.
+ */
+static int read_worktree_candidate(IngestCandidate* candidate,
+                                   const AppContext* ctx,
+                                   int keep_body,
+                                   unsigned char** buffer_out,
+                                   size_t* bytes_read_out,
+                                   int* mapped_out) {
+    int fd = -1;
+    int read_result;
+
+    if (!candidate->have_stat && candidate->open_first) {
+        fd = open_listed_regular_file(candidate);
+    }
+    admit_ingest_candidate(candidate, ctx);
+    if (candidate->outcome == INGEST_PENDING) {
+        apply_cached_classification(candidate, ctx);
+    }
+    if (candidate->outcome != INGEST_PENDING || (candidate->cache_hit && !keep_body)) {
+        if (fd != -1) {
+            close(fd);
         }
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
+        if (candidate->outcome != INGEST_PENDING) {
+            return -1;
         }
+        *bytes_read_out = (size_t)candidate->st.st_size;
+        return 0;
+    }
+
+    /* Cache accepted file contents in memory to avoid re-reading at render time. */
+    if (fd != -1) {
+        read_result = read_opened_file(fd,
+                                       &candidate->st,
+                                       ctx->max_file_size,
+                                       ctx->use_mmap,
+                                       buffer_out,
+                                       bytes_read_out,
+                                       mapped_out,
+                                       &candidate->error_label);
+    } else {
+        read_result = read_file_buffer(candidate->dir_fd,
+                                       candidate->open_name,
+                                       &candidate->st,
+                                       ctx->max_file_size,
+                                       ctx->use_mmap,
+                                       0,
+                                       buffer_out,
+                                       bytes_read_out,
+                                       mapped_out,
+                                       &candidate->error_label);
+    }
+    if (read_result == READ_FILE_TOO_LARGE) {
+        candidate->outcome = INGEST_TOO_LARGE;
+        return -1;
+    }
+    if (read_result == READ_FILE_CHANGED) {
+        candidate->outcome = INGEST_CHANGED;
+        return -1;
+    }
+    if (read_result != READ_FILE_OK) {
+        candidate->error_errno = errno;
+        candidate->outcome = INGEST_READ_FAILED;
+        return -1;
+    }
+    return 0;
+}
+
+/* Records a worktree file's classification for later runs; the cache is best effort. */
+static void remember_classification(const IngestCandidate* candidate,
+                                    const AppContext* ctx,
+                                    const TextScan* scan,
+                                    int binary,
+                                    ClassifySensitivity sensitivity,
+                                    const char* lang) {
+    ClassifyResult result;
+
+    if (!ctx->classify_cache || candidate->blob_oid) {
+        return;
+    }
+    memset(&result, 0, sizeof(result));
+    result.binary = binary;
+    result.sensitivity = sensitivity;
+    if (!binary) {
+        if (lang && strlen(lang) >= sizeof(result.lang)) {
+            return;
+        }
+        if (lang) {
+            strcpy(result.lang, lang);
+        }
+        result.line_count = scan->line_count;
+        result.max_backtick_run = scan->max_backtick_run;
+        result.ends_with_newline = candidate->ends_with_newline;
+    }
+    store_classify_cache(ctx->classify_cache, &candidate->st, &result);
+}
+
+static void ingest_candidate(IngestCandidate* candidate, const AppContext* ctx) {
+    unsigned char* buffer = NULL;
+    size_t bytes_read = 0;
+    int mapped = 0;
+    /* Blobs cannot be re-read from the worktree, so they keep their bodies under --stream. */
+    int keep_body = !ctx->stream_bodies || candidate->blob_oid != NULL;
+    ClassifySensitivity sensitivity = CLASSIFY_SENSITIVITY_UNCHECKED;
+    TextScan scan;
+
+    if (candidate->blob_oid) {
+        if (read_blob_candidate(candidate, ctx, &buffer, &bytes_read) != 0) {
+            return;
+        }
+    } else if (read_worktree_candidate(candidate, ctx, keep_body, &buffer, &bytes_read, &mapped) != 0) {
+        return;
+    }
+    if (candidate->cache_hit) {
+        if (!keep_body || bytes_read == (size_t)candidate->st.st_size) {
+            candidate->line_count = candidate->cached.line_count;
+            candidate->max_backtick_run = candidate->cached.max_backtick_run;
+            candidate->ends_with_newline = candidate->cached.ends_with_newline;
+            candidate->buf_len = bytes_read;
+            candidate->buf = buffer;
+            candidate->buf_mapped = mapped;
+            candidate->outcome = INGEST_ACCEPTED;
+            return;
+        }
+        /* The file changed size after its stat; classify what was actually read. */
+        candidate->cache_hit = 0;
+    }
+    if (bytes_read == 0) {
+        release_file_buffer(buffer, bytes_read, mapped);
+        candidate->outcome = INGEST_BINARY;
+        return;
+    }
+    /* One pass yields the binary verdict plus the line and fence data render reuses. */
+    if (fuori_scan_text(buffer, bytes_read, 0, &scan) != 0) {
+        candidate->error_errno = errno;
+        candidate->error_label = "Error scanning file";
+        release_file_buffer(buffer, bytes_read, mapped);
+        candidate->outcome = INGEST_READ_FAILED;
+        return;
+    }
+    if (fuori_text_scan_is_binary(&scan, bytes_read)) {
+        remember_classification(candidate, ctx, &scan, 1, sensitivity, NULL);
+        fuori_free_text_scan(&scan);
+        release_file_buffer(buffer, bytes_read, mapped);
+        candidate->outcome = INGEST_BINARY;
+        return;
+    }
+    candidate->lang = get_language_identifier(candidate->open_path, buffer, bytes_read);
+    candidate->ends_with_newline = (buffer[bytes_read - 1] == '\n');
+    if (!ctx->allow_sensitive) {
+        sensitivity = fuori_contains_sensitive_content(buffer, bytes_read) ? CLASSIFY_SENSITIVITY_FOUND
+                                                                          : CLASSIFY_SENSITIVITY_CLEAN;
+    }
+    remember_classification(candidate, ctx, &scan, 0, sensitivity, detect_shebang(buffer, bytes_read));
+    if (sensitivity == CLASSIFY_SENSITIVITY_FOUND) {
+        fuori_free_text_scan(&scan);
+        release_file_buffer(buffer, bytes_read, mapped);
+        candidate->outcome = INGEST_SENSITIVE;
+        return;
+    }
+
+    candidate->line_count = scan.line_count;
+    candidate->max_backtick_run = scan.max_backtick_run;
+    candidate->buf_len = bytes_read;
+    if (!keep_body) {
+        /* Streamed entries keep only identity and classification; render re-reads them. */
+        release_file_buffer(buffer, bytes_read, mapped);
+    } else {
+        candidate->buf = buffer;
+        candidate->buf_mapped = mapped;
+    }
+    candidate->outcome = INGEST_ACCEPTED;
+}
+
+static void* ingest_worker(void* arg) {
+    IngestPool* pool = arg;
+
+    while (1) {
+        size_t index;
+
+        pthread_mutex_lock(&pool->lock);
+        index = pool->next;
+        if (index < pool->queue->count) {
+            pool->next++;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        if (index >= pool->queue->count) {
+            break;
+        }
+        ingest_candidate(&pool->queue->items[index], pool->ctx);
+    }
+    return NULL;
+}
+
+size_t resolve_worker_count(size_t requested, size_t work_items) {
+    size_t workers = requested;
+
+    if (workers == 0) {
+        workers = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        if (online > 1) {
+            workers = (size_t)online;
+        }
+#endif
+    }
+    if (workers > work_items) {
+        workers = work_items;
+    }
+    return (workers == 0) ? 1 : workers;
+}
+
+static void run_ingest_pool(IngestQueue* queue, const AppContext* ctx) {
+    IngestPool pool = {.queue = queue, .ctx = ctx, .next = 0};
+    pthread_t* threads = NULL;
+    size_t workers = resolve_worker_count(ctx->jobs, queue->count);
+    size_t started = 0;
+
+    if (workers > 1) {
+        threads = malloc((workers - 1) * sizeof(*threads));
+    }
+    if (!threads || pthread_mutex_init(&pool.lock, NULL) != 0) {
+        /* Threads are an optimization; a serial pass produces the same plan. */
+        free(threads);
+        for (size_t i = 0; i < queue->count; i++) {
+            ingest_candidate(&queue->items[i], ctx);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i + 1 < workers; i++) {
+        if (pthread_create(&threads[i], NULL, ingest_worker, &pool) != 0) {
+            break;
+        }
+        started++;
+    }
+    ingest_worker(&pool);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool.lock);
+    free(threads);
+}
+
+static int commit_ingest_candidate(IngestCandidate* candidate, AppContext* ctx, ExportPlan* plan) {
+    const char* display_path = candidate->display_path;
+
+    ExportEntry* entry;
+
+    switch (candidate->outcome) {
+        case INGEST_ACCEPTED:
+            if (ctx->verbose) {
+                fprintf(stderr, "Queued file: %s\n", display_path);
+            }
+            entry = append_export_entry(plan,
+                                        candidate->open_path,
+                                        display_path,
+                                        &candidate->st,
+                                        candidate->buf,
+                                        candidate->buf_len,
+                                        candidate->buf_mapped,
+                                        candidate->lang);
+            if (!entry) {
+                return -1;
+            }
+            entry->line_count = candidate->line_count;
+            entry->max_backtick_run = candidate->max_backtick_run;
+            entry->ends_with_newline = candidate->ends_with_newline;
+            entry->stamp_settled = candidate->st.st_mtime < ctx->collect_started &&
+                                   candidate->st.st_ctime < ctx->collect_started;
+            entry->sensitive_checked = !ctx->allow_sensitive;
+            candidate->buf = NULL;
+            return 0;
+        case INGEST_SKIP_SYMLINK:
+            ctx->skipped_symlink++;
+            if (ctx->verbose) {
+                fprintf(stderr, "Skipping symlink: %s\n", display_path);
+            }
+            return 0;
+        case INGEST_STAT_FAILED:
+            fprintf(stderr, "%s: %s\n", candidate->error_label, strerror(candidate->error_errno));
+            return 0;
+        case INGEST_TOO_LARGE:
+            ctx->skipped_too_large++;
+            if (ctx->verbose) {
+                fprintf(stderr, "Skipping oversized file: %s\n", display_path);
+            }
+            return 0;
+        case INGEST_IGNORED:
+            ctx->skipped_ignored++;
+            if (ctx->verbose) {
+                fprintf(stderr, "Skipping ignored file: %s\n", display_path);
+            }
+            return 0;
+        case INGEST_SENSITIVE:
+            ctx->skipped_sensitive++;
+            fprintf(stderr, "Warning: Skipping sensitive file %s\n", display_path);
+            return 0;
+        case INGEST_CHANGED:
+            fprintf(stderr, "Warning: File changed while being processed %s\n", display_path);
+            return 0;
+        case INGEST_READ_FAILED:
+            if (candidate->error_label) {
+                fprintf(stderr, "%s: %s\n", candidate->error_label, strerror(candidate->error_errno));
+            }
+            fprintf(stderr, "Warning: Failed to process file %s\n", display_path);
+            return 0;
+        case INGEST_BINARY:
+            ctx->skipped_binary++;
+            if (ctx->verbose) {
+                fprintf(stderr, "Skipping binary/empty file: %s\n", display_path);
+            }
+            return 0;
+        case INGEST_SKIP_SILENT:
+        case INGEST_PENDING:
+        default:
+            return 0;
+    }
+}
+
+static int ingest_queue_into_plan(IngestQueue* queue, AppContext* ctx, ExportPlan* plan) {
+    run_ingest_pool(queue, ctx);
+
+    for (size_t i = 0; i < queue->count; i++) {
+        if (commit_ingest_candidate(&queue->items[i], ctx, plan) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+typedef enum {
+    WALK_ITEM_FILE = 0,
+    WALK_ITEM_DIRECTORY,
+    WALK_ITEM_SYMLINK,
+    WALK_ITEM_IGNORED_DIRECTORY,
+    WALK_ITEM_LONG_PATH,
+    WALK_ITEM_STAT_FAILED
+} WalkItemKind;
+
+struct WalkNode;
+
+typedef struct {
+    WalkItemKind kind;
+    char* path;
+    struct stat st;
+    int have_stat;  // Unset for files replayed from the directory cache.
+    int ignored;
+    int error_errno;
+    struct WalkNode* child;
+} WalkItem;
+
+/*
+ * Directories are walked out of order by the pool, so each one records what
+ * it found (files, subdirectories, and anything worth reporting) in sorted
+ * entry order. Replaying the finished tree depth-first afterwards yields the
+ * same candidates, counters, and diagnostics as a serial recursive walk.
+ *
+ * A node may keep its directory fd open (dir_fd) so children and file reads
+ * resolve names with openat()/fstatat() instead of re-walking full paths.
+ *
+ * segments is the node's path split below the walk root, inherited from the
+ * parent plus its own name, with one spare slot where each entry's name is
+ * pushed while it is matched against the ignore rules.
+ *
+ * ignore_scope is the innermost set of ignore rules in effect: the parent's,
+ * or owned_scope when the directory has its own .gitignore. Scopes outlive
+ * every descendant because children are freed before their parent.
+ */
+typedef struct WalkNode {
+    char* path;
+    const char* name;
+    const struct WalkNode* parent;
+    const IgnoreScope* ignore_scope;
+    IgnoreScope* owned_scope;
+    int dir_fd;
+    int ancestor_ignored;
+    int visited;
+    int unreadable;
+    int replaced;  // Swapped for a symlink, a file, or removed after its parent was listed.
+    int replaced_by_symlink;
+    const char* fatal_label;
+    int fatal_errno;
+    WalkItem* items;
+    size_t item_count;
+    size_t item_capacity;
+    size_t depth;
+    const char* segments[];
+} WalkNode;
+
+/* Owners push and pop at the tail; idle workers steal from the head. */
+typedef struct {
+    WalkNode** tasks;
+    size_t head;
+    size_t tail;
+    size_t capacity;
+    pthread_mutex_t lock;
+} WalkDeque;
+
+typedef struct {
+    const AppContext* ctx;
+    WalkDeque* deques;
+    size_t worker_count;
+    size_t pending;
+    size_t open_dirs;
+    size_t max_open_dirs;
+    int failed;
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+} WalkPool;
+
+typedef struct {
+    WalkPool* pool;
+    size_t index;
+} WalkWorker;
+
+static WalkNode* create_walk_node(const WalkNode* parent, const char* path, int ancestor_ignored) {
+    size_t depth = parent ? parent->depth + 1 : 0;
+    WalkNode* node = calloc(1, sizeof(*node) + (depth + 1) * sizeof(node->segments[0]));
+    if (!node) {
+        return NULL;
+    }
+    node->path = strdup(path);
+    if (!node->path) {
+        free(node);
+        return NULL;
+    }
+    node->name = strrchr(node->path, '/');
+    node->name = node->name ? node->name + 1 : node->path;
+    node->parent = parent;
+    node->depth = depth;
+    if (parent) {
+        node->ignore_scope = parent->ignore_scope;
+        memcpy(node->segments, parent->segments, parent->depth * sizeof(node->segments[0]));
+        node->segments[depth - 1] = node->name;
+    }
+    node->dir_fd = -1;
+    node->ancestor_ignored = ancestor_ignored;
+    return node;
+}
+
+static void free_walk_node(WalkNode* node) {
+    if (!node) return;
+    for (size_t i = 0; i < node->item_count; i++) {
+        free(node->items[i].path);
+        free_walk_node(node->items[i].child);
+    }
+    if (node->dir_fd != -1) {
+        close(node->dir_fd);
+    }
+    free(node->items);
+    free_ignore_scope(node->owned_scope);
+    free(node->path);
+    free(node);
+}
+
+static int fail_walk_node(WalkNode* node, const char* label) {
+    if (!node->fatal_label) {
+        node->fatal_label = label;
+        node->fatal_errno = errno;
+    }
+    return -1;
+}
+
+static WalkItem* append_walk_item(WalkNode* node, WalkItemKind kind, const char* path) {
+    if (node->item_count == node->item_capacity) {
+        size_t new_capacity = (node->item_capacity == 0) ? 32 : node->item_capacity * 2;
+        WalkItem* new_items = realloc(node->items, new_capacity * sizeof(*new_items));
+        if (!new_items) {
+            return NULL;
+        }
+        node->items = new_items;
+        node->item_capacity = new_capacity;
+    }
+
+    WalkItem* item = &node->items[node->item_count];
+    memset(item, 0, sizeof(*item));
+    if (path) {
+        item->path = strdup(path);
+        if (!item->path) {
+            return NULL;
+        }
+    }
+    item->kind = kind;
+    node->item_count++;
+    return item;
+}
+
+static int push_walk_task(WalkPool* pool, size_t worker, WalkNode* node) {
+    WalkDeque* deque = &pool->deques[worker];
+    int status = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending++;
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail == deque->capacity && deque->head > 0) {
+        memmove(deque->tasks,
+                deque->tasks + deque->head,
+                (deque->tail - deque->head) * sizeof(*deque->tasks));
+        deque->tail -= deque->head;
+        deque->head = 0;
+    }
+    if (deque->tail == deque->capacity) {
+        size_t new_capacity = (deque->capacity == 0) ? 16 : deque->capacity * 2;
+        WalkNode** new_tasks = realloc(deque->tasks, new_capacity * sizeof(*new_tasks));
+        if (!new_tasks) {
+            status = -1;
+        } else {
+            deque->tasks = new_tasks;
+            deque->capacity = new_capacity;
+        }
+    }
+    if (status == 0) {
+        deque->tasks[deque->tail++] = node;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    pthread_mutex_lock(&pool->lock);
+    if (status != 0) {
+        pool->pending--;
+    }
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+    return status;
+}
+
+static WalkNode* pop_walk_task(WalkDeque* deque, int steal) {
+    WalkNode* node = NULL;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->head < deque->tail) {
+        node = steal ? deque->tasks[deque->head++] : deque->tasks[--deque->tail];
+        if (deque->head == deque->tail) {
+            deque->head = 0;
+            deque->tail = 0;
+        }
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return node;
+}
+
+static int walk_pool_has_tasks(WalkPool* pool) {
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        WalkDeque* deque = &pool->deques[i];
+        int has_tasks;
+
+        pthread_mutex_lock(&deque->lock);
+        has_tasks = (deque->head < deque->tail);
+        pthread_mutex_unlock(&deque->lock);
+        if (has_tasks) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static WalkNode* take_walk_task(WalkPool* pool, size_t worker) {
+    while (1) {
+        WalkNode* node = pop_walk_task(&pool->deques[worker], 0);
+        for (size_t i = 1; !node && i < pool->worker_count; i++) {
+            node = pop_walk_task(&pool->deques[(worker + i) % pool->worker_count], 1);
+        }
+        if (node) {
+            return node;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if (pool->pending == 0 || pool->failed) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        if (!walk_pool_has_tasks(pool)) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static int open_walk_directory(const WalkNode* node) {
+    int open_flags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW;
+#ifdef O_CLOEXEC
+    open_flags |= O_CLOEXEC;
+#endif
+
+    if (node->parent && node->parent->dir_fd != -1) {
+        return openat(node->parent->dir_fd, node->name, open_flags);
+    }
+    return openat(AT_FDCWD, node->path, open_flags);
+}
+
+/*
+ * Keeps the directory fd for children and file reads while the pool stays
+ * under its open-directory budget; past that, names fall back to full paths.
+ */
+static void retain_walk_directory_fd(WalkPool* pool, WalkNode* node, int fd) {
+    int keep = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->open_dirs < pool->max_open_dirs) {
+        pool->open_dirs++;
+        keep = 1;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!keep) {
+        return;
+    }
+#ifdef F_DUPFD_CLOEXEC
+    node->dir_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+#else
+    node->dir_fd = dup(fd);
+#endif
+    if (node->dir_fd == -1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->open_dirs--;
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static int walk_dirent_needs_stat(int type) {
+#if defined(DT_UNKNOWN) && defined(DT_DIR) && defined(DT_LNK) && defined(DT_REG)
+    return type == DT_REG || type == DT_UNKNOWN;
+#else
+    (void)type;
+    return 1;
+#endif
+}
+
+/*
+ * Collects a directory's sorted entries with readdir(). Kinds are filled in
+ * by the caller once each entry's type is known.
+ */
+static int read_walk_listing(WalkNode* node,
+                             DIR* dir,
+                             WalkDirent** dirents_out,
+                             size_t* dirent_count_out,
+                             WalkCacheEntry** listing_out) {
+    struct dirent* entry;
+    WalkDirent* dirents = NULL;
+    WalkCacheEntry* listing = NULL;
+    size_t dirent_count = 0;
+    size_t dirent_capacity = 0;
+
+    while (1) {
+        errno = 0;
+        entry = readdir(dir);
+        if (!entry) {
+            if (errno != 0) {
+                fail_walk_node(node, "Error reading directory entries");
+                goto fail;
+            }
+            break;
+        }
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        if (dirent_count == dirent_capacity) {
+            size_t new_capacity = (dirent_capacity == 0) ? 32 : dirent_capacity * 2;
+            WalkDirent* new_dirents = realloc(dirents, new_capacity * sizeof(*new_dirents));
+            if (!new_dirents) {
+                fail_walk_node(node, "Error allocating directory entry list");
+                goto fail;
+            }
+            dirents = new_dirents;
+            dirent_capacity = new_capacity;
+        }
+
+        dirents[dirent_count].name = strdup(entry->d_name);
+        if (!dirents[dirent_count].name) {
+            fail_walk_node(node, "Error duplicating directory entry name");
+            goto fail;
+        }
+#ifdef DT_UNKNOWN
+        dirents[dirent_count].type = entry->d_type;
+#else
+        dirents[dirent_count].type = 0;
+#endif
+        dirent_count++;
+    }
+
+    if (dirent_count > 1) {
+        qsort(dirents, dirent_count, sizeof(*dirents), compare_walk_dirents);
+    }
+    listing = malloc((dirent_count + 1) * sizeof(*listing));
+    if (!listing) {
+        fail_walk_node(node, "Error allocating directory entry list");
+        goto fail;
+    }
+    for (size_t i = 0; i < dirent_count; i++) {
+        listing[i].name = dirents[i].name;
+        listing[i].kind = (WalkCacheKind)0;
+    }
+
+    *dirents_out = dirents;
+    *dirent_count_out = dirent_count;
+    *listing_out = listing;
+    return 0;
+
+fail:
+    free_walk_dirents(dirents, dirent_count);
+    return -1;
+}
+
+/*
+ * Queues a freshly read listing for the directory cache. Entries the walker
+ * does not act on are dropped; a listing with an entry of unknown kind is not
+ * cached at all.
+ */
+static void remember_walk_listing(const AppContext* ctx,
+                                  const struct stat* dir_st,
+                                  WalkCacheEntry* listing,
+                                  size_t listing_count,
+                                  int complete) {
+    size_t kept = 0;
+
+    if (!complete) {
+        return;
+    }
+    for (size_t i = 0; i < listing_count; i++) {
+        if (listing[i].kind != 0) {
+            listing[kept++] = listing[i];
+        }
+    }
+    store_walk_cache(ctx->walk_cache, dir_st, listing, kept);
+}
+
+static int walk_directory(WalkPool* pool, size_t worker, WalkNode* node) {
+    const AppContext* ctx = pool->ctx;
+    const char* base_path = node->path;
+    int fd = -1;
+    DIR* dir = NULL;
+    struct stat dir_st;
+    char path[MAX_PATH_LENGTH];
+    WalkDirent* dirents = NULL;
+    size_t dirent_count = 0;
+    WalkCacheEntry* listing = NULL;
+    size_t listing_count = 0;
+    size_t first_child = SIZE_MAX;
+    int cached = 0;
+    int have_dir_stamp = 0;
+    int has_files = 0;
+    int status = 0;
+
+    node->visited = 1;
+
+    /* An unchanged directory replays its cached listing instead of being read. */
+    fd = open_walk_directory(node);
+    if (fd != -1 && ctx->walk_cache && fstat(fd, &dir_st) == 0) {
+        have_dir_stamp = 1;
+        cached = lookup_walk_cache(ctx->walk_cache, &dir_st, &listing, &listing_count);
+        if (cached < 0) {
+            close(fd);
+            return fail_walk_node(node, "Error allocating directory entry list");
+        }
+    }
+    if (fd != -1 && !cached) {
+        dir = fdopendir(fd);
+        if (!dir) {
+            int open_errno = errno;
+            close(fd);
+            fd = -1;
+            errno = open_errno;
+        }
+    }
+    if (fd == -1) {
+        if (strcmp(base_path, ".") != 0 &&
+            (errno == EACCES || errno == EPERM)) {
+            node->unreadable = 1;
+            return 0;
+        }
+        /* O_NOFOLLOW | O_DIRECTORY reports a directory changed since the listing as ELOOP or ENOTDIR. */
+        if (strcmp(base_path, ".") != 0 &&
+            (errno == ELOOP || errno == ENOTDIR || errno == ENOENT)) {
+            node->replaced = 1;
+            node->replaced_by_symlink = (errno == ELOOP);
+            return 0;
+        }
+        return fail_walk_node(node, "Error opening directory");
+    }
+
+    if (!cached) {
+        if (read_walk_listing(node, dir, &dirents, &dirent_count, &listing) != 0) {
+            status = -1;
+            goto cleanup;
+        }
+        listing_count = dirent_count;
+    }
+
+    /* Rules found here apply to this directory's entries and everything below them. */
+    for (size_t i = 0; i < listing_count; i++) {
+        if (strcmp(listing[i].name, IGNORE_FILE) != 0) {
+            continue;
+        }
+        if (load_ignore_scope(fd, IGNORE_FILE, node->ignore_scope, node->depth, &node->owned_scope) != 0) {
+            status = fail_walk_node(node, "Error reading ignore file");
+            goto cleanup;
+        }
+        if (node->owned_scope) {
+            node->ignore_scope = node->owned_scope;
+        }
+        break;
+    }
+
+    for (size_t i = 0; i < listing_count; i++) {
+        const char* name = listing[i].name;
+        WalkCacheKind kind = listing[i].kind;
+        size_t base_len = strlen(base_path);
+        int use_direct_concat = (base_len > 0 && base_path[base_len - 1] == '/');
+        WalkItem* item;
+        struct stat st;
+        int path_len = snprintf(path,
+                                sizeof(path),
+                                use_direct_concat ? "%s%s" : "%s/%s",
+                                base_path,
+                                name);
+        if (path_len < 0 || (size_t)path_len >= sizeof(path)) {
+            have_dir_stamp = 0;
+            if (ctx->verbose) {
+                char* long_path = malloc(base_len + strlen(name) + 2);
+                if (!long_path) {
+                    status = fail_walk_node(node, "Error allocating directory walk state");
+                    goto cleanup;
+                }
+                sprintf(long_path, "%s/%s", base_path, name);
+                item = append_walk_item(node, WALK_ITEM_LONG_PATH, NULL);
+                if (!item) {
+                    free(long_path);
+                    status = fail_walk_node(node, "Error allocating directory walk state");
+                    goto cleanup;
+                }
+                item->path = long_path;
+            }
+            continue;
+        }
+
+        /*
+         * Cached entries already know their kind; their files are stat'ed when
+         * ingestion opens them. Otherwise trust d_type for directories,
+         * symlinks, and special files; only files need metadata.
+         */
+        memset(&st, 0, sizeof(st));
+        if (!cached) {
+            if (walk_dirent_needs_stat(dirents[i].type)) {
+                if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) == -1) {
+                    int stat_errno = errno;
+                    have_dir_stamp = 0;
+                    item = append_walk_item(node, WALK_ITEM_STAT_FAILED, NULL);
+                    if (!item) {
+                        status = fail_walk_node(node, "Error allocating directory walk state");
+                        goto cleanup;
+                    }
+                    item->error_errno = stat_errno;
+                    continue;
+                }
+            }
+#if defined(DT_DIR) && defined(DT_LNK)
+            else if (dirents[i].type == DT_DIR) {
+                st.st_mode = S_IFDIR;
+            } else if (dirents[i].type == DT_LNK) {
+                st.st_mode = S_IFLNK;
+            }
+#endif
+            if (S_ISLNK(st.st_mode)) {
+                kind = WALK_CACHE_SYMLINK;
+            } else if (S_ISDIR(st.st_mode)) {
+                kind = WALK_CACHE_DIRECTORY;
+            } else if (S_ISREG(st.st_mode)) {
+                kind = WALK_CACHE_FILE;
+            }
+            listing[i].kind = kind;
+        }
+        if (kind == WALK_CACHE_SYMLINK) {
+            if (!append_walk_item(node, WALK_ITEM_SYMLINK, path)) {
+                status = fail_walk_node(node, "Error allocating directory walk state");
+                goto cleanup;
+            }
+            continue;
+        }
+
+        node->segments[node->depth] = name;
+        if (kind == WALK_CACHE_DIRECTORY) {
+            int dir_is_ignored = ignore_scope_resolve_segments(node->ignore_scope,
+                                                               node->segments,
+                                                               node->depth + 1,
+                                                               1,
+                                                               node->ancestor_ignored);
+            if (dir_is_ignored &&
+                !ignore_scope_segments_may_have_included_descendants(node->ignore_scope,
+                                                                     node->segments,
+                                                                     node->depth + 1)) {
+                if (!append_walk_item(node, WALK_ITEM_IGNORED_DIRECTORY, path)) {
+                    status = fail_walk_node(node, "Error allocating directory walk state");
+                    goto cleanup;
+                }
+                continue;
+            }
+
+            item = append_walk_item(node, WALK_ITEM_DIRECTORY, NULL);
+            if (!item) {
+                status = fail_walk_node(node, "Error allocating directory walk state");
+                goto cleanup;
+            }
+            item->child = create_walk_node(node, path, dir_is_ignored);
+            if (!item->child) {
+                status = fail_walk_node(node, "Error allocating directory walk state");
+                goto cleanup;
+            }
+            if (first_child == SIZE_MAX) {
+                first_child = node->item_count - 1;
+            }
+        } else if (kind == WALK_CACHE_FILE) {
+            item = append_walk_item(node, WALK_ITEM_FILE, path);
+            if (!item) {
+                status = fail_walk_node(node, "Error duplicating export path");
+                goto cleanup;
+            }
+            item->st = st;
+            item->have_stat = !cached;
+            item->ignored = ignore_scope_resolve_segments(node->ignore_scope,
+                                                          node->segments,
+                                                          node->depth + 1,
+                                                          0,
+                                                          node->ancestor_ignored);
+            has_files = 1;
+        }
+    }
+
+    if (!cached && ctx->walk_cache) {
+        remember_walk_listing(ctx, &dir_st, listing, listing_count, have_dir_stamp);
+    }
+    if (has_files || first_child != SIZE_MAX) {
+        retain_walk_directory_fd(pool, node, fd);
+    }
+
+    /* Push children last-to-first so the owner pops them in sorted order. */
+    for (size_t i = node->item_count; first_child != SIZE_MAX && i > first_child; i--) {
+        WalkItem* item = &node->items[i - 1];
+        if (item->kind == WALK_ITEM_DIRECTORY &&
+            push_walk_task(pool, worker, item->child) != 0) {
+            status = fail_walk_node(node, "Error growing directory walk queue");
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    if (dir) {
+        if (closedir(dir) != 0 && status == 0) {
+            status = fail_walk_node(node, "Error closing directory");
+        }
+    } else {
+        close(fd);
+    }
+    free(listing);
+    free_walk_dirents(dirents, dirent_count);
+    return status;
+}
+
+static void* walk_worker(void* arg) {
+    WalkWorker* worker = arg;
+    WalkPool* pool = worker->pool;
+    WalkNode* node;
+
+    while ((node = take_walk_task(pool, worker->index)) != NULL) {
+        int status = walk_directory(pool, worker->index, node);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->pending--;
+        if (status != 0) {
+            pool->failed = 1;
+        }
+        if (pool->pending == 0 || pool->failed) {
+            pthread_cond_broadcast(&pool->work_ready);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+static int replay_walk_node(WalkNode* node, AppContext* ctx, IngestQueue* queue) {
+    int dir_fd = AT_FDCWD;
+
+    if (!node->visited) {
+        return 0;
+    }
+    if (node->replaced) {
+        if (node->replaced_by_symlink) {
+            ctx->skipped_symlink++;
+            if (ctx->verbose) {
+                fprintf(stderr, "Skipping symlink: %s\n", node->path);
+            }
+        }
+        return 0;
+    }
+
+    if (ctx->verbose) {
+        fprintf(stderr, "Processing directory: %s\n", node->path);
+    }
+    if (node->unreadable) {
+        ctx->skipped_unreadable_dirs++;
+        fprintf(stderr, "Warning: Failed to process directory %s\n", node->path);
+        return 0;
+    }
+    if (node->dir_fd != -1) {
+        if (adopt_ingest_dir_fd(queue, node->dir_fd) != 0) {
+            return -1;
+        }
+        dir_fd = node->dir_fd;
+        node->dir_fd = -1;
+    }
+
+    for (size_t i = 0; i < node->item_count; i++) {
+        WalkItem* item = &node->items[i];
+        IngestCandidate* candidate;
+
+        switch (item->kind) {
+            case WALK_ITEM_FILE:
+                candidate = push_ingest_candidate(queue);
+                if (!candidate) {
+                    return -1;
+                }
+                candidate->owned_path = item->path;
+                candidate->open_path = item->path;
+                candidate->dir_fd = dir_fd;
+                candidate->open_name = item->path;
+                if (dir_fd != AT_FDCWD) {
+                    candidate->open_name = strrchr(item->path, '/') + 1;
+                }
+                candidate->display_path = item->path;
+                candidate->st = item->st;
+                candidate->have_stat = item->have_stat;
+                /* Files replayed from the directory cache get their stat from the open. */
+                candidate->open_first = !item->have_stat && !item->ignored;
+                candidate->ignored = item->ignored;
+                item->path = NULL;
+                break;
+            case WALK_ITEM_DIRECTORY:
+                if (replay_walk_node(item->child, ctx, queue) != 0) {
+                    return -1;
+                }
+                break;
+            case WALK_ITEM_SYMLINK:
+                ctx->skipped_symlink++;
+                if (ctx->verbose) {
+                    fprintf(stderr, "Skipping symlink: %s\n", item->path);
+                }
+                break;
+            case WALK_ITEM_IGNORED_DIRECTORY:
+                ctx->skipped_ignored++;
+                if (ctx->verbose) {
+                    fprintf(stderr, "Skipping ignored directory: %s\n", item->path);
+                }
+                break;
+            case WALK_ITEM_LONG_PATH:
+                fprintf(stderr, "Skipping path that exceeds %zu bytes: %s\n",
+                        (size_t)MAX_PATH_LENGTH, item->path);
+                break;
+            case WALK_ITEM_STAT_FAILED:
+                fprintf(stderr, "Error getting file status: %s\n", strerror(item->error_errno));
+                break;
+        }
+    }
+
+    if (node->fatal_label) {
+        fprintf(stderr, "%s: %s\n", node->fatal_label, strerror(node->fatal_errno));
+    }
+    return 0;
+}
+
+/* Leaves most of the descriptor limit to ingestion workers, git pipes, and output. */
+static size_t walk_open_directory_budget(void) {
+    size_t budget = WALK_MAX_OPEN_DIRS;
+    struct rlimit limit;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        limit.rlim_cur / 4 < budget) {
+        budget = (size_t)(limit.rlim_cur / 4);
+    }
+    return budget;
+}
+
+static int collect_recursive_paths(AppContext* ctx, IngestQueue* queue) {
+    WalkPool pool = {.ctx = ctx};
+    IgnoreScope base_scope = {
+        .patterns = ctx->ignore_patterns,
+        .pattern_count = ctx->ignore_count,
+        .matcher = ctx->ignore_matcher
+    };
+    WalkWorker* workers = NULL;
+    pthread_t* threads = NULL;
+    WalkNode* root = NULL;
+    size_t deques_ready = 0;
+    size_t started = 0;
+    int pool_ready = 0;
+    int status = -1;
+
+    pool.worker_count = resolve_worker_count(ctx->jobs, FUORI_MAX_JOBS);
+    pool.max_open_dirs = walk_open_directory_budget();
+    pool.deques = calloc(pool.worker_count, sizeof(*pool.deques));
+    workers = calloc(pool.worker_count, sizeof(*workers));
+    threads = calloc(pool.worker_count, sizeof(*threads));
+    root = create_walk_node(NULL, ".", 0);
+    if (!pool.deques || !workers || !threads || !root) {
+        perror("Error allocating directory walk state");
+        goto cleanup;
+    }
+    root->ignore_scope = &base_scope;
+
+    for (; deques_ready < pool.worker_count; deques_ready++) {
+        int rc = pthread_mutex_init(&pool.deques[deques_ready].lock, NULL);
+        if (rc != 0) {
+            errno = rc;
+            perror("Error initializing directory walk");
+            goto cleanup;
+        }
+    }
+    if (pthread_mutex_init(&pool.lock, NULL) != 0) {
+        perror("Error initializing directory walk");
+        goto cleanup;
+    }
+    if (pthread_cond_init(&pool.work_ready, NULL) != 0) {
+        pthread_mutex_destroy(&pool.lock);
+        perror("Error initializing directory walk");
+        goto cleanup;
+    }
+    pool_ready = 1;
+
+    if (push_walk_task(&pool, 0, root) != 0) {
+        perror("Error allocating directory walk state");
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < pool.worker_count; i++) {
+        workers[i].pool = &pool;
+        workers[i].index = i;
+    }
+    /* Extra workers are an optimization; the calling thread can drain every deque alone. */
+    for (size_t i = 1; i < pool.worker_count; i++) {
+        if (pthread_create(&threads[i], NULL, walk_worker, &workers[i]) != 0) {
+            break;
+        }
+        started++;
+    }
+    walk_worker(&workers[0]);
+    for (size_t i = 1; i <= started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    status = pool.failed ? -1 : 0;
+    if (replay_walk_node(root, ctx, queue) != 0) {
+        status = -1;
+    }
+
+cleanup:
+    if (pool_ready) {
+        pthread_cond_destroy(&pool.work_ready);
+        pthread_mutex_destroy(&pool.lock);
+    }
+    for (size_t i = 0; i < deques_ready; i++) {
+        pthread_mutex_destroy(&pool.deques[i].lock);
+        free(pool.deques[i].tasks);
+    }
+    free(pool.deques);
+    free(workers);
+    free(threads);
+    free_walk_node(root);
+    return status;
+}
+
+int collect_recursive_export_plan(AppContext* ctx, ExportPlan* plan) {
+    IngestQueue queue = {0};
+    int status = -1;
+
+    if (collect_recursive_paths(ctx, &queue) != 0 ||
+        ingest_queue_into_plan(&queue, ctx, plan) != 0) {
+        goto cleanup;
+    }
+    if (plan->count > 1) {
+        qsort(plan->entries, plan->count, sizeof(*plan->entries), compare_export_entries);
+    }
+    status = 0;
+
+cleanup:
+    free_ingest_queue(&queue);
+    return status;
+}
+
+int collect_selected_export_plan(const SelectedPath* selected_paths,
+                                 size_t selected_count,
+                                 AppContext* ctx,
+                                 ExportPlan* plan) {
+    IngestQueue queue = {0};
+    GitBlobReader* blob_reader = NULL;
+    int status = -1;
 
-        if (name_count == name_capacity) {
-            size_t new_capacity = (name_capacity == 0) ? 32 : name_capacity * 2;
-            char** new_names = realloc(names, new_capacity * sizeof(char*));
-            if (!new_names) {
-                perror("Error allocating directory entry list");
-                status = -1;
+    for (size_t i = 0; i < selected_count; i++) {
+        IngestCandidate* candidate = push_ingest_candidate(&queue);
+        if (!candidate) {
+            goto cleanup;
+        }
+        candidate->open_path = selected_paths[i].open_path;
+        candidate->open_name = selected_paths[i].open_path;
+        candidate->display_path = selected_paths[i].display_path;
+        candidate->open_first = selected_paths[i].index_regular_file;
+        if (selected_paths[i].blob_oid) {
+            /* One cat-file process serves every blob in the selection. */
+            if (!blob_reader && open_git_blob_reader(&blob_reader) != 0) {
+                perror("Error starting git cat-file");
                 goto cleanup;
             }
-            names = new_names;
-            name_capacity = new_capacity;
+            candidate->blob_oid = selected_paths[i].blob_oid;
+            candidate->blob_mode = selected_paths[i].blob_mode;
+            candidate->blob_reader = blob_reader;
         }
+    }
 
-        names[name_count] = strdup(entry->d_name);
-        if (!names[name_count]) {
-            perror("Error duplicating directory entry name");
-            status = -1;
-            goto cleanup;
+    if (ingest_queue_into_plan(&queue, ctx, plan) != 0) {
+        goto cleanup;
+    }
+    if (plan->count > 1) {
+        qsort(plan->entries, plan->count, sizeof(*plan->entries), compare_export_entries);
+    }
+    status = 0;
+
+cleanup:
+    if (close_git_blob_reader(blob_reader) != 0 && status == 0) {
+        perror("Error stopping git cat-file");
+        status = -1;
+    }
+    free_ingest_queue(&queue);
+    return status;
+}
+
+/*
+ * Candidates live in fixed-size chunks so workers can keep pointers to them
+ * while the listener goes on appending. The backlog bounds how far the git
+ * listing may run ahead of the workers.
+ */
+#define INGEST_STREAM_CHUNK 256
+#define INGEST_STREAM_BACKLOG 1024
+
+struct IngestStream {
+    const AppContext* ctx;
+    IngestCandidate** chunks;
+    size_t chunk_count;
+    size_t chunk_capacity;
+    size_t count;    // Candidates pushed by the listener.
+    size_t claimed;  // Candidates taken by a worker.
+    int closed;      // No more candidates will be pushed.
+    GitBlobReader* blob_reader;
+    pthread_t* threads;
+    size_t thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t space_ready;
+};
+
+static IngestCandidate* ingest_stream_candidate(const IngestStream* stream, size_t index) {
+    return &stream->chunks[index / INGEST_STREAM_CHUNK][index % INGEST_STREAM_CHUNK];
+}
+
+static void* ingest_stream_worker(void* arg) {
+    IngestStream* stream = arg;
+
+    pthread_mutex_lock(&stream->lock);
+    while (1) {
+        IngestCandidate* candidate;
+
+        while (stream->claimed == stream->count && !stream->closed) {
+            pthread_cond_wait(&stream->work_ready, &stream->lock);
+        }
+        if (stream->claimed == stream->count) {
+            break;
         }
-        name_count++;
+        candidate = ingest_stream_candidate(stream, stream->claimed++);
+        pthread_cond_signal(&stream->space_ready);
+        pthread_mutex_unlock(&stream->lock);
+
+        ingest_candidate(candidate, stream->ctx);
+
+        pthread_mutex_lock(&stream->lock);
     }
-    if (status != 0) {
-        goto cleanup;
+    pthread_mutex_unlock(&stream->lock);
+    return NULL;
+}
+
+int open_ingest_stream(const AppContext* ctx, IngestStream** stream_out) {
+    IngestStream* stream;
+    size_t workers;
+
+    if (!ctx || !stream_out) {
+        errno = EINVAL;
+        return -1;
     }
+    *stream_out = NULL;
 
-    if (name_count > 1) {
-        qsort(names, name_count, sizeof(char*), compare_names);
+    stream = calloc(1, sizeof(*stream));
+    if (!stream) {
+        return -1;
+    }
+    stream->ctx = ctx;
+    if (pthread_mutex_init(&stream->lock, NULL) != 0) {
+        free(stream);
+        return -1;
+    }
+    if (pthread_cond_init(&stream->work_ready, NULL) != 0) {
+        pthread_mutex_destroy(&stream->lock);
+        free(stream);
+        return -1;
+    }
+    if (pthread_cond_init(&stream->space_ready, NULL) != 0) {
+        pthread_cond_destroy(&stream->work_ready);
+        pthread_mutex_destroy(&stream->lock);
+        free(stream);
+        return -1;
     }
 
-    for (size_t i = 0; i < name_count; i++) {
-        const char* name = names[i];
-        size_t base_len = strlen(base_path);
-        int use_direct_concat = (base_len > 0 && base_path[base_len - 1] == '/');
-        int path_len = snprintf(path,
-                                sizeof(path),
-                                use_direct_concat ? "%s%s" : "%s/%s",
-                                base_path,
-                                name);
-        if (path_len < 0 || (size_t)path_len >= sizeof(path)) {
-            if (ctx->verbose) {
-                fprintf(stderr, "Skipping path that exceeds %zu bytes: %s/%s\n",
-                        (size_t)MAX_PATH_LENGTH, base_path, name);
+    /* The listing thread only parses git output, so every job gets a worker. */
+    workers = resolve_worker_count(ctx->jobs, SIZE_MAX);
+    if (workers > 1) {
+        stream->threads = malloc(workers * sizeof(*stream->threads));
+    }
+    if (stream->threads) {
+        for (size_t i = 0; i < workers; i++) {
+            if (pthread_create(&stream->threads[i], NULL, ingest_stream_worker, stream) != 0) {
+                break;
             }
-            continue;
+            stream->thread_count++;
         }
+    }
+    /* With no workers the listener ingests each path itself, serially. */
 
-        struct stat st;
-        if (lstat(path, &st) == -1) {
-            perror("Error getting file status");
-            continue;
+    *stream_out = stream;
+    return 0;
+}
+
+static int grow_ingest_stream(IngestStream* stream) {
+    IngestCandidate* chunk;
+
+    if (stream->chunk_count == stream->chunk_capacity) {
+        size_t new_capacity = (stream->chunk_capacity == 0) ? 16 : stream->chunk_capacity * 2;
+        IngestCandidate** new_chunks = realloc(stream->chunks, new_capacity * sizeof(*new_chunks));
+        if (!new_chunks) {
+            return -1;
         }
-        if (S_ISLNK(st.st_mode)) {
-            ctx->skipped_symlink++;
-            if (ctx->verbose) {
-                fprintf(stderr, "Skipping symlink: %s\n", path);
-            }
-            continue;
+        stream->chunks = new_chunks;
+        stream->chunk_capacity = new_capacity;
+    }
+    chunk = malloc(INGEST_STREAM_CHUNK * sizeof(*chunk));
+    if (!chunk) {
+        return -1;
+    }
+    stream->chunks[stream->chunk_count++] = chunk;
+    return 0;
+}
+
+int ingest_selected_path(void* state, const SelectedPath* path) {
+    IngestStream* stream = state;
+    IngestCandidate* candidate;
+    size_t open_len = strlen(path->open_path);
+    size_t display_len = strlen(path->display_path);
+    size_t oid_len = path->blob_oid ? strlen(path->blob_oid) : 0;
+    char* owned;
+
+    /* The listing is sorted and deduplicated later, freeing these strings; keep copies. */
+    owned = malloc(open_len + display_len + oid_len + 3);
+    if (!owned) {
+        perror("Error queueing selected file");
+        return -1;
+    }
+    memcpy(owned, path->open_path, open_len + 1);
+    memcpy(owned + open_len + 1, path->display_path, display_len + 1);
+    if (path->blob_oid) {
+        memcpy(owned + open_len + display_len + 2, path->blob_oid, oid_len + 1);
+        if (!stream->blob_reader && open_git_blob_reader(&stream->blob_reader) != 0) {
+            perror("Error starting git cat-file");
+            free(owned);
+            return -1;
         }
+    }
 
-        if (S_ISDIR(st.st_mode)) {
-            int dir_is_ignored = resolve_ignore_state(path,
-                                                      ctx->ignore_patterns,
-                                                      ctx->ignore_count,
-                                                      1,
-                                                      ancestor_ignored);
-            if (dir_is_ignored) {
-                if (!ignored_directory_may_have_included_descendants(path,
-                                                                     ctx->ignore_patterns,
-                                                                     ctx->ignore_count)) {
-                    ctx->skipped_ignored++;
-                    if (ctx->verbose) {
-                        fprintf(stderr, "Skipping ignored directory: %s\n", path);
-                    }
-                    continue;
-                }
-            }
-            if (collect_recursive_paths(path, ctx, dir_is_ignored, plan) != 0) {
-                status = -1;
-                goto cleanup;
-            }
-        } else if (S_ISREG(st.st_mode)) {
-            if (collect_exportable_file(path, path, &st, ctx, ancestor_ignored, 1, plan) != 0) {
-                status = -1;
-                goto cleanup;
-            }
+    pthread_mutex_lock(&stream->lock);
+    while (stream->thread_count > 0 && stream->count - stream->claimed >= INGEST_STREAM_BACKLOG) {
+        pthread_cond_wait(&stream->space_ready, &stream->lock);
+    }
+    if (stream->count == stream->chunk_count * INGEST_STREAM_CHUNK && grow_ingest_stream(stream) != 0) {
+        pthread_mutex_unlock(&stream->lock);
+        perror("Error growing ingestion queue");
+        free(owned);
+        return -1;
+    }
+    candidate = ingest_stream_candidate(stream, stream->count);
+    memset(candidate, 0, sizeof(*candidate));
+    candidate->owned_path = owned;
+    candidate->open_path = owned;
+    candidate->open_name = owned;
+    candidate->display_path = owned + open_len + 1;
+    candidate->dir_fd = AT_FDCWD;
+    candidate->open_first = path->index_regular_file;
+    if (path->blob_oid) {
+        candidate->blob_oid = owned + open_len + display_len + 2;
+        candidate->blob_mode = path->blob_mode;
+        candidate->blob_reader = stream->blob_reader;
+    }
+    stream->count++;
+    if (stream->thread_count == 0) {
+        stream->claimed = stream->count;
+    }
+    pthread_cond_signal(&stream->work_ready);
+    pthread_mutex_unlock(&stream->lock);
+
+    if (stream->thread_count == 0) {
+        ingest_candidate(candidate, stream->ctx);
+    }
+    return 0;
+}
+
+/* Lets the workers drain the backlog and waits for them to exit. */
+static void stop_ingest_stream(IngestStream* stream) {
+    pthread_mutex_lock(&stream->lock);
+    stream->closed = 1;
+    pthread_cond_broadcast(&stream->work_ready);
+    pthread_mutex_unlock(&stream->lock);
+
+    for (size_t i = 0; i < stream->thread_count; i++) {
+        pthread_join(stream->threads[i], NULL);
+    }
+    stream->thread_count = 0;
+}
+
+static int compare_ingest_candidates(const void* lhs, const void* rhs) {
+    const IngestCandidate* left = *(const IngestCandidate* const*)lhs;
+    const IngestCandidate* right = *(const IngestCandidate* const*)rhs;
+    int display_cmp = strcmp(left->display_path, right->display_path);
+
+    if (display_cmp != 0) {
+        return display_cmp;
+    }
+    return strcmp(left->open_path, right->open_path);
+}
+
+int finish_ingest_stream(IngestStream* stream, AppContext* ctx, ExportPlan* plan) {
+    IngestCandidate** order = NULL;
+    const IngestCandidate* previous = NULL;
+    int status = -1;
+
+    if (!stream || !ctx || !plan) {
+        errno = EINVAL;
+        return -1;
+    }
+    stop_ingest_stream(stream);
+
+    /* Commit in the sorted, deduplicated order a finished listing would have had. */
+    if (stream->count > 0) {
+        order = malloc(stream->count * sizeof(*order));
+        if (!order) {
+            perror("Error ordering ingested files");
+            goto cleanup;
+        }
+        for (size_t i = 0; i < stream->count; i++) {
+            order[i] = ingest_stream_candidate(stream, i);
+        }
+        qsort(order, stream->count, sizeof(*order), compare_ingest_candidates);
+    }
+    for (size_t i = 0; i < stream->count; i++) {
+        if (previous && compare_ingest_candidates(&previous, &order[i]) == 0) {
+            continue;
+        }
+        if (commit_ingest_candidate(order[i], ctx, plan) != 0) {
+            goto cleanup;
         }
+        previous = order[i];
+    }
+    if (plan->count > 1) {
+        qsort(plan->entries, plan->count, sizeof(*plan->entries), compare_export_entries);
     }
+    status = 0;
 
 cleanup:
-    if (dir && closedir(dir) != 0 && status == 0) {
-        perror("Error closing directory");
+    free(order);
+    if (close_git_blob_reader(stream->blob_reader) != 0 && status == 0) {
+        perror("Error stopping git cat-file");
         status = -1;
     }
-    free_names(names, name_count);
+    stream->blob_reader = NULL;
     return status;
 }
 
-int collect_recursive_export_plan(AppContext* ctx, ExportPlan* plan) {
-    if (collect_recursive_paths(".", ctx, 0, plan) != 0) {
+void close_ingest_stream(IngestStream* stream) {
+    if (!stream) return;
+    stop_ingest_stream(stream);
+    for (size_t i = 0; i < stream->count; i++) {
+        release_ingest_candidate(ingest_stream_candidate(stream, i));
+    }
+    for (size_t i = 0; i < stream->chunk_count; i++) {
+        free(stream->chunks[i]);
+    }
+    close_git_blob_reader(stream->blob_reader);
+    pthread_cond_destroy(&stream->space_ready);
+    pthread_cond_destroy(&stream->work_ready);
+    pthread_mutex_destroy(&stream->lock);
+    free(stream->chunks);
+    free(stream->threads);
+    free(stream);
+}
+
+static int read_export_entry_body(const ExportEntry* entry, int verify_stamp, ExportEntry* loaded) {
+    size_t bytes_read = 0;
+    const char* error_label = NULL;
+    TextScan scan;
+    int read_result;
+
+    if (!entry || !loaded) {
+        errno = EINVAL;
         return -1;
     }
-    if (plan->count > 1) {
-        qsort(plan->entries, plan->count, sizeof(*plan->entries), compare_export_entries);
+
+    *loaded = *entry;
+    loaded->buf = NULL;
+    read_result = read_file_buffer(AT_FDCWD,
+                                   entry->open_path,
+                                   &entry->st,
+                                   entry->buf_len,
+                                   0,
+                                   verify_stamp,
+                                   &loaded->buf,
+                                   &bytes_read,
+                                   &loaded->buf_mapped,
+                                   &error_label);
+    if (read_result == READ_FILE_ERROR) {
+        if (error_label) {
+            perror(error_label);
+        }
+        return -1;
+    }
+    if (read_result == READ_FILE_OK && fuori_scan_text(loaded->buf, bytes_read, 0, &scan) != 0) {
+        perror("Error scanning file");
+        release_file_buffer(loaded->buf, bytes_read, loaded->buf_mapped);
+        loaded->buf = NULL;
+        return -1;
+    }
+    if (read_result != READ_FILE_OK ||
+        bytes_read != entry->buf_len ||
+        fuori_text_scan_is_binary(&scan, bytes_read) ||
+        scan.line_count != entry->line_count ||
+        scan.max_backtick_run != entry->max_backtick_run ||
+        (loaded->buf[bytes_read - 1] == '\n') != entry->ends_with_newline ||
+        (entry->sensitive_checked && fuori_contains_sensitive_content(loaded->buf, bytes_read))) {
+        if (read_result == READ_FILE_OK) {
+            fuori_free_text_scan(&scan);
+        }
+        release_file_buffer(loaded->buf, bytes_read, loaded->buf_mapped);
+        loaded->buf = NULL;
+        fprintf(stderr, "Error: File changed after it was collected %s\n", entry->display_path);
+        errno = ESTALE;
+        return -1;
     }
+
+    fuori_free_text_scan(&scan);
     return 0;
 }
 
-int collect_selected_export_plan(const SelectedPath* selected_paths,
-                                 size_t selected_count,
-                                 AppContext* ctx,
-                                 ExportPlan* plan) {
-    for (size_t i = 0; i < selected_count; i++) {
-        const SelectedPath* path = &selected_paths[i];
-        struct stat st;
+int load_export_entry_body(const ExportEntry* entry, ExportEntry* loaded) {
+    return read_export_entry_body(entry, 1, loaded);
+}
 
-        if (lstat(path->open_path, &st) == -1) {
-            if (errno == ENOENT) {
-                continue;
-            }
-            perror("Error getting selected file status");
-            continue;
+int reload_export_entry_body(const ExportEntry* entry, ExportEntry* loaded) {
+    return read_export_entry_body(entry, 0, loaded);
+}
+
+void release_export_entry_body(ExportEntry* loaded) {
+    if (!loaded) return;
+    release_file_buffer(loaded->buf, loaded->buf_len, loaded->buf_mapped);
+    loaded->buf = NULL;
+}
+
+/* Returns 1 when the open file still has the identity and stamp that were collected. */
+static int export_entry_file_matches(const ExportEntry* entry, const struct stat* opened_st) {
+    return S_ISREG(opened_st->st_mode) &&
+           opened_st->st_dev == entry->st.st_dev &&
+           opened_st->st_ino == entry->st.st_ino &&
+           file_stamp_matches(opened_st, &entry->st) &&
+           (uintmax_t)opened_st->st_size == (uintmax_t)entry->buf_len;
+}
+
+int export_entry_mapping_current(const ExportEntry* entry) {
+    struct stat opened_st;
+    int fd = open_file_nofollow(AT_FDCWD, entry->open_path);
+    int current;
+
+    if (fd == -1) {
+        return 0;
+    }
+    current = fstat(fd, &opened_st) == 0 && export_entry_file_matches(entry, &opened_st);
+    close(fd);
+    return current;
+}
+
+int open_export_entry_body(const ExportEntry* entry, int* fd_out) {
+    struct stat opened_st;
+    int fd;
+
+    if (!entry || !fd_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *fd_out = -1;
+
+    fd = open_file_nofollow(AT_FDCWD, entry->open_path);
+    if (fd == -1) {
+        perror("Error opening file");
+        return -1;
+    }
+    if (fstat(fd, &opened_st) == -1) {
+        perror("Error stating opened file");
+        close(fd);
+        return -1;
+    }
+    if (!export_entry_file_matches(entry, &opened_st)) {
+        close(fd);
+        fprintf(stderr, "Error: File changed after it was collected %s\n", entry->display_path);
+        errno = ESTALE;
+        return -1;
+    }
+    *fd_out = fd;
+    return 0;
+}
+
+int verify_export_entry_body(const ExportEntry* entry, int fd) {
+    struct stat opened_st;
+
+    if (!entry || fd < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (fstat(fd, &opened_st) == -1) {
+        perror("Error stating opened file");
+        return -1;
+    }
+    if (!export_entry_file_matches(entry, &opened_st)) {
+        fprintf(stderr, "Error: File changed after it was collected %s\n", entry->display_path);
+        errno = ESTALE;
+        return -1;
+    }
+    return 0;
+}
+
+/* Loads the baseline copy of display_path; *missing_out is set when there is none. */
+static int read_baseline_file(const char* baseline_dir,
+                              const char* display_path,
+                              unsigned char** buffer_out,
+                              size_t* bytes_read_out,
+                              int* missing_out) {
+    char* baseline_path = NULL;
+    const char* error_label = NULL;
+    struct stat st;
+    size_t dir_len = strlen(baseline_dir);
+    int mapped = 0;
+    int read_result;
+
+    *missing_out = 0;
+    while (*display_path == '/') {
+        display_path++;
+    }
+    baseline_path = malloc(dir_len + strlen(display_path) + 2);
+    if (!baseline_path) {
+        perror("Error building baseline path");
+        return -1;
+    }
+    memcpy(baseline_path, baseline_dir, dir_len);
+    baseline_path[dir_len] = '/';
+    strcpy(baseline_path + dir_len + 1, display_path);
+
+    if (lstat(baseline_path, &st) == -1) {
+        if (errno != ENOENT && errno != ENOTDIR) {
+            fprintf(stderr, "Error reading baseline file %s: %s\n", baseline_path, strerror(errno));
+            free(baseline_path);
+            return -1;
         }
-        if (S_ISLNK(st.st_mode)) {
-            ctx->skipped_symlink++;
-            if (ctx->verbose) {
-                fprintf(stderr, "Skipping symlink: %s\n", path->display_path);
+        *missing_out = 1;
+    } else if (!S_ISREG(st.st_mode)) {
+        *missing_out = 1;
+    }
+    if (*missing_out) {
+        free(baseline_path);
+        return 0;
+    }
+
+    read_result = read_file_buffer(AT_FDCWD, baseline_path, &st, SIZE_MAX, 0, 0,
+                                   buffer_out, bytes_read_out, &mapped, &error_label);
+    if (read_result != READ_FILE_OK) {
+        fprintf(stderr, "Error reading baseline file %s: %s\n",
+                baseline_path, error_label ? error_label : "file changed while reading");
+        free(baseline_path);
+        return -1;
+    }
+    free(baseline_path);
+    return 0;
+}
+
+int collect_export_hunks(const ExportPlan* plan,
+                         const SelectedPath* selected_paths,
+                         const char* baseline_dir,
+                         GitFileHunks** hunks_out) {
+    GitBlobReader* blob_reader = NULL;
+    GitFileHunks* hunks = NULL;
+    int status = -1;
+
+    if (!plan || !hunks_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *hunks_out = NULL;
+    if (plan->count == 0) {
+        return 0;
+    }
+
+    hunks = calloc(plan->count, sizeof(*hunks));
+    if (!hunks) {
+        perror("Error allocating hunk list");
+        return -1;
+    }
+
+    for (size_t i = 0; i < plan->count; i++) {
+        const ExportEntry* entry = &plan->entries[i];
+        const char* base_oid = selected_paths ? selected_paths[i].base_oid : NULL;
+        unsigned char* old_buf = NULL;
+        size_t old_len = 0;
+        ExportEntry loaded;
+        const ExportEntry* current = entry;
+        int diff_status;
+
+        if (base_oid) {
+            int blob_result;
+
+            if (!blob_reader && open_git_blob_reader(&blob_reader) != 0) {
+                perror("Error starting git cat-file");
+                goto cleanup;
             }
-            continue;
+            blob_result = read_git_blob(blob_reader, base_oid, SIZE_MAX, &old_buf, &old_len);
+            if (blob_result < 0) {
+                fprintf(stderr, "Error reading base blob %s for %s: %s\n",
+                        base_oid, entry->display_path, strerror(errno));
+                goto cleanup;
+            }
+            hunks[i].whole_file = (blob_result == 1);
+        } else if (baseline_dir) {
+            if (read_baseline_file(baseline_dir, entry->display_path, &old_buf, &old_len, &hunks[i].whole_file) != 0) {
+                goto cleanup;
+            }
+        } else {
+            hunks[i].whole_file = 1;
         }
-        if (!S_ISREG(st.st_mode)) {
+        if (hunks[i].whole_file) {
             continue;
         }
 
-        if (collect_exportable_file(path->open_path, path->display_path, &st, ctx, 0, 0, plan) != 0) {
-            return -1;
+        /* Streamed entries are reloaded one at a time, as the renderer does. */
+        if (!entry->buf && entry->buf_len > 0) {
+            if (load_export_entry_body(entry, &loaded) != 0) {
+                free(old_buf);
+                goto cleanup;
+            }
+            current = &loaded;
+        }
+        diff_status = compute_line_hunks(old_buf, old_len, current->buf, current->buf_len, &hunks[i]);
+        if (current == &loaded) {
+            release_export_entry_body(&loaded);
+        }
+        free(old_buf);
+        if (diff_status != 0) {
+            perror("Error computing line diff");
+            goto cleanup;
         }
     }
 
-    if (plan->count > 1) {
-        qsort(plan->entries, plan->count, sizeof(*plan->entries), compare_export_entries);
+    *hunks_out = hunks;
+    hunks = NULL;
+    status = 0;
+
+cleanup:
+    if (close_git_blob_reader(blob_reader) != 0 && status == 0) {
+        perror("Error stopping git cat-file");
+        status = -1;
     }
-    return 0;
+    if (status != 0 && *hunks_out) {
+        hunks = *hunks_out;
+        *hunks_out = NULL;
+    }
+    free_git_hunks(hunks, plan->count);
+    return status;
 }
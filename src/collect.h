@@ -6,6 +6,7 @@
 
 #include "app.h"
 #include "git_paths.h"
+#include "line_diff.h"
 
 typedef struct {
     char* open_path;
@@ -13,7 +14,13 @@ typedef struct {
     struct stat st;
     unsigned char* buf;
     size_t buf_len;
+    int buf_mapped;    // buf is a read-only file mapping (--mmap), released with munmap.
     const char* lang;  // Points to a static literal; not heap-owned.
+    size_t line_count;        // Newline-terminated lines plus any unterminated tail.
+    size_t max_backtick_run;  // Longest run of '`', used to pick a safe fence.
+    int ends_with_newline;    // Last byte is '\n'; render terminates the tail otherwise.
+    int stamp_settled;        // mtime and ctime predate collection, so the stamp alone vouches for the body.
+    int sensitive_checked;    // Passed the sensitive-content scan; a reloaded body must pass it again.
 } ExportEntry;
 
 typedef struct {
@@ -22,6 +29,9 @@ typedef struct {
     size_t capacity;
 } ExportPlan;
 
+/* Resolves a requested job count (0 = online CPUs) against the available work. */
+size_t resolve_worker_count(size_t requested, size_t work_items);
+
 int collect_recursive_export_plan(AppContext* ctx, ExportPlan* plan);
 int collect_selected_export_plan(const SelectedPath* selected_paths,
                                  size_t selected_count,
@@ -29,4 +39,61 @@ int collect_selected_export_plan(const SelectedPath* selected_paths,
                                  ExportPlan* plan);
 void free_export_plan(ExportPlan* plan);
 
+/*
+ * Pipelined counterpart of collect_selected_export_plan() for Git listings:
+ * ingest_selected_path() is a SelectedPathListener callback that queues each
+ * path for the read-and-classify workers while git is still running, and
+ * finish_ingest_stream() waits for them and builds the plan in sorted order.
+ * ctx must stay valid, and its output-file identity set, until the stream is closed.
+ */
+typedef struct IngestStream IngestStream;
+
+int open_ingest_stream(const AppContext* ctx, IngestStream** stream_out);
+int ingest_selected_path(void* state, const SelectedPath* path);
+int finish_ingest_stream(IngestStream* stream, AppContext* ctx, ExportPlan* plan);
+void close_ingest_stream(IngestStream* stream);
+
+/*
+ * With --stream, accepted entries keep buf == NULL and only their identity,
+ * size, and classification. load_export_entry_body() fills *loaded with a copy
+ * of the entry carrying a freshly read body for rendering, and fails with
+ * ESTALE if the file no longer matches what was collected (dev, ino, size,
+ * mtime and ctime to the nanosecond, measured line/fence stats, and, for
+ * sensitive_checked entries, the sensitive-content scan).
+ */
+int load_export_entry_body(const ExportEntry* entry, ExportEntry* loaded);
+void release_export_entry_body(ExportEntry* loaded);
+
+/*
+ * With --mmap, a mapped body follows later writes to its file.
+ * export_entry_mapping_current() returns 1 while the file still has the
+ * collected identity and stamp (to the nanosecond); otherwise the body is
+ * re-read with reload_export_entry_body(), which is load_export_entry_body()
+ * without the stamp check: the fresh body must still pass every content check.
+ */
+int export_entry_mapping_current(const ExportEntry* entry);
+int reload_export_entry_body(const ExportEntry* entry, ExportEntry* loaded);
+
+/*
+ * For copying a streamed body without loading it: opens the entry's file and
+ * fails with ESTALE unless its dev, ino, size, mtime, and ctime (to the
+ * nanosecond) still match what was collected. verify_export_entry_body()
+ * repeats the check once the body has been copied. The contents are not
+ * re-scanned, so callers only copy stamp_settled entries, whose stamp cannot
+ * hide a later rewrite.
+ */
+int open_export_entry_body(const ExportEntry* entry, int* fd_out);
+int verify_export_entry_body(const ExportEntry* entry, int fd);
+
+/*
+ * Computes changed line ranges for every plan entry, parallel to
+ * selected_paths (which may be NULL). The base version is the selected
+ * path's base_oid blob, else the same display path under baseline_dir;
+ * entries with neither are marked whole_file.
+ */
+int collect_export_hunks(const ExportPlan* plan,
+                         const SelectedPath* selected_paths,
+                         const char* baseline_dir,
+                         GitFileHunks** hunks_out);
+
 #endif
@@ -0,0 +1,616 @@
+#ifndef GENERATED_UNPACKER_H
+#define GENERATED_UNPACKER_H
+
+#include <stddef.h>
+
+static const unsigned char FUORI_UNPACKER_SCRIPT[] = {
+    0x23, 0x21, 0x2F, 0x75, 0x73, 0x72, 0x2F, 0x62, 0x69, 0x6E, 0x2F, 0x65,
+    0x6E, 0x76, 0x20, 0x70, 0x79, 0x74, 0x68, 0x6F, 0x6E, 0x33, 0x0A, 0x0A,
+    0x66, 0x72, 0x6F, 0x6D, 0x20, 0x5F, 0x5F, 0x66, 0x75, 0x74, 0x75, 0x72,
+    0x65, 0x5F, 0x5F, 0x20, 0x69, 0x6D, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x61,
+    0x6E, 0x6E, 0x6F, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x73, 0x0A, 0x0A,
+    0x69, 0x6D, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x61, 0x72, 0x67, 0x70, 0x61,
+    0x72, 0x73, 0x65, 0x0A, 0x69, 0x6D, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x68,
+    0x74, 0x6D, 0x6C, 0x0A, 0x69, 0x6D, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x72,
+    0x65, 0x0A, 0x69, 0x6D, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x73, 0x79, 0x73,
+    0x0A, 0x66, 0x72, 0x6F, 0x6D, 0x20, 0x70, 0x61, 0x74, 0x68, 0x6C, 0x69,
+    0x62, 0x20, 0x69, 0x6D, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x50, 0x61, 0x74,
+    0x68, 0x0A, 0x0A, 0x0A, 0x4C, 0x49, 0x4E, 0x45, 0x5F, 0x4E, 0x55, 0x4D,
+    0x42, 0x45, 0x52, 0x5F, 0x52, 0x45, 0x20, 0x3D, 0x20, 0x72, 0x65, 0x2E,
+    0x63, 0x6F, 0x6D, 0x70, 0x69, 0x6C, 0x65, 0x28, 0x72, 0x22, 0x5E, 0x5C,
+    0x73, 0x2A, 0x5C, 0x64, 0x2B, 0x20, 0x5C, 0x7C, 0x20, 0x3F, 0x28, 0x2E,
+    0x2A, 0x29, 0x24, 0x22, 0x29, 0x0A, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F,
+    0x42, 0x45, 0x47, 0x49, 0x4E, 0x5F, 0x4D, 0x41, 0x52, 0x4B, 0x45, 0x52,
+    0x20, 0x3D, 0x20, 0x22, 0x3C, 0x21, 0x2D, 0x2D, 0x20, 0x46, 0x55, 0x4F,
+    0x52, 0x49, 0x5F, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F, 0x42, 0x45, 0x47,
+    0x49, 0x4E, 0x20, 0x2D, 0x2D, 0x3E, 0x22, 0x0A, 0x46, 0x49, 0x4C, 0x45,
+    0x53, 0x5F, 0x45, 0x4E, 0x44, 0x5F, 0x4D, 0x41, 0x52, 0x4B, 0x45, 0x52,
+    0x20, 0x3D, 0x20, 0x22, 0x3C, 0x21, 0x2D, 0x2D, 0x20, 0x46, 0x55, 0x4F,
+    0x52, 0x49, 0x5F, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F, 0x45, 0x4E, 0x44,
+    0x20, 0x2D, 0x2D, 0x3E, 0x22, 0x0A, 0x0A, 0x0A, 0x63, 0x6C, 0x61, 0x73,
+    0x73, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72, 0x73,
+    0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28, 0x45, 0x78, 0x63, 0x65, 0x70,
+    0x74, 0x69, 0x6F, 0x6E, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x70,
+    0x61, 0x73, 0x73, 0x0A, 0x0A, 0x0A, 0x64, 0x65, 0x66, 0x20, 0x64, 0x65,
+    0x63, 0x6F, 0x64, 0x65, 0x5F, 0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67,
+    0x5F, 0x70, 0x61, 0x74, 0x68, 0x28, 0x74, 0x65, 0x78, 0x74, 0x3A, 0x20,
+    0x73, 0x74, 0x72, 0x29, 0x20, 0x2D, 0x3E, 0x20, 0x73, 0x74, 0x72, 0x3A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x74, 0x65, 0x78, 0x74, 0x20, 0x3D, 0x20,
+    0x68, 0x74, 0x6D, 0x6C, 0x2E, 0x75, 0x6E, 0x65, 0x73, 0x63, 0x61, 0x70,
+    0x65, 0x28, 0x74, 0x65, 0x78, 0x74, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x3A, 0x20, 0x6C, 0x69, 0x73, 0x74,
+    0x5B, 0x73, 0x74, 0x72, 0x5D, 0x20, 0x3D, 0x20, 0x5B, 0x5D, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x69, 0x20, 0x3D, 0x20, 0x30, 0x0A, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x77, 0x68, 0x69, 0x6C, 0x65, 0x20, 0x69, 0x20, 0x3C, 0x20,
+    0x6C, 0x65, 0x6E, 0x28, 0x74, 0x65, 0x78, 0x74, 0x29, 0x3A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x74, 0x65,
+    0x78, 0x74, 0x5B, 0x69, 0x5D, 0x20, 0x21, 0x3D, 0x20, 0x22, 0x5C, 0x5C,
+    0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E, 0x61, 0x70,
+    0x70, 0x65, 0x6E, 0x64, 0x28, 0x74, 0x65, 0x78, 0x74, 0x5B, 0x69, 0x5D,
+    0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6E,
+    0x74, 0x69, 0x6E, 0x75, 0x65, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x69, 0x20, 0x2B, 0x20, 0x31, 0x20,
+    0x3E, 0x3D, 0x20, 0x6C, 0x65, 0x6E, 0x28, 0x74, 0x65, 0x78, 0x74, 0x29,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E, 0x61, 0x70, 0x70,
+    0x65, 0x6E, 0x64, 0x28, 0x22, 0x5C, 0x5C, 0x22, 0x29, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x72,
+    0x65, 0x61, 0x6B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x6E, 0x65, 0x78, 0x74, 0x5F, 0x63, 0x68, 0x61, 0x72, 0x20, 0x3D,
+    0x20, 0x74, 0x65, 0x78, 0x74, 0x5B, 0x69, 0x20, 0x2B, 0x20, 0x31, 0x5D,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20,
+    0x6E, 0x65, 0x78, 0x74, 0x5F, 0x63, 0x68, 0x61, 0x72, 0x20, 0x3D, 0x3D,
+    0x20, 0x22, 0x6E, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74,
+    0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x22, 0x5C, 0x6E, 0x22,
+    0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x32, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x65, 0x6C, 0x69, 0x66, 0x20, 0x6E, 0x65,
+    0x78, 0x74, 0x5F, 0x63, 0x68, 0x61, 0x72, 0x20, 0x3D, 0x3D, 0x20, 0x22,
+    0x72, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E, 0x61,
+    0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x22, 0x5C, 0x72, 0x22, 0x29, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x20, 0x2B, 0x3D, 0x20, 0x32, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x65, 0x6C, 0x69, 0x66, 0x20, 0x6E, 0x65, 0x78, 0x74,
+    0x5F, 0x63, 0x68, 0x61, 0x72, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x74, 0x22,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E, 0x61, 0x70, 0x70,
+    0x65, 0x6E, 0x64, 0x28, 0x22, 0x5C, 0x74, 0x22, 0x29, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20,
+    0x2B, 0x3D, 0x20, 0x32, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x65, 0x6C, 0x69, 0x66, 0x20, 0x6E, 0x65, 0x78, 0x74, 0x5F, 0x63,
+    0x68, 0x61, 0x72, 0x20, 0x69, 0x6E, 0x20, 0x28, 0x22, 0x5C, 0x5C, 0x22,
+    0x2C, 0x20, 0x22, 0x60, 0x22, 0x2C, 0x20, 0x22, 0x2A, 0x22, 0x2C, 0x20,
+    0x22, 0x5B, 0x22, 0x2C, 0x20, 0x22, 0x5D, 0x22, 0x29, 0x3A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72,
+    0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64,
+    0x28, 0x6E, 0x65, 0x78, 0x74, 0x5F, 0x63, 0x68, 0x61, 0x72, 0x29, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x20, 0x2B, 0x3D, 0x20, 0x32, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x65, 0x6C, 0x69, 0x66, 0x20, 0x6E, 0x65, 0x78, 0x74,
+    0x5F, 0x63, 0x68, 0x61, 0x72, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x78, 0x22,
+    0x20, 0x61, 0x6E, 0x64, 0x20, 0x69, 0x20, 0x2B, 0x20, 0x33, 0x20, 0x3C,
+    0x20, 0x6C, 0x65, 0x6E, 0x28, 0x74, 0x65, 0x78, 0x74, 0x29, 0x3A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x68, 0x65, 0x78, 0x5F, 0x76, 0x61, 0x6C, 0x75, 0x65, 0x20, 0x3D, 0x20,
+    0x74, 0x65, 0x78, 0x74, 0x5B, 0x69, 0x20, 0x2B, 0x20, 0x32, 0x20, 0x3A,
+    0x20, 0x69, 0x20, 0x2B, 0x20, 0x34, 0x5D, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x74, 0x72, 0x79, 0x3A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E,
+    0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x63, 0x68, 0x72, 0x28, 0x69,
+    0x6E, 0x74, 0x28, 0x68, 0x65, 0x78, 0x5F, 0x76, 0x61, 0x6C, 0x75, 0x65,
+    0x2C, 0x20, 0x31, 0x36, 0x29, 0x29, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x20, 0x2B, 0x3D, 0x20, 0x34, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x65, 0x78, 0x63, 0x65, 0x70,
+    0x74, 0x20, 0x56, 0x61, 0x6C, 0x75, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74,
+    0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x22, 0x5C, 0x5C, 0x22,
+    0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74,
+    0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x6E, 0x65, 0x78, 0x74,
+    0x5F, 0x63, 0x68, 0x61, 0x72, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69,
+    0x20, 0x2B, 0x3D, 0x20, 0x32, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x65, 0x6C, 0x73, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75,
+    0x6C, 0x74, 0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x22, 0x5C,
+    0x5C, 0x22, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6C, 0x74, 0x2E, 0x61,
+    0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x6E, 0x65, 0x78, 0x74, 0x5F, 0x63,
+    0x68, 0x61, 0x72, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x32, 0x0A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20,
+    0x22, 0x22, 0x2E, 0x6A, 0x6F, 0x69, 0x6E, 0x28, 0x72, 0x65, 0x73, 0x75,
+    0x6C, 0x74, 0x29, 0x0A, 0x0A, 0x0A, 0x64, 0x65, 0x66, 0x20, 0x70, 0x61,
+    0x72, 0x73, 0x65, 0x5F, 0x6F, 0x70, 0x65, 0x6E, 0x5F, 0x66, 0x65, 0x6E,
+    0x63, 0x65, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x3A, 0x20, 0x73, 0x74, 0x72,
+    0x29, 0x20, 0x2D, 0x3E, 0x20, 0x69, 0x6E, 0x74, 0x20, 0x7C, 0x20, 0x4E,
+    0x6F, 0x6E, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20,
+    0x6E, 0x6F, 0x74, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x2E, 0x73, 0x74, 0x61,
+    0x72, 0x74, 0x73, 0x77, 0x69, 0x74, 0x68, 0x28, 0x22, 0x60, 0x60, 0x60,
+    0x22, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x4E, 0x6F, 0x6E, 0x65, 0x0A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x20, 0x3D,
+    0x20, 0x30, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x77, 0x68, 0x69, 0x6C, 0x65,
+    0x20, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x20, 0x3C, 0x20, 0x6C, 0x65, 0x6E,
+    0x28, 0x6C, 0x69, 0x6E, 0x65, 0x29, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x6C,
+    0x69, 0x6E, 0x65, 0x5B, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x5D, 0x20, 0x3D,
+    0x3D, 0x20, 0x22, 0x60, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x20, 0x2B, 0x3D, 0x20,
+    0x31, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72,
+    0x6E, 0x20, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x20, 0x69, 0x66, 0x20, 0x63,
+    0x6F, 0x75, 0x6E, 0x74, 0x20, 0x3E, 0x3D, 0x20, 0x33, 0x20, 0x65, 0x6C,
+    0x73, 0x65, 0x20, 0x4E, 0x6F, 0x6E, 0x65, 0x0A, 0x0A, 0x0A, 0x64, 0x65,
+    0x66, 0x20, 0x70, 0x61, 0x72, 0x73, 0x65, 0x5F, 0x70, 0x72, 0x65, 0x61,
+    0x6D, 0x62, 0x6C, 0x65, 0x5F, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x28, 0x6C,
+    0x69, 0x6E, 0x65, 0x73, 0x3A, 0x20, 0x6C, 0x69, 0x73, 0x74, 0x5B, 0x73,
+    0x74, 0x72, 0x5D, 0x29, 0x20, 0x2D, 0x3E, 0x20, 0x74, 0x75, 0x70, 0x6C,
+    0x65, 0x5B, 0x62, 0x6F, 0x6F, 0x6C, 0x2C, 0x20, 0x62, 0x6F, 0x6F, 0x6C,
+    0x5D, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x5F,
+    0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x5F, 0x6F, 0x6E, 0x20, 0x3D,
+    0x20, 0x46, 0x61, 0x6C, 0x73, 0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x68,
+    0x75, 0x6E, 0x6B, 0x73, 0x5F, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x46, 0x61,
+    0x6C, 0x73, 0x65, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6F, 0x72,
+    0x20, 0x6C, 0x69, 0x6E, 0x65, 0x20, 0x69, 0x6E, 0x20, 0x6C, 0x69, 0x6E,
+    0x65, 0x73, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x20, 0x3D, 0x20, 0x6C, 0x69,
+    0x6E, 0x65, 0x2E, 0x72, 0x73, 0x74, 0x72, 0x69, 0x70, 0x28, 0x22, 0x5C,
+    0x6E, 0x22, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x66, 0x20, 0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x2E, 0x73,
+    0x74, 0x61, 0x72, 0x74, 0x73, 0x77, 0x69, 0x74, 0x68, 0x28, 0x22, 0x23,
+    0x23, 0x20, 0x22, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x72, 0x65, 0x61, 0x6B, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x68,
+    0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x4C,
+    0x69, 0x6E, 0x65, 0x20, 0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x3A,
+    0x20, 0x6F, 0x6E, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x5F, 0x6E,
+    0x75, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x5F, 0x6F, 0x6E, 0x20, 0x3D, 0x20,
+    0x54, 0x72, 0x75, 0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x65, 0x6C, 0x69, 0x66, 0x20, 0x68, 0x65, 0x61, 0x64, 0x69, 0x6E,
+    0x67, 0x2E, 0x73, 0x74, 0x61, 0x72, 0x74, 0x73, 0x77, 0x69, 0x74, 0x68,
+    0x28, 0x22, 0x48, 0x75, 0x6E, 0x6B, 0x73, 0x3A, 0x20, 0x6F, 0x6E, 0x22,
+    0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x68, 0x75, 0x6E, 0x6B, 0x73, 0x5F, 0x6F, 0x6E, 0x20,
+    0x3D, 0x20, 0x54, 0x72, 0x75, 0x65, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x5F,
+    0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x5F, 0x6F, 0x6E, 0x2C, 0x20,
+    0x68, 0x75, 0x6E, 0x6B, 0x73, 0x5F, 0x6F, 0x6E, 0x0A, 0x0A, 0x0A, 0x64,
+    0x65, 0x66, 0x20, 0x73, 0x74, 0x72, 0x69, 0x70, 0x5F, 0x6C, 0x69, 0x6E,
+    0x65, 0x5F, 0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x28, 0x6C, 0x69, 0x6E,
+    0x65, 0x3A, 0x20, 0x73, 0x74, 0x72, 0x29, 0x20, 0x2D, 0x3E, 0x20, 0x73,
+    0x74, 0x72, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6E, 0x65, 0x77, 0x6C,
+    0x69, 0x6E, 0x65, 0x20, 0x3D, 0x20, 0x22, 0x5C, 0x6E, 0x22, 0x20, 0x69,
+    0x66, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x2E, 0x65, 0x6E, 0x64, 0x73, 0x77,
+    0x69, 0x74, 0x68, 0x28, 0x22, 0x5C, 0x6E, 0x22, 0x29, 0x20, 0x65, 0x6C,
+    0x73, 0x65, 0x20, 0x22, 0x22, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F,
+    0x6E, 0x74, 0x65, 0x6E, 0x74, 0x20, 0x3D, 0x20, 0x6C, 0x69, 0x6E, 0x65,
+    0x5B, 0x3A, 0x2D, 0x31, 0x5D, 0x20, 0x69, 0x66, 0x20, 0x6E, 0x65, 0x77,
+    0x6C, 0x69, 0x6E, 0x65, 0x20, 0x65, 0x6C, 0x73, 0x65, 0x20, 0x6C, 0x69,
+    0x6E, 0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6D, 0x61, 0x74, 0x63, 0x68,
+    0x20, 0x3D, 0x20, 0x4C, 0x49, 0x4E, 0x45, 0x5F, 0x4E, 0x55, 0x4D, 0x42,
+    0x45, 0x52, 0x5F, 0x52, 0x45, 0x2E, 0x66, 0x75, 0x6C, 0x6C, 0x6D, 0x61,
+    0x74, 0x63, 0x68, 0x28, 0x63, 0x6F, 0x6E, 0x74, 0x65, 0x6E, 0x74, 0x29,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x6E, 0x6F, 0x74, 0x20,
+    0x6D, 0x61, 0x74, 0x63, 0x68, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x72, 0x61, 0x69, 0x73, 0x65, 0x20, 0x45, 0x78, 0x70,
+    0x6F, 0x72, 0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x45, 0x72, 0x72, 0x6F,
+    0x72, 0x28, 0x66, 0x22, 0x69, 0x6E, 0x76, 0x61, 0x6C, 0x69, 0x64, 0x20,
+    0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x65, 0x64, 0x20, 0x6C, 0x69, 0x6E,
+    0x65, 0x3A, 0x20, 0x7B, 0x63, 0x6F, 0x6E, 0x74, 0x65, 0x6E, 0x74, 0x21,
+    0x72, 0x7D, 0x22, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74,
+    0x75, 0x72, 0x6E, 0x20, 0x6D, 0x61, 0x74, 0x63, 0x68, 0x2E, 0x67, 0x72,
+    0x6F, 0x75, 0x70, 0x28, 0x31, 0x29, 0x20, 0x2B, 0x20, 0x6E, 0x65, 0x77,
+    0x6C, 0x69, 0x6E, 0x65, 0x0A, 0x0A, 0x0A, 0x64, 0x65, 0x66, 0x20, 0x6E,
+    0x65, 0x78, 0x74, 0x5F, 0x6E, 0x6F, 0x6E, 0x62, 0x6C, 0x61, 0x6E, 0x6B,
+    0x5F, 0x69, 0x6E, 0x64, 0x65, 0x78, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73,
+    0x3A, 0x20, 0x6C, 0x69, 0x73, 0x74, 0x5B, 0x73, 0x74, 0x72, 0x5D, 0x2C,
+    0x20, 0x73, 0x74, 0x61, 0x72, 0x74, 0x3A, 0x20, 0x69, 0x6E, 0x74, 0x29,
+    0x20, 0x2D, 0x3E, 0x20, 0x69, 0x6E, 0x74, 0x20, 0x7C, 0x20, 0x4E, 0x6F,
+    0x6E, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x3D, 0x20,
+    0x73, 0x74, 0x61, 0x72, 0x74, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x77, 0x68,
+    0x69, 0x6C, 0x65, 0x20, 0x69, 0x20, 0x3C, 0x20, 0x6C, 0x65, 0x6E, 0x28,
+    0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x6C,
+    0x69, 0x6E, 0x65, 0x73, 0x5B, 0x69, 0x5D, 0x2E, 0x73, 0x74, 0x72, 0x69,
+    0x70, 0x28, 0x29, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x22, 0x3A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20,
+    0x31, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E,
+    0x20, 0x69, 0x20, 0x69, 0x66, 0x20, 0x69, 0x20, 0x3C, 0x20, 0x6C, 0x65,
+    0x6E, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x20, 0x65, 0x6C, 0x73,
+    0x65, 0x20, 0x4E, 0x6F, 0x6E, 0x65, 0x0A, 0x0A, 0x0A, 0x64, 0x65, 0x66,
+    0x20, 0x72, 0x65, 0x61, 0x64, 0x5F, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74,
+    0x5F, 0x65, 0x6E, 0x74, 0x72, 0x69, 0x65, 0x73, 0x28, 0x65, 0x78, 0x70,
+    0x6F, 0x72, 0x74, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x3A, 0x20, 0x50, 0x61,
+    0x74, 0x68, 0x29, 0x20, 0x2D, 0x3E, 0x20, 0x74, 0x75, 0x70, 0x6C, 0x65,
+    0x5B, 0x6C, 0x69, 0x73, 0x74, 0x5B, 0x74, 0x75, 0x70, 0x6C, 0x65, 0x5B,
+    0x73, 0x74, 0x72, 0x2C, 0x20, 0x73, 0x74, 0x72, 0x5D, 0x5D, 0x2C, 0x20,
+    0x62, 0x6F, 0x6F, 0x6C, 0x5D, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x74,
+    0x65, 0x78, 0x74, 0x20, 0x3D, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74,
+    0x5F, 0x70, 0x61, 0x74, 0x68, 0x2E, 0x72, 0x65, 0x61, 0x64, 0x5F, 0x74,
+    0x65, 0x78, 0x74, 0x28, 0x65, 0x6E, 0x63, 0x6F, 0x64, 0x69, 0x6E, 0x67,
+    0x3D, 0x22, 0x75, 0x74, 0x66, 0x2D, 0x38, 0x22, 0x29, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x20, 0x3D, 0x20, 0x74, 0x65,
+    0x78, 0x74, 0x2E, 0x73, 0x70, 0x6C, 0x69, 0x74, 0x6C, 0x69, 0x6E, 0x65,
+    0x73, 0x28, 0x6B, 0x65, 0x65, 0x70, 0x65, 0x6E, 0x64, 0x73, 0x3D, 0x54,
+    0x72, 0x75, 0x65, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x6C, 0x69, 0x6E,
+    0x65, 0x5F, 0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x5F, 0x6F, 0x6E,
+    0x2C, 0x20, 0x68, 0x75, 0x6E, 0x6B, 0x73, 0x5F, 0x6F, 0x6E, 0x20, 0x3D,
+    0x20, 0x70, 0x61, 0x72, 0x73, 0x65, 0x5F, 0x70, 0x72, 0x65, 0x61, 0x6D,
+    0x62, 0x6C, 0x65, 0x5F, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x28, 0x6C, 0x69,
+    0x6E, 0x65, 0x73, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x68, 0x61, 0x73,
+    0x5F, 0x66, 0x69, 0x6C, 0x65, 0x73, 0x5F, 0x6D, 0x61, 0x72, 0x6B, 0x65,
+    0x72, 0x20, 0x3D, 0x20, 0x61, 0x6E, 0x79, 0x28, 0x6C, 0x69, 0x6E, 0x65,
+    0x2E, 0x72, 0x73, 0x74, 0x72, 0x69, 0x70, 0x28, 0x22, 0x5C, 0x6E, 0x22,
+    0x29, 0x20, 0x3D, 0x3D, 0x20, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F, 0x42,
+    0x45, 0x47, 0x49, 0x4E, 0x5F, 0x4D, 0x41, 0x52, 0x4B, 0x45, 0x52, 0x20,
+    0x66, 0x6F, 0x72, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x20, 0x69, 0x6E, 0x20,
+    0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x66, 0x20, 0x68, 0x75, 0x6E, 0x6B, 0x73, 0x5F, 0x6F, 0x6E, 0x3A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x61, 0x69,
+    0x73, 0x65, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72,
+    0x73, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28, 0x22, 0x68, 0x75, 0x6E,
+    0x6B, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x73, 0x20, 0x61, 0x72,
+    0x65, 0x20, 0x6E, 0x6F, 0x74, 0x20, 0x73, 0x75, 0x70, 0x70, 0x6F, 0x72,
+    0x74, 0x65, 0x64, 0x3B, 0x20, 0x75, 0x73, 0x65, 0x20, 0x61, 0x20, 0x66,
+    0x75, 0x6C, 0x6C, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x20, 0x77,
+    0x69, 0x74, 0x68, 0x6F, 0x75, 0x74, 0x20, 0x2D, 0x2D, 0x68, 0x75, 0x6E,
+    0x6B, 0x73, 0x22, 0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x65, 0x6E,
+    0x74, 0x72, 0x69, 0x65, 0x73, 0x3A, 0x20, 0x6C, 0x69, 0x73, 0x74, 0x5B,
+    0x74, 0x75, 0x70, 0x6C, 0x65, 0x5B, 0x73, 0x74, 0x72, 0x2C, 0x20, 0x73,
+    0x74, 0x72, 0x5D, 0x5D, 0x20, 0x3D, 0x20, 0x5B, 0x5D, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x20, 0x3D, 0x20, 0x30, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x73, 0x65, 0x65, 0x6E, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x20, 0x3D, 0x20,
+    0x46, 0x61, 0x6C, 0x73, 0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x73, 0x61,
+    0x77, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x73, 0x5F, 0x6D, 0x61, 0x72, 0x6B,
+    0x65, 0x72, 0x20, 0x3D, 0x20, 0x46, 0x61, 0x6C, 0x73, 0x65, 0x0A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x77, 0x68, 0x69, 0x6C, 0x65, 0x20, 0x69, 0x20,
+    0x3C, 0x20, 0x6C, 0x65, 0x6E, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x68, 0x65,
+    0x61, 0x64, 0x69, 0x6E, 0x67, 0x20, 0x3D, 0x20, 0x6C, 0x69, 0x6E, 0x65,
+    0x73, 0x5B, 0x69, 0x5D, 0x2E, 0x72, 0x73, 0x74, 0x72, 0x69, 0x70, 0x28,
+    0x22, 0x5C, 0x6E, 0x22, 0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x68, 0x61, 0x73, 0x5F, 0x66, 0x69,
+    0x6C, 0x65, 0x73, 0x5F, 0x6D, 0x61, 0x72, 0x6B, 0x65, 0x72, 0x20, 0x61,
+    0x6E, 0x64, 0x20, 0x6E, 0x6F, 0x74, 0x20, 0x73, 0x61, 0x77, 0x5F, 0x66,
+    0x69, 0x6C, 0x65, 0x73, 0x5F, 0x6D, 0x61, 0x72, 0x6B, 0x65, 0x72, 0x3A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x69, 0x66, 0x20, 0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x20,
+    0x3D, 0x3D, 0x20, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F, 0x42, 0x45, 0x47,
+    0x49, 0x4E, 0x5F, 0x4D, 0x41, 0x52, 0x4B, 0x45, 0x52, 0x3A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x73, 0x61, 0x77, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x73,
+    0x5F, 0x6D, 0x61, 0x72, 0x6B, 0x65, 0x72, 0x20, 0x3D, 0x20, 0x54, 0x72,
+    0x75, 0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F,
+    0x6E, 0x74, 0x69, 0x6E, 0x75, 0x65, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x68, 0x65, 0x61, 0x64, 0x69,
+    0x6E, 0x67, 0x20, 0x3D, 0x3D, 0x20, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F,
+    0x42, 0x45, 0x47, 0x49, 0x4E, 0x5F, 0x4D, 0x41, 0x52, 0x4B, 0x45, 0x52,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x73, 0x61, 0x77, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x73, 0x5F,
+    0x6D, 0x61, 0x72, 0x6B, 0x65, 0x72, 0x20, 0x3D, 0x20, 0x54, 0x72, 0x75,
+    0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6E,
+    0x74, 0x69, 0x6E, 0x75, 0x65, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x66, 0x20, 0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67,
+    0x20, 0x3D, 0x3D, 0x20, 0x46, 0x49, 0x4C, 0x45, 0x53, 0x5F, 0x45, 0x4E,
+    0x44, 0x5F, 0x4D, 0x41, 0x52, 0x4B, 0x45, 0x52, 0x3A, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x72,
+    0x65, 0x61, 0x6B, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x69, 0x66, 0x20, 0x6E, 0x6F, 0x74, 0x20, 0x73, 0x65, 0x65, 0x6E,
+    0x5F, 0x66, 0x69, 0x6C, 0x65, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x68, 0x65,
+    0x61, 0x64, 0x69, 0x6E, 0x67, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x23, 0x23,
+    0x20, 0x43, 0x68, 0x61, 0x6E, 0x67, 0x65, 0x20, 0x43, 0x6F, 0x6E, 0x74,
+    0x65, 0x78, 0x74, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x77, 0x68, 0x69, 0x6C, 0x65, 0x20, 0x69, 0x20, 0x3C, 0x20, 0x6C,
+    0x65, 0x6E, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x20, 0x61, 0x6E,
+    0x64, 0x20, 0x6E, 0x6F, 0x74, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x5B,
+    0x69, 0x5D, 0x2E, 0x73, 0x74, 0x61, 0x72, 0x74, 0x73, 0x77, 0x69, 0x74,
+    0x68, 0x28, 0x22, 0x23, 0x23, 0x20, 0x22, 0x29, 0x3A, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6E,
+    0x74, 0x69, 0x6E, 0x75, 0x65, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x6E, 0x6F, 0x74, 0x20, 0x73, 0x65,
+    0x65, 0x6E, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x20, 0x61, 0x6E, 0x64, 0x20,
+    0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x20, 0x3D, 0x3D, 0x20, 0x22,
+    0x23, 0x23, 0x20, 0x50, 0x72, 0x6F, 0x6A, 0x65, 0x63, 0x74, 0x20, 0x54,
+    0x72, 0x65, 0x65, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x77, 0x68, 0x69, 0x6C, 0x65, 0x20, 0x69, 0x20, 0x3C, 0x20, 0x6C,
+    0x65, 0x6E, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x20, 0x61, 0x6E,
+    0x64, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x5B, 0x69, 0x5D, 0x2E, 0x73,
+    0x74, 0x72, 0x69, 0x70, 0x28, 0x29, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x22,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x69, 0x66, 0x20, 0x69, 0x20, 0x3E, 0x3D, 0x20, 0x6C, 0x65, 0x6E,
+    0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x72, 0x61, 0x69, 0x73, 0x65, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72,
+    0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28,
+    0x22, 0x75, 0x6E, 0x74, 0x65, 0x72, 0x6D, 0x69, 0x6E, 0x61, 0x74, 0x65,
+    0x64, 0x20, 0x70, 0x72, 0x6F, 0x6A, 0x65, 0x63, 0x74, 0x20, 0x74, 0x72,
+    0x65, 0x65, 0x20, 0x73, 0x65, 0x63, 0x74, 0x69, 0x6F, 0x6E, 0x22, 0x29,
+    0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x66, 0x65, 0x6E, 0x63, 0x65, 0x5F, 0x6C, 0x65, 0x6E, 0x20,
+    0x3D, 0x20, 0x70, 0x61, 0x72, 0x73, 0x65, 0x5F, 0x6F, 0x70, 0x65, 0x6E,
+    0x5F, 0x66, 0x65, 0x6E, 0x63, 0x65, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73,
+    0x5B, 0x69, 0x5D, 0x2E, 0x72, 0x73, 0x74, 0x72, 0x69, 0x70, 0x28, 0x22,
+    0x5C, 0x6E, 0x22, 0x29, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x66, 0x65, 0x6E,
+    0x63, 0x65, 0x5F, 0x6C, 0x65, 0x6E, 0x20, 0x69, 0x73, 0x20, 0x4E, 0x6F,
+    0x6E, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x61, 0x69, 0x73,
+    0x65, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72, 0x73,
+    0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28, 0x22, 0x70, 0x72, 0x6F, 0x6A,
+    0x65, 0x63, 0x74, 0x20, 0x74, 0x72, 0x65, 0x65, 0x20, 0x73, 0x65, 0x63,
+    0x74, 0x69, 0x6F, 0x6E, 0x20, 0x69, 0x73, 0x20, 0x6D, 0x69, 0x73, 0x73,
+    0x69, 0x6E, 0x67, 0x20, 0x69, 0x74, 0x73, 0x20, 0x6F, 0x70, 0x65, 0x6E,
+    0x69, 0x6E, 0x67, 0x20, 0x66, 0x65, 0x6E, 0x63, 0x65, 0x22, 0x29, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x77, 0x68, 0x69, 0x6C,
+    0x65, 0x20, 0x69, 0x20, 0x3C, 0x20, 0x6C, 0x65, 0x6E, 0x28, 0x6C, 0x69,
+    0x6E, 0x65, 0x73, 0x29, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x6C, 0x69, 0x6E,
+    0x65, 0x73, 0x5B, 0x69, 0x5D, 0x2E, 0x72, 0x73, 0x74, 0x72, 0x69, 0x70,
+    0x28, 0x22, 0x5C, 0x6E, 0x22, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x28, 0x22,
+    0x60, 0x22, 0x20, 0x2A, 0x20, 0x66, 0x65, 0x6E, 0x63, 0x65, 0x5F, 0x6C,
+    0x65, 0x6E, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B,
+    0x3D, 0x20, 0x31, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x69, 0x20, 0x3E, 0x3D, 0x20,
+    0x6C, 0x65, 0x6E, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x29, 0x3A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x72, 0x61, 0x69, 0x73, 0x65, 0x20, 0x45, 0x78,
+    0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x45, 0x72, 0x72,
+    0x6F, 0x72, 0x28, 0x22, 0x75, 0x6E, 0x74, 0x65, 0x72, 0x6D, 0x69, 0x6E,
+    0x61, 0x74, 0x65, 0x64, 0x20, 0x70, 0x72, 0x6F, 0x6A, 0x65, 0x63, 0x74,
+    0x20, 0x74, 0x72, 0x65, 0x65, 0x20, 0x63, 0x6F, 0x64, 0x65, 0x20, 0x66,
+    0x65, 0x6E, 0x63, 0x65, 0x22, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20,
+    0x31, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x63, 0x6F, 0x6E, 0x74, 0x69, 0x6E, 0x75, 0x65, 0x0A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x6E,
+    0x6F, 0x74, 0x20, 0x68, 0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x2E, 0x73,
+    0x74, 0x61, 0x72, 0x74, 0x73, 0x77, 0x69, 0x74, 0x68, 0x28, 0x22, 0x23,
+    0x23, 0x20, 0x22, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20, 0x31,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x63, 0x6F, 0x6E, 0x74, 0x69, 0x6E, 0x75, 0x65, 0x0A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x6F, 0x64, 0x79, 0x5F,
+    0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x3D, 0x20, 0x6E, 0x65, 0x78, 0x74,
+    0x5F, 0x6E, 0x6F, 0x6E, 0x62, 0x6C, 0x61, 0x6E, 0x6B, 0x5F, 0x69, 0x6E,
+    0x64, 0x65, 0x78, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x2C, 0x20, 0x69,
+    0x20, 0x2B, 0x20, 0x31, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x69, 0x66, 0x20, 0x62, 0x6F, 0x64, 0x79, 0x5F, 0x73, 0x74,
+    0x61, 0x72, 0x74, 0x20, 0x69, 0x73, 0x20, 0x4E, 0x6F, 0x6E, 0x65, 0x3A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x72, 0x61, 0x69, 0x73, 0x65, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72,
+    0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28,
+    0x66, 0x22, 0x6D, 0x69, 0x73, 0x73, 0x69, 0x6E, 0x67, 0x20, 0x63, 0x6F,
+    0x64, 0x65, 0x20, 0x66, 0x65, 0x6E, 0x63, 0x65, 0x20, 0x66, 0x6F, 0x72,
+    0x20, 0x73, 0x65, 0x63, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x7B, 0x68, 0x65,
+    0x61, 0x64, 0x69, 0x6E, 0x67, 0x5B, 0x33, 0x3A, 0x5D, 0x21, 0x72, 0x7D,
+    0x22, 0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x66, 0x65, 0x6E, 0x63, 0x65, 0x5F, 0x6C, 0x65, 0x6E, 0x20, 0x3D, 0x20,
+    0x70, 0x61, 0x72, 0x73, 0x65, 0x5F, 0x6F, 0x70, 0x65, 0x6E, 0x5F, 0x66,
+    0x65, 0x6E, 0x63, 0x65, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x5B, 0x62,
+    0x6F, 0x64, 0x79, 0x5F, 0x73, 0x74, 0x61, 0x72, 0x74, 0x5D, 0x2E, 0x72,
+    0x73, 0x74, 0x72, 0x69, 0x70, 0x28, 0x22, 0x5C, 0x6E, 0x22, 0x29, 0x29,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20,
+    0x66, 0x65, 0x6E, 0x63, 0x65, 0x5F, 0x6C, 0x65, 0x6E, 0x20, 0x69, 0x73,
+    0x20, 0x4E, 0x6F, 0x6E, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x6E, 0x6F,
+    0x74, 0x20, 0x73, 0x65, 0x65, 0x6E, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x20,
+    0x61, 0x6E, 0x64, 0x20, 0x6E, 0x6F, 0x74, 0x20, 0x73, 0x61, 0x77, 0x5F,
+    0x66, 0x69, 0x6C, 0x65, 0x73, 0x5F, 0x6D, 0x61, 0x72, 0x6B, 0x65, 0x72,
+    0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x61, 0x69, 0x73, 0x65, 0x20,
+    0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x45,
+    0x72, 0x72, 0x6F, 0x72, 0x28, 0x66, 0x22, 0x75, 0x6E, 0x65, 0x78, 0x70,
+    0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x6E, 0x6F, 0x6E, 0x2D, 0x66, 0x69,
+    0x6C, 0x65, 0x20, 0x73, 0x65, 0x63, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x62,
+    0x65, 0x66, 0x6F, 0x72, 0x65, 0x20, 0x66, 0x69, 0x6C, 0x65, 0x20, 0x65,
+    0x6E, 0x74, 0x72, 0x69, 0x65, 0x73, 0x3A, 0x20, 0x7B, 0x68, 0x65, 0x61,
+    0x64, 0x69, 0x6E, 0x67, 0x21, 0x72, 0x7D, 0x22, 0x29, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x61,
+    0x69, 0x73, 0x65, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50, 0x61,
+    0x72, 0x73, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28, 0x66, 0x22, 0x69,
+    0x6E, 0x76, 0x61, 0x6C, 0x69, 0x64, 0x20, 0x63, 0x6F, 0x64, 0x65, 0x20,
+    0x66, 0x65, 0x6E, 0x63, 0x65, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x7B, 0x68,
+    0x65, 0x61, 0x64, 0x69, 0x6E, 0x67, 0x5B, 0x33, 0x3A, 0x5D, 0x21, 0x72,
+    0x7D, 0x22, 0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x66, 0x69, 0x6C, 0x65, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x20, 0x3D,
+    0x20, 0x64, 0x65, 0x63, 0x6F, 0x64, 0x65, 0x5F, 0x68, 0x65, 0x61, 0x64,
+    0x69, 0x6E, 0x67, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x28, 0x68, 0x65, 0x61,
+    0x64, 0x69, 0x6E, 0x67, 0x5B, 0x33, 0x3A, 0x5D, 0x29, 0x0A, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x3D, 0x20, 0x62, 0x6F,
+    0x64, 0x79, 0x5F, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x2B, 0x20, 0x31,
+    0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x6F,
+    0x64, 0x79, 0x5F, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x3A, 0x20, 0x6C, 0x69,
+    0x73, 0x74, 0x5B, 0x73, 0x74, 0x72, 0x5D, 0x20, 0x3D, 0x20, 0x5B, 0x5D,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x77, 0x68, 0x69,
+    0x6C, 0x65, 0x20, 0x69, 0x20, 0x3C, 0x20, 0x6C, 0x65, 0x6E, 0x28, 0x6C,
+    0x69, 0x6E, 0x65, 0x73, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20, 0x6C, 0x69,
+    0x6E, 0x65, 0x73, 0x5B, 0x69, 0x5D, 0x2E, 0x72, 0x73, 0x74, 0x72, 0x69,
+    0x70, 0x28, 0x22, 0x5C, 0x6E, 0x22, 0x29, 0x20, 0x3D, 0x3D, 0x20, 0x28,
+    0x22, 0x60, 0x22, 0x20, 0x2A, 0x20, 0x66, 0x65, 0x6E, 0x63, 0x65, 0x5F,
+    0x6C, 0x65, 0x6E, 0x29, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20,
+    0x2B, 0x3D, 0x20, 0x31, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x72, 0x65,
+    0x61, 0x6B, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x62, 0x6F, 0x64, 0x79, 0x5F, 0x6C, 0x69, 0x6E, 0x65,
+    0x73, 0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x6C, 0x69, 0x6E,
+    0x65, 0x73, 0x5B, 0x69, 0x5D, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x20, 0x2B, 0x3D, 0x20,
+    0x31, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x65, 0x6C,
+    0x73, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x72, 0x61, 0x69, 0x73, 0x65, 0x20, 0x45, 0x78,
+    0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x45, 0x72, 0x72,
+    0x6F, 0x72, 0x28, 0x66, 0x22, 0x75, 0x6E, 0x74, 0x65, 0x72, 0x6D, 0x69,
+    0x6E, 0x61, 0x74, 0x65, 0x64, 0x20, 0x63, 0x6F, 0x64, 0x65, 0x20, 0x66,
+    0x65, 0x6E, 0x63, 0x65, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x7B, 0x66, 0x69,
+    0x6C, 0x65, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x21, 0x72, 0x7D, 0x22, 0x29,
+    0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66,
+    0x20, 0x6C, 0x69, 0x6E, 0x65, 0x5F, 0x6E, 0x75, 0x6D, 0x62, 0x65, 0x72,
+    0x73, 0x5F, 0x6F, 0x6E, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x6F, 0x64, 0x79, 0x5F, 0x6C,
+    0x69, 0x6E, 0x65, 0x73, 0x20, 0x3D, 0x20, 0x5B, 0x73, 0x74, 0x72, 0x69,
+    0x70, 0x5F, 0x6C, 0x69, 0x6E, 0x65, 0x5F, 0x6E, 0x75, 0x6D, 0x62, 0x65,
+    0x72, 0x28, 0x6C, 0x69, 0x6E, 0x65, 0x29, 0x20, 0x66, 0x6F, 0x72, 0x20,
+    0x6C, 0x69, 0x6E, 0x65, 0x20, 0x69, 0x6E, 0x20, 0x62, 0x6F, 0x64, 0x79,
+    0x5F, 0x6C, 0x69, 0x6E, 0x65, 0x73, 0x5D, 0x0A, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x65, 0x6E, 0x74, 0x72, 0x69, 0x65, 0x73,
+    0x2E, 0x61, 0x70, 0x70, 0x65, 0x6E, 0x64, 0x28, 0x28, 0x66, 0x69, 0x6C,
+    0x65, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x2C, 0x20, 0x22, 0x22, 0x2E, 0x6A,
+    0x6F, 0x69, 0x6E, 0x28, 0x62, 0x6F, 0x64, 0x79, 0x5F, 0x6C, 0x69, 0x6E,
+    0x65, 0x73, 0x29, 0x29, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x73, 0x65, 0x65, 0x6E, 0x5F, 0x66, 0x69, 0x6C, 0x65, 0x20,
+    0x3D, 0x20, 0x54, 0x72, 0x75, 0x65, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x65, 0x6E, 0x74, 0x72, 0x69,
+    0x65, 0x73, 0x2C, 0x20, 0x6C, 0x69, 0x6E, 0x65, 0x5F, 0x6E, 0x75, 0x6D,
+    0x62, 0x65, 0x72, 0x73, 0x5F, 0x6F, 0x6E, 0x0A, 0x0A, 0x0A, 0x64, 0x65,
+    0x66, 0x20, 0x73, 0x61, 0x66, 0x65, 0x5F, 0x6F, 0x75, 0x74, 0x70, 0x75,
+    0x74, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x28, 0x6F, 0x75, 0x74, 0x70, 0x75,
+    0x74, 0x5F, 0x64, 0x69, 0x72, 0x3A, 0x20, 0x50, 0x61, 0x74, 0x68, 0x2C,
+    0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x5F, 0x70, 0x61, 0x74, 0x68,
+    0x3A, 0x20, 0x73, 0x74, 0x72, 0x29, 0x20, 0x2D, 0x3E, 0x20, 0x50, 0x61,
+    0x74, 0x68, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x6C, 0x61,
+    0x74, 0x69, 0x76, 0x65, 0x20, 0x3D, 0x20, 0x50, 0x61, 0x74, 0x68, 0x28,
+    0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x2E,
+    0x6C, 0x73, 0x74, 0x72, 0x69, 0x70, 0x28, 0x22, 0x2F, 0x22, 0x29, 0x29,
+    0x20, 0x69, 0x66, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x5F, 0x70,
+    0x61, 0x74, 0x68, 0x2E, 0x73, 0x74, 0x61, 0x72, 0x74, 0x73, 0x77, 0x69,
+    0x74, 0x68, 0x28, 0x22, 0x2F, 0x22, 0x29, 0x20, 0x65, 0x6C, 0x73, 0x65,
+    0x20, 0x50, 0x61, 0x74, 0x68, 0x28, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74,
+    0x5F, 0x70, 0x61, 0x74, 0x68, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x64,
+    0x65, 0x73, 0x74, 0x69, 0x6E, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D,
+    0x20, 0x28, 0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x5F, 0x64, 0x69, 0x72,
+    0x20, 0x2F, 0x20, 0x72, 0x65, 0x6C, 0x61, 0x74, 0x69, 0x76, 0x65, 0x29,
+    0x2E, 0x72, 0x65, 0x73, 0x6F, 0x6C, 0x76, 0x65, 0x28, 0x29, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x5F, 0x72, 0x6F,
+    0x6F, 0x74, 0x20, 0x3D, 0x20, 0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x5F,
+    0x64, 0x69, 0x72, 0x2E, 0x72, 0x65, 0x73, 0x6F, 0x6C, 0x76, 0x65, 0x28,
+    0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x74, 0x72, 0x79, 0x3A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x64, 0x65, 0x73, 0x74,
+    0x69, 0x6E, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x2E, 0x72, 0x65, 0x6C, 0x61,
+    0x74, 0x69, 0x76, 0x65, 0x5F, 0x74, 0x6F, 0x28, 0x6F, 0x75, 0x74, 0x70,
+    0x75, 0x74, 0x5F, 0x72, 0x6F, 0x6F, 0x74, 0x29, 0x0A, 0x20, 0x20, 0x20,
+    0x20, 0x65, 0x78, 0x63, 0x65, 0x70, 0x74, 0x20, 0x56, 0x61, 0x6C, 0x75,
+    0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x20, 0x61, 0x73, 0x20, 0x65, 0x78,
+    0x63, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72,
+    0x61, 0x69, 0x73, 0x65, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50,
+    0x61, 0x72, 0x73, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x28, 0x66, 0x22,
+    0x72, 0x65, 0x66, 0x75, 0x73, 0x69, 0x6E, 0x67, 0x20, 0x74, 0x6F, 0x20,
+    0x77, 0x72, 0x69, 0x74, 0x65, 0x20, 0x6F, 0x75, 0x74, 0x73, 0x69, 0x64,
+    0x65, 0x20, 0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x20, 0x64, 0x69, 0x72,
+    0x65, 0x63, 0x74, 0x6F, 0x72, 0x79, 0x3A, 0x20, 0x7B, 0x65, 0x78, 0x70,
+    0x6F, 0x72, 0x74, 0x5F, 0x70, 0x61, 0x74, 0x68, 0x21, 0x72, 0x7D, 0x22,
+    0x29, 0x20, 0x66, 0x72, 0x6F, 0x6D, 0x20, 0x65, 0x78, 0x63, 0x0A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x64,
+    0x65, 0x73, 0x74, 0x69, 0x6E, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x0A, 0x0A,
+    0x0A, 0x64, 0x65, 0x66, 0x20, 0x77, 0x72, 0x69, 0x74, 0x65, 0x5F, 0x65,
+    0x6E, 0x74, 0x72, 0x69, 0x65, 0x73, 0x28, 0x6F, 0x75, 0x74, 0x70, 0x75,
+    0x74, 0x5F, 0x64, 0x69, 0x72, 0x3A, 0x20, 0x50, 0x61, 0x74, 0x68, 0x2C,
+    0x20, 0x65, 0x6E, 0x74, 0x72, 0x69, 0x65, 0x73, 0x3A, 0x20, 0x6C, 0x69,
+    0x73, 0x74, 0x5B, 0x74, 0x75, 0x70, 0x6C, 0x65, 0x5B, 0x73, 0x74, 0x72,
+    0x2C, 0x20, 0x73, 0x74, 0x72, 0x5D, 0x5D, 0x29, 0x20, 0x2D, 0x3E, 0x20,
+    0x4E, 0x6F, 0x6E, 0x65, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x66, 0x6F,
+    0x72, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x5F, 0x70, 0x61, 0x74,
+    0x68, 0x2C, 0x20, 0x63, 0x6F, 0x6E, 0x74, 0x65, 0x6E, 0x74, 0x20, 0x69,
+    0x6E, 0x20, 0x65, 0x6E, 0x74, 0x72, 0x69, 0x65, 0x73, 0x3A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x64, 0x65, 0x73, 0x74, 0x69,
+    0x6E, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x73, 0x61, 0x66,
+    0x65, 0x5F, 0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x5F, 0x70, 0x61, 0x74,
+    0x68, 0x28, 0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x5F, 0x64, 0x69, 0x72,
+    0x2C, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x5F, 0x70, 0x61, 0x74,
+    0x68, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x64,
+    0x65, 0x73, 0x74, 0x69, 0x6E, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x2E, 0x70,
+    0x61, 0x72, 0x65, 0x6E, 0x74, 0x2E, 0x6D, 0x6B, 0x64, 0x69, 0x72, 0x28,
+    0x70, 0x61, 0x72, 0x65, 0x6E, 0x74, 0x73, 0x3D, 0x54, 0x72, 0x75, 0x65,
+    0x2C, 0x20, 0x65, 0x78, 0x69, 0x73, 0x74, 0x5F, 0x6F, 0x6B, 0x3D, 0x54,
+    0x72, 0x75, 0x65, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x64, 0x65, 0x73, 0x74, 0x69, 0x6E, 0x61, 0x74, 0x69, 0x6F, 0x6E,
+    0x2E, 0x77, 0x72, 0x69, 0x74, 0x65, 0x5F, 0x74, 0x65, 0x78, 0x74, 0x28,
+    0x63, 0x6F, 0x6E, 0x74, 0x65, 0x6E, 0x74, 0x2C, 0x20, 0x65, 0x6E, 0x63,
+    0x6F, 0x64, 0x69, 0x6E, 0x67, 0x3D, 0x22, 0x75, 0x74, 0x66, 0x2D, 0x38,
+    0x22, 0x29, 0x0A, 0x0A, 0x0A, 0x64, 0x65, 0x66, 0x20, 0x6D, 0x61, 0x69,
+    0x6E, 0x28, 0x29, 0x20, 0x2D, 0x3E, 0x20, 0x69, 0x6E, 0x74, 0x3A, 0x0A,
+    0x20, 0x20, 0x20, 0x20, 0x70, 0x61, 0x72, 0x73, 0x65, 0x72, 0x20, 0x3D,
+    0x20, 0x61, 0x72, 0x67, 0x70, 0x61, 0x72, 0x73, 0x65, 0x2E, 0x41, 0x72,
+    0x67, 0x75, 0x6D, 0x65, 0x6E, 0x74, 0x50, 0x61, 0x72, 0x73, 0x65, 0x72,
+    0x28, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x64, 0x65,
+    0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x69, 0x6F, 0x6E, 0x3D, 0x22, 0x45,
+    0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x20, 0x73, 0x6F, 0x75, 0x72, 0x63,
+    0x65, 0x20, 0x66, 0x69, 0x6C, 0x65, 0x73, 0x20, 0x66, 0x72, 0x6F, 0x6D,
+    0x20, 0x61, 0x20, 0x66, 0x75, 0x6C, 0x6C, 0x20, 0x66, 0x75, 0x6F, 0x72,
+    0x69, 0x20, 0x6D, 0x61, 0x72, 0x6B, 0x64, 0x6F, 0x77, 0x6E, 0x20, 0x65,
+    0x78, 0x70, 0x6F, 0x72, 0x74, 0x2E, 0x22, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x70, 0x61, 0x72, 0x73, 0x65, 0x72,
+    0x2E, 0x61, 0x64, 0x64, 0x5F, 0x61, 0x72, 0x67, 0x75, 0x6D, 0x65, 0x6E,
+    0x74, 0x28, 0x22, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x22, 0x2C, 0x20,
+    0x74, 0x79, 0x70, 0x65, 0x3D, 0x50, 0x61, 0x74, 0x68, 0x2C, 0x20, 0x68,
+    0x65, 0x6C, 0x70, 0x3D, 0x22, 0x50, 0x61, 0x74, 0x68, 0x20, 0x74, 0x6F,
+    0x20, 0x74, 0x68, 0x65, 0x20, 0x6D, 0x61, 0x72, 0x6B, 0x64, 0x6F, 0x77,
+    0x6E, 0x20, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x22, 0x29, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x70, 0x61, 0x72, 0x73, 0x65, 0x72, 0x2E, 0x61, 0x64,
+    0x64, 0x5F, 0x61, 0x72, 0x67, 0x75, 0x6D, 0x65, 0x6E, 0x74, 0x28, 0x22,
+    0x6F, 0x75, 0x74, 0x70, 0x75, 0x74, 0x5F, 0x64, 0x69, 0x72, 0x22, 0x2C,
+    0x20, 0x74, 0x79, 0x70, 0x65, 0x3D, 0x50, 0x61, 0x74, 0x68, 0x2C, 0x20,
+    0x68, 0x65, 0x6C, 0x70, 0x3D, 0x22, 0x44, 0x69, 0x72, 0x65, 0x63, 0x74,
+    0x6F, 0x72, 0x79, 0x20, 0x74, 0x6F, 0x20, 0x72, 0x65, 0x63, 0x6F, 0x6E,
+    0x73, 0x74, 0x72, 0x75, 0x63, 0x74, 0x20, 0x66, 0x69, 0x6C, 0x65, 0x73,
+    0x20, 0x69, 0x6E, 0x74, 0x6F, 0x22, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20,
+    0x61, 0x72, 0x67, 0x73, 0x20, 0x3D, 0x20, 0x70, 0x61, 0x72, 0x73, 0x65,
+    0x72, 0x2E, 0x70, 0x61, 0x72, 0x73, 0x65, 0x5F, 0x61, 0x72, 0x67, 0x73,
+    0x28, 0x29, 0x0A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x74, 0x72, 0x79, 0x3A,
+    0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x65, 0x6E, 0x74,
+    0x72, 0x69, 0x65, 0x73, 0x2C, 0x20, 0x5F, 0x20, 0x3D, 0x20, 0x72, 0x65,
+    0x61, 0x64, 0x5F, 0x65, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x5F, 0x65, 0x6E,
+    0x74, 0x72, 0x69, 0x65, 0x73, 0x28, 0x61, 0x72, 0x67, 0x73, 0x2E, 0x65,
+    0x78, 0x70, 0x6F, 0x72, 0x74, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x20, 0x61, 0x72, 0x67, 0x73, 0x2E, 0x6F, 0x75, 0x74, 0x70,
+    0x75, 0x74, 0x5F, 0x64, 0x69, 0x72, 0x2E, 0x6D, 0x6B, 0x64, 0x69, 0x72,
+    0x28, 0x70, 0x61, 0x72, 0x65, 0x6E, 0x74, 0x73, 0x3D, 0x54, 0x72, 0x75,
+    0x65, 0x2C, 0x20, 0x65, 0x78, 0x69, 0x73, 0x74, 0x5F, 0x6F, 0x6B, 0x3D,
+    0x54, 0x72, 0x75, 0x65, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x77, 0x72, 0x69, 0x74, 0x65, 0x5F, 0x65, 0x6E, 0x74, 0x72,
+    0x69, 0x65, 0x73, 0x28, 0x61, 0x72, 0x67, 0x73, 0x2E, 0x6F, 0x75, 0x74,
+    0x70, 0x75, 0x74, 0x5F, 0x64, 0x69, 0x72, 0x2C, 0x20, 0x65, 0x6E, 0x74,
+    0x72, 0x69, 0x65, 0x73, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x65, 0x78,
+    0x63, 0x65, 0x70, 0x74, 0x20, 0x28, 0x4F, 0x53, 0x45, 0x72, 0x72, 0x6F,
+    0x72, 0x2C, 0x20, 0x45, 0x78, 0x70, 0x6F, 0x72, 0x74, 0x50, 0x61, 0x72,
+    0x73, 0x65, 0x45, 0x72, 0x72, 0x6F, 0x72, 0x29, 0x20, 0x61, 0x73, 0x20,
+    0x65, 0x78, 0x63, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x70, 0x72, 0x69, 0x6E, 0x74, 0x28, 0x66, 0x22, 0x65, 0x72, 0x72,
+    0x6F, 0x72, 0x3A, 0x20, 0x7B, 0x65, 0x78, 0x63, 0x7D, 0x22, 0x2C, 0x20,
+    0x66, 0x69, 0x6C, 0x65, 0x3D, 0x73, 0x79, 0x73, 0x2E, 0x73, 0x74, 0x64,
+    0x65, 0x72, 0x72, 0x29, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x31, 0x0A, 0x0A, 0x20,
+    0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x30, 0x0A,
+    0x0A, 0x0A, 0x69, 0x66, 0x20, 0x5F, 0x5F, 0x6E, 0x61, 0x6D, 0x65, 0x5F,
+    0x5F, 0x20, 0x3D, 0x3D, 0x20, 0x22, 0x5F, 0x5F, 0x6D, 0x61, 0x69, 0x6E,
+    0x5F, 0x5F, 0x22, 0x3A, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x72, 0x61, 0x69,
+    0x73, 0x65, 0x20, 0x53, 0x79, 0x73, 0x74, 0x65, 0x6D, 0x45, 0x78, 0x69,
+    0x74, 0x28, 0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x29, 0x0A,
+    0x00
+};
+
+static const size_t FUORI_UNPACKER_SCRIPT_LEN = 7246;
+
+#endif
@@ -0,0 +1,266 @@
+#include "git_index.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define GIT_INDEX_HEADER_BYTES 12
+#define GIT_INDEX_STAT_BYTES 40
+#define GIT_INDEX_FLAG_EXTENDED 0x4000U
+#define GIT_INDEX_FLAG_STAGE_MASK 0x3000U
+#define GIT_INDEX_FLAG_NAME_MASK 0x0FFFU
+#define GIT_INDEX_EXTENDED_KNOWN_MASK 0x6000U  // skip-worktree, intent-to-add
+#define GIT_INDEX_MODE_DIRECTORY 0040000U
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t capacity;
+} IndexNameBuffer;
+
+static uint32_t read_be32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static uint16_t read_be16(const unsigned char* p) {
+    return (uint16_t)(((unsigned)p[0] << 8) | (unsigned)p[1]);
+}
+
+/* Git's offset varint (varint.c): each continuation adds one before shifting. */
+static int read_index_varint(const unsigned char** cursor, const unsigned char* end, size_t* value_out) {
+    const unsigned char* p = *cursor;
+    size_t value;
+    unsigned char c;
+
+    if (p >= end) {
+        return -1;
+    }
+    c = *p++;
+    value = c & 127U;
+    while (c & 128U) {
+        if (p >= end || value > (SIZE_MAX >> 7) - 1) {
+            return -1;
+        }
+        c = *p++;
+        value = ((value + 1) << 7) | (c & 127U);
+    }
+    *cursor = p;
+    *value_out = value;
+    return 0;
+}
+
+static int reserve_index_name(IndexNameBuffer* name, size_t needed) {
+    if (needed <= name->capacity) {
+        return 0;
+    }
+    size_t new_capacity = (name->capacity == 0) ? 256 : name->capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    char* new_data = realloc(name->data, new_capacity);
+    if (!new_data) {
+        return -1;
+    }
+    name->data = new_data;
+    name->capacity = new_capacity;
+    return 0;
+}
+
+/*
+ * Walks every entry and extension. With fn == NULL this only validates the
+ * layout, so a rejected index never produces a partial listing.
+ * Returns 1 when the layout is supported, 0 when it is not, -1 on error.
+ */
+static int walk_git_index(const unsigned char* data,
+                          size_t len,
+                          size_t hash_size,
+                          GitIndexEntryFn fn,
+                          void* state,
+                          IndexNameBuffer* name) {
+    const unsigned char* end;
+    const unsigned char* p;
+    uint32_t version;
+    uint32_t entry_count;
+    size_t entry_fixed = GIT_INDEX_STAT_BYTES + hash_size + 2;
+
+    if (len < GIT_INDEX_HEADER_BYTES + hash_size || memcmp(data, "DIRC", 4) != 0) {
+        return 0;
+    }
+    version = read_be32(data + 4);
+    entry_count = read_be32(data + 8);
+    if (version < 2 || version > 4) {
+        return 0;
+    }
+
+    end = data + len - hash_size;
+    p = data + GIT_INDEX_HEADER_BYTES;
+    name->len = 0;
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+        const unsigned char* entry = p;
+        const unsigned char* path;
+        const unsigned char* nul;
+        GitIndexEntry parsed;
+        uint16_t flags;
+        size_t flag_name_len;
+        size_t path_len;
+
+        if ((size_t)(end - p) < entry_fixed) {
+            return 0;
+        }
+        flags = read_be16(p + GIT_INDEX_STAT_BYTES + hash_size);
+        p += entry_fixed;
+        if (flags & GIT_INDEX_FLAG_EXTENDED) {
+            if (version < 3 || end - p < 2 ||
+                (read_be16(p) & ~GIT_INDEX_EXTENDED_KNOWN_MASK) != 0) {
+                return 0;
+            }
+            p += 2;
+        }
+        flag_name_len = flags & GIT_INDEX_FLAG_NAME_MASK;
+
+        if (version == 4) {
+            size_t strip_len;
+            size_t suffix_len;
+
+            if (read_index_varint(&p, end, &strip_len) != 0 || strip_len > name->len) {
+                return 0;
+            }
+            nul = memchr(p, '\0', (size_t)(end - p));
+            if (!nul) {
+                return 0;
+            }
+            suffix_len = (size_t)(nul - p);
+            path_len = name->len - strip_len + suffix_len;
+            if (reserve_index_name(name, path_len + 1) != 0) {
+                return -1;
+            }
+            memcpy(name->data + name->len - strip_len, p, suffix_len);
+            name->data[path_len] = '\0';
+            name->len = path_len;
+            path = (const unsigned char*)name->data;
+            p = nul + 1;
+        } else {
+            size_t entry_len;
+
+            nul = memchr(p, '\0', (size_t)(end - p));
+            if (!nul) {
+                return 0;
+            }
+            path = p;
+            path_len = (size_t)(nul - p);
+            /* v2/v3 entries are NUL-padded to a multiple of eight bytes. */
+            entry_len = ((size_t)(p - entry) + path_len + 8) & ~(size_t)7;
+            if ((size_t)(end - entry) < entry_len) {
+                return 0;
+            }
+            p = entry + entry_len;
+        }
+
+        if (path_len == 0 ||
+            (flag_name_len < GIT_INDEX_FLAG_NAME_MASK && flag_name_len != path_len)) {
+            return 0;
+        }
+
+        parsed.mode = read_be32(entry + 24);
+        if ((parsed.mode & GIT_INDEX_MODE_TYPE_MASK) == GIT_INDEX_MODE_DIRECTORY) {
+            /* Sparse-index directory entry: only git can expand it. */
+            return 0;
+        }
+        if (!fn) {
+            continue;
+        }
+        parsed.path = (const char*)path;
+        parsed.path_len = path_len;
+        parsed.mtime_sec = read_be32(entry + 8);
+        parsed.mtime_nsec = read_be32(entry + 12);
+        parsed.ino = read_be32(entry + 20);
+        parsed.size = read_be32(entry + 36);
+        parsed.stage = (flags & GIT_INDEX_FLAG_STAGE_MASK) >> 12;
+        if (fn(state, &parsed) != 0) {
+            return -1;
+        }
+    }
+
+    while (p < end) {
+        uint32_t extension_len;
+
+        if (end - p < 8) {
+            return 0;
+        }
+        /* Lower-case signatures (split "link", sparse "sdir") are mandatory. */
+        if (p[0] < 'A' || p[0] > 'Z') {
+            return 0;
+        }
+        extension_len = read_be32(p + 4);
+        p += 8;
+        if ((size_t)(end - p) < extension_len) {
+            return 0;
+        }
+        p += extension_len;
+    }
+
+    return 1;
+}
+
+int read_git_index(const char* index_path,
+                   size_t hash_size,
+                   GitIndexEntryFn fn,
+                   void* state,
+                   GitIndexResult* result) {
+    IndexNameBuffer name = {NULL, 0, 0};
+    struct stat st;
+    void* mapped;
+    int fd;
+    int walk_status;
+    int open_flags = O_RDONLY;
+
+    if (!index_path || !fn || !result) {
+        errno = EINVAL;
+        return -1;
+    }
+    *result = GIT_INDEX_UNSUPPORTED;
+
+#ifdef O_CLOEXEC
+    open_flags |= O_CLOEXEC;
+#endif
+    fd = open(index_path, open_flags);
+    if (fd == -1) {
+        if (errno == ENOENT) {
+            /* A repository without an index simply has nothing tracked yet. */
+            *result = GIT_INDEX_READ;
+            return 0;
+        }
+        return -1;
+    }
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return -1;
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+
+    mapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+
+    walk_status = walk_git_index(mapped, (size_t)st.st_size, hash_size, NULL, NULL, &name);
+    if (walk_status > 0) {
+        walk_status = walk_git_index(mapped, (size_t)st.st_size, hash_size, fn, state, &name);
+        if (walk_status > 0) {
+            *result = GIT_INDEX_READ;
+        }
+    }
+
+    free(name.data);
+    munmap(mapped, (size_t)st.st_size);
+    return (walk_status < 0) ? -1 : 0;
+}
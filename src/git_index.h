@@ -0,0 +1,52 @@
+#ifndef GIT_INDEX_H
+#define GIT_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GIT_INDEX_SHA1_HASH_SIZE 20
+#define GIT_INDEX_SHA256_HASH_SIZE 32
+
+/* Git's on-disk entry modes; the type bits match S_IFREG/S_IFLNK/S_IFDIR. */
+#define GIT_INDEX_MODE_TYPE_MASK 0170000U
+#define GIT_INDEX_MODE_REGULAR 0100000U
+#define GIT_INDEX_MODE_SYMLINK 0120000U
+#define GIT_INDEX_MODE_GITLINK 0160000U
+
+/*
+ * One index entry. path is repo-relative, NUL-terminated, and only valid for
+ * the duration of the callback (v4 entries are rebuilt in a shared buffer).
+ * The stat fields are git's cached, 32-bit truncated copies.
+ */
+typedef struct {
+    const char* path;
+    size_t path_len;
+    uint32_t mode;
+    uint32_t mtime_sec;
+    uint32_t mtime_nsec;
+    uint32_t ino;
+    uint32_t size;
+    unsigned stage;
+} GitIndexEntry;
+
+typedef int (*GitIndexEntryFn)(void* state, const GitIndexEntry* entry);
+
+typedef enum {
+    GIT_INDEX_READ = 0,
+    GIT_INDEX_UNSUPPORTED
+} GitIndexResult;
+
+/*
+ * Reads a DIRC index (versions 2-4) and calls fn for every entry in index
+ * order. A missing index reads as empty. Layouts this reader does not model
+ * (split or sparse indexes, unknown versions or required extensions,
+ * malformed data) set GIT_INDEX_UNSUPPORTED without calling fn so the
+ * caller can ask git instead. Returns -1 on I/O errors or when fn fails.
+ */
+int read_git_index(const char* index_path,
+                   size_t hash_size,
+                   GitIndexEntryFn fn,
+                   void* state,
+                   GitIndexResult* result);
+
+#endif
@@ -3,30 +3,60 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <libgen.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "git_index.h"
+
+extern char** environ;
+
 typedef enum {
     GIT_PROBE_READY = 0,
     GIT_PROBE_FALLBACK
 } GitProbeResult;
 
-#ifndef GIT_CAPTURE_MAX_BYTES
-#define GIT_CAPTURE_MAX_BYTES (64U * 1024U * 1024U)
+#ifndef GIT_STREAM_CHUNK_BYTES
+#define GIT_STREAM_CHUNK_BYTES (64U * 1024U)
 #endif
 
 #define GIT_SELECTION_ARGS_MAX 13
-#define GIT_HUNK_ARGS_MAX 13
+#define GIT_OBJECT_HEX_MAX (GIT_INDEX_SHA256_HASH_SIZE * 2)
+/* Longest cat-file header we accept: "<oid> <type> <size>". */
+#define GIT_BLOB_HEADER_MAX 128
 
 typedef struct {
     char* repo_root;
     char* prefix;
+    char* git_dir;     // Set by native discovery only; NULL when git resolved the repository.
+    size_t hash_size;  // Object id width used by git_dir's index.
 } GitRepoPaths;
 
+typedef enum {
+    GIT_DISCOVERY_FOUND = 0,
+    GIT_DISCOVERY_NOT_FOUND,
+    GIT_DISCOVERY_DEFER
+} GitDiscoveryResult;
+
+typedef enum {
+    GIT_REPO_CACHE_EMPTY = 0,
+    GIT_REPO_CACHE_READY,
+    GIT_REPO_CACHE_NOT_FOUND,
+    GIT_REPO_CACHE_NO_GIT
+} GitRepoCacheState;
+
+/* Repository probe result, resolved once per run and shared by every caller. */
+static GitRepoCacheState cached_repo_state = GIT_REPO_CACHE_EMPTY;
+static GitRepoPaths cached_repo = {NULL, NULL, NULL, 0};
+
 static int compare_selected_paths(const void* lhs, const void* rhs) {
     const SelectedPath* left = lhs;
     const SelectedPath* right = rhs;
@@ -57,23 +87,6 @@ static int compare_selected_paths(const void* lhs, const void* rhs) {
                   right->previous_repo_rel_path ? right->previous_repo_rel_path : "");
 }
 
-static int set_fd_cloexec(int fd) {
-    int flags;
-
-    if (fd < 0) {
-        errno = EINVAL;
-        return -1;
-    }
-    flags = fcntl(fd, F_GETFD);
-    if (flags == -1) {
-        return -1;
-    }
-    if (fcntl(fd, F_SETFD, flags | FD_CLOEXEC) == -1) {
-        return -1;
-    }
-    return 0;
-}
-
 void free_selected_paths(SelectedPath* paths, size_t count) {
     if (!paths) return;
     for (size_t i = 0; i < count; i++) {
@@ -82,6 +95,8 @@ void free_selected_paths(SelectedPath* paths, size_t count) {
         free(paths[i].repo_rel_path);
         free(paths[i].previous_display_path);
         free(paths[i].previous_repo_rel_path);
+        free(paths[i].blob_oid);
+        free(paths[i].base_oid);
     }
     free(paths);
 }
@@ -100,25 +115,31 @@ static int normalize_selected_paths(SelectedPath* paths, size_t* count) {
         qsort(paths, *count, sizeof(*paths), compare_selected_paths);
         size_t unique_count = 1;
         for (size_t i = 1; i < *count; i++) {
-            if (strcmp(paths[i - 1].open_path, paths[i].open_path) == 0 &&
-                strcmp(paths[i - 1].display_path, paths[i].display_path) == 0 &&
-                strcmp(paths[i - 1].repo_rel_path ? paths[i - 1].repo_rel_path : "",
+            /* Compare against the last kept entry; paths[i - 1] may be a freed duplicate. */
+            const SelectedPath* kept = &paths[unique_count - 1];
+            if (strcmp(kept->open_path, paths[i].open_path) == 0 &&
+                strcmp(kept->display_path, paths[i].display_path) == 0 &&
+                strcmp(kept->repo_rel_path ? kept->repo_rel_path : "",
                        paths[i].repo_rel_path ? paths[i].repo_rel_path : "") == 0 &&
-                paths[i - 1].change_type == paths[i].change_type &&
-                strcmp(paths[i - 1].previous_display_path ? paths[i - 1].previous_display_path : "",
+                kept->change_type == paths[i].change_type &&
+                strcmp(kept->previous_display_path ? kept->previous_display_path : "",
                        paths[i].previous_display_path ? paths[i].previous_display_path : "") == 0 &&
-                strcmp(paths[i - 1].previous_repo_rel_path ? paths[i - 1].previous_repo_rel_path : "",
+                strcmp(kept->previous_repo_rel_path ? kept->previous_repo_rel_path : "",
                        paths[i].previous_repo_rel_path ? paths[i].previous_repo_rel_path : "") == 0) {
                 free(paths[i].open_path);
                 free(paths[i].display_path);
                 free(paths[i].repo_rel_path);
                 free(paths[i].previous_display_path);
                 free(paths[i].previous_repo_rel_path);
+                free(paths[i].blob_oid);
+                free(paths[i].base_oid);
                 paths[i].open_path = NULL;
                 paths[i].display_path = NULL;
                 paths[i].repo_rel_path = NULL;
                 paths[i].previous_display_path = NULL;
                 paths[i].previous_repo_rel_path = NULL;
+                paths[i].blob_oid = NULL;
+                paths[i].base_oid = NULL;
                 continue;
             }
             if (unique_count != i) {
@@ -128,6 +149,8 @@ static int normalize_selected_paths(SelectedPath* paths, size_t* count) {
                 paths[i].repo_rel_path = NULL;
                 paths[i].previous_display_path = NULL;
                 paths[i].previous_repo_rel_path = NULL;
+                paths[i].blob_oid = NULL;
+                paths[i].base_oid = NULL;
             }
             unique_count++;
         }
@@ -137,99 +160,275 @@ static int normalize_selected_paths(SelectedPath* paths, size_t* count) {
     return 0;
 }
 
-static int run_command_capture(const char* const argv[],
-                               int suppress_stderr,
-                               unsigned char** output,
-                               size_t* output_len,
-                               int* exit_status,
-                               int* exec_errno) {
-    int stdout_pipe[2];
-    int error_pipe[2];
-    pid_t pid;
-    unsigned char* buffer = NULL;
-    size_t used = 0;
-    size_t capacity = 0;
-    int status = -1;
+/* Receives git's stdout as it arrives; a non-zero return aborts the read. */
+typedef int (*GitOutputFn)(void* state, const unsigned char* data, size_t len);
 
-    *output = NULL;
-    *output_len = 0;
-    *exit_status = -1;
-    *exec_errno = 0;
+/* Receives one record without its delimiter. Records split by NUL are
+ * NUL-terminated in memory; terminated is 0 only for a trailing record that
+ * git did not finish with the delimiter. */
+typedef int (*GitRecordFn)(void* state, const char* record, size_t record_len, int terminated);
 
-    if (pipe(stdout_pipe) == -1) {
-        return -1;
-    }
-    if (pipe(error_pipe) == -1) {
-        close(stdout_pipe[0]);
-        close(stdout_pipe[1]);
+/* Reassembles records that straddle pipe reads, so parsers only ever hold
+ * the one partial record rather than the whole command output. The first
+ * parser error is latched and the rest of the stream is discarded, letting
+ * the caller still judge git's exit status before reporting it. */
+typedef struct {
+    char delimiter;
+    GitRecordFn on_record;
+    void* state;
+    char* pending;
+    size_t pending_len;
+    size_t pending_capacity;
+    int failed;
+    int failed_errno;
+} GitRecordSplitter;
+
+static void init_git_record_splitter(GitRecordSplitter* splitter,
+                                     char delimiter,
+                                     GitRecordFn on_record,
+                                     void* state) {
+    memset(splitter, 0, sizeof(*splitter));
+    splitter->delimiter = delimiter;
+    splitter->on_record = on_record;
+    splitter->state = state;
+}
+
+static void free_git_record_splitter(GitRecordSplitter* splitter) {
+    free(splitter->pending);
+    splitter->pending = NULL;
+    splitter->pending_len = 0;
+    splitter->pending_capacity = 0;
+}
+
+static int append_pending_record(GitRecordSplitter* splitter, const unsigned char* data, size_t len) {
+    size_t needed = splitter->pending_len + len + 1;
+
+    if (needed < splitter->pending_len) {
+        errno = EOVERFLOW;
         return -1;
     }
-    if (set_fd_cloexec(stdout_pipe[0]) == -1 ||
-        set_fd_cloexec(stdout_pipe[1]) == -1 ||
-        set_fd_cloexec(error_pipe[0]) == -1 ||
-        set_fd_cloexec(error_pipe[1]) == -1) {
-        close(stdout_pipe[0]);
-        close(stdout_pipe[1]);
-        close(error_pipe[0]);
-        close(error_pipe[1]);
-        return -1;
+    if (needed > splitter->pending_capacity) {
+        size_t new_capacity = (splitter->pending_capacity == 0) ? 256 : splitter->pending_capacity;
+        char* new_pending;
+
+        while (new_capacity < needed) {
+            if (new_capacity > SIZE_MAX / 2) {
+                new_capacity = needed;
+                break;
+            }
+            new_capacity *= 2;
+        }
+        new_pending = realloc(splitter->pending, new_capacity);
+        if (!new_pending) {
+            return -1;
+        }
+        splitter->pending = new_pending;
+        splitter->pending_capacity = new_capacity;
     }
+    memcpy(splitter->pending + splitter->pending_len, data, len);
+    splitter->pending_len += len;
+    splitter->pending[splitter->pending_len] = '\0';
+    return 0;
+}
 
-    pid = fork();
-    if (pid == -1) {
-        close(stdout_pipe[0]);
-        close(stdout_pipe[1]);
-        close(error_pipe[0]);
-        close(error_pipe[1]);
-        return -1;
+static void latch_git_record_failure(GitRecordSplitter* splitter) {
+    splitter->failed = 1;
+    splitter->failed_errno = errno;
+    free_git_record_splitter(splitter);
+}
+
+static int feed_git_record_splitter(void* state, const unsigned char* data, size_t len) {
+    GitRecordSplitter* splitter = state;
+    size_t start = 0;
+
+    if (splitter->failed) {
+        return 0;
     }
 
-    if (pid == 0) {
-        int child_errno;
-        int null_fd = -1;
-        size_t argc = 0;
-        close(stdout_pipe[0]);
-        close(error_pipe[0]);
+    while (start < len) {
+        const unsigned char* delim = memchr(data + start, (unsigned char)splitter->delimiter, len - start);
+        size_t end;
 
-        if (dup2(stdout_pipe[1], STDOUT_FILENO) == -1) {
-            child_errno = errno;
-            write(error_pipe[1], &child_errno, sizeof(child_errno));
-            _exit(127);
+        if (!delim) {
+            if (append_pending_record(splitter, data + start, len - start) != 0) {
+                latch_git_record_failure(splitter);
+            }
+            return 0;
         }
+        end = (size_t)(delim - data);
 
-        if (suppress_stderr) {
-            null_fd = open("/dev/null", O_WRONLY);
-            if (null_fd == -1 || dup2(null_fd, STDERR_FILENO) == -1) {
-                child_errno = errno;
-                write(error_pipe[1], &child_errno, sizeof(child_errno));
-                if (null_fd != -1) {
-                    close(null_fd);
-                }
-                _exit(127);
+        if (splitter->pending_len > 0) {
+            if (append_pending_record(splitter, data + start, end - start) != 0 ||
+                splitter->on_record(splitter->state, splitter->pending, splitter->pending_len, 1) != 0) {
+                latch_git_record_failure(splitter);
+                return 0;
             }
-            close(null_fd);
+            splitter->pending_len = 0;
+        } else if (splitter->on_record(splitter->state, (const char*)(data + start), end - start, 1) != 0) {
+            latch_git_record_failure(splitter);
+            return 0;
         }
+        start = end + 1;
+    }
+    return 0;
+}
 
-        close(stdout_pipe[1]);
-        while (argv[argc] != NULL) {
-            argc++;
+/* Flushes a trailing unterminated record and reports any latched failure. */
+static int finish_git_record_splitter(GitRecordSplitter* splitter) {
+    if (!splitter->failed && splitter->pending_len > 0) {
+        if (splitter->on_record(splitter->state, splitter->pending, splitter->pending_len, 0) != 0) {
+            latch_git_record_failure(splitter);
+        }
+        splitter->pending_len = 0;
+    }
+    if (splitter->failed) {
+        errno = splitter->failed_errno;
+        return -1;
+    }
+    return 0;
+}
+
+static int set_fd_cloexec(int fd) {
+    int flags;
+
+    if (fd < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    flags = fcntl(fd, F_GETFD);
+    if (flags == -1) {
+        return -1;
+    }
+    if (fcntl(fd, F_SETFD, flags | FD_CLOEXEC) == -1) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Both ends are close-on-exec, so a child only keeps the end it is handed as
+ * stdin or stdout. Otherwise a later child (cat-file, started while a listing
+ * is still streaming) would hold the listing's read end, and git would never
+ * see SIGPIPE once the exporter stops reading. */
+static int open_cloexec_pipe(int fds[2]) {
+    if (pipe(fds) == -1) {
+        return -1;
+    }
+    if (set_fd_cloexec(fds[0]) == -1 || set_fd_cloexec(fds[1]) == -1) {
+        int saved_errno = errno;
+        close(fds[0]);
+        close(fds[1]);
+        fds[0] = -1;
+        fds[1] = -1;
+        errno = saved_errno;
+        return -1;
+    }
+    return 0;
+}
+
+/* Starts argv[0] from PATH with stdin (unless stdin_fd is -1) and stdout
+ * wired to the given pipe ends. posix_spawnp avoids duplicating the
+ * exporter's address space (glibc uses a CLONE_VM|CLONE_VFORK child), so
+ * spawn cost does not grow with the buffers already held, and it returns the
+ * child's exec errno directly. Setup failures return -1 with errno; a command
+ * that could not be started returns 0 with *exec_errno set. parent_fds are
+ * the caller's ends of the same pipes, closed in the child. */
+static int spawn_command(const char* const argv[],
+                         int stdin_fd,
+                         int stdout_fd,
+                         const int* parent_fds,
+                         size_t parent_fd_count,
+                         int suppress_stderr,
+                         pid_t* pid_out,
+                         int* exec_errno) {
+    posix_spawn_file_actions_t actions;
+    size_t argc = 0;
+    int spawn_status;
+
+    *exec_errno = 0;
+    spawn_status = posix_spawn_file_actions_init(&actions);
+    if (spawn_status != 0) {
+        errno = spawn_status;
+        return -1;
+    }
+    for (size_t i = 0; spawn_status == 0 && i < parent_fd_count; i++) {
+        spawn_status = posix_spawn_file_actions_addclose(&actions, parent_fds[i]);
+    }
+    if (spawn_status == 0 && stdin_fd != -1) {
+        spawn_status = posix_spawn_file_actions_adddup2(&actions, stdin_fd, STDIN_FILENO);
+        if (spawn_status == 0) {
+            spawn_status = posix_spawn_file_actions_addclose(&actions, stdin_fd);
         }
+    }
+    if (spawn_status == 0) {
+        spawn_status = posix_spawn_file_actions_adddup2(&actions, stdout_fd, STDOUT_FILENO);
+    }
+    if (spawn_status == 0) {
+        spawn_status = posix_spawn_file_actions_addclose(&actions, stdout_fd);
+    }
+    if (spawn_status == 0 && suppress_stderr) {
+        spawn_status = posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    }
+    if (spawn_status != 0) {
+        posix_spawn_file_actions_destroy(&actions);
+        errno = spawn_status;
+        return -1;
+    }
+
+    while (argv[argc] != NULL) {
+        argc++;
+    }
+    {
         char* argv_mut[argc + 1];
         memcpy(argv_mut, argv, (argc + 1) * sizeof(*argv_mut));
-        execvp(argv_mut[0], argv_mut);
+        spawn_status = posix_spawnp(pid_out, argv_mut[0], &actions, NULL, argv_mut, environ);
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    /* The command never ran; callers report it like a failed exec. */
+    *exec_errno = spawn_status;
+    return 0;
+}
+
+/* Launches argv[0] from PATH and streams its stdout to on_output; a spawn
+ * failure is passed back in exec_errno. */
+static int run_command_stream(const char* const argv[],
+                              int suppress_stderr,
+                              GitOutputFn on_output,
+                              void* state,
+                              int* exit_status,
+                              int* exec_errno) {
+    int stdout_pipe[2];
+    pid_t pid;
+    unsigned char* chunk = NULL;
+    int status = -1;
+
+    *exit_status = -1;
+    *exec_errno = 0;
 
-        child_errno = errno;
-        write(error_pipe[1], &child_errno, sizeof(child_errno));
-        close(error_pipe[1]);
-        _exit(127);
+    chunk = malloc(GIT_STREAM_CHUNK_BYTES);
+    if (!chunk) {
+        return -1;
+    }
+    if (open_cloexec_pipe(stdout_pipe) == -1) {
+        free(chunk);
+        return -1;
     }
 
+    if (spawn_command(argv, -1, stdout_pipe[1], &stdout_pipe[0], 1, suppress_stderr, &pid, exec_errno) != 0) {
+        close(stdout_pipe[0]);
+        close(stdout_pipe[1]);
+        free(chunk);
+        return -1;
+    }
     close(stdout_pipe[1]);
-    close(error_pipe[1]);
+
+    if (*exec_errno != 0) {
+        close(stdout_pipe[0]);
+        free(chunk);
+        return 0;
+    }
 
     while (1) {
-        unsigned char chunk[4096];
-        ssize_t read_len = read(stdout_pipe[0], chunk, sizeof(chunk));
+        ssize_t read_len = read(stdout_pipe[0], chunk, GIT_STREAM_CHUNK_BYTES);
         if (read_len == 0) {
             break;
         }
@@ -239,47 +438,9 @@ static int run_command_capture(const char* const argv[],
             }
             goto cleanup;
         }
-        if ((size_t)read_len > GIT_CAPTURE_MAX_BYTES ||
-            used > GIT_CAPTURE_MAX_BYTES - (size_t)read_len) {
-            errno = EFBIG;
-            goto cleanup;
-        }
-        if (used + (size_t)read_len < used) {
-            errno = EOVERFLOW;
-            goto cleanup;
-        }
-        if (used + (size_t)read_len > capacity) {
-            size_t new_capacity = (capacity == 0) ? 65536 : capacity;
-            while (new_capacity < used + (size_t)read_len) {
-                if (new_capacity > SIZE_MAX / 2) {
-                    new_capacity = used + (size_t)read_len;
-                    break;
-                }
-                new_capacity *= 2;
-            }
-            unsigned char* new_buffer = realloc(buffer, new_capacity);
-            if (!new_buffer) {
-                goto cleanup;
-            }
-            buffer = new_buffer;
-            capacity = new_capacity;
-        }
-        memcpy(buffer + used, chunk, (size_t)read_len);
-        used += (size_t)read_len;
-    }
-
-    while (1) {
-        ssize_t error_len = read(error_pipe[0], exec_errno, sizeof(*exec_errno));
-        if (error_len == 0) {
-            break;
-        }
-        if (error_len < 0) {
-            if (errno == EINTR) {
-                continue;
-            }
+        if (on_output(state, chunk, (size_t)read_len) != 0) {
             goto cleanup;
         }
-        break;
     }
 
     while (waitpid(pid, exit_status, 0) == -1) {
@@ -288,18 +449,77 @@ static int run_command_capture(const char* const argv[],
         }
     }
 
-    *output = buffer;
-    *output_len = used;
     status = 0;
-    buffer = NULL;
 
 cleanup:
-    free(buffer);
+    free(chunk);
     close(stdout_pipe[0]);
-    close(error_pipe[0]);
+    if (status != 0) {
+        /* Reap the child after closing its pipe so a failed capture leaves no zombie. */
+        int saved_errno = errno;
+        while (waitpid(pid, exit_status, 0) == -1 && errno == EINTR) {
+        }
+        errno = saved_errno;
+    }
     return status;
 }
 
+typedef struct {
+    unsigned char* buffer;
+    size_t used;
+    size_t capacity;
+} GitCaptureBuffer;
+
+static int append_git_capture(void* state, const unsigned char* data, size_t len) {
+    GitCaptureBuffer* capture = state;
+
+    if (capture->used + len < capture->used) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    if (capture->used + len > capture->capacity) {
+        size_t new_capacity = (capture->capacity == 0) ? 256 : capture->capacity;
+        unsigned char* new_buffer;
+
+        while (new_capacity < capture->used + len) {
+            if (new_capacity > SIZE_MAX / 2) {
+                new_capacity = capture->used + len;
+                break;
+            }
+            new_capacity *= 2;
+        }
+        new_buffer = realloc(capture->buffer, new_capacity);
+        if (!new_buffer) {
+            return -1;
+        }
+        capture->buffer = new_buffer;
+        capture->capacity = new_capacity;
+    }
+    memcpy(capture->buffer + capture->used, data, len);
+    capture->used += len;
+    return 0;
+}
+
+/* Collects a command's whole stdout; only for short outputs like rev-parse. */
+static int run_command_capture(const char* const argv[],
+                               int suppress_stderr,
+                               unsigned char** output,
+                               size_t* output_len,
+                               int* exit_status,
+                               int* exec_errno) {
+    GitCaptureBuffer capture = {NULL, 0, 0};
+
+    *output = NULL;
+    *output_len = 0;
+    if (run_command_stream(argv, suppress_stderr, append_git_capture, &capture, exit_status, exec_errno) != 0) {
+        free(capture.buffer);
+        return -1;
+    }
+    *output = capture.buffer;
+    *output_len = capture.used;
+    return 0;
+}
+
 static int capture_git_line(const char* repo_root,
                             const char* rev_parse_arg,
                             int quiet_probe,
@@ -368,85 +588,518 @@ static void free_git_repo_paths(GitRepoPaths* repo) {
     }
     free(repo->repo_root);
     free(repo->prefix);
+    free(repo->git_dir);
     repo->repo_root = NULL;
     repo->prefix = NULL;
+    repo->git_dir = NULL;
+    repo->hash_size = 0;
 }
 
-static int capture_git_repo_root(int quiet_probe, char** repo_root_out, GitProbeResult* probe_result) {
-    return capture_git_line(".", "--show-toplevel", quiet_probe, repo_root_out, probe_result);
-}
-
-static int load_git_repo_paths(int quiet_probe, GitRepoPaths* repo, GitProbeResult* probe_result) {
-    if (!repo) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    repo->repo_root = NULL;
-    repo->prefix = NULL;
+static int join_path(const char* dir, const char* name, char* buffer, size_t buffer_size) {
+    int written;
 
-    if (capture_git_repo_root(quiet_probe, &repo->repo_root, probe_result) != 0) {
-        return -1;
+    if (strcmp(dir, "/") == 0) {
+        written = snprintf(buffer, buffer_size, "/%s", name);
+    } else {
+        written = snprintf(buffer, buffer_size, "%s/%s", dir, name);
     }
-    if (capture_git_line(".", "--show-prefix", quiet_probe, &repo->prefix, probe_result) != 0) {
-        free_git_repo_paths(repo);
+    if (written < 0 || (size_t)written >= buffer_size) {
+        errno = ENAMETOOLONG;
         return -1;
     }
-
     return 0;
 }
 
-static int copy_path_basename(const char* path, char* buffer, size_t buffer_size) {
-    char path_copy[MAX_PATH_LENGTH];
-    size_t path_len;
-    char* base;
-
-    if (!path || !buffer || buffer_size == 0) {
-        errno = EINVAL;
-        return -1;
-    }
+static int path_has_type(const char* dir, const char* name, mode_t type) {
+    char path[MAX_PATH_LENGTH];
+    struct stat st;
 
-    path_len = strlen(path);
-    if (path_len >= sizeof(path_copy)) {
-        errno = ENAMETOOLONG;
-        return -1;
+    if (join_path(dir, name, path, sizeof(path)) != 0 || stat(path, &st) != 0) {
+        return 0;
     }
-    memcpy(path_copy, path, path_len + 1);
+    return (st.st_mode & S_IFMT) == type;
+}
 
-    base = basename(path_copy);
-    if (!base || base[0] == '\0') {
-        errno = EINVAL;
-        return -1;
+/* Mirrors git's is_git_directory(): HEAD plus objects/ and refs/, either
+ * local or shared through a commondir file (linked worktrees). */
+static int is_git_directory(const char* dir) {
+    if (!path_has_type(dir, "HEAD", S_IFREG)) {
+        return 0;
     }
-    if (snprintf(buffer, buffer_size, "%s", base) < 0 || strlen(base) >= buffer_size) {
-        errno = ENAMETOOLONG;
-        return -1;
+    if (path_has_type(dir, "commondir", S_IFREG)) {
+        return 1;
     }
-
-    return 0;
+    return path_has_type(dir, "objects", S_IFDIR) && path_has_type(dir, "refs", S_IFDIR);
 }
 
-static int append_selected_path(SelectedPath** paths,
-                                size_t* count,
-                                size_t* capacity,
-                                const char* repo_root,
-                                size_t repo_root_len,
-                                const char* prefix,
-                                size_t prefix_len,
-                                const char* repo_rel,
-                                size_t repo_rel_len,
-                                SelectedPathChangeType change_type,
-                                const char* previous_repo_rel) {
-    const char* display_rel = repo_rel;
-    const char* previous_display_rel = previous_repo_rel;
-    if (prefix_len > 0 &&
-        strncmp(repo_rel, prefix, prefix_len) == 0) {
-        display_rel = repo_rel + prefix_len;
+static int config_value_is_true(const char* key_line) {
+    const char* value = strchr(key_line, '=');
+
+    if (!value) {
+        return 1;
     }
-    if (previous_repo_rel &&
-        prefix_len > 0 &&
-        strncmp(previous_repo_rel, prefix, prefix_len) == 0) {
-        previous_display_rel = previous_repo_rel + prefix_len;
+    value++;
+    while (*value == ' ' || *value == '\t') {
+        value++;
+    }
+    return strcasecmp(value, "false") != 0 && strcasecmp(value, "no") != 0 &&
+           strcasecmp(value, "off") != 0 && strcmp(value, "0") != 0;
+}
+
+static int config_key_is(const char* line, const char* key) {
+    size_t key_len = strlen(key);
+
+    return strncasecmp(line, key, key_len) == 0 &&
+           (line[key_len] == '\0' || line[key_len] == ' ' || line[key_len] == '\t' || line[key_len] == '=');
+}
+
+/* The few config facts discovery depends on; anything it cannot read as
+ * plainly as git would sets needs_git so git resolves the repository. */
+typedef struct {
+    int needs_git;
+    size_t hash_size;
+} GitConfigFacts;
+
+static void scan_git_config(const char* config_dir, int read_core, GitConfigFacts* facts) {
+    char path[MAX_PATH_LENGTH];
+    FILE* file;
+    char* line = NULL;
+    size_t line_cap = 0;
+    enum { SECTION_OTHER, SECTION_CORE, SECTION_EXTENSIONS } section = SECTION_OTHER;
+
+    if (join_path(config_dir, "config", path, sizeof(path)) != 0) {
+        facts->needs_git = 1;
+        return;
+    }
+    file = fopen(path, "r");
+    if (!file) {
+        if (errno != ENOENT) {
+            facts->needs_git = 1;
+        }
+        return;
+    }
+
+    while (!facts->needs_git && getline(&line, &line_cap, file) != -1) {
+        char* cursor = line;
+        char* end;
+
+        while (*cursor == ' ' || *cursor == '\t') {
+            cursor++;
+        }
+        end = cursor + strlen(cursor);
+        while (end > cursor && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) {
+            *--end = '\0';
+        }
+        if (*cursor == '[') {
+            if (strcasecmp(cursor, "[core]") == 0) {
+                section = SECTION_CORE;
+            } else if (strcasecmp(cursor, "[extensions]") == 0) {
+                section = SECTION_EXTENSIONS;
+            } else {
+                section = SECTION_OTHER;
+            }
+            continue;
+        }
+        if (section == SECTION_CORE && read_core) {
+            /* core.worktree or core.bare = true move or remove the work tree. */
+            if (config_key_is(cursor, "worktree") ||
+                (config_key_is(cursor, "bare") && config_value_is_true(cursor))) {
+                facts->needs_git = 1;
+            }
+        } else if (section == SECTION_EXTENSIONS && config_key_is(cursor, "objectformat")) {
+            const char* value = strchr(cursor, '=');
+
+            value = value ? value + 1 : "";
+            while (*value == ' ' || *value == '\t') {
+                value++;
+            }
+            if (strcasecmp(value, "sha256") == 0) {
+                facts->hash_size = GIT_INDEX_SHA256_HASH_SIZE;
+            } else if (strcasecmp(value, "sha1") != 0) {
+                facts->needs_git = 1;
+            }
+        }
+    }
+
+    free(line);
+    fclose(file);
+}
+
+/* Reads the config that governs git_dir. Linked worktrees keep theirs in the
+ * common directory and ignore its core.worktree and core.bare. */
+static void load_git_config_facts(const char* git_dir, GitConfigFacts* facts) {
+    char commondir_path[MAX_PATH_LENGTH];
+    char common_dir[MAX_PATH_LENGTH];
+    FILE* file;
+    char* line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len;
+
+    facts->needs_git = 0;
+    facts->hash_size = GIT_INDEX_SHA1_HASH_SIZE;
+
+    if (!path_has_type(git_dir, "commondir", S_IFREG)) {
+        scan_git_config(git_dir, 1, facts);
+        return;
+    }
+
+    if (join_path(git_dir, "commondir", commondir_path, sizeof(commondir_path)) != 0 ||
+        !(file = fopen(commondir_path, "r"))) {
+        facts->needs_git = 1;
+        return;
+    }
+    line_len = getline(&line, &line_cap, file);
+    fclose(file);
+    while (line_len > 0 && (line[line_len - 1] == '\n' || line[line_len - 1] == '\r')) {
+        line[--line_len] = '\0';
+    }
+    if (line_len <= 0) {
+        free(line);
+        facts->needs_git = 1;
+        return;
+    }
+    if (line[0] == '/') {
+        if ((size_t)line_len >= sizeof(common_dir)) {
+            free(line);
+            facts->needs_git = 1;
+            return;
+        }
+        memcpy(common_dir, line, (size_t)line_len + 1);
+    } else if (join_path(git_dir, line, common_dir, sizeof(common_dir)) != 0) {
+        free(line);
+        facts->needs_git = 1;
+        return;
+    }
+    free(line);
+    scan_git_config(common_dir, 0, facts);
+}
+
+/* Resolves a "gitdir: <path>" file into the git directory it points to. */
+static int read_gitdir_file(const char* dir, const char* dotgit_path, char* git_dir, size_t git_dir_size) {
+    FILE* file;
+    char* line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len;
+    const char* target;
+    int status = -1;
+
+    file = fopen(dotgit_path, "r");
+    if (!file) {
+        return -1;
+    }
+    line_len = getline(&line, &line_cap, file);
+    fclose(file);
+    if (line_len <= 0) {
+        free(line);
+        errno = EINVAL;
+        return -1;
+    }
+    while (line_len > 0 && (line[line_len - 1] == '\n' || line[line_len - 1] == '\r')) {
+        line[--line_len] = '\0';
+    }
+    if (strncmp(line, "gitdir: ", 8) != 0 || line[8] == '\0') {
+        free(line);
+        errno = EINVAL;
+        return -1;
+    }
+
+    target = line + 8;
+    if (target[0] == '/') {
+        if (snprintf(git_dir, git_dir_size, "%s", target) < 0 || strlen(target) >= git_dir_size) {
+            errno = ENAMETOOLONG;
+        } else {
+            status = 0;
+        }
+    } else {
+        status = join_path(dir, target, git_dir, git_dir_size);
+    }
+
+    free(line);
+    return status;
+}
+
+static int owned_by_current_user(const char* path) {
+    struct stat st;
+
+    return stat(path, &st) == 0 && st.st_uid == geteuid();
+}
+
+/* Walks up from the working directory the way git's setup does and returns
+ * the work tree root and the cwd prefix inside it. Anything git would
+ * resolve through state we do not model (GIT_* overrides, mount crossings,
+ * config-relocated work trees, foreign ownership) is left to git itself. */
+static int discover_git_repo(GitRepoPaths* repo, GitDiscoveryResult* result) {
+    static const char* const override_env[] = {
+        "GIT_DIR",
+        "GIT_WORK_TREE",
+        "GIT_COMMON_DIR",
+        "GIT_CEILING_DIRECTORIES",
+        "GIT_DISCOVERY_ACROSS_FILESYSTEM",
+        "GIT_INDEX_FILE",
+        NULL
+    };
+    char cwd[MAX_PATH_LENGTH];
+    char dir[MAX_PATH_LENGTH];
+    char dotgit[MAX_PATH_LENGTH];
+    char git_dir[MAX_PATH_LENGTH];
+    struct stat cwd_st;
+    GitConfigFacts config;
+    size_t root_len;
+    const char* rest;
+
+    *result = GIT_DISCOVERY_DEFER;
+    for (size_t i = 0; override_env[i] != NULL; i++) {
+        if (getenv(override_env[i]) != NULL) {
+            return 0;
+        }
+    }
+
+    if (!getcwd(cwd, sizeof(cwd)) || cwd[0] != '/' || stat(cwd, &cwd_st) != 0) {
+        return 0;
+    }
+    memcpy(dir, cwd, strlen(cwd) + 1);
+
+    while (1) {
+        struct stat st;
+        char* slash;
+
+        if (join_path(dir, ".git", dotgit, sizeof(dotgit)) != 0) {
+            return 0;
+        }
+        if (stat(dotgit, &st) == 0) {
+            if (S_ISDIR(st.st_mode) && is_git_directory(dotgit)) {
+                memcpy(git_dir, dotgit, strlen(dotgit) + 1);
+                break;
+            }
+            if (S_ISREG(st.st_mode)) {
+                if (read_gitdir_file(dir, dotgit, git_dir, sizeof(git_dir)) != 0 || !is_git_directory(git_dir)) {
+                    return 0;
+                }
+                break;
+            }
+        }
+        if (is_git_directory(dir)) {
+            /* Inside a git directory or bare repository: no work tree to report. */
+            return 0;
+        }
+
+        if (strcmp(dir, "/") == 0) {
+            *result = GIT_DISCOVERY_NOT_FOUND;
+            return 0;
+        }
+        slash = strrchr(dir, '/');
+        if (slash == dir) {
+            dir[1] = '\0';
+        } else {
+            *slash = '\0';
+        }
+        if (stat(dir, &st) != 0 || st.st_dev != cwd_st.st_dev) {
+            return 0;
+        }
+    }
+
+    load_git_config_facts(git_dir, &config);
+    if (config.needs_git || !owned_by_current_user(dir) || !owned_by_current_user(git_dir)) {
+        return 0;
+    }
+
+    root_len = strlen(dir);
+    rest = cwd + root_len;
+    while (*rest == '/') {
+        rest++;
+    }
+    repo->repo_root = strdup(dir);
+    repo->prefix = malloc(strlen(rest) + 2);
+    repo->git_dir = strdup(git_dir);
+    repo->hash_size = config.hash_size;
+    if (!repo->repo_root || !repo->prefix || !repo->git_dir) {
+        free_git_repo_paths(repo);
+        return -1;
+    }
+    if (*rest == '\0') {
+        repo->prefix[0] = '\0';
+    } else {
+        sprintf(repo->prefix, "%s/", rest);
+    }
+
+    *result = GIT_DISCOVERY_FOUND;
+    return 0;
+}
+
+/* Native discovery only decides where the repository is; the ls-files and
+ * diff work still needs a git binary, so check PATH the way execvp would. */
+static int git_executable_available(void) {
+    const char* path_env = getenv("PATH");
+    const char* cursor;
+
+    if (!path_env) {
+        path_env = "/bin:/usr/bin";
+    }
+
+    cursor = path_env;
+    while (1) {
+        const char* sep = strchr(cursor, ':');
+        size_t dir_len = sep ? (size_t)(sep - cursor) : strlen(cursor);
+        char candidate[MAX_PATH_LENGTH];
+        int written;
+
+        if (dir_len == 0) {
+            written = snprintf(candidate, sizeof(candidate), "git");
+        } else {
+            written = snprintf(candidate, sizeof(candidate), "%.*s/git", (int)dir_len, cursor);
+        }
+        if (written > 0 && (size_t)written < sizeof(candidate) && access(candidate, X_OK) == 0) {
+            struct stat st;
+            if (stat(candidate, &st) == 0 && S_ISREG(st.st_mode)) {
+                return 1;
+            }
+        }
+        if (!sep) {
+            return 0;
+        }
+        cursor = sep + 1;
+    }
+}
+
+/* Fills the per-run repository cache on first use. Returns 0 when a work
+ * tree was found; otherwise -1 with probe_result/errno set as the former
+ * rev-parse probe did (errno ENOENT when git itself is missing). */
+static int probe_git_repo(int quiet_probe, GitProbeResult* probe_result) {
+    if (probe_result) {
+        *probe_result = GIT_PROBE_READY;
+    }
+
+    if (cached_repo_state == GIT_REPO_CACHE_EMPTY) {
+        GitRepoPaths found = {NULL, NULL, NULL, 0};
+        GitDiscoveryResult discovery = GIT_DISCOVERY_DEFER;
+
+        if (discover_git_repo(&found, &discovery) != 0) {
+            return -1;
+        }
+        if (discovery == GIT_DISCOVERY_DEFER) {
+            if (capture_git_line(".", "--show-toplevel", quiet_probe, &found.repo_root, probe_result) != 0) {
+                return -1;
+            }
+            if (capture_git_line(".", "--show-prefix", quiet_probe, &found.prefix, probe_result) != 0) {
+                free_git_repo_paths(&found);
+                return -1;
+            }
+            cached_repo = found;
+            cached_repo_state = GIT_REPO_CACHE_READY;
+        } else if (discovery == GIT_DISCOVERY_NOT_FOUND) {
+            cached_repo_state = GIT_REPO_CACHE_NOT_FOUND;
+        } else if (!git_executable_available()) {
+            free_git_repo_paths(&found);
+            cached_repo_state = GIT_REPO_CACHE_NO_GIT;
+        } else {
+            cached_repo = found;
+            cached_repo_state = GIT_REPO_CACHE_READY;
+        }
+    }
+
+    switch (cached_repo_state) {
+        case GIT_REPO_CACHE_READY:
+            return 0;
+        case GIT_REPO_CACHE_NO_GIT:
+            errno = ENOENT;
+            if (quiet_probe) {
+                if (probe_result) {
+                    *probe_result = GIT_PROBE_FALLBACK;
+                }
+            } else {
+                perror("Error executing git");
+            }
+            errno = ENOENT;
+            return -1;
+        case GIT_REPO_CACHE_NOT_FOUND:
+        case GIT_REPO_CACHE_EMPTY:
+        default:
+            errno = 0;
+            if (quiet_probe && probe_result) {
+                *probe_result = GIT_PROBE_FALLBACK;
+            }
+            return -1;
+    }
+}
+
+static int load_git_repo_paths(int quiet_probe, GitRepoPaths* repo, GitProbeResult* probe_result) {
+    if (!repo) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    repo->repo_root = NULL;
+    repo->prefix = NULL;
+    repo->git_dir = NULL;
+    repo->hash_size = 0;
+
+    if (probe_git_repo(quiet_probe, probe_result) != 0) {
+        return -1;
+    }
+
+    repo->repo_root = strdup(cached_repo.repo_root);
+    repo->prefix = strdup(cached_repo.prefix);
+    repo->git_dir = cached_repo.git_dir ? strdup(cached_repo.git_dir) : NULL;
+    repo->hash_size = cached_repo.hash_size;
+    if (!repo->repo_root || !repo->prefix || (cached_repo.git_dir && !repo->git_dir)) {
+        free_git_repo_paths(repo);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int copy_path_basename(const char* path, char* buffer, size_t buffer_size) {
+    char path_copy[MAX_PATH_LENGTH];
+    size_t path_len;
+    char* base;
+
+    if (!path || !buffer || buffer_size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    path_len = strlen(path);
+    if (path_len >= sizeof(path_copy)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memcpy(path_copy, path, path_len + 1);
+
+    base = basename(path_copy);
+    if (!base || base[0] == '\0') {
+        errno = EINVAL;
+        return -1;
+    }
+    if (snprintf(buffer, buffer_size, "%s", base) < 0 || strlen(base) >= buffer_size) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    return 0;
+}
+
+static int append_selected_path(SelectedPath** paths,
+                                size_t* count,
+                                size_t* capacity,
+                                const char* repo_root,
+                                size_t repo_root_len,
+                                const char* prefix,
+                                size_t prefix_len,
+                                const char* repo_rel,
+                                size_t repo_rel_len,
+                                SelectedPathChangeType change_type,
+                                const char* previous_repo_rel) {
+    const char* display_rel = repo_rel;
+    const char* previous_display_rel = previous_repo_rel;
+    if (prefix_len > 0 &&
+        strncmp(repo_rel, prefix, prefix_len) == 0) {
+        display_rel = repo_rel + prefix_len;
+    }
+    if (previous_repo_rel &&
+        prefix_len > 0 &&
+        strncmp(previous_repo_rel, prefix, prefix_len) == 0) {
+        previous_display_rel = previous_repo_rel + prefix_len;
     }
 
     if (*count == *capacity) {
@@ -486,6 +1139,10 @@ static int append_selected_path(SelectedPath** paths,
     }
 
     (*paths)[*count].change_type = change_type;
+    (*paths)[*count].index_regular_file = 0;
+    (*paths)[*count].blob_oid = NULL;
+    (*paths)[*count].blob_mode = 0;
+    (*paths)[*count].base_oid = NULL;
     (*paths)[*count].previous_display_path = NULL;
     (*paths)[*count].previous_repo_rel_path = NULL;
     if (previous_display_rel) {
@@ -551,6 +1208,10 @@ static int append_literal_selected_path(SelectedPath** paths,
     (*paths)[*count].display_path[path_len] = '\0';
     (*paths)[*count].repo_rel_path = NULL;
     (*paths)[*count].change_type = SELECTED_PATH_CHANGE_NONE;
+    (*paths)[*count].index_regular_file = 0;
+    (*paths)[*count].blob_oid = NULL;
+    (*paths)[*count].blob_mode = 0;
+    (*paths)[*count].base_oid = NULL;
     (*paths)[*count].previous_display_path = NULL;
     (*paths)[*count].previous_repo_rel_path = NULL;
 
@@ -558,54 +1219,6 @@ static int append_literal_selected_path(SelectedPath** paths,
     return 0;
 }
 
-static int parse_name_only_output(const unsigned char* output,
-                                  size_t output_len,
-                                  const GitRepoPaths* repo,
-                                  SelectedPath** paths_out,
-                                  size_t* count_out) {
-    SelectedPath* paths = NULL;
-    size_t count = 0;
-    size_t capacity = 0;
-    size_t start = 0;
-    size_t prefix_len = strlen(repo->prefix);
-    size_t repo_root_len = strlen(repo->repo_root);
-
-    while (start < output_len) {
-        size_t end = start;
-        while (end < output_len && output[end] != '\0') {
-            end++;
-        }
-        if (end > start) {
-            const char* repo_rel = (const char*)(output + start);
-            size_t repo_rel_len = end - start;
-            if (append_selected_path(&paths,
-                                     &count,
-                                     &capacity,
-                                     repo->repo_root,
-                                     repo_root_len,
-                                     repo->prefix,
-                                     prefix_len,
-                                     repo_rel,
-                                     repo_rel_len,
-                                     SELECTED_PATH_CHANGE_NONE,
-                                     NULL) != 0) {
-                free_selected_paths(paths, count);
-                return -1;
-            }
-        }
-        start = end + 1;
-    }
-
-    if (normalize_selected_paths(paths, &count) != 0) {
-        free_selected_paths(paths, count);
-        return -1;
-    }
-
-    *paths_out = paths;
-    *count_out = count;
-    return 0;
-}
-
 static SelectedPathChangeType parse_change_type(const char* status) {
     if (!status || status[0] == '\0') {
         return SELECTED_PATH_CHANGE_NONE;
@@ -622,459 +1235,427 @@ static SelectedPathChangeType parse_change_type(const char* status) {
     }
 }
 
-static int next_nul_terminated_field(const unsigned char* output,
-                                     size_t output_len,
-                                     size_t* start,
-                                     const char** field_out,
-                                     size_t* field_len_out) {
-    size_t end;
-
-    if (!output || !start || !field_out || !field_len_out || *start > output_len) {
-        errno = EINVAL;
-        return -1;
-    }
-    if (*start == output_len) {
-        *field_out = NULL;
-        *field_len_out = 0;
-        return 0;
-    }
-
-    end = *start;
-    while (end < output_len && output[end] != '\0') {
-        end++;
-    }
-    if (end == output_len) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    *field_out = (const char*)(output + *start);
-    *field_len_out = end - *start;
-    *start = end + 1;
-    return 1;
-}
+typedef enum {
+    SELECTION_FIELD_STATUS = 0,
+    SELECTION_FIELD_FIRST_PATH,
+    SELECTION_FIELD_SECOND_PATH
+} SelectionField;
 
-static int parse_name_status_output(const unsigned char* output,
-                                    size_t output_len,
-                                    const GitRepoPaths* repo,
-                                    SelectedPath** paths_out,
-                                    size_t* count_out) {
-    SelectedPath* paths = NULL;
-    size_t count = 0;
-    size_t capacity = 0;
-    size_t start = 0;
-    size_t prefix_len = strlen(repo->prefix);
-    size_t repo_root_len = strlen(repo->repo_root);
-
-    while (start < output_len) {
-        const char* status = NULL;
-        const char* first_path = NULL;
-        const char* second_path = NULL;
-        size_t status_len = 0;
-        size_t first_path_len = 0;
-        size_t second_path_len = 0;
-        int field_status = next_nul_terminated_field(output, output_len, &start, &status, &status_len);
-        if (field_status <= 0) {
+typedef enum {
+    SELECTION_FORMAT_PATHS = 0,  // ls-files -z
+    SELECTION_FORMAT_RAW,  // diff --raw --no-abbrev -z
+    SELECTION_FORMAT_TREE  // ls-tree -r -z
+} SelectionFormat;
+
+/* Incremental parser for git's NUL-delimited listings: one path per record,
+ * or a status record followed by a path (two for renames). Raw records name
+ * the pre-change blob that --hunks diffs against; with blob_backed, raw and
+ * tree records also name the blob each path is exported from. */
+typedef struct {
+    const GitRepoPaths* repo;
+    size_t repo_root_len;
+    size_t prefix_len;
+    SelectionFormat format;
+    int blob_backed;
+    SelectionField expected;
+    SelectedPathChangeType change_type;
+    char blob_oid[GIT_OBJECT_HEX_MAX + 1];
+    char base_oid[GIT_OBJECT_HEX_MAX + 1];  // Empty when the path is new.
+    unsigned blob_mode;
+    char* first_path;
+    const SelectedPathListener* listener;
+    SelectedPath* paths;
+    size_t count;
+    size_t capacity;
+} SelectionParser;
+
+static void init_selection_parser(SelectionParser* parser,
+                                  FileSelectionMode mode,
+                                  const GitRepoPaths* repo,
+                                  const SelectedPathListener* listener) {
+    memset(parser, 0, sizeof(*parser));
+    parser->repo = repo;
+    parser->listener = listener;
+    parser->repo_root_len = strlen(repo->repo_root);
+    parser->prefix_len = strlen(repo->prefix);
+    switch (mode) {
+        case FILE_SELECTION_GIT_WORKTREE:
+            parser->format = SELECTION_FORMAT_PATHS;
+            break;
+        case FILE_SELECTION_GIT_REV:
+            parser->format = SELECTION_FORMAT_TREE;
+            parser->blob_backed = 1;
+            break;
+        case FILE_SELECTION_GIT_STAGED:
+            parser->format = SELECTION_FORMAT_RAW;
+            parser->blob_backed = 1;
+            break;
+        default:
+            parser->format = SELECTION_FORMAT_RAW;
             break;
-        }
-        if (status_len == 0) {
-            continue;
-        }
-        if (next_nul_terminated_field(output, output_len, &start, &first_path, &first_path_len) <= 0 ||
-            first_path_len == 0) {
-            free_selected_paths(paths, count);
-            errno = EINVAL;
-            return -1;
-        }
-
-        SelectedPathChangeType change_type = parse_change_type(status);
-        if (change_type == SELECTED_PATH_CHANGE_RENAMED) {
-            if (next_nul_terminated_field(output, output_len, &start, &second_path, &second_path_len) <= 0 ||
-                second_path_len == 0) {
-                free_selected_paths(paths, count);
-                errno = EINVAL;
-                return -1;
-            }
-            if (append_selected_path(&paths,
-                                     &count,
-                                     &capacity,
-                                     repo->repo_root,
-                                     repo_root_len,
-                                     repo->prefix,
-                                     prefix_len,
-                                     second_path,
-                                     second_path_len,
-                                     change_type,
-                                     first_path) != 0) {
-                free_selected_paths(paths, count);
-                return -1;
-            }
-            continue;
-        }
-
-        if (append_selected_path(&paths,
-                                 &count,
-                                 &capacity,
-                                 repo->repo_root,
-                                 repo_root_len,
-                                 repo->prefix,
-                                 prefix_len,
-                                 first_path,
-                                 first_path_len,
-                                 change_type,
-                                 NULL) != 0) {
-            free_selected_paths(paths, count);
-            return -1;
-        }
-    }
-
-    if (normalize_selected_paths(paths, &count) != 0) {
-        free_selected_paths(paths, count);
-        return -1;
     }
-
-    *paths_out = paths;
-    *count_out = count;
-    return 0;
+    parser->expected = SELECTION_FIELD_STATUS;
 }
 
-static int parse_git_selected_paths(FileSelectionMode mode,
-                                    const unsigned char* output,
-                                    size_t output_len,
-                                    const GitRepoPaths* repo,
-                                    SelectedPath** paths_out,
-                                    size_t* count_out) {
-    if (!repo) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    if (mode == FILE_SELECTION_GIT_WORKTREE) {
-        return parse_name_only_output(output, output_len, repo, paths_out, count_out);
-    }
-
-    return parse_name_status_output(output, output_len, repo, paths_out, count_out);
+static void free_selection_parser(SelectionParser* parser) {
+    free(parser->first_path);
+    parser->first_path = NULL;
+    free_selected_paths(parser->paths, parser->count);
+    parser->paths = NULL;
+    parser->count = 0;
+    parser->capacity = 0;
 }
 
-static int append_arg(const char** args, size_t args_size, size_t* argc, const char* arg) {
-    if (!args || !argc || !arg) {
-        errno = EINVAL;
-        return -1;
-    }
-    if (*argc + 1 >= args_size) {
-        errno = EOVERFLOW;
+static int append_parsed_selected_path(SelectionParser* parser,
+                                       const char* repo_rel,
+                                       size_t repo_rel_len,
+                                       SelectedPathChangeType change_type,
+                                       const char* previous_repo_rel,
+                                       int index_regular_file) {
+    SelectedPath* path;
+
+    if (append_selected_path(&parser->paths,
+                             &parser->count,
+                             &parser->capacity,
+                             parser->repo->repo_root,
+                             parser->repo_root_len,
+                             parser->repo->prefix,
+                             parser->prefix_len,
+                             repo_rel,
+                             repo_rel_len,
+                             change_type,
+                             previous_repo_rel) != 0) {
         return -1;
     }
-    args[(*argc)++] = arg;
-    return 0;
-}
-
-static int build_git_selection_args(const GitRepoPaths* repo,
-                                    FileSelectionMode mode,
-                                    const char* diff_range,
-                                    const char** args,
-                                    size_t args_size) {
-    size_t argc = 0;
-
-    if (!repo || !args || args_size < 1) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    if (append_arg(args, args_size, &argc, "git") != 0 ||
-        append_arg(args, args_size, &argc, "-C") != 0 ||
-        append_arg(args, args_size, &argc, repo->repo_root) != 0 ||
-        append_arg(args, args_size, &argc, (mode == FILE_SELECTION_GIT_WORKTREE) ? "ls-files" : "diff") != 0) {
-        return -1;
-    }
-    if (mode == FILE_SELECTION_GIT_WORKTREE) {
-        if (append_arg(args, args_size, &argc, "--cached") != 0 ||
-            append_arg(args, args_size, &argc, "--others") != 0 ||
-            append_arg(args, args_size, &argc, "--exclude-standard") != 0) {
+    path = &parser->paths[parser->count - 1];
+    if (parser->format == SELECTION_FORMAT_RAW && parser->base_oid[0] != '\0') {
+        path->base_oid = strdup(parser->base_oid);
+        if (!path->base_oid) {
             return -1;
         }
-    } else {
-        if (mode == FILE_SELECTION_GIT_STAGED) {
-            if (append_arg(args, args_size, &argc, "--cached") != 0) {
-                return -1;
-            }
-        }
-        if (append_arg(args, args_size, &argc, "--name-status") != 0 ||
-            append_arg(args, args_size, &argc, "--diff-filter=AMR") != 0) {
+    }
+    if (parser->blob_backed) {
+        path->blob_oid = strdup(parser->blob_oid);
+        if (!path->blob_oid) {
             return -1;
         }
-        if (mode == FILE_SELECTION_GIT_DIFF) {
-            if (append_arg(args, args_size, &argc, diff_range) != 0) {
-                return -1;
-            }
-        }
+        path->blob_mode = parser->blob_mode;
     }
-    if (append_arg(args, args_size, &argc, "-z") != 0) {
+    path->index_regular_file = index_regular_file;
+    if (parser->listener && parser->listener->on_path(parser->listener->state, path) != 0) {
         return -1;
     }
-    if (repo->prefix[0] != '\0') {
-        if (append_arg(args, args_size, &argc, "--") != 0 ||
-            append_arg(args, args_size, &argc, repo->prefix) != 0) {
-            return -1;
-        }
-    }
-    args[argc] = NULL;
     return 0;
 }
 
-static int append_git_hunk_range(GitFileHunks* hunks, size_t* capacity, size_t new_start, size_t new_count) {
-    GitHunkRange* new_ranges;
-    size_t new_capacity;
-
-    if (!hunks || !capacity) {
+/* Accepts only full-length lowercase hex object ids (SHA-1 or SHA-256). */
+static int copy_object_id(const char* text, size_t len, char* oid_out) {
+    if (len != GIT_INDEX_SHA1_HASH_SIZE * 2 && len != GIT_INDEX_SHA256_HASH_SIZE * 2) {
         errno = EINVAL;
         return -1;
     }
-    if (hunks->count == *capacity) {
-        new_capacity = (*capacity == 0) ? 4 : *capacity * 2;
-        new_ranges = realloc(hunks->ranges, new_capacity * sizeof(*new_ranges));
-        if (!new_ranges) {
+    for (size_t i = 0; i < len; i++) {
+        if (!((text[i] >= '0' && text[i] <= '9') || (text[i] >= 'a' && text[i] <= 'f'))) {
+            errno = EINVAL;
             return -1;
         }
-        hunks->ranges = new_ranges;
-        *capacity = new_capacity;
     }
-
-    hunks->ranges[hunks->count].new_start = new_start;
-    hunks->ranges[hunks->count].new_count = new_count;
-    hunks->count++;
+    memcpy(oid_out, text, len);
+    oid_out[len] = '\0';
     return 0;
 }
 
-static int parse_hunk_number(const char** cursor, const char* end, size_t* value_out) {
-    size_t value = 0;
-    const char* p;
-
-    if (!cursor || !*cursor || !value_out) {
-        errno = EINVAL;
-        return -1;
-    }
+static int parse_object_mode(const char* text, size_t len, unsigned* mode_out) {
+    unsigned mode = 0;
 
-    p = *cursor;
-    if (p >= end || *p < '0' || *p > '9') {
+    if (len == 0 || len > 7) {
         errno = EINVAL;
         return -1;
     }
-
-    while (p < end && *p >= '0' && *p <= '9') {
-        unsigned digit = (unsigned)(*p - '0');
-        if (value > (SIZE_MAX - digit) / 10) {
-            errno = EOVERFLOW;
+    for (size_t i = 0; i < len; i++) {
+        if (text[i] < '0' || text[i] > '7') {
+            errno = EINVAL;
             return -1;
         }
-        value = value * 10 + digit;
-        p++;
+        mode = (mode << 3) | (unsigned)(text[i] - '0');
     }
-
-    *cursor = p;
-    *value_out = value;
+    *mode_out = mode;
     return 0;
 }
 
-static int parse_unified_hunk_header(const char* line,
-                                     size_t line_len,
-                                     size_t* new_start_out,
-                                     size_t* new_count_out) {
-    const char* p;
-    const char* end;
-    size_t ignored = 0;
-    size_t new_start = 0;
-    size_t new_count = 1;
-
-    if (!line || !new_start_out || !new_count_out) {
-        errno = EINVAL;
-        return -1;
-    }
-    if (line_len < 4 || line[0] != '@' || line[1] != '@') {
-        return 0;
-    }
+/* Splits off the next space-delimited field of a raw or tree record. */
+static const char* next_record_field(const char** cursor, const char* end, char delimiter, size_t* len_out) {
+    const char* field = *cursor;
+    const char* stop = memchr(field, delimiter, (size_t)(end - field));
 
-    p = line + 2;
-    end = line + line_len;
-    while (p < end && *p == ' ') {
-        p++;
+    if (!stop) {
+        stop = end;
+        *cursor = end;
+    } else {
+        *cursor = stop + 1;
     }
-    if (p >= end || *p != '-') {
+    *len_out = (size_t)(stop - field);
+    return field;
+}
+
+/* Git prints an all-zero id for a side that has no blob (added paths, worktree files). */
+static int is_null_object_id(const char* oid) {
+    return oid[strspn(oid, "0")] == '\0';
+}
+
+/* `:<old mode> <new mode> <old oid> <new oid> <status>`. */
+static int parse_raw_status_record(SelectionParser* parser, const char* record, size_t record_len) {
+    const char* cursor = record + 1;
+    const char* end = record + record_len;
+    const char* field;
+    size_t field_len;
+
+    if (record[0] != ':') {
         errno = EINVAL;
         return -1;
     }
-    p++;
-    if (parse_hunk_number(&p, end, &ignored) != 0) {
+    next_record_field(&cursor, end, ' ', &field_len);
+    field = next_record_field(&cursor, end, ' ', &field_len);
+    if (parse_object_mode(field, field_len, &parser->blob_mode) != 0) {
         return -1;
     }
-    if (p < end && *p == ',') {
-        p++;
-        if (parse_hunk_number(&p, end, &ignored) != 0) {
-            return -1;
-        }
-    }
-    while (p < end && *p == ' ') {
-        p++;
-    }
-    if (p >= end || *p != '+') {
-        errno = EINVAL;
-        return -1;
-    }
-    p++;
-    if (parse_hunk_number(&p, end, &new_start) != 0) {
+    field = next_record_field(&cursor, end, ' ', &field_len);
+    if (copy_object_id(field, field_len, parser->base_oid) != 0) {
         return -1;
     }
-    if (p < end && *p == ',') {
-        p++;
-        if (parse_hunk_number(&p, end, &new_count) != 0) {
-            return -1;
-        }
+    if (is_null_object_id(parser->base_oid)) {
+        parser->base_oid[0] = '\0';
     }
-    while (p < end && *p == ' ') {
-        p++;
+    field = next_record_field(&cursor, end, ' ', &field_len);
+    if (copy_object_id(field, field_len, parser->blob_oid) != 0) {
+        return -1;
     }
-    if ((size_t)(end - p) < 2 || p[0] != '@' || p[1] != '@') {
+    if (cursor >= end) {
         errno = EINVAL;
         return -1;
     }
-
-    *new_start_out = new_start;
-    *new_count_out = new_count;
-    return 1;
+    parser->change_type = parse_change_type(cursor);
+    return 0;
 }
 
-static int parse_hunk_ranges_from_diff_output(const unsigned char* output,
-                                              size_t output_len,
-                                              GitFileHunks* hunks) {
-    size_t start = 0;
-    size_t capacity = 0;
+/* `<mode> <type> <oid>\t<path>`; trees are recursed and submodules skipped. */
+static int parse_tree_record(SelectionParser* parser, const char* record, size_t record_len) {
+    const char* cursor = record;
+    const char* end = record + record_len;
+    const char* field;
+    size_t field_len;
+    int is_blob;
 
-    if (!hunks) {
+    field = next_record_field(&cursor, end, ' ', &field_len);
+    if (parse_object_mode(field, field_len, &parser->blob_mode) != 0) {
+        return -1;
+    }
+    field = next_record_field(&cursor, end, ' ', &field_len);
+    is_blob = (field_len == 4 && memcmp(field, "blob", 4) == 0);
+    field = next_record_field(&cursor, end, '\t', &field_len);
+    if (cursor >= end || copy_object_id(field, field_len, parser->blob_oid) != 0) {
         errno = EINVAL;
         return -1;
     }
+    if (!is_blob) {
+        return 0;
+    }
+    return append_parsed_selected_path(parser, cursor, (size_t)(end - cursor), SELECTED_PATH_CHANGE_NONE, NULL, 0);
+}
 
-    while (start < output_len) {
-        size_t end = start;
-        size_t new_start = 0;
-        size_t new_count = 0;
-        int header_status;
+static int parse_selection_record(void* state, const char* record, size_t record_len, int terminated) {
+    SelectionParser* parser = state;
 
-        while (end < output_len && output[end] != '\n') {
-            end++;
-        }
-        if (end > start && output[end - 1] == '\r') {
-            end--;
+    if (parser->format == SELECTION_FORMAT_PATHS) {
+        if (record_len == 0) {
+            return 0;
         }
-
-        header_status = parse_unified_hunk_header((const char*)(output + start),
-                                                  end - start,
-                                                  &new_start,
-                                                  &new_count);
-        if (header_status < 0) {
-            return -1;
+        return append_parsed_selected_path(parser, record, record_len, SELECTED_PATH_CHANGE_NONE, NULL, 0);
+    }
+    if (parser->format == SELECTION_FORMAT_TREE) {
+        if (record_len == 0) {
+            return 0;
         }
-        if (header_status > 0 &&
-            append_git_hunk_range(hunks, &capacity, new_start, new_count) != 0) {
+        if (!terminated) {
+            errno = EINVAL;
             return -1;
         }
-
-        start = (end < output_len && output[end] == '\n') ? end + 1 : output_len;
+        return parse_tree_record(parser, record, record_len);
     }
 
-    return 0;
+    switch (parser->expected) {
+        case SELECTION_FIELD_STATUS:
+            /* An unterminated status field ends the listing, as before. */
+            if (record_len == 0 || !terminated) {
+                return 0;
+            }
+            if (parser->format == SELECTION_FORMAT_RAW) {
+                if (parse_raw_status_record(parser, record, record_len) != 0) {
+                    return -1;
+                }
+            } else {
+                parser->change_type = parse_change_type(record);
+            }
+            parser->expected = SELECTION_FIELD_FIRST_PATH;
+            return 0;
+        case SELECTION_FIELD_FIRST_PATH:
+            if (record_len == 0 || !terminated) {
+                errno = EINVAL;
+                return -1;
+            }
+            if (parser->change_type == SELECTED_PATH_CHANGE_RENAMED) {
+                parser->first_path = strdup(record);
+                if (!parser->first_path) {
+                    return -1;
+                }
+                parser->expected = SELECTION_FIELD_SECOND_PATH;
+                return 0;
+            }
+            parser->expected = SELECTION_FIELD_STATUS;
+            return append_parsed_selected_path(parser, record, record_len, parser->change_type, NULL, 0);
+        case SELECTION_FIELD_SECOND_PATH:
+        default:
+            if (record_len == 0 || !terminated) {
+                errno = EINVAL;
+                return -1;
+            }
+            if (append_parsed_selected_path(parser,
+                                            record,
+                                            record_len,
+                                            parser->change_type,
+                                            parser->first_path,
+                                            0) != 0) {
+                return -1;
+            }
+            free(parser->first_path);
+            parser->first_path = NULL;
+            parser->expected = SELECTION_FIELD_STATUS;
+            return 0;
+    }
 }
 
-static int derive_repo_root_from_selected_paths(const SelectedPath* paths,
-                                                size_t path_count,
-                                                char** repo_root_out) {
-    for (size_t i = 0; i < path_count; i++) {
-        const SelectedPath* path = &paths[i];
-        size_t open_len;
-        size_t repo_rel_len;
-        size_t repo_root_len;
-        char* repo_root;
-
-        if (!path->open_path || !path->repo_rel_path) {
-            continue;
-        }
+/* Hands the parsed paths to the caller once git's output has ended. */
+static int finish_selection_parser(SelectionParser* parser, SelectedPath** paths_out, size_t* count_out) {
+    if (parser->format == SELECTION_FORMAT_RAW && parser->expected != SELECTION_FIELD_STATUS) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (normalize_selected_paths(parser->paths, &parser->count) != 0) {
+        return -1;
+    }
 
-        open_len = strlen(path->open_path);
-        repo_rel_len = strlen(path->repo_rel_path);
-        if (open_len <= repo_rel_len ||
-            strcmp(path->open_path + open_len - repo_rel_len, path->repo_rel_path) != 0 ||
-            path->open_path[open_len - repo_rel_len - 1] != '/') {
-            errno = EINVAL;
-            return -1;
-        }
+    *paths_out = parser->paths;
+    *count_out = parser->count;
+    parser->paths = NULL;
+    parser->count = 0;
+    parser->capacity = 0;
+    return 0;
+}
 
-        repo_root_len = open_len - repo_rel_len - 1;
-        if (repo_root_len == 0) {
-            repo_root = strdup("/");
-        } else {
-            repo_root = malloc(repo_root_len + 1);
-            if (repo_root) {
-                memcpy(repo_root, path->open_path, repo_root_len);
-                repo_root[repo_root_len] = '\0';
-            }
-        }
-        if (!repo_root) {
-            return -1;
-        }
+/* Adds tracked paths under the cwd prefix straight from the index, the
+ * same set `ls-files --cached` prints; conflict stages collapse to one path. */
+static int parse_index_selection_entry(void* state, const GitIndexEntry* entry) {
+    SelectionParser* parser = state;
+    SelectedPath* previous;
 
-        *repo_root_out = repo_root;
+    if (parser->prefix_len > 0 &&
+        (entry->path_len < parser->prefix_len ||
+         memcmp(entry->path, parser->repo->prefix, parser->prefix_len) != 0)) {
         return 0;
     }
+    previous = (parser->count > 0) ? &parser->paths[parser->count - 1] : NULL;
+    if (previous && strcmp(previous->repo_rel_path, entry->path) == 0) {
+        return 0;
+    }
+    return append_parsed_selected_path(parser,
+                                       entry->path,
+                                       entry->path_len,
+                                       SELECTED_PATH_CHANGE_NONE,
+                                       NULL,
+                                       (entry->mode & GIT_INDEX_MODE_TYPE_MASK) == GIT_INDEX_MODE_REGULAR);
+}
 
-    errno = EINVAL;
-    return -1;
+static int append_arg(const char** args, size_t args_size, size_t* argc, const char* arg) {
+    if (!args || !argc || !arg) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (*argc + 1 >= args_size) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    args[(*argc)++] = arg;
+    return 0;
+}
+
+static const char* git_selection_command(FileSelectionMode mode) {
+    switch (mode) {
+        case FILE_SELECTION_GIT_WORKTREE:
+            return "ls-files";
+        case FILE_SELECTION_GIT_REV:
+            return "ls-tree";
+        default:
+            return "diff";
+    }
 }
 
-static int build_git_hunk_args(const char* repo_root,
-                               FileSelectionMode mode,
-                               const char* diff_range,
-                               const SelectedPath* path,
-                               const char* repo_rel_path,
-                               const char** args,
-                               size_t args_size) {
+static int build_git_selection_args(const GitRepoPaths* repo,
+                                    FileSelectionMode mode,
+                                    const char* diff_range,
+                                    int untracked_only,
+                                    const char** args,
+                                    size_t args_size) {
     size_t argc = 0;
 
-    if (!repo_root || !path || !repo_rel_path || !args || args_size < 1) {
+    if (!repo || !args || args_size < 1) {
         errno = EINVAL;
         return -1;
     }
 
     if (append_arg(args, args_size, &argc, "git") != 0 ||
         append_arg(args, args_size, &argc, "-C") != 0 ||
-        append_arg(args, args_size, &argc, repo_root) != 0 ||
-        append_arg(args, args_size, &argc, "diff") != 0) {
-        return -1;
-    }
-    if (mode == FILE_SELECTION_GIT_STAGED &&
-        append_arg(args, args_size, &argc, "--cached") != 0) {
-        return -1;
-    }
-    if (append_arg(args, args_size, &argc, "-U0") != 0 ||
-        append_arg(args, args_size, &argc, "--no-color") != 0 ||
-        append_arg(args, args_size, &argc, "--no-ext-diff") != 0) {
-        return -1;
-    }
-    if (mode == FILE_SELECTION_GIT_DIFF &&
-        append_arg(args, args_size, &argc, diff_range) != 0) {
+        append_arg(args, args_size, &argc, repo->repo_root) != 0 ||
+        append_arg(args, args_size, &argc, git_selection_command(mode)) != 0) {
         return -1;
     }
-    if (append_arg(args, args_size, &argc, "--") != 0) {
-        return -1;
+    if (mode == FILE_SELECTION_GIT_REV) {
+        if (append_arg(args, args_size, &argc, "-r") != 0 ||
+            append_arg(args, args_size, &argc, "-z") != 0 ||
+            append_arg(args, args_size, &argc, diff_range) != 0) {
+            return -1;
+        }
+    } else if (mode == FILE_SELECTION_GIT_WORKTREE) {
+        if ((!untracked_only && append_arg(args, args_size, &argc, "--cached") != 0) ||
+            append_arg(args, args_size, &argc, "--others") != 0 ||
+            append_arg(args, args_size, &argc, "--exclude-standard") != 0) {
+            return -1;
+        }
+    } else {
+        if (mode == FILE_SELECTION_GIT_STAGED &&
+            append_arg(args, args_size, &argc, "--cached") != 0) {
+            return -1;
+        }
+        /* Raw records carry full blob ids: the staged contents and the --hunks base. */
+        if (append_arg(args, args_size, &argc, "--raw") != 0 ||
+            append_arg(args, args_size, &argc, "--no-abbrev") != 0 ||
+            append_arg(args, args_size, &argc, "--diff-filter=AMR") != 0) {
+            return -1;
+        }
+        if (mode == FILE_SELECTION_GIT_DIFF) {
+            if (append_arg(args, args_size, &argc, diff_range) != 0) {
+                return -1;
+            }
+        }
     }
-    if (path->change_type == SELECTED_PATH_CHANGE_RENAMED &&
-        path->previous_repo_rel_path &&
-        append_arg(args, args_size, &argc, path->previous_repo_rel_path) != 0) {
+    if (mode != FILE_SELECTION_GIT_REV && append_arg(args, args_size, &argc, "-z") != 0) {
         return -1;
     }
-    if (append_arg(args, args_size, &argc, repo_rel_path) != 0) {
-        return -1;
+    if (repo->prefix[0] != '\0') {
+        if (append_arg(args, args_size, &argc, "--") != 0 ||
+            append_arg(args, args_size, &argc, repo->prefix) != 0) {
+            return -1;
+        }
     }
-
     args[argc] = NULL;
     return 0;
 }
@@ -1141,13 +1722,15 @@ int collect_stdin_paths(int null_delim,
 int collect_git_paths(FileSelectionMode mode,
                       const char* diff_range,
                       int quiet_probe,
+                      const SelectedPathListener* listener,
                       SelectedPath** paths_out,
                       size_t* count_out,
                       GitPathResult* result_out) {
     GitRepoPaths repo = {0};
     const char* args[GIT_SELECTION_ARGS_MAX];
-    unsigned char* output = NULL;
-    size_t output_len = 0;
+    SelectionParser parser = {0};
+    GitRecordSplitter splitter;
+    GitIndexResult index_result = GIT_INDEX_UNSUPPORTED;
     int exit_status = 0;
     int exec_errno = 0;
     SelectedPath* paths = NULL;
@@ -1174,26 +1757,54 @@ int collect_git_paths(FileSelectionMode mode,
         }
         goto cleanup;
     }
-    if (build_git_selection_args(&repo, mode, diff_range, args, GIT_SELECTION_ARGS_MAX) != 0) {
+    init_selection_parser(&parser, mode, &repo, listener);
+    if (mode == FILE_SELECTION_GIT_WORKTREE && repo.git_dir) {
+        char index_path[MAX_PATH_LENGTH];
+        int written = snprintf(index_path, sizeof(index_path), "%s/index", repo.git_dir);
+
+        /* Tracked paths come from the index itself; git only lists untracked files. */
+        if (written > 0 && (size_t)written < sizeof(index_path)) {
+            if (read_git_index(index_path,
+                               repo.hash_size,
+                               parse_index_selection_entry,
+                               &parser,
+                               &index_result) != 0) {
+                perror("Error reading git index");
+                goto cleanup;
+            }
+        }
+    }
+    if (build_git_selection_args(&repo,
+                                 mode,
+                                 diff_range,
+                                 index_result == GIT_INDEX_READ,
+                                 args,
+                                 GIT_SELECTION_ARGS_MAX) != 0) {
         goto cleanup;
     }
 
-    if (run_command_capture(args, 0, &output, &output_len, &exit_status, &exec_errno) != 0) {
+    init_git_record_splitter(&splitter, '\0', parse_selection_record, &parser);
+    if (run_command_stream(args, 0, feed_git_record_splitter, &splitter, &exit_status, &exec_errno) != 0) {
         perror("Error running git");
+        free_git_record_splitter(&splitter);
         goto cleanup;
     }
     if (exec_errno != 0) {
         errno = exec_errno;
         perror("Error executing git");
+        free_git_record_splitter(&splitter);
         goto cleanup;
     }
     if (!WIFEXITED(exit_status) || WEXITSTATUS(exit_status) != 0) {
-        fprintf(stderr, "git %s failed for the requested file-selection mode\n",
-                (mode == FILE_SELECTION_GIT_WORKTREE) ? "ls-files" : "diff");
+        fprintf(stderr, "git %s failed for the requested file-selection mode\n", git_selection_command(mode));
+        free_git_record_splitter(&splitter);
         goto cleanup;
     }
 
-    if (parse_git_selected_paths(mode, output, output_len, &repo, &paths, &parsed_count) != 0) {
+    status = finish_git_record_splitter(&splitter);
+    free_git_record_splitter(&splitter);
+    if (status != 0 || finish_selection_parser(&parser, &paths, &parsed_count) != 0) {
+        status = -1;
         goto cleanup;
     }
 
@@ -1206,110 +1817,356 @@ int collect_git_paths(FileSelectionMode mode,
     status = 0;
 
 cleanup:
-    free(output);
+    free_selection_parser(&parser);
     free_git_repo_paths(&repo);
     free_selected_paths(paths, parsed_count);
     return status;
 }
 
-int collect_git_hunks(FileSelectionMode mode,
-                      const char* diff_range,
-                      const SelectedPath* paths,
-                      size_t path_count,
-                      GitFileHunks** hunks_out,
-                      size_t* hunk_count_out) {
-    char* repo_root = NULL;
-    GitFileHunks* hunks = NULL;
-    int status = -1;
+struct GitBlobReader {
+    pid_t pid;
+    int request_fd;   // cat-file's stdin: one object id per line.
+    int response_fd;  // cat-file's stdout: header, contents, newline.
+    unsigned char* pending;
+    size_t pending_start;
+    size_t pending_len;
+    int broken;  // The response stream lost sync; every later read fails.
+    pthread_mutex_t lock;
+    struct sigaction saved_sigpipe;
+};
+
+/*
+ * Starts `git cat-file --batch` in the repository root. Requests are written
+ * one at a time without --buffer, so cat-file flushes each object as soon as
+ * it is asked for and the two pipes can never fill up against each other.
+ * SIGPIPE is ignored while the reader is open so a cat-file that dies turns
+ * into an EPIPE write error instead of killing the export.
+ */
+int open_git_blob_reader(GitBlobReader** reader_out) {
+    GitBlobReader* reader = NULL;
+    int request_pipe[2] = {-1, -1};
+    int response_pipe[2] = {-1, -1};
+    int parent_fds[2];
+    int exec_errno = 0;
+    struct sigaction ignore_sigpipe;
 
-    if (!hunks_out || !hunk_count_out || (path_count > 0 && !paths)) {
+    if (!reader_out) {
         errno = EINVAL;
         return -1;
     }
+    *reader_out = NULL;
+    if (probe_git_repo(0, NULL) != 0) {
+        return -1;
+    }
 
-    *hunks_out = NULL;
-    *hunk_count_out = 0;
-
-    if (mode != FILE_SELECTION_GIT_STAGED &&
-        mode != FILE_SELECTION_GIT_UNSTAGED &&
-        mode != FILE_SELECTION_GIT_DIFF) {
-        errno = EINVAL;
+    reader = calloc(1, sizeof(*reader));
+    if (!reader) {
         return -1;
     }
+    reader->pending = malloc(GIT_STREAM_CHUNK_BYTES);
+    if (!reader->pending) {
+        goto fail;
+    }
+    if (open_cloexec_pipe(request_pipe) == -1) {
+        goto fail;
+    }
+    if (open_cloexec_pipe(response_pipe) == -1) {
+        goto fail;
+    }
 
-    if (path_count == 0) {
-        return 0;
+    {
+        const char* const argv[] = {"git", "-C", cached_repo.repo_root, "cat-file", "--batch", NULL};
+        parent_fds[0] = request_pipe[1];
+        parent_fds[1] = response_pipe[0];
+        if (spawn_command(argv, request_pipe[0], response_pipe[1], parent_fds, 2, 0, &reader->pid, &exec_errno) != 0) {
+            goto fail;
+        }
+    }
+    close(request_pipe[0]);
+    close(response_pipe[1]);
+    request_pipe[0] = -1;
+    response_pipe[1] = -1;
+    if (exec_errno != 0) {
+        errno = exec_errno;
+        goto fail;
     }
 
-    hunks = calloc(path_count, sizeof(*hunks));
-    if (!hunks) {
+    reader->request_fd = request_pipe[1];
+    reader->response_fd = response_pipe[0];
+    if (pthread_mutex_init(&reader->lock, NULL) != 0) {
+        int saved_errno = errno;
+        close(reader->request_fd);
+        close(reader->response_fd);
+        while (waitpid(reader->pid, NULL, 0) == -1 && errno == EINTR) {
+        }
+        free(reader->pending);
+        free(reader);
+        errno = saved_errno;
         return -1;
     }
+    memset(&ignore_sigpipe, 0, sizeof(ignore_sigpipe));
+    ignore_sigpipe.sa_handler = SIG_IGN;
+    sigemptyset(&ignore_sigpipe.sa_mask);
+    sigaction(SIGPIPE, &ignore_sigpipe, &reader->saved_sigpipe);
 
-    if (derive_repo_root_from_selected_paths(paths, path_count, &repo_root) != 0) {
-        goto cleanup;
+    *reader_out = reader;
+    return 0;
+
+fail:
+    {
+        int saved_errno = errno;
+        for (int i = 0; i < 2; i++) {
+            if (request_pipe[i] != -1) {
+                close(request_pipe[i]);
+            }
+            if (response_pipe[i] != -1) {
+                close(response_pipe[i]);
+            }
+        }
+        free(reader->pending);
+        free(reader);
+        errno = saved_errno;
     }
+    return -1;
+}
 
-    for (size_t i = 0; i < path_count; i++) {
-        const char* args[GIT_HUNK_ARGS_MAX];
-        unsigned char* output = NULL;
-        size_t output_len = 0;
-        int exit_status = 0;
-        int exec_errno = 0;
+static int write_blob_request(GitBlobReader* reader, const char* oid) {
+    char request[GIT_OBJECT_HEX_MAX + 2];
+    size_t len = strlen(oid);
+    size_t written = 0;
 
-        if (paths[i].change_type == SELECTED_PATH_CHANGE_ADDED) {
-            continue;
+    if (len > GIT_OBJECT_HEX_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(request, oid, len);
+    request[len++] = '\n';
+    while (written < len) {
+        ssize_t result = write(reader->request_fd, request + written, len - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
         }
-        if (!paths[i].repo_rel_path) {
-            errno = EINVAL;
-            goto cleanup;
+        written += (size_t)result;
+    }
+    return 0;
+}
+
+/* Refills the read-ahead buffer; end of output mid-response is an I/O error. */
+static int fill_blob_pending(GitBlobReader* reader) {
+    ssize_t result;
+
+    reader->pending_start = 0;
+    reader->pending_len = 0;
+    while ((result = read(reader->response_fd, reader->pending, GIT_STREAM_CHUNK_BYTES)) < 0) {
+        if (errno != EINTR) {
+            return -1;
         }
-        if (build_git_hunk_args(repo_root,
-                                mode,
-                                diff_range,
-                                &paths[i],
-                                paths[i].repo_rel_path,
-                                args,
-                                GIT_HUNK_ARGS_MAX) != 0) {
-            goto cleanup;
+    }
+    if (result == 0) {
+        errno = EIO;
+        return -1;
+    }
+    reader->pending_len = (size_t)result;
+    return 0;
+}
+
+static int read_blob_header(GitBlobReader* reader, char* header, size_t header_size) {
+    size_t used = 0;
+
+    while (1) {
+        if (reader->pending_start == reader->pending_len && fill_blob_pending(reader) != 0) {
+            return -1;
         }
-        if (run_command_capture(args, 0, &output, &output_len, &exit_status, &exec_errno) != 0) {
-            perror("Error running git");
-            free(output);
-            goto cleanup;
+        unsigned char c = reader->pending[reader->pending_start++];
+        if (c == '\n') {
+            header[used] = '\0';
+            return 0;
         }
-        if (exec_errno != 0) {
-            errno = exec_errno;
-            perror("Error executing git");
-            free(output);
-            goto cleanup;
+        if (used + 1 >= header_size) {
+            errno = EIO;
+            return -1;
         }
-        if (!WIFEXITED(exit_status) || WEXITSTATUS(exit_status) != 0) {
-            fprintf(stderr, "git diff failed while collecting hunks for %s\n", paths[i].display_path);
-            free(output);
-            goto cleanup;
+        header[used++] = (char)c;
+    }
+}
+
+/* Moves len response bytes into dest, or discards them when dest is NULL. */
+static int read_blob_bytes(GitBlobReader* reader, unsigned char* dest, size_t len) {
+    while (len > 0) {
+        size_t available;
+
+        if (reader->pending_start == reader->pending_len) {
+            /* Large bodies bypass the read-ahead buffer. */
+            if (dest && len >= GIT_STREAM_CHUNK_BYTES) {
+                ssize_t result = read(reader->response_fd, dest, len);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return -1;
+                }
+                if (result == 0) {
+                    errno = EIO;
+                    return -1;
+                }
+                dest += result;
+                len -= (size_t)result;
+                continue;
+            }
+            if (fill_blob_pending(reader) != 0) {
+                return -1;
+            }
         }
-        if (parse_hunk_ranges_from_diff_output(output, output_len, &hunks[i]) != 0) {
-            free(output);
-            goto cleanup;
+        available = reader->pending_len - reader->pending_start;
+        if (available > len) {
+            available = len;
         }
-        free(output);
+        if (dest) {
+            memcpy(dest, reader->pending + reader->pending_start, available);
+            dest += available;
+        }
+        reader->pending_start += available;
+        len -= available;
     }
+    return 0;
+}
 
-    *hunks_out = hunks;
-    *hunk_count_out = path_count;
-    hunks = NULL;
-    status = 0;
+static int read_git_blob_locked(GitBlobReader* reader,
+                                const char* oid,
+                                size_t max_size,
+                                unsigned char** buf_out,
+                                size_t* size_out) {
+    char header[GIT_BLOB_HEADER_MAX];
+    char* type;
+    char* size_text;
+    char* endptr;
+    unsigned long long size;
+    unsigned char* buffer = NULL;
+    unsigned char terminator;
+    int is_blob;
+    int alloc_failed = 0;
 
-cleanup:
-    free(repo_root);
-    free_git_hunks(hunks, path_count);
+    if (reader->broken) {
+        errno = EIO;
+        return -1;
+    }
+    if (write_blob_request(reader, oid) != 0 ||
+        read_blob_header(reader, header, sizeof(header)) != 0) {
+        reader->broken = 1;
+        return -1;
+    }
+
+    type = strchr(header, ' ');
+    if (!type) {
+        reader->broken = 1;
+        errno = EIO;
+        return -1;
+    }
+    type++;
+    if (strcmp(type, "missing") == 0 || strcmp(type, "ambiguous") == 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    size_text = strchr(type, ' ');
+    if (!size_text) {
+        reader->broken = 1;
+        errno = EIO;
+        return -1;
+    }
+    is_blob = (size_text - type == 4 && memcmp(type, "blob", 4) == 0);
+    errno = 0;
+    size = strtoull(size_text + 1, &endptr, 10);
+    if (errno != 0 || *endptr != '\0' || endptr == size_text + 1 || size > SIZE_MAX - 1) {
+        reader->broken = 1;
+        errno = EIO;
+        return -1;
+    }
+    *size_out = (size_t)size;
+
+    if (is_blob && size <= max_size) {
+        buffer = malloc((size_t)size + 1);
+        /* Without a buffer the body is drained below so the stream stays usable. */
+        alloc_failed = (buffer == NULL);
+    }
+    if (read_blob_bytes(reader, buffer, (size_t)size) != 0 ||
+        read_blob_bytes(reader, &terminator, 1) != 0) {
+        free(buffer);
+        reader->broken = 1;
+        return -1;
+    }
+    if (terminator != '\n') {
+        free(buffer);
+        reader->broken = 1;
+        errno = EIO;
+        return -1;
+    }
+    if (alloc_failed) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (!is_blob) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!buffer) {
+        return 1;
+    }
+    *buf_out = buffer;
+    return 0;
+}
+
+int read_git_blob(GitBlobReader* reader,
+                  const char* oid,
+                  size_t max_size,
+                  unsigned char** buf_out,
+                  size_t* size_out) {
+    int status;
+
+    if (!reader || !oid || !buf_out || !size_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *buf_out = NULL;
+    *size_out = 0;
+
+    pthread_mutex_lock(&reader->lock);
+    status = read_git_blob_locked(reader, oid, max_size, buf_out, size_out);
+    {
+        int saved_errno = errno;
+        pthread_mutex_unlock(&reader->lock);
+        errno = saved_errno;
+    }
+    return status;
+}
+
+/* Closes cat-file's stdin, which ends the batch, and reaps the process. */
+int close_git_blob_reader(GitBlobReader* reader) {
+    int exit_status = 0;
+    int status = 0;
+
+    if (!reader) {
+        return 0;
+    }
+    close(reader->request_fd);
+    close(reader->response_fd);
+    while (waitpid(reader->pid, &exit_status, 0) == -1) {
+        if (errno != EINTR) {
+            status = -1;
+            break;
+        }
+    }
+    sigaction(SIGPIPE, &reader->saved_sigpipe, NULL);
+    pthread_mutex_destroy(&reader->lock);
+    free(reader->pending);
+    free(reader);
     return status;
 }
 
 int resolve_repository_name(FileSelectionMode mode, char* buffer, size_t buffer_size) {
     char cwd[MAX_PATH_LENGTH];
-    char* repo_root = NULL;
     const char* source = NULL;
 
     if (!buffer || buffer_size == 0) {
@@ -1319,32 +2176,14 @@ int resolve_repository_name(FileSelectionMode mode, char* buffer, size_t buffer_
 
     (void)mode;
 
-    if (capture_git_repo_root(1, &repo_root, NULL) == 0) {
-        source = repo_root;
+    if (probe_git_repo(1, NULL) == 0) {
+        source = cached_repo.repo_root;
     } else {
         if (!getcwd(cwd, sizeof(cwd))) {
-            free(repo_root);
             return -1;
         }
         source = cwd;
     }
 
-    if (copy_path_basename(source, buffer, buffer_size) != 0) {
-        free(repo_root);
-        return -1;
-    }
-
-    free(repo_root);
-    return 0;
-}
-
-void free_git_hunks(GitFileHunks* hunks, size_t count) {
-    if (!hunks) {
-        return;
-    }
-
-    for (size_t i = 0; i < count; i++) {
-        free(hunks[i].ranges);
-    }
-    free(hunks);
+    return copy_path_basename(source, buffer, buffer_size);
 }
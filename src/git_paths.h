@@ -17,42 +17,57 @@ typedef struct {
     char* display_path;
     char* repo_rel_path;
     SelectedPathChangeType change_type;
+    int index_regular_file;  // Listed from the index as a regular file; collection may open it without lstat.
+    char* blob_oid;          // Set for --staged/--rev: contents come from this blob, not the worktree file.
+    unsigned blob_mode;      // Git entry mode of blob_oid (regular, executable, or symlink).
+    char* base_oid;          // Pre-change blob that --hunks diffs against; NULL for added paths.
     char* previous_display_path;
     char* previous_repo_rel_path;
 } SelectedPath;
 
-typedef struct {
-    size_t new_start;
-    size_t new_count;
-} GitHunkRange;
-
-typedef struct {
-    GitHunkRange* ranges;
-    size_t count;
-} GitFileHunks;
+/* One long-lived `git cat-file --batch` process shared by ingestion workers. */
+typedef struct GitBlobReader GitBlobReader;
 
 typedef enum {
     GIT_PATHS_COLLECTED = 0,
     GIT_PATHS_FALLBACK
 } GitPathResult;
 
+/*
+ * Told about each path as soon as it is parsed, while git is still listing
+ * and before the selection is sorted and deduplicated, so collection can
+ * start early. path is only valid during the call; a non-zero return aborts
+ * the listing.
+ */
+typedef struct {
+    int (*on_path)(void* state, const SelectedPath* path);
+    void* state;
+} SelectedPathListener;
+
+/* diff_range is the range for --diff or the revision for --rev. listener may be NULL. */
 int collect_git_paths(FileSelectionMode mode,
                       const char* diff_range,
                       int quiet_probe,
+                      const SelectedPathListener* listener,
                       SelectedPath** paths_out,
                       size_t* count_out,
                       GitPathResult* result_out);
 int collect_stdin_paths(int null_delim,
                         SelectedPath** paths_out,
                         size_t* count_out);
-int collect_git_hunks(FileSelectionMode mode,
-                      const char* diff_range,
-                      const SelectedPath* paths,
-                      size_t path_count,
-                      GitFileHunks** hunks_out,
-                      size_t* hunk_count_out);
+int open_git_blob_reader(GitBlobReader** reader_out);
+/*
+ * Reads one blob. Returns 0 with a heap buffer, 1 when the blob is larger
+ * than max_size (its bytes are discarded and *size_out still reports the
+ * size), or -1 with errno set (ENOENT for a missing object).
+ */
+int read_git_blob(GitBlobReader* reader,
+                  const char* oid,
+                  size_t max_size,
+                  unsigned char** buf_out,
+                  size_t* size_out);
+int close_git_blob_reader(GitBlobReader* reader);
 int resolve_repository_name(FileSelectionMode mode, char* buffer, size_t buffer_size);
-void free_git_hunks(GitFileHunks* hunks, size_t count);
 void free_selected_paths(SelectedPath* paths, size_t count);
 
 #endif
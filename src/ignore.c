@@ -1,10 +1,13 @@
 #include "ignore.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <fnmatch.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 typedef struct {
     char* storage;
@@ -131,7 +134,8 @@ static int is_double_star_segment(const char* segment) {
 static int match_segment_lists(char* const* pattern_items,
                                size_t pattern_count,
                                size_t pattern_index,
-                               const PathSegments* path_segments,
+                               const char* const* path_items,
+                               size_t path_count,
                                size_t path_index) {
     while (pattern_index < pattern_count) {
         const char* pattern = pattern_items[pattern_index];
@@ -146,19 +150,19 @@ static int match_segment_lists(char* const* pattern_items,
                 return 1;
             }
 
-            for (size_t i = path_index; i <= path_segments->count; i++) {
-                if (match_segment_lists(pattern_items, pattern_count, pattern_index + 1, path_segments, i)) {
+            for (size_t i = path_index; i <= path_count; i++) {
+                if (match_segment_lists(pattern_items, pattern_count, pattern_index + 1, path_items, path_count, i)) {
                     return 1;
                 }
             }
             return 0;
         }
 
-        if (path_index >= path_segments->count) {
+        if (path_index >= path_count) {
             return 0;
         }
 
-        if (fnmatch(pattern, path_segments->items[path_index], 0) != 0) {
+        if (fnmatch(pattern, path_items[path_index], 0) != 0) {
             return 0;
         }
 
@@ -166,13 +170,14 @@ static int match_segment_lists(char* const* pattern_items,
         path_index++;
     }
 
-    return path_index == path_segments->count;
+    return path_index == path_count;
 }
 
 static int pattern_can_match_at_or_below_path(char* const* pattern_items,
                                               size_t pattern_count,
                                               size_t pattern_index,
-                                              const PathSegments* path_segments,
+                                              const char* const* path_items,
+                                              size_t path_count,
                                               size_t path_index) {
     while (pattern_index < pattern_count) {
         const char* pattern = pattern_items[pattern_index];
@@ -187,11 +192,12 @@ static int pattern_can_match_at_or_below_path(char* const* pattern_items,
                 return 1;
             }
 
-            for (size_t i = path_index; i <= path_segments->count; i++) {
+            for (size_t i = path_index; i <= path_count; i++) {
                 if (pattern_can_match_at_or_below_path(pattern_items,
                                                        pattern_count,
                                                        pattern_index + 1,
-                                                       path_segments,
+                                                       path_items,
+                                                       path_count,
                                                        i)) {
                     return 1;
                 }
@@ -199,11 +205,11 @@ static int pattern_can_match_at_or_below_path(char* const* pattern_items,
             return 0;
         }
 
-        if (path_index >= path_segments->count) {
+        if (path_index >= path_count) {
             return 1;
         }
 
-        if (fnmatch(pattern, path_segments->items[path_index], 0) != 0) {
+        if (fnmatch(pattern, path_items[path_index], 0) != 0) {
             return 0;
         }
 
@@ -211,7 +217,7 @@ static int pattern_can_match_at_or_below_path(char* const* pattern_items,
         path_index++;
     }
 
-    return path_index == path_segments->count;
+    return path_index == path_count;
 }
 
 static int compile_ignore_pattern(const char* raw_pattern, IgnorePattern* pattern) {
@@ -312,7 +318,8 @@ int resolve_ignore_state(const char* filepath,
         if (match_segment_lists(pattern->segment_items,
                                 pattern->segment_count,
                                 0,
-                                &rel_segments,
+                                (const char* const*)rel_segments.items,
+                                rel_segments.count,
                                 0)) {
             ignored = !pattern->negated;
         }
@@ -348,6 +355,7 @@ int ignored_directory_may_have_included_descendants(const char* dirpath,
         }
 
         if (!pattern->use_path_match) {
+            free_path_segments(&dir_segments);
             return 1;
         }
 
@@ -361,7 +369,8 @@ int ignored_directory_may_have_included_descendants(const char* dirpath,
         if (pattern_can_match_at_or_below_path(pattern->segment_items,
                                                pattern->segment_count,
                                                0,
-                                               &dir_segments,
+                                               (const char* const*)dir_segments.items,
+                                               dir_segments.count,
                                                0)) {
             free_path_segments(&dir_segments);
             return 1;
@@ -372,6 +381,56 @@ int ignored_directory_may_have_included_descendants(const char* dirpath,
     return 0;
 }
 
+/* Appends the patterns of an ignore file to *patterns and closes file. */
+static int read_ignore_file(FILE* file, IgnorePattern** patterns, size_t* count, size_t* capacity) {
+    char* line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len = 0;
+    int saved_errno;
+
+    while ((line_len = getline(&line, &line_cap, file)) != -1) {
+        while (line_len > 0 &&
+               (line[line_len - 1] == '\n' || line[line_len - 1] == '\r' ||
+                line[line_len - 1] == ' ' || line[line_len - 1] == '\t')) {
+            line[--line_len] = '\0';
+        }
+
+        if (line_len == 0 || line[0] == '#') {
+            continue;
+        }
+
+        if (*count >= *capacity) {
+            size_t new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+            IgnorePattern* new_patterns = realloc(*patterns, new_capacity * sizeof(*new_patterns));
+            if (!new_patterns) {
+                goto fail;
+            }
+            *patterns = new_patterns;
+            *capacity = new_capacity;
+        }
+
+        if (compile_ignore_pattern(line, &(*patterns)[*count]) != 0) {
+            goto fail;
+        }
+
+        (*count)++;
+    }
+
+    if (ferror(file)) {
+        goto fail;
+    }
+
+    free(line);
+    return fclose(file);
+
+fail:
+    saved_errno = errno;
+    free(line);
+    fclose(file);
+    errno = saved_errno;
+    return -1;
+}
+
 int load_ignore_patterns(const char* ignore_file,
                          int include_default_ignores,
                          IgnorePattern** patterns,
@@ -419,7 +478,7 @@ int load_ignore_patterns(const char* ignore_file,
 
     FILE* file = fopen(ignore_file, "r");
     if (!file) {
-        if (errno == ENOENT) {
+        if (errno == ENOENT || errno == ENOTDIR) {
             return 0;  // Defaults only
         }
         cleanup_patterns(patterns, *count);
@@ -427,65 +486,615 @@ int load_ignore_patterns(const char* ignore_file,
         return -1;
     }
 
-    char* line = NULL;
-    size_t line_cap = 0;
-    ssize_t line_len = 0;
-    while ((line_len = getline(&line, &line_cap, file)) != -1) {
-        while (line_len > 0 &&
-               (line[line_len - 1] == '\n' || line[line_len - 1] == '\r' ||
-                line[line_len - 1] == ' ' || line[line_len - 1] == '\t')) {
-            line[--line_len] = '\0';
+    if (read_ignore_file(file, patterns, count, &capacity) != 0) {
+        cleanup_patterns(patterns, *count);
+        *count = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void free_ignore_patterns(IgnorePattern* patterns, size_t count) {
+    if (!patterns) return;
+    for (size_t i = 0; i < count; i++) {
+        free_pattern_fields(&patterns[i]);
+    }
+    free(patterns);
+}
+
+/*
+ * Compiled form of a pattern list. Each pattern lands in exactly one place:
+ * - glob-free basenames in a hash set,
+ * - "*.ext" basenames in a suffix table,
+ * - path patterns in a trie keyed by their leading literal segments,
+ * - the remaining basename globs in a list still matched with fnmatch.
+ * Every lookup yields the highest matching pattern index, so combining the
+ * buckets keeps last-match-wins and negation semantics exactly.
+ */
+typedef struct {
+    const char* key;  // Not owned; points into a pattern's storage.
+    size_t key_len;
+    size_t owner;  // Parent trie node for trie edges, 0 for the basename tables.
+    size_t value;  // Payload index in the owning table.
+} IgnoreHashSlot;
+
+typedef struct {
+    IgnoreHashSlot* slots;
+    size_t capacity;  // Power of two; 0 while empty.
+    size_t count;
+} IgnoreHash;
+
+/* 1 + index of the last pattern for each (dir_only, negated) pair; 0 = none. */
+typedef struct {
+    size_t last[4];
+} IgnoreLastMatch;
+
+typedef struct {
+    size_t* patterns;  // Ascending pattern indices whose literal prefix ends here.
+    size_t pattern_count;
+    size_t pattern_capacity;
+    int negated_below;  // This node or a descendant holds a negated pattern.
+} IgnoreTrieNode;
+
+struct IgnoreMatcher {
+    const IgnorePattern* patterns;
+    IgnoreHash literal_index;
+    IgnoreLastMatch* literals;
+    size_t literal_count;
+    IgnoreHash suffix_index;
+    IgnoreLastMatch* suffixes;
+    size_t suffix_count;
+    IgnoreHash edge_index;
+    IgnoreTrieNode* nodes;  // nodes[0] is the root.
+    size_t node_count;
+    size_t* basename_globs;  // Ascending pattern indices.
+    size_t basename_glob_count;
+    int has_negated_basename;
+};
+
+static size_t hash_ignore_key(size_t owner, const char* key, size_t key_len) {
+    size_t hash = (size_t)2166136261u ^ owner;
+
+    for (size_t i = 0; i < key_len; i++) {
+        hash ^= (unsigned char)key[i];
+        hash *= (size_t)16777619u;
+    }
+    return hash;
+}
+
+static IgnoreHashSlot* find_ignore_slot(const IgnoreHash* hash, size_t owner, const char* key, size_t key_len) {
+    size_t mask;
+    size_t index;
+
+    if (hash->capacity == 0) {
+        return NULL;
+    }
+    mask = hash->capacity - 1;
+    index = hash_ignore_key(owner, key, key_len) & mask;
+    while (hash->slots[index].key) {
+        IgnoreHashSlot* slot = &hash->slots[index];
+        if (slot->owner == owner && slot->key_len == key_len && memcmp(slot->key, key, key_len) == 0) {
+            return slot;
         }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
 
-        if (line_len == 0 || line[0] == '#') {
+static int insert_ignore_slot(IgnoreHash* hash, size_t owner, const char* key, size_t key_len, size_t value) {
+    size_t mask;
+    size_t index;
+
+    if ((hash->count + 1) * 2 > hash->capacity) {
+        size_t new_capacity = (hash->capacity == 0) ? 16 : hash->capacity * 2;
+        IgnoreHashSlot* new_slots = calloc(new_capacity, sizeof(*new_slots));
+        if (!new_slots) {
+            return -1;
+        }
+        for (size_t i = 0; i < hash->capacity; i++) {
+            const IgnoreHashSlot* slot = &hash->slots[i];
+            if (!slot->key) {
+                continue;
+            }
+            index = hash_ignore_key(slot->owner, slot->key, slot->key_len) & (new_capacity - 1);
+            while (new_slots[index].key) {
+                index = (index + 1) & (new_capacity - 1);
+            }
+            new_slots[index] = *slot;
+        }
+        free(hash->slots);
+        hash->slots = new_slots;
+        hash->capacity = new_capacity;
+    }
+
+    mask = hash->capacity - 1;
+    index = hash_ignore_key(owner, key, key_len) & mask;
+    while (hash->slots[index].key) {
+        index = (index + 1) & mask;
+    }
+    hash->slots[index].key = key;
+    hash->slots[index].key_len = key_len;
+    hash->slots[index].owner = owner;
+    hash->slots[index].value = value;
+    hash->count++;
+    return 0;
+}
+
+static int is_literal_glob(const char* text) {
+    return strpbrk(text, "*?[\\") == NULL;
+}
+
+static size_t last_match_variant(const IgnorePattern* pattern) {
+    return (pattern->dir_only ? 2u : 0u) | (pattern->negated ? 1u : 0u);
+}
+
+/* Records pattern index in the table entry for key, creating it on first use. */
+static int add_last_match(IgnoreHash* hash,
+                          IgnoreLastMatch** entries,
+                          size_t* entry_count,
+                          const char* key,
+                          const IgnorePattern* pattern,
+                          size_t index) {
+    IgnoreHashSlot* slot = find_ignore_slot(hash, 0, key, strlen(key));
+    IgnoreLastMatch* entry;
+
+    if (!slot) {
+        IgnoreLastMatch* new_entries = realloc(*entries, (*entry_count + 1) * sizeof(*new_entries));
+        if (!new_entries) {
+            return -1;
+        }
+        *entries = new_entries;
+        memset(&new_entries[*entry_count], 0, sizeof(*new_entries));
+        if (insert_ignore_slot(hash, 0, key, strlen(key), *entry_count) != 0) {
+            return -1;
+        }
+        entry = &new_entries[(*entry_count)++];
+    } else {
+        entry = &(*entries)[slot->value];
+    }
+    entry->last[last_match_variant(pattern)] = index + 1;
+    return 0;
+}
+
+static int append_trie_pattern(IgnoreTrieNode* node, size_t index) {
+    if (node->pattern_count == node->pattern_capacity) {
+        size_t new_capacity = (node->pattern_capacity == 0) ? 4 : node->pattern_capacity * 2;
+        size_t* new_patterns = realloc(node->patterns, new_capacity * sizeof(*new_patterns));
+        if (!new_patterns) {
+            return -1;
+        }
+        node->patterns = new_patterns;
+        node->pattern_capacity = new_capacity;
+    }
+    node->patterns[node->pattern_count++] = index;
+    return 0;
+}
+
+static int add_trie_pattern(IgnoreMatcher* matcher, const IgnorePattern* pattern, size_t index) {
+    size_t node = 0;
+
+    for (size_t depth = 0; depth < pattern->segment_count; depth++) {
+        const char* segment = pattern->segment_items[depth];
+        size_t segment_len = strlen(segment);
+        IgnoreHashSlot* edge;
+
+        if (!is_literal_glob(segment)) {
+            break;
+        }
+        if (pattern->negated) {
+            matcher->nodes[node].negated_below = 1;
+        }
+        edge = find_ignore_slot(&matcher->edge_index, node, segment, segment_len);
+        if (edge) {
+            node = edge->value;
             continue;
         }
 
-        if (*count >= capacity) {
-            capacity *= 2;
-            IgnorePattern* new_patterns = realloc(*patterns, capacity * sizeof(*new_patterns));
-            if (!new_patterns) {
-                free(line);
-                fclose(file);
-                cleanup_patterns(patterns, *count);
-                *count = 0;
-                return -1;
-            }
-            *patterns = new_patterns;
+        IgnoreTrieNode* new_nodes = realloc(matcher->nodes, (matcher->node_count + 1) * sizeof(*new_nodes));
+        if (!new_nodes) {
+            return -1;
         }
+        matcher->nodes = new_nodes;
+        memset(&new_nodes[matcher->node_count], 0, sizeof(*new_nodes));
+        if (insert_ignore_slot(&matcher->edge_index, node, segment, segment_len, matcher->node_count) != 0) {
+            return -1;
+        }
+        node = matcher->node_count++;
+    }
+    if (pattern->negated) {
+        matcher->nodes[node].negated_below = 1;
+    }
+    return append_trie_pattern(&matcher->nodes[node], index);
+}
 
-        if (compile_ignore_pattern(line, &(*patterns)[*count]) != 0) {
-            free(line);
-            fclose(file);
-            cleanup_patterns(patterns, *count);
-            *count = 0;
+static int add_basename_glob(IgnoreMatcher* matcher, size_t index) {
+    size_t* new_globs = realloc(matcher->basename_globs,
+                                (matcher->basename_glob_count + 1) * sizeof(*new_globs));
+    if (!new_globs) {
+        return -1;
+    }
+    matcher->basename_globs = new_globs;
+    matcher->basename_globs[matcher->basename_glob_count++] = index;
+    return 0;
+}
+
+int compile_ignore_matcher(const IgnorePattern* patterns, size_t count, IgnoreMatcher** matcher_out) {
+    IgnoreMatcher* matcher;
+
+    if (!matcher_out || (!patterns && count > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    *matcher_out = NULL;
+
+    matcher = calloc(1, sizeof(*matcher));
+    if (!matcher) {
+        return -1;
+    }
+    matcher->patterns = patterns;
+    matcher->nodes = calloc(1, sizeof(*matcher->nodes));
+    if (!matcher->nodes) {
+        free(matcher);
+        return -1;
+    }
+    matcher->node_count = 1;
+
+    for (size_t i = 0; i < count; i++) {
+        const IgnorePattern* pattern = &patterns[i];
+        const char* text = pattern->match_pattern;
+        int status;
+
+        if (pattern->use_path_match) {
+            status = add_trie_pattern(matcher, pattern, i);
+        } else {
+            matcher->has_negated_basename |= pattern->negated;
+            if (is_literal_glob(text)) {
+                status = add_last_match(&matcher->literal_index, &matcher->literals, &matcher->literal_count,
+                                        text, pattern, i);
+            } else if (text[0] == '*' && text[1] == '.' && is_literal_glob(text + 1)) {
+                status = add_last_match(&matcher->suffix_index, &matcher->suffixes, &matcher->suffix_count,
+                                        text + 1, pattern, i);
+            } else {
+                status = add_basename_glob(matcher, i);
+            }
+        }
+        if (status != 0) {
+            free_ignore_matcher(matcher);
             return -1;
         }
+    }
 
-        (*count)++;
+    *matcher_out = matcher;
+    return 0;
+}
+
+/* Folds a table entry into *best (1 + index) for the variants this lookup may use. */
+static void apply_last_match(const IgnoreLastMatch* entry, int is_dir, int initial_ignored, size_t* best) {
+    for (size_t variant = 0; variant < 4; variant++) {
+        if ((variant & 2u) && !is_dir) {
+            continue;
+        }
+        /* Basename negations should not resurrect descendants of an ignored directory. */
+        if ((variant & 1u) && initial_ignored) {
+            continue;
+        }
+        if (entry->last[variant] > *best) {
+            *best = entry->last[variant];
+        }
+    }
+}
+
+/* Returns the child of node along segment, or 0 (the root) when there is none. */
+static size_t find_trie_child(const IgnoreMatcher* matcher, size_t node, const char* segment) {
+    const IgnoreHashSlot* edge = find_ignore_slot(&matcher->edge_index, node, segment, strlen(segment));
+    return edge ? edge->value : 0;
+}
+
+/* Returns 1 + the index of the last pattern matching the path, or 0 when none does. */
+static size_t match_compiled(const IgnoreMatcher* matcher,
+                             const char* base,
+                             const char* const* segments,
+                             size_t segment_count,
+                             int is_dir,
+                             int initial_ignored) {
+    size_t best = 0;
+    size_t node = 0;
+
+    if (matcher->literal_count > 0) {
+        const IgnoreHashSlot* slot = find_ignore_slot(&matcher->literal_index, 0, base, strlen(base));
+        if (slot) {
+            apply_last_match(&matcher->literals[slot->value], is_dir, initial_ignored, &best);
+        }
     }
+    if (matcher->suffix_count > 0) {
+        for (const char* dot = strchr(base, '.'); dot; dot = strchr(dot + 1, '.')) {
+            const IgnoreHashSlot* slot = find_ignore_slot(&matcher->suffix_index, 0, dot, strlen(dot));
+            if (slot) {
+                apply_last_match(&matcher->suffixes[slot->value], is_dir, initial_ignored, &best);
+            }
+        }
+    }
+    for (size_t i = matcher->basename_glob_count; i > 0; i--) {
+        size_t index = matcher->basename_globs[i - 1];
+        const IgnorePattern* pattern = &matcher->patterns[index];
 
-    if (ferror(file)) {
-        free(line);
-        fclose(file);
-        cleanup_patterns(patterns, *count);
-        *count = 0;
+        if (index + 1 <= best) {
+            break;
+        }
+        if ((pattern->dir_only && !is_dir) || (initial_ignored && pattern->negated)) {
+            continue;
+        }
+        if (fnmatch(pattern->match_pattern, base, 0) == 0) {
+            best = index + 1;
+            break;
+        }
+    }
+
+    /* Walk the trie along the path; only patterns on visited nodes can match. */
+    for (size_t depth = 0; ; depth++) {
+        const IgnoreTrieNode* trie_node = &matcher->nodes[node];
+
+        for (size_t i = trie_node->pattern_count; i > 0; i--) {
+            size_t index = trie_node->patterns[i - 1];
+            const IgnorePattern* pattern = &matcher->patterns[index];
+
+            if (index + 1 <= best) {
+                break;
+            }
+            if (pattern->dir_only && !is_dir) {
+                continue;
+            }
+            if (match_segment_lists(pattern->segment_items, pattern->segment_count, depth,
+                                    segments, segment_count, depth)) {
+                best = index + 1;
+                break;
+            }
+        }
+        if (depth == segment_count) {
+            break;
+        }
+        node = find_trie_child(matcher, node, segments[depth]);
+        if (node == 0) {
+            break;
+        }
+    }
+    return best;
+}
+
+static int resolve_compiled(const IgnoreMatcher* matcher,
+                            const char* base,
+                            const char* const* segments,
+                            size_t segment_count,
+                            int is_dir,
+                            int initial_ignored) {
+    size_t best = match_compiled(matcher, base, segments, segment_count, is_dir, initial_ignored);
+
+    if (best == 0) {
+        return initial_ignored;
+    }
+    return !matcher->patterns[best - 1].negated;
+}
+
+int ignore_matcher_resolve_segments(const IgnoreMatcher* matcher,
+                                    const char* const* segments,
+                                    size_t segment_count,
+                                    int is_dir,
+                                    int initial_ignored) {
+    if (!matcher) return 0;
+    return resolve_compiled(matcher,
+                            (segment_count > 0) ? segments[segment_count - 1] : "",
+                            segments,
+                            segment_count,
+                            is_dir,
+                            initial_ignored);
+}
+
+int ignore_matcher_resolve(const IgnoreMatcher* matcher,
+                           const char* filepath,
+                           int is_dir,
+                           int initial_ignored) {
+    PathSegments rel_segments = {0};
+    const char* rel;
+    const char* base;
+    int ignored;
+
+    if (!matcher) return 0;
+
+    rel = (strncmp(filepath, "./", 2) == 0) ? filepath + 2 : filepath;
+    base = strrchr(rel, '/');
+    base = (base) ? base + 1 : rel;
+    if (split_path_segments(rel, &rel_segments) != 0) {
+        return 1;
+    }
+    ignored = resolve_compiled(matcher,
+                               base,
+                               (const char* const*)rel_segments.items,
+                               rel_segments.count,
+                               is_dir,
+                               initial_ignored);
+    free_path_segments(&rel_segments);
+    return ignored;
+}
+
+int ignore_matcher_segments_may_have_included_descendants(const IgnoreMatcher* matcher,
+                                                          const char* const* segments,
+                                                          size_t segment_count) {
+    size_t node = 0;
+
+    if (!matcher || (!segments && segment_count > 0)) {
+        errno = EINVAL;
+        return 0;
+    }
+    if (matcher->has_negated_basename) {
+        return 1;
+    }
+
+    for (size_t depth = 0; matcher->nodes[node].negated_below; depth++) {
+        const IgnoreTrieNode* trie_node = &matcher->nodes[node];
+
+        /* Once the directory is used up, anything negated below it may apply. */
+        if (depth == segment_count) {
+            return 1;
+        }
+        for (size_t i = 0; i < trie_node->pattern_count; i++) {
+            const IgnorePattern* pattern = &matcher->patterns[trie_node->patterns[i]];
+
+            if (pattern->negated &&
+                pattern_can_match_at_or_below_path(pattern->segment_items,
+                                                   pattern->segment_count,
+                                                   depth,
+                                                   segments,
+                                                   segment_count,
+                                                   depth)) {
+                return 1;
+            }
+        }
+        node = find_trie_child(matcher, node, segments[depth]);
+        if (node == 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+int ignore_matcher_may_have_included_descendants(const IgnoreMatcher* matcher, const char* dirpath) {
+    PathSegments dir_segments = {0};
+    int result;
+
+    if (!matcher || !dirpath) {
+        errno = EINVAL;
+        return 0;
+    }
+    if (split_path_segments((strncmp(dirpath, "./", 2) == 0) ? dirpath + 2 : dirpath, &dir_segments) != 0) {
+        return 1;
+    }
+    result = ignore_matcher_segments_may_have_included_descendants(matcher,
+                                                                   (const char* const*)dir_segments.items,
+                                                                   dir_segments.count);
+    free_path_segments(&dir_segments);
+    return result;
+}
+
+void free_ignore_matcher(IgnoreMatcher* matcher) {
+    if (!matcher) return;
+    for (size_t i = 0; i < matcher->node_count; i++) {
+        free(matcher->nodes[i].patterns);
+    }
+    free(matcher->nodes);
+    free(matcher->edge_index.slots);
+    free(matcher->literal_index.slots);
+    free(matcher->literals);
+    free(matcher->suffix_index.slots);
+    free(matcher->suffixes);
+    free(matcher->basename_globs);
+    free(matcher);
+}
+
+int load_ignore_scope(int dir_fd,
+                      const char* name,
+                      const IgnoreScope* parent,
+                      size_t depth,
+                      IgnoreScope** scope_out) {
+    int open_flags = O_RDONLY | O_NOFOLLOW;
+    IgnoreScope* scope = NULL;
+    size_t capacity = 0;
+    struct stat st;
+    FILE* file;
+    int fd;
+
+    if (!name || !scope_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *scope_out = NULL;
+
+#ifdef O_CLOEXEC
+    open_flags |= O_CLOEXEC;
+#endif
+    fd = openat(dir_fd, name, open_flags);
+    if (fd == -1) {
+        /* Like git, a missing or symlinked ignore file contributes nothing. */
+        return (errno == ENOENT || errno == ELOOP) ? 0 : -1;
+    }
+    if (fstat(fd, &st) == 0 && !S_ISREG(st.st_mode)) {
+        close(fd);
+        return 0;
+    }
+    file = fdopen(fd, "r");
+    if (!file) {
+        int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
         return -1;
     }
 
-    free(line);
-    if (fclose(file) != 0) {
-        cleanup_patterns(patterns, *count);
-        *count = 0;
+    scope = calloc(1, sizeof(*scope));
+    if (!scope) {
+        fclose(file);
         return -1;
     }
+    scope->parent = parent;
+    scope->depth = depth;
+    if (read_ignore_file(file, &scope->patterns, &scope->pattern_count, &capacity) != 0) {
+        free_ignore_scope(scope);
+        return -1;
+    }
+    if (scope->pattern_count == 0) {
+        free_ignore_scope(scope);
+        return 0;
+    }
+    if (compile_ignore_matcher(scope->patterns, scope->pattern_count, &scope->matcher) != 0) {
+        free_ignore_scope(scope);
+        return -1;
+    }
+    *scope_out = scope;
     return 0;
 }
 
-void free_ignore_patterns(IgnorePattern* patterns, size_t count) {
-    if (!patterns) return;
-    for (size_t i = 0; i < count; i++) {
-        free_pattern_fields(&patterns[i]);
+int ignore_scope_resolve_segments(const IgnoreScope* scope,
+                                  const char* const* segments,
+                                  size_t segment_count,
+                                  int is_dir,
+                                  int initial_ignored) {
+    const char* base = (segment_count > 0) ? segments[segment_count - 1] : "";
+
+    /* The innermost scope with any matching pattern decides. */
+    for (; scope; scope = scope->parent) {
+        size_t best;
+
+        if (!scope->matcher || scope->depth > segment_count) {
+            continue;
+        }
+        best = match_compiled(scope->matcher,
+                              base,
+                              segments + scope->depth,
+                              segment_count - scope->depth,
+                              is_dir,
+                              initial_ignored);
+        if (best != 0) {
+            return !scope->matcher->patterns[best - 1].negated;
+        }
     }
-    free(patterns);
+    return initial_ignored;
+}
+
+int ignore_scope_segments_may_have_included_descendants(const IgnoreScope* scope,
+                                                        const char* const* segments,
+                                                        size_t segment_count) {
+    for (; scope; scope = scope->parent) {
+        if (scope->matcher && scope->depth <= segment_count &&
+            ignore_matcher_segments_may_have_included_descendants(scope->matcher,
+                                                                  segments + scope->depth,
+                                                                  segment_count - scope->depth)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void free_ignore_scope(IgnoreScope* scope) {
+    if (!scope) return;
+    free_ignore_matcher(scope->matcher);
+    free_ignore_patterns(scope->patterns, scope->pattern_count);
+    free(scope);
 }
@@ -29,4 +29,61 @@ int load_ignore_patterns(const char* ignore_file,
                          size_t* count);
 void free_ignore_patterns(IgnorePattern* patterns, size_t count);
 
+/*
+ * Indexed form of a pattern list with the same results as
+ * resolve_ignore_state() and ignored_directory_may_have_included_descendants().
+ * It borrows patterns, which must outlive the matcher.
+ */
+typedef struct IgnoreMatcher IgnoreMatcher;
+
+int compile_ignore_matcher(const IgnorePattern* patterns, size_t count, IgnoreMatcher** matcher_out);
+int ignore_matcher_resolve(const IgnoreMatcher* matcher,
+                           const char* filepath,
+                           int is_dir,
+                           int initial_ignored);
+int ignore_matcher_may_have_included_descendants(const IgnoreMatcher* matcher, const char* dirpath);
+/*
+ * Allocation-free forms for callers that already hold the path split into
+ * segments (no "." or empty entries); the basename is the last segment.
+ */
+int ignore_matcher_resolve_segments(const IgnoreMatcher* matcher,
+                                    const char* const* segments,
+                                    size_t segment_count,
+                                    int is_dir,
+                                    int initial_ignored);
+int ignore_matcher_segments_may_have_included_descendants(const IgnoreMatcher* matcher,
+                                                          const char* const* segments,
+                                                          size_t segment_count);
+void free_ignore_matcher(IgnoreMatcher* matcher);
+
+/*
+ * Patterns from one ignore file, matched relative to the directory holding it
+ * (depth segments below the walk root). Scopes chain to their enclosing ones;
+ * the innermost scope with a matching pattern decides, as with nested
+ * .gitignore files. A scope does not own its parent.
+ */
+typedef struct IgnoreScope {
+    const struct IgnoreScope* parent;
+    size_t depth;
+    IgnorePattern* patterns;
+    size_t pattern_count;
+    IgnoreMatcher* matcher;
+} IgnoreScope;
+
+/* Leaves *scope_out NULL when the file is missing, a symlink, or holds no patterns. */
+int load_ignore_scope(int dir_fd,
+                      const char* name,
+                      const IgnoreScope* parent,
+                      size_t depth,
+                      IgnoreScope** scope_out);
+int ignore_scope_resolve_segments(const IgnoreScope* scope,
+                                  const char* const* segments,
+                                  size_t segment_count,
+                                  int is_dir,
+                                  int initial_ignored);
+int ignore_scope_segments_may_have_included_descendants(const IgnoreScope* scope,
+                                                        const char* const* segments,
+                                                        size_t segment_count);
+void free_ignore_scope(IgnoreScope* scope);
+
 #endif
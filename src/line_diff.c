@@ -0,0 +1,704 @@
+#include "line_diff.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Edit cost after which a bisection settles for the furthest-reaching split. */
+#define LINE_DIFF_MAX_COST_MIN 256
+/* Ranges with at least this many lines try unique-line anchors before Myers. */
+#define LINE_DIFF_PATIENCE_MIN 256
+
+typedef struct {
+    const unsigned char* start;
+    size_t len;
+} DiffLine;
+
+typedef struct {
+    const uint32_t* a;
+    const uint32_t* b;
+    unsigned char* a_changed;
+    unsigned char* b_changed;
+    ptrdiff_t* forward;
+    ptrdiff_t* backward;
+    size_t max_cost;
+    uint32_t* count_a;  // Per line id, reset after every patience pass.
+    uint32_t* count_b;
+    size_t* pos_b;
+} DiffContext;
+
+typedef struct {
+    size_t a;
+    size_t b;
+} DiffAnchor;
+
+static size_t count_lines(const unsigned char* buf, size_t len) {
+    size_t count = 0;
+    const unsigned char* p = buf;
+    const unsigned char* end = buf + len;
+
+    while (p < end) {
+        const unsigned char* nl = memchr(p, '\n', (size_t)(end - p));
+        count++;
+        if (!nl) {
+            break;
+        }
+        p = nl + 1;
+    }
+    return count;
+}
+
+static DiffLine* split_lines(const unsigned char* buf, size_t len, size_t* count_out) {
+    size_t count = count_lines(buf, len);
+    DiffLine* lines = malloc((count > 0 ? count : 1) * sizeof(*lines));
+    const unsigned char* p = buf;
+    const unsigned char* end = buf + len;
+
+    if (!lines) {
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char* nl = memchr(p, '\n', (size_t)(end - p));
+        const unsigned char* next = nl ? nl + 1 : end;
+        lines[i].start = p;
+        lines[i].len = (size_t)(next - p);
+        p = next;
+    }
+    *count_out = count;
+    return lines;
+}
+
+static uint64_t hash_line(const DiffLine* line) {
+    uint64_t hash = 1469598103934665603ULL;
+
+    for (size_t i = 0; i < line->len; i++) {
+        hash ^= line->start[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+ * Replaces every line of both files by a small integer id so the diff
+ * compares words instead of byte ranges. Equal lines share an id.
+ */
+static int intern_lines(const DiffLine* old_lines,
+                        size_t old_count,
+                        const DiffLine* new_lines,
+                        size_t new_count,
+                        uint32_t* old_ids,
+                        uint32_t* new_ids,
+                        size_t* id_count_out) {
+    size_t total = old_count + new_count;
+    size_t capacity = 16;
+    const DiffLine** slots;
+    uint32_t* slot_ids;
+    size_t id_count = 0;
+
+    if (total > UINT32_MAX) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    while (capacity < total * 2) {
+        capacity *= 2;
+    }
+    slots = calloc(capacity, sizeof(*slots));
+    slot_ids = malloc(capacity * sizeof(*slot_ids));
+    if (!slots || !slot_ids) {
+        free(slots);
+        free(slot_ids);
+        return -1;
+    }
+
+    for (size_t i = 0; i < total; i++) {
+        const DiffLine* line = (i < old_count) ? &old_lines[i] : &new_lines[i - old_count];
+        size_t slot = (size_t)hash_line(line) & (capacity - 1);
+
+        while (slots[slot] &&
+               (slots[slot]->len != line->len || memcmp(slots[slot]->start, line->start, line->len) != 0)) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (!slots[slot]) {
+            slots[slot] = line;
+            slot_ids[slot] = (uint32_t)id_count++;
+        }
+        if (i < old_count) {
+            old_ids[i] = slot_ids[slot];
+        } else {
+            new_ids[i - old_count] = slot_ids[slot];
+        }
+    }
+
+    free(slots);
+    free(slot_ids);
+    *id_count_out = id_count;
+    return 0;
+}
+
+static void mark_changed(unsigned char* changed, size_t from, size_t to) {
+    if (to > from) {
+        memset(changed + from, 1, to - from);
+    }
+}
+
+/*
+ * Myers' bisection: walks the edit graph of a[off1,lim1) x b[off2,lim2) from
+ * both corners until the paths overlap and returns that middle-snake point.
+ * Past max_cost the furthest forward point found so far is used instead,
+ * trading minimality for a bounded run time. Returns 1 when no usable split
+ * exists and the whole range should be treated as changed.
+ */
+static int diff_bisect(DiffContext* d,
+                       size_t off1,
+                       size_t lim1,
+                       size_t off2,
+                       size_t lim2,
+                       size_t* split1,
+                       size_t* split2) {
+    const uint32_t* a = d->a + off1;
+    const uint32_t* b = d->b + off2;
+    ptrdiff_t len1 = (ptrdiff_t)(lim1 - off1);
+    ptrdiff_t len2 = (ptrdiff_t)(lim2 - off2);
+    ptrdiff_t max_d = (len1 + len2 + 1) / 2;
+    ptrdiff_t v_offset = max_d;
+    ptrdiff_t v_length = 2 * max_d + 2;
+    ptrdiff_t delta = len1 - len2;
+    int front = (delta & 1) != 0;
+    ptrdiff_t k1start = 0;
+    ptrdiff_t k1end = 0;
+    ptrdiff_t k2start = 0;
+    ptrdiff_t k2end = 0;
+    ptrdiff_t best_x = 0;
+    ptrdiff_t best_y = 0;
+    ptrdiff_t* v1 = d->forward;
+    ptrdiff_t* v2 = d->backward;
+    ptrdiff_t x1;
+    ptrdiff_t y1;
+    ptrdiff_t x2;
+    ptrdiff_t y2;
+
+    for (ptrdiff_t i = 0; i < v_length; i++) {
+        v1[i] = -1;
+        v2[i] = -1;
+    }
+    v1[v_offset + 1] = 0;
+    v2[v_offset + 1] = 0;
+
+    for (ptrdiff_t cost = 0; cost < max_d; cost++) {
+        if ((size_t)cost > d->max_cost && best_x + best_y > 0) {
+            x1 = best_x;
+            y1 = best_y;
+            goto split;
+        }
+
+        for (ptrdiff_t k1 = -cost + k1start; k1 <= cost - k1end; k1 += 2) {
+            ptrdiff_t k1_offset = v_offset + k1;
+
+            if (k1 == -cost || (k1 != cost && v1[k1_offset - 1] < v1[k1_offset + 1])) {
+                x1 = v1[k1_offset + 1];
+            } else {
+                x1 = v1[k1_offset - 1] + 1;
+            }
+            y1 = x1 - k1;
+            while (x1 < len1 && y1 < len2 && a[x1] == b[y1]) {
+                x1++;
+                y1++;
+            }
+            v1[k1_offset] = x1;
+            if (x1 > len1) {
+                k1end += 2;
+            } else if (y1 > len2) {
+                k1start += 2;
+            } else {
+                if (x1 + y1 > best_x + best_y) {
+                    best_x = x1;
+                    best_y = y1;
+                }
+                if (front) {
+                    ptrdiff_t k2_offset = v_offset + delta - k1;
+                    if (k2_offset >= 0 && k2_offset < v_length && v2[k2_offset] != -1 &&
+                        x1 >= len1 - v2[k2_offset]) {
+                        goto split;
+                    }
+                }
+            }
+        }
+
+        for (ptrdiff_t k2 = -cost + k2start; k2 <= cost - k2end; k2 += 2) {
+            ptrdiff_t k2_offset = v_offset + k2;
+
+            if (k2 == -cost || (k2 != cost && v2[k2_offset - 1] < v2[k2_offset + 1])) {
+                x2 = v2[k2_offset + 1];
+            } else {
+                x2 = v2[k2_offset - 1] + 1;
+            }
+            y2 = x2 - k2;
+            while (x2 < len1 && y2 < len2 && a[len1 - x2 - 1] == b[len2 - y2 - 1]) {
+                x2++;
+                y2++;
+            }
+            v2[k2_offset] = x2;
+            if (x2 > len1) {
+                k2end += 2;
+            } else if (y2 > len2) {
+                k2start += 2;
+            } else if (!front) {
+                ptrdiff_t k1_offset = v_offset + delta - k2;
+                if (k1_offset >= 0 && k1_offset < v_length && v1[k1_offset] != -1) {
+                    x1 = v1[k1_offset];
+                    y1 = v_offset + x1 - k1_offset;
+                    if (x1 >= len1 - x2) {
+                        goto split;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+
+split:
+    /* A corner split would recurse on the same range forever. */
+    if ((x1 == 0 && y1 == 0) || (x1 == len1 && y1 == len2)) {
+        return 1;
+    }
+    *split1 = off1 + (size_t)x1;
+    *split2 = off2 + (size_t)y1;
+    return 0;
+}
+
+static int diff_compare(DiffContext* d, size_t off1, size_t lim1, size_t off2, size_t lim2);
+
+/* Longest increasing run of b positions among anchors already sorted by a. */
+static size_t select_anchor_chain(DiffAnchor* anchors, size_t count) {
+    size_t* tails = malloc(count * sizeof(*tails));
+    size_t* previous = malloc(count * sizeof(*previous));
+    size_t length = 0;
+
+    if (!tails || !previous) {
+        free(tails);
+        free(previous);
+        return SIZE_MAX;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t lo = 0;
+        size_t hi = length;
+
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (anchors[tails[mid]].b < anchors[i].b) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        previous[i] = (lo > 0) ? tails[lo - 1] : SIZE_MAX;
+        tails[lo] = i;
+        if (lo == length) {
+            length++;
+        }
+    }
+
+    /* Compact the chain to the front of anchors, in order. */
+    if (length > 0) {
+        size_t index = tails[length - 1];
+        for (size_t i = length; i > 0; i--) {
+            tails[i - 1] = index;
+            index = previous[index];
+        }
+        for (size_t i = 0; i < length; i++) {
+            anchors[i] = anchors[tails[i]];
+        }
+    }
+    free(tails);
+    free(previous);
+    return length;
+}
+
+/*
+ * Patience step: lines that occur exactly once on each side are matched in
+ * order and the gaps between them are diffed separately. On large files this
+ * keeps Myers' work proportional to the edited regions and lines up moved
+ * blocks by their distinctive lines. Returns 1 when anchors handled the
+ * range, 0 when there were none, and -1 on allocation failure.
+ */
+static int diff_patience(DiffContext* d, size_t off1, size_t lim1, size_t off2, size_t lim2) {
+    DiffAnchor* anchors;
+    size_t anchor_count = 0;
+    size_t chain;
+    size_t prev1 = off1;
+    size_t prev2 = off2;
+    int status = 1;
+
+    for (size_t i = off1; i < lim1; i++) {
+        d->count_a[d->a[i]]++;
+    }
+    for (size_t j = off2; j < lim2; j++) {
+        d->count_b[d->b[j]]++;
+        d->pos_b[d->b[j]] = j;
+    }
+    anchors = malloc((lim1 - off1) * sizeof(*anchors));
+    if (anchors) {
+        for (size_t i = off1; i < lim1; i++) {
+            uint32_t id = d->a[i];
+            if (d->count_a[id] == 1 && d->count_b[id] == 1) {
+                anchors[anchor_count].a = i;
+                anchors[anchor_count].b = d->pos_b[id];
+                anchor_count++;
+            }
+        }
+    }
+    for (size_t i = off1; i < lim1; i++) {
+        d->count_a[d->a[i]] = 0;
+    }
+    for (size_t j = off2; j < lim2; j++) {
+        d->count_b[d->b[j]] = 0;
+    }
+    if (!anchors) {
+        return -1;
+    }
+    if (anchor_count == 0) {
+        free(anchors);
+        return 0;
+    }
+
+    chain = select_anchor_chain(anchors, anchor_count);
+    if (chain == SIZE_MAX) {
+        free(anchors);
+        return -1;
+    }
+    for (size_t i = 0; i < chain; i++) {
+        if (diff_compare(d, prev1, anchors[i].a, prev2, anchors[i].b) != 0) {
+            status = -1;
+            break;
+        }
+        prev1 = anchors[i].a + 1;
+        prev2 = anchors[i].b + 1;
+    }
+    if (status == 1 && diff_compare(d, prev1, lim1, prev2, lim2) != 0) {
+        status = -1;
+    }
+    free(anchors);
+    return status;
+}
+
+static int diff_compare(DiffContext* d, size_t off1, size_t lim1, size_t off2, size_t lim2) {
+    size_t split1;
+    size_t split2;
+    int anchored;
+
+    while (off1 < lim1 && off2 < lim2 && d->a[off1] == d->b[off2]) {
+        off1++;
+        off2++;
+    }
+    while (off1 < lim1 && off2 < lim2 && d->a[lim1 - 1] == d->b[lim2 - 1]) {
+        lim1--;
+        lim2--;
+    }
+    if (off1 == lim1 || off2 == lim2) {
+        mark_changed(d->a_changed, off1, lim1);
+        mark_changed(d->b_changed, off2, lim2);
+        return 0;
+    }
+
+    if ((lim1 - off1) + (lim2 - off2) >= LINE_DIFF_PATIENCE_MIN) {
+        anchored = diff_patience(d, off1, lim1, off2, lim2);
+        if (anchored != 0) {
+            return (anchored < 0) ? -1 : 0;
+        }
+    }
+
+    if (diff_bisect(d, off1, lim1, off2, lim2, &split1, &split2) != 0) {
+        mark_changed(d->a_changed, off1, lim1);
+        mark_changed(d->b_changed, off2, lim2);
+        return 0;
+    }
+    if (diff_compare(d, off1, split1, off2, split2) != 0) {
+        return -1;
+    }
+    return diff_compare(d, split1, lim1, split2, lim2);
+}
+
+/* One file's line ids and change marks, walked group by group while compacting. */
+typedef struct {
+    const uint32_t* ids;
+    unsigned char* changed;
+    size_t count;
+} DiffSide;
+
+/* A run of changed lines [start, end); empty between two unchanged lines. */
+typedef struct {
+    size_t start;
+    size_t end;
+} DiffGroup;
+
+static void group_init(const DiffSide* side, DiffGroup* g) {
+    g->start = 0;
+    g->end = 0;
+    while (g->end < side->count && side->changed[g->end]) {
+        g->end++;
+    }
+}
+
+static int group_next(const DiffSide* side, DiffGroup* g) {
+    if (g->end == side->count) {
+        return -1;
+    }
+    g->start = g->end + 1;
+    g->end = g->start;
+    while (g->end < side->count && side->changed[g->end]) {
+        g->end++;
+    }
+    return 0;
+}
+
+static int group_previous(const DiffSide* side, DiffGroup* g) {
+    if (g->start == 0) {
+        return -1;
+    }
+    g->end = g->start - 1;
+    g->start = g->end;
+    while (g->start > 0 && side->changed[g->start - 1]) {
+        g->start--;
+    }
+    return 0;
+}
+
+/* Moves a group one line down when the line past it equals its first line. */
+static int group_slide_down(DiffSide* side, DiffGroup* g) {
+    if (g->end == side->count || side->ids[g->start] != side->ids[g->end]) {
+        return -1;
+    }
+    side->changed[g->start++] = 0;
+    side->changed[g->end++] = 1;
+    while (g->end < side->count && side->changed[g->end]) {
+        g->end++;
+    }
+    return 0;
+}
+
+static int group_slide_up(DiffSide* side, DiffGroup* g) {
+    if (g->start == 0 || side->ids[g->start - 1] != side->ids[g->end - 1]) {
+        return -1;
+    }
+    side->changed[--g->start] = 1;
+    side->changed[--g->end] = 0;
+    while (g->start > 0 && side->changed[g->start - 1]) {
+        g->start--;
+    }
+    return 0;
+}
+
+/*
+ * Shifts each change group of side through runs of repeated lines the way
+ * git's xdl_change_compact() does, so ranges match `git diff
+ * --no-indent-heuristic`: a group slides up and then down as far as it can,
+ * merging with any group it touches, and comes back up to line up with the
+ * last change on the other side it passed, if any. Both sides stay in step
+ * because each slide swaps an unchanged line across the group.
+ */
+static void compact_changes(DiffSide* side, DiffSide* other) {
+    DiffGroup g;
+    DiffGroup go;
+
+    group_init(side, &g);
+    group_init(other, &go);
+    for (;;) {
+        if (g.end != g.start) {
+            size_t group_size;
+            size_t earliest_end;
+            size_t end_matching_other;
+            int matched;
+
+            do {
+                group_size = g.end - g.start;
+                matched = 0;
+                end_matching_other = 0;
+
+                while (group_slide_up(side, &g) == 0) {
+                    group_previous(other, &go);
+                }
+                earliest_end = g.end;
+                if (go.end > go.start) {
+                    matched = 1;
+                    end_matching_other = g.end;
+                }
+                while (group_slide_down(side, &g) == 0) {
+                    group_next(other, &go);
+                    if (go.end > go.start) {
+                        matched = 1;
+                        end_matching_other = g.end;
+                    }
+                }
+            } while (group_size != g.end - g.start);
+
+            if (g.end != earliest_end && matched) {
+                while (go.end == go.start && g.end > end_matching_other) {
+                    group_slide_up(side, &g);
+                    group_previous(other, &go);
+                }
+            }
+        }
+        if (group_next(side, &g) != 0 || group_next(other, &go) != 0) {
+            break;
+        }
+    }
+}
+
+static size_t diff_max_cost(size_t total_lines) {
+    size_t root = 1;
+
+    while (root * root < total_lines) {
+        root++;
+    }
+    return (root > LINE_DIFF_MAX_COST_MIN) ? root : LINE_DIFF_MAX_COST_MIN;
+}
+
+static int append_hunk_range(GitFileHunks* hunks, size_t* capacity, size_t new_start, size_t new_count) {
+    if (hunks->count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 4 : *capacity * 2;
+        GitHunkRange* new_ranges = realloc(hunks->ranges, new_capacity * sizeof(*new_ranges));
+        if (!new_ranges) {
+            return -1;
+        }
+        hunks->ranges = new_ranges;
+        *capacity = new_capacity;
+    }
+    hunks->ranges[hunks->count].new_start = new_start;
+    hunks->ranges[hunks->count].new_count = new_count;
+    hunks->count++;
+    return 0;
+}
+
+/* Turns per-line change marks into -U0 style new-side ranges. */
+static int build_hunks(const unsigned char* a_changed,
+                       size_t old_count,
+                       const unsigned char* b_changed,
+                       size_t new_count,
+                       GitFileHunks* hunks) {
+    size_t capacity = hunks->count;
+    size_t i = 0;
+    size_t j = 0;
+
+    while (i < old_count || j < new_count) {
+        size_t group_old = i;
+        size_t group_new = j;
+
+        if (i < old_count && j < new_count && !a_changed[i] && !b_changed[j]) {
+            i++;
+            j++;
+            continue;
+        }
+        while ((i < old_count && a_changed[i]) || (j < new_count && b_changed[j])) {
+            if (i < old_count && a_changed[i]) {
+                i++;
+            }
+            if (j < new_count && b_changed[j]) {
+                j++;
+            }
+        }
+        if (i == group_old && j == group_new) {
+            /* Unchanged lines left on only one side; the marks are inconsistent. */
+            errno = EINVAL;
+            return -1;
+        }
+        if (append_hunk_range(hunks,
+                              &capacity,
+                              (j > group_new) ? group_new + 1 : group_new,
+                              j - group_new) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int compute_line_hunks(const unsigned char* old_buf,
+                       size_t old_len,
+                       const unsigned char* new_buf,
+                       size_t new_len,
+                       GitFileHunks* hunks) {
+    DiffContext d;
+    DiffSide old_side;
+    DiffSide new_side;
+    DiffLine* old_lines = NULL;
+    DiffLine* new_lines = NULL;
+    uint32_t* ids = NULL;
+    unsigned char* changed = NULL;
+    size_t old_count = 0;
+    size_t new_count = 0;
+    size_t id_count = 0;
+    size_t v_length;
+    int status = -1;
+
+    if ((!old_buf && old_len > 0) || (!new_buf && new_len > 0) || !hunks) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(&d, 0, sizeof(d));
+
+    old_lines = split_lines(old_buf, old_len, &old_count);
+    new_lines = split_lines(new_buf, new_len, &new_count);
+    ids = malloc((old_count + new_count + 1) * sizeof(*ids));
+    changed = calloc(old_count + new_count + 1, 1);
+    if (!old_lines || !new_lines || !ids || !changed) {
+        goto cleanup;
+    }
+    if (intern_lines(old_lines, old_count, new_lines, new_count, ids, ids + old_count, &id_count) != 0) {
+        goto cleanup;
+    }
+
+    v_length = 2 * ((old_count + new_count + 1) / 2) + 2;
+    d.a = ids;
+    d.b = ids + old_count;
+    d.a_changed = changed;
+    d.b_changed = changed + old_count;
+    d.max_cost = diff_max_cost(old_count + new_count);
+    d.forward = malloc(v_length * sizeof(*d.forward));
+    d.backward = malloc(v_length * sizeof(*d.backward));
+    d.count_a = calloc(id_count + 1, sizeof(*d.count_a));
+    d.count_b = calloc(id_count + 1, sizeof(*d.count_b));
+    d.pos_b = malloc((id_count + 1) * sizeof(*d.pos_b));
+    if (!d.forward || !d.backward || !d.count_a || !d.count_b || !d.pos_b) {
+        goto cleanup;
+    }
+
+    if (diff_compare(&d, 0, old_count, 0, new_count) != 0) {
+        goto cleanup;
+    }
+    old_side.ids = d.a;
+    old_side.changed = d.a_changed;
+    old_side.count = old_count;
+    new_side.ids = d.b;
+    new_side.changed = d.b_changed;
+    new_side.count = new_count;
+    compact_changes(&old_side, &new_side);
+    compact_changes(&new_side, &old_side);
+    if (build_hunks(d.a_changed, old_count, d.b_changed, new_count, hunks) != 0) {
+        goto cleanup;
+    }
+    status = 0;
+
+cleanup:
+    free(d.forward);
+    free(d.backward);
+    free(d.count_a);
+    free(d.count_b);
+    free(d.pos_b);
+    free(old_lines);
+    free(new_lines);
+    free(ids);
+    free(changed);
+    return status;
+}
+
+void free_git_hunks(GitFileHunks* hunks, size_t count) {
+    if (!hunks) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        free(hunks[i].ranges);
+    }
+    free(hunks);
+}
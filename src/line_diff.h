@@ -0,0 +1,37 @@
+#ifndef LINE_DIFF_H
+#define LINE_DIFF_H
+
+#include <stddef.h>
+
+/*
+ * New-side line range of one change, numbered like `git diff -U0`: a pure
+ * deletion has new_count == 0 and new_start naming the line it follows
+ * (0 for the top of the file).
+ */
+typedef struct {
+    size_t new_start;
+    size_t new_count;
+} GitHunkRange;
+
+typedef struct {
+    GitHunkRange* ranges;
+    size_t count;
+    int whole_file;  // No base version exists; the file renders in full.
+} GitFileHunks;
+
+/*
+ * Diffs two buffers line by line (a line keeps its '\n', so a missing final
+ * newline counts as a change) and appends the changed ranges to hunks in
+ * new-file order. Uses Myers' linear-space algorithm with a cost cap, and
+ * anchors large inputs on lines unique to both sides (patience diff) first.
+ * Changes are then slid through repeated lines as git does, so an ambiguous
+ * insertion lands where `git diff -U0` puts it.
+ */
+int compute_line_hunks(const unsigned char* old_buf,
+                       size_t old_len,
+                       const unsigned char* new_buf,
+                       size_t new_len,
+                       GitFileHunks* hunks);
+void free_git_hunks(GitFileHunks* hunks, size_t count);
+
+#endif
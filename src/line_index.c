@@ -0,0 +1,112 @@
+#include "line_index.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int append_checkpoint(LineIndex* index, size_t* capacity, size_t offset) {
+    int wide = index->text_len > UINT32_MAX;
+
+    if (index->checkpoint_count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 16 : *capacity * 2;
+        size_t width = wide ? sizeof(size_t) : sizeof(uint32_t);
+        void* grown;
+
+        if (new_capacity > SIZE_MAX / width) {
+            errno = ENOMEM;
+            return -1;
+        }
+        grown = realloc(wide ? (void*)index->starts : (void*)index->starts32, new_capacity * width);
+        if (!grown) {
+            return -1;
+        }
+        if (wide) {
+            index->starts = grown;
+        } else {
+            index->starts32 = grown;
+        }
+        *capacity = new_capacity;
+    }
+
+    if (wide) {
+        index->starts[index->checkpoint_count] = offset;
+    } else {
+        index->starts32[index->checkpoint_count] = (uint32_t)offset;
+    }
+    index->checkpoint_count++;
+    return 0;
+}
+
+int build_line_index(const unsigned char* buf, size_t len, LineIndex* index) {
+    const unsigned char* p = buf;
+    const unsigned char* end = buf + len;
+    size_t capacity = 0;
+
+    if ((!buf && len > 0) || !index) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(index, 0, sizeof(*index));
+    index->text_len = len;
+    if (len > 0 && append_checkpoint(index, &capacity, 0) != 0) {
+        free_line_index(index);
+        return -1;
+    }
+
+    while (p < end) {
+        const unsigned char* newline = memchr(p, '\n', (size_t)(end - p));
+
+        index->line_count++;
+        if (!newline) {
+            break;
+        }
+        p = newline + 1;
+        if (p < end && index->line_count % LINE_INDEX_STRIDE == 0 &&
+            append_checkpoint(index, &capacity, (size_t)(p - buf)) != 0) {
+            free_line_index(index);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int line_index_is_built(const LineIndex* index) {
+    return index && (index->starts32 || index->starts);
+}
+
+size_t line_index_start(const LineIndex* index, const unsigned char* buf, size_t line_no) {
+    size_t checkpoint;
+    size_t skip;
+    size_t offset;
+
+    if (line_no <= 1) {
+        return 0;
+    }
+    if (line_no > index->line_count) {
+        return index->text_len;
+    }
+
+    checkpoint = (line_no - 1) / LINE_INDEX_STRIDE;
+    skip = (line_no - 1) % LINE_INDEX_STRIDE;
+    offset = index->starts ? index->starts[checkpoint] : index->starts32[checkpoint];
+    while (skip-- > 0) {
+        const unsigned char* newline = memchr(buf + offset, '\n', index->text_len - offset);
+
+        if (!newline) {
+            return index->text_len;
+        }
+        offset = (size_t)(newline - buf) + 1;
+    }
+    return offset;
+}
+
+void free_line_index(LineIndex* index) {
+    if (!index) {
+        return;
+    }
+    free(index->starts32);
+    free(index->starts);
+    memset(index, 0, sizeof(*index));
+}
@@ -0,0 +1,33 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Lines between checkpoints; a lookup scans at most this many newlines. */
+#define LINE_INDEX_STRIDE 64
+
+/*
+ * Sparse line index over a file body: the start offset of every
+ * LINE_INDEX_STRIDE-th line, held in 32 bits unless the body is 4 GiB or
+ * larger. Lines between checkpoints are found with memchr(), so the index
+ * costs well under a byte per line.
+ */
+typedef struct {
+    size_t line_count;  // Newline-terminated lines plus any unterminated tail.
+    size_t text_len;
+    size_t checkpoint_count;
+    uint32_t* starts32;  // Start of lines 1, 1 + STRIDE, ... for bodies under 4 GiB.
+    size_t* starts;      // The same for larger bodies.
+} LineIndex;
+
+int build_line_index(const unsigned char* buf, size_t len, LineIndex* index);
+int line_index_is_built(const LineIndex* index);
+/*
+ * Offset where 1-based line line_no starts in buf, the body the index was
+ * built from; line_count + 1 maps to the end of the body.
+ */
+size_t line_index_start(const LineIndex* index, const unsigned char* buf, size_t line_no);
+void free_line_index(LineIndex* index);
+
+#endif
@@ -10,11 +10,15 @@
 #include <unistd.h>
 
 #include "app.h"
+#include "cache_file.h"
+#include "classify_cache.h"
 #include "collect.h"
 #include "ignore.h"
 #include "options.h"
+#include "output_writer.h"
 #include "render.h"
 #include "tree.h"
+#include "walk_cache.h"
 
 #ifndef VERSION
 #define VERSION "dev"
@@ -82,6 +86,21 @@ static void print_export_summary(const ExportMetrics* metrics) {
     fprintf(stderr, "Est. tokens:    ~%s  (approx, assuming BPE ~3.5 chars/token)\n", tokens_buf);
 }
 
+/* extra holds the parallel render workers' share, if any. */
+static void print_output_writer_stats(const OutputWriter* writer, const OutputWriterStats* extra) {
+    OutputWriterStats stats;
+
+    output_writer_stats(writer, &stats);
+    stats.write_calls += extra->write_calls;
+    stats.kernel_copy_calls += extra->kernel_copy_calls;
+    stats.bytes_written += extra->bytes_written;
+    fprintf(stderr,
+            "Output writes:  %zu writev call(s), %zu kernel copy call(s) for %zu MiB\n",
+            stats.write_calls,
+            stats.kernel_copy_calls,
+            (stats.bytes_written + 1024 * 1024 - 1) / (1024 * 1024));
+}
+
 static void print_verbose_skip_summary(const AppContext* ctx) {
     char binary_buf[32];
     char large_buf[32];
@@ -196,20 +215,6 @@ static int format_generated_timestamp(char* buffer, size_t buffer_size) {
     return 0;
 }
 
-static int fsync_stream_file(FILE* file) {
-    int fd;
-
-    if (!file) {
-        errno = EINVAL;
-        return -1;
-    }
-    fd = fileno(file);
-    if (fd == -1) {
-        return -1;
-    }
-    return fsync(fd);
-}
-
 static int fsync_parent_directory(const char* path) {
     char path_copy[MAX_PATH_LENGTH];
     int dir_fd = -1;
@@ -310,6 +315,8 @@ static void compact_selected_paths_to_export_plan(SelectedPath* selected_paths,
                 path->repo_rel_path = NULL;
                 path->previous_display_path = NULL;
                 path->previous_repo_rel_path = NULL;
+                path->blob_oid = NULL;
+                path->base_oid = NULL;
             }
             write_index++;
             continue;
@@ -320,16 +327,97 @@ static void compact_selected_paths_to_export_plan(SelectedPath* selected_paths,
         free(path->repo_rel_path);
         free(path->previous_display_path);
         free(path->previous_repo_rel_path);
+        free(path->blob_oid);
+        free(path->base_oid);
         path->open_path = NULL;
         path->display_path = NULL;
         path->repo_rel_path = NULL;
         path->previous_display_path = NULL;
         path->previous_repo_rel_path = NULL;
+        path->blob_oid = NULL;
+        path->base_oid = NULL;
     }
 
     *selected_count = write_index;
 }
 
+/* The caches only save work; failing to open one falls back to doing everything. */
+static int resolve_cli_cache_directory(const CliOptions* options, char* buffer, size_t buffer_size) {
+    int len;
+
+    if (!options->cache_path) {
+        if (default_cache_directory(buffer, buffer_size) != 0) {
+            fprintf(stderr, "Warning: Failed to locate cache directory: %s\n", strerror(errno));
+            return -1;
+        }
+        return 0;
+    }
+    len = snprintf(buffer, buffer_size, "%s", options->cache_path);
+    if (len < 0 || (size_t)len >= buffer_size) {
+        errno = ENAMETOOLONG;
+    } else if (prepare_cache_directory(buffer) == 0) {
+        return 0;
+    }
+    fprintf(stderr, "Warning: Failed to create cache directory %s: %s\n", options->cache_path, strerror(errno));
+    return -1;
+}
+
+static int format_cli_cache_path(const char* directory, const char* name, char* buffer, size_t buffer_size) {
+    int len = snprintf(buffer, buffer_size, "%s/%s", directory, name);
+
+    if (len < 0 || (size_t)len >= buffer_size) {
+        fprintf(stderr, "Warning: Cache path too long: %s/%s\n", directory, name);
+        return -1;
+    }
+    return 0;
+}
+
+static void open_cli_classify_cache(const char* cache_dir, AppContext* ctx) {
+    char path[MAX_PATH_LENGTH];
+
+    if (format_cli_cache_path(cache_dir, CLASSIFY_CACHE_NAME, path, sizeof(path)) != 0) {
+        return;
+    }
+    if (open_classify_cache(path, &ctx->classify_cache) != 0) {
+        fprintf(stderr, "Warning: Failed to open classification cache %s: %s\n", path, strerror(errno));
+    }
+}
+
+static void open_cli_walk_cache(const char* cache_dir, AppContext* ctx) {
+    char path[MAX_PATH_LENGTH];
+
+    if (format_cli_cache_path(cache_dir, WALK_CACHE_NAME, path, sizeof(path)) != 0) {
+        return;
+    }
+    if (open_walk_cache(path, &ctx->walk_cache) != 0) {
+        fprintf(stderr, "Warning: Failed to open directory cache %s: %s\n", path, strerror(errno));
+    }
+}
+
+static void save_cli_caches(AppContext* ctx) {
+    size_t hits = 0;
+    size_t stored = 0;
+
+    if (ctx->walk_cache) {
+        walk_cache_counts(ctx->walk_cache, &hits, &stored);
+        if (save_walk_cache(ctx->walk_cache) != 0) {
+            fprintf(stderr, "Warning: Failed to update directory cache: %s\n", strerror(errno));
+        }
+        if (ctx->verbose) {
+            fprintf(stderr, "Directory cache: %zu hit(s), %zu new record(s)\n", hits, stored);
+        }
+    }
+    if (ctx->classify_cache) {
+        classify_cache_counts(ctx->classify_cache, &hits, &stored);
+        if (save_classify_cache(ctx->classify_cache) != 0) {
+            fprintf(stderr, "Warning: Failed to update classification cache: %s\n", strerror(errno));
+        }
+        if (ctx->verbose) {
+            fprintf(stderr, "Classification cache: %zu hit(s), %zu new record(s)\n", hits, stored);
+        }
+    }
+}
+
 int main(int argc, char* argv[]) {
     CliOptions options;
     AppContext ctx = {0};
@@ -339,12 +427,19 @@ int main(int argc, char* argv[]) {
     RenderPlanInfo render_info = {0};
     ExportRenderContext render_ctx = {0};
     ExportMetrics metrics = {0};
+    IngestStream* ingest_stream = NULL;
+    SelectedPathListener listener = {ingest_selected_path, NULL};
     int status = 1;
     int temp_created = 0;
-    int output_needs_close = 0;
-    FILE* output_file = NULL;
+    int output_fd = -1;
+    OutputWriter* output_writer = NULL;
+    OutputWriterStats render_stats = {0};
+    size_t render_workers;
+    int render_status;
     char temp_output_path[MAX_PATH_LENGTH];
     char repository_name[MAX_PATH_LENGTH];
+    char cache_dir[MAX_PATH_LENGTH];
+    int have_cache_dir = 0;
     char generated_at[32];
     temp_output_path[0] = '\0';
     if (parse_cli_options(argc, argv, &options) != 0) {
@@ -358,34 +453,21 @@ int main(int argc, char* argv[]) {
         print_usage(argv[0]);
         return 0;
     }
-    if (resolve_cli_selection(&options, &selected_paths, &selected_count) != 0) {
-        goto cleanup;
-    }
-    if (validate_resolved_cli_options(&options) != 0) {
-        goto cleanup;
-    }
 
     ctx.verbose = options.verbose;
     ctx.no_clobber = options.no_clobber;
     ctx.output_is_stdout = options.output_is_stdout;
     ctx.show_tree = options.show_tree;
     ctx.allow_sensitive = options.allow_sensitive;
+    ctx.use_mmap = options.use_mmap;
+    ctx.stream_bodies = options.stream_bodies;
     ctx.max_file_size = options.max_file_size;
+    ctx.jobs = options.jobs;
     ctx.tree_depth = options.tree_depth;
     ctx.warn_tokens = options.warn_tokens;
     ctx.max_tokens = options.max_tokens;
     ctx.output_path = options.output_path;
 
-    if (options.resolved_mode == FILE_SELECTION_RECURSIVE) {
-        if (load_ignore_patterns(IGNORE_FILE,
-                                 !options.no_default_ignore,
-                                 &ctx.ignore_patterns,
-                                 &ctx.ignore_count) != 0) {
-            fprintf(stderr, "Error: Failed to initialize ignore patterns.\n");
-            goto cleanup;
-        }
-    }
-
     if (ctx.output_is_stdout) {
         if (fstat(fileno(stdout), &ctx.final_stat) == 0 &&
             S_ISREG(ctx.final_stat.st_mode)) {
@@ -405,18 +487,66 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (options.use_cache && resolve_cli_cache_directory(&options, cache_dir, sizeof(cache_dir)) == 0) {
+        have_cache_dir = 1;
+        open_cli_classify_cache(cache_dir, &ctx);
+    }
+
+    ctx.collect_started = time(NULL);
+    /* Git listings are ingested while git is still producing them. */
+    if (options.requested_mode != FILE_SELECTION_RECURSIVE &&
+        options.requested_mode != FILE_SELECTION_STDIN) {
+        if (open_ingest_stream(&ctx, &ingest_stream) != 0) {
+            perror("Error starting file ingestion");
+            goto cleanup;
+        }
+        listener.state = ingest_stream;
+    }
+    if (resolve_cli_selection(&options,
+                              ingest_stream ? &listener : NULL,
+                              &selected_paths,
+                              &selected_count) != 0) {
+        goto cleanup;
+    }
+    if (validate_resolved_cli_options(&options) != 0) {
+        goto cleanup;
+    }
+
+    if (options.resolved_mode == FILE_SELECTION_RECURSIVE) {
+        /* Auto mode fell back to the filesystem walk; nothing was listed. */
+        close_ingest_stream(ingest_stream);
+        ingest_stream = NULL;
+        if (load_ignore_patterns(IGNORE_EXCLUDE_FILE,
+                                 !options.no_default_ignore,
+                                 &ctx.ignore_patterns,
+                                 &ctx.ignore_count) != 0 ||
+            compile_ignore_matcher(ctx.ignore_patterns, ctx.ignore_count, &ctx.ignore_matcher) != 0) {
+            fprintf(stderr, "Error: Failed to initialize ignore patterns.\n");
+            goto cleanup;
+        }
+        if (have_cache_dir) {
+            open_cli_walk_cache(cache_dir, &ctx);
+        }
+    }
+
     if (options.resolved_mode == FILE_SELECTION_RECURSIVE) {
         if (collect_recursive_export_plan(&ctx, &plan) != 0) {
             fprintf(stderr, "Error collecting directory entries\n");
             goto cleanup;
         }
     } else {
-        if (collect_selected_export_plan(selected_paths, selected_count, &ctx, &plan) != 0) {
+        if (ingest_stream) {
+            if (finish_ingest_stream(ingest_stream, &ctx, &plan) != 0) {
+                fprintf(stderr, "Error collecting selected files\n");
+                goto cleanup;
+            }
+        } else if (collect_selected_export_plan(selected_paths, selected_count, &ctx, &plan) != 0) {
             fprintf(stderr, "Error collecting selected files\n");
             goto cleanup;
         }
         compact_selected_paths_to_export_plan(selected_paths, &selected_count, &plan);
     }
+    save_cli_caches(&ctx);
 
     if (resolve_repository_name(options.resolved_mode, repository_name, sizeof(repository_name)) != 0) {
         perror("Error resolving repository name");
@@ -434,6 +564,8 @@ int main(int argc, char* argv[]) {
     render_ctx.selected_paths = selected_paths;
     render_ctx.selected_count = selected_count;
     render_ctx.diff_range = options.diff_range;
+    render_ctx.revision = options.revision;
+    render_ctx.baseline_dir = options.baseline_dir;
     render_ctx.show_line_numbers = options.show_line_numbers;
     render_ctx.show_hunks = options.show_hunks;
     render_ctx.show_unpacker = options.show_unpacker;
@@ -489,47 +621,52 @@ int main(int argc, char* argv[]) {
     }
 
     if (ctx.output_is_stdout) {
-        output_file = stdout;
+        /* The writer bypasses stdio, so nothing may stay buffered ahead of it. */
+        if (fflush(stdout) != 0) {
+            perror("Error flushing stdout");
+            goto cleanup;
+        }
+        if (open_output_writer(STDOUT_FILENO, &output_writer) != 0) {
+            perror("Error opening output writer");
+            goto cleanup;
+        }
     } else {
         if (make_temp_output_template(ctx.output_path, temp_output_path, sizeof(temp_output_path)) != 0) {
             perror("Error creating temporary output path");
             goto cleanup;
         }
 
-        int temp_fd = mkstemp(temp_output_path);
-        if (temp_fd == -1) {
+        output_fd = mkstemp(temp_output_path);
+        if (output_fd == -1) {
             perror("Error creating temporary output file");
             goto cleanup;
         }
         temp_created = 1;
 
-        output_file = fdopen(temp_fd, "w");
-        if (!output_file) {
-            perror("Error opening temporary output stream");
-            close(temp_fd);
+        if (open_output_writer(output_fd, &output_writer) != 0) {
+            perror("Error opening output writer");
             goto cleanup;
         }
-        output_needs_close = 1;
 
-        if (fstat(fileno(output_file), &ctx.temp_stat) == -1) {
+        if (fstat(output_fd, &ctx.temp_stat) == -1) {
             perror("fstat on temporary output file");
             goto cleanup;
         }
         ctx.have_temp = 1;
     }
 
-    if (write_export_header(output_file, &render_ctx) != 0) {
+    if (write_export_header(output_writer, &render_ctx) != 0) {
         perror("Error writing output header");
         goto cleanup;
     }
 
-    if (write_change_context(output_file, &render_ctx) != 0) {
+    if (write_change_context(output_writer, &render_ctx) != 0) {
         perror("Error writing change context");
         goto cleanup;
     }
 
     if (render_ctx.show_tree) {
-        if (write_project_tree_filtered(output_file,
+        if (write_project_tree_filtered(output_writer,
                                         &plan,
                                         render_info.include_mask,
                                         render_ctx.tree_depth) != 0) {
@@ -538,8 +675,28 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    /* A temp file can be filled out of order, so its entries are rendered in parallel. */
+    render_workers = (output_fd != -1) ? resolve_worker_count(ctx.jobs, render_info.visible_count) : 1;
     errno = 0;
-    if (render_export_plan(output_file, &plan, &render_info, &render_ctx, ctx.verbose) != 0) {
+    if (render_workers > 1) {
+        off_t entries_offset = -1;
+
+        if (output_writer_flush(output_writer) == 0) {
+            entries_offset = lseek(output_fd, 0, SEEK_CUR);
+        }
+        render_status = (entries_offset < 0) ? -1
+                                             : render_export_plan_parallel(output_fd,
+                                                                           entries_offset,
+                                                                           &plan,
+                                                                           &render_info,
+                                                                           &render_ctx,
+                                                                           render_workers,
+                                                                           ctx.verbose,
+                                                                           &render_stats);
+    } else {
+        render_status = render_export_plan(output_writer, &plan, &render_info, &render_ctx, ctx.verbose);
+    }
+    if (render_status != 0) {
         if (errno != 0) {
             perror("Error processing export files");
         } else {
@@ -548,22 +705,23 @@ int main(int argc, char* argv[]) {
         goto cleanup;
     }
 
-    if (fflush(output_file) != 0) {
+    if (output_writer_flush(output_writer) != 0) {
         perror("Error flushing output file");
         goto cleanup;
     }
-    if (output_needs_close) {
-        if (fsync_stream_file(output_file) != 0) {
+    if (output_fd != -1) {
+        int close_status;
+
+        if (fsync(output_fd) != 0) {
             perror("Error syncing temporary output file");
             goto cleanup;
         }
-        if (fclose(output_file) != 0) {
-            output_file = NULL;
+        close_status = close(output_fd);
+        output_fd = -1;
+        if (close_status != 0) {
             perror("Error closing output file");
             goto cleanup;
         }
-        output_file = NULL;
-        output_needs_close = 0;
     }
 
     if (!ctx.output_is_stdout) {
@@ -584,21 +742,29 @@ int main(int argc, char* argv[]) {
     }
 
     print_export_summary(&metrics);
+    if (ctx.verbose) {
+        print_output_writer_stats(output_writer, &render_stats);
+    }
     print_unreadable_directory_warning(&ctx);
     print_verbose_skip_summary(&ctx);
 
     status = 0;
 
 cleanup:
-    if (output_needs_close && output_file) {
-        fclose(output_file);
+    close_output_writer(output_writer);
+    if (output_fd != -1) {
+        close(output_fd);
     }
     if (temp_created && temp_output_path[0] != '\0') {
         unlink(temp_output_path);
     }
+    close_ingest_stream(ingest_stream);
     free_export_plan(&plan);
     free_render_plan_info(&render_info);
     free_selected_paths(selected_paths, selected_count);
+    free_ignore_matcher(ctx.ignore_matcher);
     free_ignore_patterns(ctx.ignore_patterns, ctx.ignore_count);
+    close_classify_cache(ctx.classify_cache);
+    close_walk_cache(ctx.walk_cache);
     return status;
 }
@@ -39,7 +39,7 @@ static int parse_size_value(const char* value,
 }
 
 static void print_selection_mode_conflict(void) {
-    fprintf(stderr, "--from-stdin, --staged, --unstaged, and --diff are mutually exclusive\n");
+    fprintf(stderr, "--from-stdin, --staged, --unstaged, --diff, and --rev are mutually exclusive\n");
     fprintf(stderr, "Use -h or --help for usage information\n");
 }
 
@@ -49,7 +49,7 @@ static void print_no_default_ignore_conflict(void) {
 }
 
 static void print_hunks_conflict(void) {
-    fprintf(stderr, "--hunks can only be used with --staged, --unstaged, or --diff\n");
+    fprintf(stderr, "--hunks can only be used with --staged, --unstaged, --diff, or --baseline\n");
     fprintf(stderr, "Use -h or --help for usage information\n");
 }
 
@@ -86,16 +86,23 @@ void print_usage(const char* argv0) {
     printf("      --staged        Export staged files from the current Git subtree\n");
     printf("      --unstaged      Export unstaged tracked files from the current Git subtree\n");
     printf("      --diff <r>      Export files changed by a git diff range (for example main...HEAD)\n");
+    printf("      --rev <c>       Export the current Git subtree as of commit c, without a checkout\n");
     printf("      --from-stdin    Read paths from stdin instead of using Git or filesystem selection\n");
-    printf("                      --from-stdin, --staged, --unstaged, and --diff are mutually exclusive\n");
+    printf("                      --from-stdin, --staged, --unstaged, --diff, and --rev are mutually exclusive\n");
     printf("  -0, --null          Use NUL as the input record delimiter instead of newline (requires --from-stdin)\n");
     printf("      --line-numbers  Prefix exported code lines with line numbers\n");
     printf("      --hunks[=N]     Export only changed hunks with N context lines (default: 3)\n");
+    printf("      --baseline <d>  Compute --hunks against the same paths under directory d\n");
     printf("      --unpacker      Append an LLM-oriented unpacker appendix for full exports\n");
     printf("      --tree          Include a directory tree section (default)\n");
     printf("      --no-tree       Omit the directory tree section\n");
     printf("      --tree-depth    Limit tree rendering depth to N levels\n");
     printf("  -s <size_kb>        Set maximum file size limit in KB (default: 100)\n");
+    printf("  -j, --jobs <n>      Read, classify, and render files with N worker threads (default: online CPUs)\n");
+    printf("      --mmap          Map larger files read-only instead of copying them into memory\n");
+    printf("                      (a file truncated while mapped aborts fuori with SIGBUS)\n");
+    printf("      --stream        Re-read file bodies while rendering instead of keeping them in memory\n");
+    printf("      --cache[=<d>]   Reuse classifications and directory listings from earlier runs (default: ~/.cache/fuori)\n");
     printf("      --warn-tokens   Warn if estimated tokens exceed N (default: %d)\n",
            DEFAULT_WARN_TOKENS);
     printf("      --max-tokens    Fail if estimated tokens exceed N\n");
@@ -139,6 +146,20 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
                 fprintf(stderr, "Use -h or --help for usage information\n");
                 return -1;
             }
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) {
+            if (i + 1 < argc) {
+                if (parse_size_value(argv[++i], "jobs", 1, FUORI_MAX_JOBS, &options->jobs) != 0) {
+                    return -1;
+                }
+            } else {
+                fprintf(stderr, "Missing value for -j/--jobs option\n");
+                fprintf(stderr, "Use -h or --help for usage information\n");
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            if (parse_size_value(argv[i] + 7, "jobs", 1, FUORI_MAX_JOBS, &options->jobs) != 0) {
+                return -1;
+            }
         } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) {
             if (i + 1 < argc) {
                 options->output_path = argv[++i];
@@ -175,6 +196,22 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
             options->no_clobber = 1;
         } else if (strcmp(argv[i], "--allow-sensitive") == 0) {
             options->allow_sensitive = 1;
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            options->use_mmap = 1;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            options->stream_bodies = 1;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            options->use_cache = 1;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options->cache_path = argv[++i];
+            }
+        } else if (strncmp(argv[i], "--cache=", 8) == 0) {
+            options->use_cache = 1;
+            options->cache_path = argv[i] + 8;
+            if (options->cache_path[0] == '\0') {
+                fprintf(stderr, "Invalid cache path: empty string\n");
+                return -1;
+            }
         } else if (strcmp(argv[i], "--tree") == 0) {
             options->show_tree = 1;
         } else if (strcmp(argv[i], "--no-tree") == 0) {
@@ -204,6 +241,23 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
                                  &options->hunk_context_lines) != 0) {
                 return -1;
             }
+        } else if (strcmp(argv[i], "--baseline") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Missing directory value for --baseline option\n");
+                fprintf(stderr, "Use -h or --help for usage information\n");
+                return -1;
+            }
+            options->baseline_dir = argv[++i];
+            if (options->baseline_dir[0] == '\0') {
+                fprintf(stderr, "Invalid baseline directory: empty string\n");
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--baseline=", 11) == 0) {
+            options->baseline_dir = argv[i] + 11;
+            if (options->baseline_dir[0] == '\0') {
+                fprintf(stderr, "Invalid baseline directory: empty string\n");
+                return -1;
+            }
         } else if (strcmp(argv[i], "--tree-depth") == 0) {
             if (i + 1 < argc) {
                 if (parse_size_value(argv[++i], "tree depth", 1, SIZE_MAX, &options->tree_depth) != 0) {
@@ -285,6 +339,33 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
                 return -1;
             }
             options->requested_mode = FILE_SELECTION_GIT_DIFF;
+        } else if (strcmp(argv[i], "--rev") == 0) {
+            if (options->requested_mode != FILE_SELECTION_AUTO) {
+                print_selection_mode_conflict();
+                return -1;
+            }
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Missing commit value for --rev option\n");
+                fprintf(stderr, "Use -h or --help for usage information\n");
+                return -1;
+            }
+            options->revision = argv[++i];
+            if (options->revision[0] == '\0') {
+                fprintf(stderr, "Invalid revision: empty string\n");
+                return -1;
+            }
+            options->requested_mode = FILE_SELECTION_GIT_REV;
+        } else if (strncmp(argv[i], "--rev=", 6) == 0) {
+            if (options->requested_mode != FILE_SELECTION_AUTO) {
+                print_selection_mode_conflict();
+                return -1;
+            }
+            options->revision = argv[i] + 6;
+            if (options->revision[0] == '\0') {
+                fprintf(stderr, "Invalid revision: empty string\n");
+                return -1;
+            }
+            options->requested_mode = FILE_SELECTION_GIT_REV;
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             options->show_help = 1;
             return 0;
@@ -296,7 +377,7 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
     }
 
     if (force_no_git && options->requested_mode != FILE_SELECTION_AUTO) {
-        fprintf(stderr, "--no-git cannot be combined with --from-stdin, --staged, --unstaged, or --diff\n");
+        fprintf(stderr, "--no-git cannot be combined with --from-stdin, --staged, --unstaged, --diff, or --rev\n");
         fprintf(stderr, "Use -h or --help for usage information\n");
         return -1;
     }
@@ -311,15 +392,32 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
         (options->requested_mode == FILE_SELECTION_STDIN ||
          options->requested_mode == FILE_SELECTION_GIT_STAGED ||
          options->requested_mode == FILE_SELECTION_GIT_UNSTAGED ||
-         options->requested_mode == FILE_SELECTION_GIT_DIFF)) {
+         options->requested_mode == FILE_SELECTION_GIT_DIFF ||
+         options->requested_mode == FILE_SELECTION_GIT_REV)) {
         print_no_default_ignore_conflict();
         return -1;
     }
 
+    if (options->baseline_dir && !options->show_hunks) {
+        fprintf(stderr, "--baseline requires --hunks\n");
+        fprintf(stderr, "Use -h or --help for usage information\n");
+        return -1;
+    }
+    if (options->baseline_dir &&
+        (options->requested_mode == FILE_SELECTION_GIT_STAGED ||
+         options->requested_mode == FILE_SELECTION_GIT_UNSTAGED ||
+         options->requested_mode == FILE_SELECTION_GIT_DIFF)) {
+        fprintf(stderr, "--baseline cannot be combined with --staged, --unstaged, or --diff\n");
+        fprintf(stderr, "Use -h or --help for usage information\n");
+        return -1;
+    }
+
     if (options->show_hunks &&
+        !options->baseline_dir &&
         (options->requested_mode == FILE_SELECTION_AUTO ||
          options->requested_mode == FILE_SELECTION_RECURSIVE ||
          options->requested_mode == FILE_SELECTION_GIT_WORKTREE ||
+         options->requested_mode == FILE_SELECTION_GIT_REV ||
          options->requested_mode == FILE_SELECTION_STDIN)) {
         print_hunks_conflict();
         return -1;
@@ -337,6 +435,7 @@ int parse_cli_options(int argc, char* argv[], CliOptions* options) {
 }
 
 int resolve_cli_selection(CliOptions* options,
+                          const SelectedPathListener* listener,
                           SelectedPath** selected_paths_out,
                           size_t* selected_count_out) {
     GitPathResult git_result = GIT_PATHS_FALLBACK;
@@ -353,6 +452,7 @@ int resolve_cli_selection(CliOptions* options,
         if (collect_git_paths(FILE_SELECTION_GIT_WORKTREE,
                               NULL,
                               1,
+                              listener,
                               selected_paths_out,
                               selected_count_out,
                               &git_result) != 0) {
@@ -375,8 +475,10 @@ int resolve_cli_selection(CliOptions* options,
     }
 
     return collect_git_paths(options->resolved_mode,
-                             options->diff_range,
+                             (options->resolved_mode == FILE_SELECTION_GIT_REV) ? options->revision
+                                                                                : options->diff_range,
                              0,
+                             listener,
                              selected_paths_out,
                              selected_count_out,
                              &git_result);
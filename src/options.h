@@ -17,13 +17,20 @@ typedef struct {
     int show_unpacker;
     int no_default_ignore;
     int allow_sensitive;
+    int use_mmap;
+    int stream_bodies;
     size_t max_file_size;
+    size_t jobs;
     size_t hunk_context_lines;
     size_t tree_depth;
     size_t warn_tokens;
     size_t max_tokens;
     const char* output_path;
     const char* diff_range;
+    const char* revision;
+    const char* baseline_dir;
+    int use_cache;
+    const char* cache_path;  // Cache directory; NULL selects the default location.
     FileSelectionMode requested_mode;
     FileSelectionMode resolved_mode;
 } CliOptions;
@@ -31,7 +38,9 @@ typedef struct {
 void init_cli_options(CliOptions* options);
 void print_usage(const char* argv0);
 int parse_cli_options(int argc, char* argv[], CliOptions* options);
+/* listener, when set, sees Git-selected paths while they are being listed. */
 int resolve_cli_selection(CliOptions* options,
+                          const SelectedPathListener* listener,
                           SelectedPath** selected_paths_out,
                           size_t* selected_count_out);
 int validate_resolved_cli_options(const CliOptions* options);
@@ -0,0 +1,415 @@
+/* copy_file_range(), splice(), and pwritev() are Linux extensions glibc hides under strict POSIX. */
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "output_writer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#define OUTPUT_WRITER_HAVE_SENDFILE 1
+#define OUTPUT_WRITER_HAVE_SPLICE 1
+#define OUTPUT_WRITER_HAVE_PWRITEV 1
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define OUTPUT_WRITER_HAVE_COPY_FILE_RANGE 1
+#endif
+#endif
+
+#define OUTPUT_WRITER_BUFFER_SIZE (1024 * 1024)
+/* Below this, queuing an iovec costs more than copying the bytes. */
+#define OUTPUT_WRITER_MIN_REFERENCE 2048
+
+#if defined(IOV_MAX) && IOV_MAX < 1024
+#define OUTPUT_WRITER_MAX_IOVECS IOV_MAX
+#else
+#define OUTPUT_WRITER_MAX_IOVECS 1024
+#endif
+
+/* Largest single kernel copy request; Linux caps transfers just below 2 GiB anyway. */
+#define OUTPUT_WRITER_MAX_KERNEL_COPY (1024 * 1024 * 1024)
+
+typedef enum {
+    KERNEL_COPY_FILE_RANGE = 1 << 0,
+    KERNEL_COPY_SPLICE = 1 << 1,
+    KERNEL_COPY_SENDFILE = 1 << 2
+} KernelCopyMethod;
+
+struct OutputWriter {
+    int fd;
+    char* buffer;
+    size_t buffer_len;
+    struct iovec iov[OUTPUT_WRITER_MAX_IOVECS];
+    size_t iov_count;
+    int last_iov_staged;  // The last iovec ends at buffer + buffer_len and can grow in place.
+    int kernel_methods;   // KernelCopyMethod bits still worth trying on fd; -1 until probed.
+    int positional;       // Writes go to offset with pwrite(); fd's own file offset is left alone.
+    off_t offset;
+    OutputWriterStats stats;
+};
+
+int open_output_writer(int fd, OutputWriter** writer_out) {
+    OutputWriter* writer;
+
+    if (fd < 0 || !writer_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *writer_out = NULL;
+
+    writer = calloc(1, sizeof(*writer));
+    if (!writer) {
+        return -1;
+    }
+    writer->buffer = malloc(OUTPUT_WRITER_BUFFER_SIZE);
+    if (!writer->buffer) {
+        free(writer);
+        return -1;
+    }
+    writer->fd = fd;
+    writer->kernel_methods = -1;
+    *writer_out = writer;
+    return 0;
+}
+
+int open_output_writer_at(int fd, off_t offset, OutputWriter** writer_out) {
+    if (offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (open_output_writer(fd, writer_out) != 0) {
+        return -1;
+    }
+    (*writer_out)->positional = 1;
+    (*writer_out)->offset = offset;
+    return 0;
+}
+
+static ssize_t write_iovecs(OutputWriter* writer, const struct iovec* iov, size_t iov_count) {
+    ssize_t written;
+
+    if (!writer->positional) {
+        return writev(writer->fd, iov, (int)iov_count);
+    }
+#ifdef OUTPUT_WRITER_HAVE_PWRITEV
+    written = pwritev(writer->fd, iov, (int)iov_count, writer->offset);
+#else
+    /* The flush loop treats this as a short write and comes back for the rest. */
+    written = pwrite(writer->fd, iov->iov_base, iov->iov_len, writer->offset);
+#endif
+    if (written > 0) {
+        writer->offset += written;
+    }
+    return written;
+}
+
+int output_writer_flush(OutputWriter* writer) {
+    struct iovec* iov;
+    size_t iov_count;
+
+    if (!writer) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    iov = writer->iov;
+    iov_count = writer->iov_count;
+    while (iov_count > 0) {
+        ssize_t written = write_iovecs(writer, iov, iov_count);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        writer->stats.write_calls++;
+        writer->stats.bytes_written += (size_t)written;
+
+        /* Resume a short write from the first iovec it did not finish. */
+        while (iov_count > 0 && (size_t)written >= iov->iov_len) {
+            written -= (ssize_t)iov->iov_len;
+            iov++;
+            iov_count--;
+        }
+        if (iov_count > 0) {
+            iov->iov_base = (char*)iov->iov_base + written;
+            iov->iov_len -= (size_t)written;
+        }
+    }
+
+    writer->iov_count = 0;
+    writer->buffer_len = 0;
+    writer->last_iov_staged = 0;
+    return 0;
+}
+
+/* Makes room for len staged bytes (at most the buffer size) and returns where they go. */
+static char* reserve_staged(OutputWriter* writer, size_t len) {
+    char* target;
+
+    if (OUTPUT_WRITER_BUFFER_SIZE - writer->buffer_len < len ||
+        (!writer->last_iov_staged && writer->iov_count == OUTPUT_WRITER_MAX_IOVECS)) {
+        if (output_writer_flush(writer) != 0) {
+            return NULL;
+        }
+    }
+
+    target = writer->buffer + writer->buffer_len;
+    if (writer->last_iov_staged) {
+        writer->iov[writer->iov_count - 1].iov_len += len;
+    } else {
+        writer->iov[writer->iov_count].iov_base = target;
+        writer->iov[writer->iov_count].iov_len = len;
+        writer->iov_count++;
+        writer->last_iov_staged = 1;
+    }
+    writer->buffer_len += len;
+    return target;
+}
+
+int output_writer_write(OutputWriter* writer, const void* data, size_t len) {
+    const char* bytes = data;
+
+    if (!writer || (!data && len > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    while (len > 0) {
+        size_t chunk = (len < OUTPUT_WRITER_BUFFER_SIZE) ? len : OUTPUT_WRITER_BUFFER_SIZE;
+        char* target = reserve_staged(writer, chunk);
+
+        if (!target) {
+            return -1;
+        }
+        memcpy(target, bytes, chunk);
+        bytes += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+int output_writer_write_text(OutputWriter* writer, const char* text) {
+    if (!text) {
+        errno = EINVAL;
+        return -1;
+    }
+    return output_writer_write(writer, text, strlen(text));
+}
+
+int output_writer_fill(OutputWriter* writer, char c, size_t count) {
+    if (!writer) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    while (count > 0) {
+        size_t chunk = (count < OUTPUT_WRITER_BUFFER_SIZE) ? count : OUTPUT_WRITER_BUFFER_SIZE;
+        char* target = reserve_staged(writer, chunk);
+
+        if (!target) {
+            return -1;
+        }
+        memset(target, c, chunk);
+        count -= chunk;
+    }
+    return 0;
+}
+
+int output_writer_reference(OutputWriter* writer, const void* data, size_t len) {
+    if (!writer || (!data && len > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (len < OUTPUT_WRITER_MIN_REFERENCE) {
+        return output_writer_write(writer, data, len);
+    }
+
+    if (writer->iov_count == OUTPUT_WRITER_MAX_IOVECS && output_writer_flush(writer) != 0) {
+        return -1;
+    }
+    writer->iov[writer->iov_count].iov_base = (void*)data;
+    writer->iov[writer->iov_count].iov_len = len;
+    writer->iov_count++;
+    writer->last_iov_staged = 0;
+    return 0;
+}
+
+/* Picks the kernel copy methods that can target the writer's fd. */
+static int probe_kernel_methods(int fd, int positional) {
+    struct stat st;
+    int methods = 0;
+
+    if (fstat(fd, &st) != 0) {
+        return 0;
+    }
+#ifdef OUTPUT_WRITER_HAVE_COPY_FILE_RANGE
+    if (S_ISREG(st.st_mode) && !(fcntl(fd, F_GETFL) & O_APPEND)) {
+        methods |= KERNEL_COPY_FILE_RANGE;
+    }
+#endif
+    /* Only copy_file_range() takes an explicit output offset. */
+    if (positional) {
+        return methods;
+    }
+#ifdef OUTPUT_WRITER_HAVE_SPLICE
+    if (S_ISFIFO(st.st_mode)) {
+        methods |= KERNEL_COPY_SPLICE;
+    }
+#endif
+#ifdef OUTPUT_WRITER_HAVE_SENDFILE
+    if (!(fcntl(fd, F_GETFL) & O_APPEND)) {
+        methods |= KERNEL_COPY_SENDFILE;
+    }
+#endif
+    return methods;
+}
+
+/* dst_offset is NULL to write at dst_fd's file offset; only copy_file_range() accepts one. */
+static ssize_t kernel_copy(int method, int src_fd, int dst_fd, off_t* dst_offset, size_t len) {
+    switch (method) {
+#ifdef OUTPUT_WRITER_HAVE_COPY_FILE_RANGE
+        case KERNEL_COPY_FILE_RANGE:
+            return copy_file_range(src_fd, NULL, dst_fd, dst_offset, len, 0);
+#endif
+#ifdef OUTPUT_WRITER_HAVE_SPLICE
+        case KERNEL_COPY_SPLICE:
+            return splice(src_fd, NULL, dst_fd, NULL, len, 0);
+#endif
+#ifdef OUTPUT_WRITER_HAVE_SENDFILE
+        case KERNEL_COPY_SENDFILE:
+            return sendfile(dst_fd, src_fd, NULL, len);
+#endif
+        default:
+            (void)src_fd;
+            (void)dst_fd;
+            (void)dst_offset;
+            (void)len;
+            errno = ENOSYS;
+            return -1;
+    }
+}
+
+/* Errors meaning this method cannot handle these descriptors, rather than a failed copy. */
+static int kernel_copy_unsupported(int error) {
+    return error == EINVAL || error == ENOSYS || error == EXDEV || error == EBADF ||
+           error == EOPNOTSUPP || error == ENOTSUP || error == ETXTBSY;
+}
+
+/* Moves up to *remaining bytes in the kernel; stops early once no method is left. */
+static int copy_file_in_kernel(OutputWriter* writer, int src_fd, size_t* remaining) {
+    if (writer->kernel_methods == -1) {
+        writer->kernel_methods = probe_kernel_methods(writer->fd, writer->positional);
+    }
+
+    while (*remaining > 0 && writer->kernel_methods != 0) {
+        int method = writer->kernel_methods & -writer->kernel_methods;
+        size_t chunk = (*remaining < OUTPUT_WRITER_MAX_KERNEL_COPY) ? *remaining : OUTPUT_WRITER_MAX_KERNEL_COPY;
+        ssize_t copied = kernel_copy(method, src_fd, writer->fd, writer->positional ? &writer->offset : NULL, chunk);
+
+        if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!kernel_copy_unsupported(errno)) {
+                return -1;
+            }
+            /* Both ends keep their offsets, so the next method resumes where this one stopped. */
+            writer->kernel_methods &= ~method;
+            continue;
+        }
+        if (copied == 0) {
+            errno = ESTALE;
+            return -1;
+        }
+        writer->stats.kernel_copy_calls++;
+        writer->stats.bytes_written += (size_t)copied;
+        *remaining -= (size_t)copied;
+    }
+    return 0;
+}
+
+/* Reads straight into the staging buffer. */
+static int copy_file_buffered(OutputWriter* writer, int src_fd, size_t remaining) {
+    while (remaining > 0) {
+        size_t room;
+        ssize_t got;
+
+        if (writer->buffer_len == OUTPUT_WRITER_BUFFER_SIZE ||
+            (!writer->last_iov_staged && writer->iov_count == OUTPUT_WRITER_MAX_IOVECS)) {
+            if (output_writer_flush(writer) != 0) {
+                return -1;
+            }
+        }
+        room = OUTPUT_WRITER_BUFFER_SIZE - writer->buffer_len;
+        got = read(src_fd, writer->buffer + writer->buffer_len, (remaining < room) ? remaining : room);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (got == 0) {
+            errno = ESTALE;
+            return -1;
+        }
+        /* There is room and a free iovec, so this only records the bytes just read. */
+        reserve_staged(writer, (size_t)got);
+        remaining -= (size_t)got;
+    }
+    return 0;
+}
+
+int output_writer_copy_file(OutputWriter* writer, int src_fd, size_t len) {
+    if (!writer || src_fd < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* Kernel copies land directly in fd, so everything queued must go first. */
+    if (output_writer_flush(writer) != 0 || copy_file_in_kernel(writer, src_fd, &len) != 0) {
+        return -1;
+    }
+    return copy_file_buffered(writer, src_fd, len);
+}
+
+int output_writer_seek(OutputWriter* writer, off_t offset) {
+    if (!writer || !writer->positional || offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (output_writer_flush(writer) != 0) {
+        return -1;
+    }
+    writer->offset = offset;
+    return 0;
+}
+
+off_t output_writer_offset(const OutputWriter* writer) {
+    return (writer && writer->positional) ? writer->offset : -1;
+}
+
+void output_writer_stats(const OutputWriter* writer, OutputWriterStats* stats) {
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (writer) {
+        *stats = writer->stats;
+    }
+}
+
+void close_output_writer(OutputWriter* writer) {
+    if (!writer) return;
+    free(writer->buffer);
+    free(writer);
+}
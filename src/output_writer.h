@@ -0,0 +1,52 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+ * Gather-writer for the export. Small fragments are copied into one large
+ * staging buffer, while file bodies are queued by reference and go out with
+ * the staged bytes in a single writev(), so they are never copied. Memory
+ * passed to output_writer_reference() must stay valid and unchanged until
+ * the next output_writer_flush().
+ */
+typedef struct OutputWriter OutputWriter;
+
+typedef struct {
+    size_t write_calls;        // writev() or pwritev() calls, including retries after short writes.
+    size_t kernel_copy_calls;  // copy_file_range(), splice(), or sendfile() calls.
+    size_t bytes_written;
+} OutputWriterStats;
+
+/* Writes to fd, which stays owned by the caller. */
+int open_output_writer(int fd, OutputWriter** writer_out);
+/*
+ * Writes to fd from offset on with pwrite(), leaving fd's file offset alone,
+ * so several writers can fill disjoint parts of one preallocated file.
+ */
+int open_output_writer_at(int fd, off_t offset, OutputWriter** writer_out);
+int output_writer_write(OutputWriter* writer, const void* data, size_t len);
+int output_writer_write_text(OutputWriter* writer, const char* text);
+/* Writes count copies of c. */
+int output_writer_fill(OutputWriter* writer, char c, size_t count);
+/* Queues data without copying it; short spans are copied anyway. */
+int output_writer_reference(OutputWriter* writer, const void* data, size_t len);
+/*
+ * Appends the next len bytes of src_fd, from its current offset. On Linux
+ * they move in the kernel (copy_file_range() to a regular file, splice() to
+ * a pipe, sendfile() otherwise; positional writers only the first), and
+ * whatever those cannot take is read through the staging buffer. Fails with
+ * ESTALE if src_fd ends early.
+ */
+int output_writer_copy_file(OutputWriter* writer, int src_fd, size_t len);
+int output_writer_flush(OutputWriter* writer);
+/* For positional writers: flushes, then continues at offset. */
+int output_writer_seek(OutputWriter* writer, off_t offset);
+/* Where a flushed positional writer writes next; -1 for the others. */
+off_t output_writer_offset(const OutputWriter* writer);
+void output_writer_stats(const OutputWriter* writer, OutputWriterStats* stats);
+/* Frees the writer without flushing it. */
+void close_output_writer(OutputWriter* writer);
+
+#endif
@@ -1,34 +1,41 @@
 #include "render.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "text_io.h"
 #include "tree.h"
 #include "unpacker.h"
 
 #ifdef FUORI_TESTING
-static int maybe_inject_render_failure(size_t index) {
-    static int initialized = 0;
-    static int enabled = 0;
-    static size_t fail_index = 0;
-
-    if (!initialized) {
-        const char* value = getenv("FUORI_TEST_FAIL_RENDER_AT");
-        initialized = 1;
-        if (value && *value != '\0') {
-            char* end = NULL;
-            unsigned long parsed = strtoul(value, &end, 10);
-            if (end != value && *end == '\0') {
-                fail_index = (size_t)parsed;
-                enabled = 1;
-            }
+static pthread_once_t render_failure_once = PTHREAD_ONCE_INIT;
+static int render_failure_enabled = 0;
+static size_t render_failure_index = 0;
+
+static void load_render_failure_index(void) {
+    const char* value = getenv("FUORI_TEST_FAIL_RENDER_AT");
+
+    if (value && *value != '\0') {
+        char* end = NULL;
+        unsigned long parsed = strtoul(value, &end, 10);
+        if (end != value && *end == '\0') {
+            render_failure_index = (size_t)parsed;
+            render_failure_enabled = 1;
         }
     }
+}
 
-    if (enabled && index == fail_index) {
+/* Called from render workers too, hence the pthread_once(). */
+static int maybe_inject_render_failure(size_t index) {
+    pthread_once(&render_failure_once, load_render_failure_index);
+    if (render_failure_enabled && index == render_failure_index) {
         errno = EIO;
         return -1;
     }
@@ -47,23 +54,32 @@ static int add_size(size_t* total, size_t amount) {
 }
 
 typedef struct {
-    FILE* out;
+    OutputWriter* out;
     size_t* total;
+    int transient_bodies;       // Bodies are released right after the entry; see sink_release_bodies().
+    int referenced_transient;
 } RenderSink;
 
-typedef struct {
-    size_t* starts;
-    size_t* ends;
-    size_t count;
-} LineIndex;
+/*
+ * Referencing a streamed body forces a flush before it is released, so
+ * smaller ones are copied instead and keep riding in the staging buffer.
+ */
+#define TRANSIENT_BODY_REFERENCE_MIN (256 * 1024)
+/*
+ * Below a page, the flush and extra syscalls a kernel copy costs outweigh
+ * reading and re-scanning the body.
+ */
+#define KERNEL_COPY_MIN_BODY 4096
 
 static int count_fence_bytes(size_t* total, size_t count, const char* lang);
-static int write_fence(FILE* out, size_t count, const char* lang);
+static int write_fence(OutputWriter* out, size_t count, const char* lang);
 
 static const char* FILES_BEGIN_MARKER = "<!-- FUORI_FILES_BEGIN -->\n\n";
 static const char* FILES_END_MARKER = "<!-- FUORI_FILES_END -->\n\n";
 static const char* UNPACKER_BEGIN_MARKER = "<!-- FUORI_UNPACKER_BEGIN -->\n\n";
 static const char* UNPACKER_END_MARKER = "<!-- FUORI_UNPACKER_END -->\n";
+static const char* OMISSION_PREFIX = "... ";
+static const char* OMISSION_SUFFIX = " unchanged lines omitted ...\n\n";
 static const char* UNPACKER_EXPLANATION =
     "This export contains complete file bodies and an unpacker helper for frontier LLM workflows. "
     "To reconstruct the tree locally, write the Python script below to a file such as "
@@ -80,6 +96,8 @@ static const char* export_description(FileSelectionMode mode) {
             return "This document contains unstaged tracked files selected from the current Git subtree.\n\n";
         case FILE_SELECTION_GIT_DIFF:
             return "This document contains files selected from the current Git subtree by the requested Git diff range.\n\n";
+        case FILE_SELECTION_GIT_REV:
+            return "This document contains files from the current Git subtree as recorded in the requested revision.\n\n";
         case FILE_SELECTION_STDIN:
             return "This document contains files selected from caller-supplied stdin paths.\n\n";
         case FILE_SELECTION_RECURSIVE:
@@ -100,6 +118,8 @@ static const char* export_mode_label(FileSelectionMode mode) {
             return "unstaged";
         case FILE_SELECTION_GIT_DIFF:
             return "diff";
+        case FILE_SELECTION_GIT_REV:
+            return "rev";
         case FILE_SELECTION_STDIN:
             return "stdin";
         case FILE_SELECTION_RECURSIVE:
@@ -160,7 +180,7 @@ static int sink_write_char(RenderSink* sink, char c) {
         return -1;
     }
     if (sink->out) {
-        return (fputc(c, sink->out) == EOF) ? -1 : 0;
+        return output_writer_write(sink->out, &c, 1);
     }
     if (sink->total) {
         return add_size(sink->total, 1);
@@ -175,7 +195,27 @@ static int sink_write_bytes(RenderSink* sink, const void* data, size_t len) {
         return -1;
     }
     if (sink->out) {
-        return (fwrite(data, 1, len, sink->out) == len) ? 0 : -1;
+        return output_writer_write(sink->out, data, len);
+    }
+    if (sink->total) {
+        return add_size(sink->total, len);
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+/* Like sink_write_bytes(), but file bodies may go out by reference. */
+static int sink_write_body(RenderSink* sink, const void* data, size_t len) {
+    if (!sink || (!data && len > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (sink->out && sink->transient_bodies && len < TRANSIENT_BODY_REFERENCE_MIN) {
+        return output_writer_write(sink->out, data, len);
+    }
+    if (sink->out) {
+        sink->referenced_transient |= sink->transient_bodies;
+        return output_writer_reference(sink->out, data, len);
     }
     if (sink->total) {
         return add_size(sink->total, len);
@@ -184,6 +224,30 @@ static int sink_write_bytes(RenderSink* sink, const void* data, size_t len) {
     return -1;
 }
 
+/* Writes out referenced transient bodies before their memory is released. */
+static int sink_release_bodies(RenderSink* sink) {
+    if (!sink->referenced_transient) {
+        return 0;
+    }
+    sink->referenced_transient = 0;
+    return output_writer_flush(sink->out);
+}
+
+static int sink_fill(RenderSink* sink, char c, size_t count) {
+    if (!sink) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (sink->out) {
+        return output_writer_fill(sink->out, c, count);
+    }
+    if (sink->total) {
+        return add_size(sink->total, count);
+    }
+    errno = EINVAL;
+    return -1;
+}
+
 static int sink_write_fence(RenderSink* sink, size_t count, const char* lang) {
     if (!sink) {
         errno = EINVAL;
@@ -202,6 +266,17 @@ static int sink_write_fence(RenderSink* sink, size_t count, const char* lang) {
 static int emit_markdown_path(RenderSink* sink, const char* path) {
     for (const unsigned char* p = (const unsigned char*)path; *p != '\0'; p++) {
         unsigned char c = *p;
+        size_t run = 0;
+
+        /* Pass plain runs through in one write. */
+        while (p[run] >= 0x20 && p[run] != 0x7f && p[run] != '&' && p[run] != '<' && !needs_markdown_escape(p[run])) {
+            run++;
+        }
+        if (run > 0) {
+            if (sink_write_bytes(sink, p, run) != 0) return -1;
+            p += run - 1;
+            continue;
+        }
         if (c == '&') {
             if (sink_write_text(sink, "&amp;") != 0) return -1;
             continue;
@@ -240,18 +315,37 @@ static int emit_markdown_path(RenderSink* sink, const char* path) {
     return 0;
 }
 
+/* Byte length emit_markdown_path() produces for path. */
+static size_t markdown_path_length(const char* path) {
+    size_t length = 0;
+
+    for (const unsigned char* p = (const unsigned char*)path; *p != '\0'; p++) {
+        unsigned char c = *p;
+        if (c == '&') {
+            length += 5;
+        } else if (c == '<') {
+            length += 4;
+        } else if (c == '\n' || c == '\r' || c == '\t') {
+            length += 2;
+        } else if (c < 0x20 || c == 0x7f) {
+            length += 4;
+        } else {
+            length += needs_markdown_escape(c) ? 2 : 1;
+        }
+    }
+    return length;
+}
+
 static int count_fence_bytes(size_t* total, size_t count, const char* lang) {
     if (add_size(total, count) != 0) return -1;
     if (lang && *lang && add_size(total, strlen(lang)) != 0) return -1;
     return add_size(total, 1);
 }
 
-static int write_fence(FILE* out, size_t count, const char* lang) {
-    for (size_t i = 0; i < count; i++) {
-        if (fputc('`', out) == EOF) return -1;
-    }
+static int write_fence(OutputWriter* out, size_t count, const char* lang) {
+    if (output_writer_fill(out, '`', count) != 0) return -1;
     if (lang && *lang && fuori_write_text(out, lang) != 0) return -1;
-    return (fputc('\n', out) == EOF) ? -1 : 0;
+    return output_writer_write(out, "\n", 1);
 }
 
 static int format_size_value(size_t value, char* buffer, size_t buffer_size) {
@@ -278,23 +372,10 @@ static size_t decimal_digit_count(size_t value) {
 }
 
 static size_t entry_line_count(const ExportEntry* entry) {
-    size_t count = 0;
-
     if (!entry || entry->buf_len == 0) {
         return 0;
     }
-
-    for (size_t i = 0; i < entry->buf_len; i++) {
-        if (entry->buf[i] == '\n') {
-            count++;
-        }
-    }
-
-    if (entry->buf[entry->buf_len - 1] != '\n') {
-        count++;
-    }
-
-    return count;
+    return entry->line_count;
 }
 
 static int emit_line_number_prefix(RenderSink* sink, size_t line_no, size_t width) {
@@ -304,11 +385,8 @@ static int emit_line_number_prefix(RenderSink* sink, size_t line_no, size_t widt
     if (format_size_value(line_no, number_buf, sizeof(number_buf)) != 0) {
         return -1;
     }
-    while (digits < width) {
-        if (sink_write_char(sink, ' ') != 0) {
-            return -1;
-        }
-        digits++;
+    if (digits < width && sink_fill(sink, ' ', width - digits) != 0) {
+        return -1;
     }
     return sink_write_text(sink, number_buf);
 }
@@ -323,8 +401,16 @@ static int emit_export_header(RenderSink* sink, const ExportRenderContext* ctx)
         sink_write_text(sink, "Repository: ") != 0 ||
         sink_write_text(sink, ctx->repository) != 0 ||
         sink_write_text(sink, "\nMode: ") != 0 ||
-        sink_write_text(sink, export_mode_label(ctx->mode)) != 0 ||
-        sink_write_text(sink, "\nGenerated: ") != 0 ||
+        sink_write_text(sink, export_mode_label(ctx->mode)) != 0) {
+        return -1;
+    }
+    if (ctx->mode == FILE_SELECTION_GIT_REV &&
+        ctx->revision &&
+        (sink_write_text(sink, "\nRevision: ") != 0 ||
+         sink_write_text(sink, ctx->revision) != 0)) {
+        return -1;
+    }
+    if (sink_write_text(sink, "\nGenerated: ") != 0 ||
         sink_write_text(sink, ctx->generated_at) != 0) {
         return -1;
     }
@@ -341,6 +427,11 @@ static int emit_export_header(RenderSink* sink, const ExportRenderContext* ctx)
             sink_write_char(sink, ')') != 0) {
             return -1;
         }
+        if (ctx->baseline_dir &&
+            (sink_write_text(sink, "\nBaseline: ") != 0 ||
+             sink_write_text(sink, ctx->baseline_dir) != 0)) {
+            return -1;
+        }
     }
     if (ctx->show_unpacker &&
         sink_write_text(sink, "\nUnpacker: included") != 0) {
@@ -469,32 +560,18 @@ static int emit_unpacker_appendix(RenderSink* sink, const ExportRenderContext* c
     return 0;
 }
 
-int write_export_header(FILE* out, const ExportRenderContext* ctx) {
+int write_export_header(OutputWriter* out, const ExportRenderContext* ctx) {
     RenderSink sink = {.out = out, .total = NULL};
     return emit_export_header(&sink, ctx);
 }
 
-int write_change_context(FILE* out, const ExportRenderContext* ctx) {
+int write_change_context(OutputWriter* out, const ExportRenderContext* ctx) {
     RenderSink sink = {.out = out, .total = NULL};
     return emit_change_context(&sink, ctx);
 }
 
 static size_t compute_fence_length(const ExportEntry* entry) {
-    size_t max_run = 0;
-    size_t current_run = 0;
-
-    for (size_t i = 0; i < entry->buf_len; i++) {
-        if (entry->buf[i] == '`') {
-            current_run++;
-            if (current_run > max_run) {
-                max_run = current_run;
-            }
-        } else {
-            current_run = 0;
-        }
-    }
-
-    return (max_run >= 3) ? max_run + 1 : 3;
+    return (entry->max_backtick_run >= 3) ? entry->max_backtick_run + 1 : 3;
 }
 
 static int append_render_range(RenderEntryInfo* info,
@@ -595,63 +672,31 @@ static int compute_entry_render_ranges(const ExportEntry* entry,
     return 0;
 }
 
-static int build_line_index(const ExportEntry* entry, LineIndex* index) {
-    size_t line_count;
-    size_t line_no = 0;
-    size_t line_start = 0;
-
-    if (!entry || !index) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    memset(index, 0, sizeof(*index));
-    line_count = entry_line_count(entry);
-    if (line_count == 0) {
+/*
+ * Sliced entries look their ranges up in the sparse index that
+ * calculate_export_metrics() kept on the plan; without one (or for a body it
+ * does not describe) a fresh index goes to *scratch.
+ */
+static int resolve_line_index(const ExportEntry* entry,
+                              const RenderEntryInfo* entry_info,
+                              LineIndex* scratch,
+                              const LineIndex** index_out) {
+    if (line_index_is_built(&entry_info->line_index) && entry_info->line_index.text_len == entry->buf_len) {
+        *index_out = &entry_info->line_index;
         return 0;
     }
-
-    index->starts = malloc(line_count * sizeof(*index->starts));
-    index->ends = malloc(line_count * sizeof(*index->ends));
-    if (!index->starts || !index->ends) {
-        free(index->starts);
-        free(index->ends);
-        index->starts = NULL;
-        index->ends = NULL;
+    if (build_line_index(entry->buf, entry->buf_len, scratch) != 0) {
         return -1;
     }
-
-    for (size_t i = 0; i < entry->buf_len; i++) {
-        if (entry->buf[i] != '\n') {
-            continue;
-        }
-        index->starts[line_no] = line_start;
-        index->ends[line_no] = i + 1;
-        line_no++;
-        line_start = i + 1;
-    }
-
-    if (line_start < entry->buf_len || (entry->buf_len > 0 && entry->buf[entry->buf_len - 1] != '\n')) {
-        index->starts[line_no] = line_start;
-        index->ends[line_no] = entry->buf_len;
-        line_no++;
+    if (scratch->line_count != entry_line_count(entry)) {
+        free_line_index(scratch);
+        errno = EINVAL;
+        return -1;
     }
-
-    index->count = line_no;
+    *index_out = scratch;
     return 0;
 }
 
-static void free_line_index(LineIndex* index) {
-    if (!index) {
-        return;
-    }
-    free(index->starts);
-    free(index->ends);
-    index->starts = NULL;
-    index->ends = NULL;
-    index->count = 0;
-}
-
 static int emit_entry_heading(RenderSink* sink, const ExportEntry* entry) {
     if (!sink || !entry) {
         errno = EINVAL;
@@ -667,37 +712,43 @@ static int emit_entry_heading(RenderSink* sink, const ExportEntry* entry) {
     return 0;
 }
 
+/* Emits the lines held in buf[start, end), numbering them from first_line. */
 static int emit_line_range(RenderSink* sink,
                            const ExportEntry* entry,
-                           const LineIndex* index,
-                           size_t start_line,
-                           size_t end_line,
+                           size_t start,
+                           size_t end,
+                           size_t first_line,
                            int show_line_numbers,
                            size_t line_number_width) {
-    if (!sink || !entry || !index || start_line == 0 || end_line < start_line || end_line > index->count) {
+    size_t line_no = first_line;
+
+    if (!sink || !entry || start >= end || end > entry->buf_len) {
         errno = EINVAL;
         return -1;
     }
 
-    for (size_t line_no = start_line; line_no <= end_line; line_no++) {
-        size_t offset = line_no - 1;
-        size_t start = index->starts[offset];
-        size_t end = index->ends[offset];
-
-        if (show_line_numbers &&
-            (emit_line_number_prefix(sink, line_no, line_number_width) != 0 ||
-             sink_write_text(sink, " | ") != 0)) {
+    /* Without line numbers the range is one contiguous span of the body. */
+    if (!show_line_numbers) {
+        if (sink_write_body(sink, entry->buf + start, end - start) != 0) {
             return -1;
         }
-        if (end > start &&
-            sink_write_bytes(sink, entry->buf + start, end - start) != 0) {
+        return (entry->buf[end - 1] != '\n') ? sink_write_char(sink, '\n') : 0;
+    }
+
+    while (start < end) {
+        const unsigned char* newline = memchr(entry->buf + start, '\n', end - start);
+        size_t line_end = newline ? (size_t)(newline - entry->buf) + 1 : end;
+
+        if (emit_line_number_prefix(sink, line_no, line_number_width) != 0 ||
+            sink_write_text(sink, " | ") != 0 ||
+            sink_write_body(sink, entry->buf + start, line_end - start) != 0) {
             return -1;
         }
-        if (end == start || entry->buf[end - 1] != '\n') {
-            if (sink_write_char(sink, '\n') != 0) {
-                return -1;
-            }
+        if (!newline && sink_write_char(sink, '\n') != 0) {
+            return -1;
         }
+        start = line_end;
+        line_no++;
     }
 
     return 0;
@@ -711,9 +762,9 @@ static int emit_omission_marker(RenderSink* sink, size_t omitted_lines) {
         return -1;
     }
     if (format_size_value(omitted_lines, count_buf, sizeof(count_buf)) != 0 ||
-        sink_write_text(sink, "... ") != 0 ||
+        sink_write_text(sink, OMISSION_PREFIX) != 0 ||
         sink_write_text(sink, count_buf) != 0 ||
-        sink_write_text(sink, " unchanged lines omitted ...\n\n") != 0) {
+        sink_write_text(sink, OMISSION_SUFFIX) != 0) {
         return -1;
     }
     return 0;
@@ -723,9 +774,7 @@ static int emit_full_entry(RenderSink* sink,
                            const ExportEntry* entry,
                            const RenderEntryInfo* entry_info,
                            const ExportRenderContext* ctx) {
-    LineIndex index = {0};
     size_t width = 0;
-    int status = -1;
 
     if (!sink || !entry || !entry_info || !ctx) {
         errno = EINVAL;
@@ -737,41 +786,28 @@ static int emit_full_entry(RenderSink* sink,
         return -1;
     }
 
-    if (build_line_index(entry, &index) != 0) {
-        goto cleanup;
-    }
-
     if (ctx->show_line_numbers) {
         width = decimal_digit_count(entry_info->total_lines);
     }
-    if (index.count > 0 &&
-        emit_line_range(sink,
-                        entry,
-                        &index,
-                        1,
-                        index.count,
-                        ctx->show_line_numbers,
-                        width) != 0) {
-        goto cleanup;
+    if (entry_line_count(entry) > 0 &&
+        emit_line_range(sink, entry, 0, entry->buf_len, 1, ctx->show_line_numbers, width) != 0) {
+        return -1;
     }
 
     if (sink_write_fence(sink, entry_info->fence_length, NULL) != 0 ||
         sink_write_text(sink, "\n\n") != 0) {
-        goto cleanup;
+        return -1;
     }
 
-    status = 0;
-
-cleanup:
-    free_line_index(&index);
-    return status;
+    return 0;
 }
 
 static int emit_sliced_entry(RenderSink* sink,
                              const ExportEntry* entry,
                              const RenderEntryInfo* entry_info,
                              const ExportRenderContext* ctx) {
-    LineIndex index = {0};
+    LineIndex scratch = {0};
+    const LineIndex* index = NULL;
     size_t width = 0;
     size_t previous_end = 0;
     int status = -1;
@@ -782,7 +818,7 @@ static int emit_sliced_entry(RenderSink* sink,
     }
 
     if (emit_entry_heading(sink, entry) != 0 ||
-        build_line_index(entry, &index) != 0) {
+        resolve_line_index(entry, entry_info, &scratch, &index) != 0) {
         goto cleanup;
     }
 
@@ -792,6 +828,11 @@ static int emit_sliced_entry(RenderSink* sink,
 
     for (size_t i = 0; i < entry_info->range_count; i++) {
         const RenderLineRange* range = &entry_info->ranges[i];
+
+        if (range->start_line == 0 || range->end_line < range->start_line || range->end_line > index->line_count) {
+            errno = EINVAL;
+            goto cleanup;
+        }
         if (range->start_line > previous_end + 1 &&
             emit_omission_marker(sink, range->start_line - previous_end - 1) != 0) {
             goto cleanup;
@@ -799,9 +840,9 @@ static int emit_sliced_entry(RenderSink* sink,
         if (sink_write_fence(sink, entry_info->fence_length, entry->lang) != 0 ||
             emit_line_range(sink,
                             entry,
-                            &index,
+                            line_index_start(index, entry->buf, range->start_line),
+                            line_index_start(index, entry->buf, range->end_line + 1),
                             range->start_line,
-                            range->end_line,
                             ctx->show_line_numbers,
                             width) != 0 ||
             sink_write_fence(sink, entry_info->fence_length, NULL) != 0 ||
@@ -819,30 +860,257 @@ static int emit_sliced_entry(RenderSink* sink,
     status = 0;
 
 cleanup:
-    free_line_index(&index);
+    free_line_index(&scratch);
+    return status;
+}
+
+/*
+ * A full entry without line numbers is the file itself plus, at most, a
+ * newline, so a streamed body is handed to the kernel instead of being read.
+ * That skips the re-scan, so it is only done for files last changed before
+ * collection started; the rest are loaded and checked.
+ */
+static int can_copy_entry(const RenderSink* sink,
+                          const ExportEntry* entry,
+                          const RenderEntryInfo* entry_info,
+                          const ExportRenderContext* ctx) {
+    return sink->out && !entry->buf && entry->stamp_settled && entry->buf_len >= KERNEL_COPY_MIN_BODY &&
+           entry_info->mode == RENDER_ENTRY_FULL && !ctx->show_line_numbers;
+}
+
+static int emit_copied_entry(RenderSink* sink, const ExportEntry* entry, const RenderEntryInfo* entry_info) {
+    int fd = -1;
+    int status = -1;
+
+    if (emit_entry_heading(sink, entry) != 0 ||
+        sink_write_fence(sink, entry_info->fence_length, entry->lang) != 0 ||
+        open_export_entry_body(entry, &fd) != 0) {
+        return -1;
+    }
+    if (output_writer_copy_file(sink->out, fd, entry->buf_len) != 0) {
+        if (errno == ESTALE) {
+            fprintf(stderr, "Error: File changed after it was collected %s\n", entry->display_path);
+        }
+        goto cleanup;
+    }
+    if (verify_export_entry_body(entry, fd) != 0) {
+        goto cleanup;
+    }
+    if ((!entry->ends_with_newline && sink_write_char(sink, '\n') != 0) ||
+        sink_write_fence(sink, entry_info->fence_length, NULL) != 0 ||
+        sink_write_text(sink, "\n\n") != 0) {
+        goto cleanup;
+    }
+    status = 0;
+
+cleanup:
+    if (fd != -1) {
+        int saved_errno = errno;
+        close(fd);
+        errno = saved_errno;
+    }
     return status;
 }
 
+static int emit_loaded_entry(RenderSink* sink,
+                             const ExportEntry* entry,
+                             const RenderEntryInfo* entry_info,
+                             const ExportRenderContext* ctx) {
+    switch (entry_info->mode) {
+        case RENDER_ENTRY_FULL:
+            return emit_full_entry(sink, entry, entry_info, ctx);
+        case RENDER_ENTRY_SLICED:
+            return emit_sliced_entry(sink, entry, entry_info, ctx);
+        case RENDER_ENTRY_OMIT:
+            return 0;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+}
+
 static int emit_entry(RenderSink* sink,
                       const ExportEntry* entry,
                       const RenderEntryInfo* entry_info,
                       const ExportRenderContext* ctx) {
+    ExportEntry loaded;
+    RenderEntryInfo reloaded_info;
+    int remapped;
+    int status;
+
     if (!sink || !entry || !entry_info || !ctx) {
         errno = EINVAL;
         return -1;
     }
+    /*
+     * A mapping shows the file as it is now, so a mapped body whose stamp
+     * moved since collection is re-read and re-checked instead.
+     */
+    remapped = entry->buf && entry->buf_mapped && entry_info->mode != RENDER_ENTRY_OMIT &&
+               !export_entry_mapping_current(entry);
+    if ((entry->buf && !remapped) || entry->buf_len == 0 || entry_info->mode == RENDER_ENTRY_OMIT) {
+        return emit_loaded_entry(sink, entry, entry_info, ctx);
+    }
+    if (can_copy_entry(sink, entry, entry_info, ctx)) {
+        return emit_copied_entry(sink, entry, entry_info);
+    }
+
+    /* Streamed entry: hold only this body in memory while it is emitted. */
+    if ((remapped ? reload_export_entry_body(entry, &loaded) : load_export_entry_body(entry, &loaded)) != 0) {
+        return -1;
+    }
+    if (remapped) {
+        /* The cached line index points into the old mapping. */
+        reloaded_info = *entry_info;
+        memset(&reloaded_info.line_index, 0, sizeof(reloaded_info.line_index));
+        entry_info = &reloaded_info;
+    }
+    sink->transient_bodies = 1;
+    status = emit_loaded_entry(sink, &loaded, entry_info, ctx);
+    sink->transient_bodies = 0;
+    if (status == 0) {
+        status = sink_release_bodies(sink);
+    }
+    sink->referenced_transient = 0;
+    release_export_entry_body(&loaded);
+    return status;
+}
+
+/*
+ * Closed-form sizes for calculate_export_metrics(). Each mirrors its emit_*
+ * counterpart from the entry's collected statistics, so full entries are
+ * sized without touching (or, under --stream, re-reading) their bodies.
+ * Sliced entries still need the line index to find their ranges' offsets.
+ */
+static int add_size_product(size_t* total, size_t count, size_t amount) {
+    if (amount != 0 && count > SIZE_MAX / amount) {
+        errno = EOVERFLOW;
+        return -1;
+    }
+    return add_size(total, count * amount);
+}
+
+static int count_entry_heading(const ExportEntry* entry, size_t* total) {
+    return add_size(total, strlen("## ") + markdown_path_length(entry->display_path) + strlen("\n\n"));
+}
+
+static size_t line_number_prefix_length(const RenderEntryInfo* entry_info, const ExportRenderContext* ctx) {
+    return ctx->show_line_numbers ? decimal_digit_count(entry_info->total_lines) + strlen(" | ") : 0;
+}
+
+static int count_full_entry(const ExportEntry* entry,
+                            const RenderEntryInfo* entry_info,
+                            const ExportRenderContext* ctx,
+                            size_t* total) {
+    size_t line_count = entry_line_count(entry);
+
+    if (count_entry_heading(entry, total) != 0 ||
+        count_fence_bytes(total, entry_info->fence_length, entry->lang) != 0) {
+        return -1;
+    }
+    if (line_count > 0 &&
+        (add_size(total, entry->buf_len) != 0 ||
+         (!entry->ends_with_newline && add_size(total, 1) != 0) ||
+         add_size_product(total, line_count, line_number_prefix_length(entry_info, ctx)) != 0)) {
+        return -1;
+    }
+    if (count_fence_bytes(total, entry_info->fence_length, NULL) != 0) {
+        return -1;
+    }
+    return add_size(total, strlen("\n\n"));
+}
+
+static int count_omission_marker(size_t omitted_lines, size_t* total) {
+    return add_size(total, strlen(OMISSION_PREFIX) + decimal_digit_count(omitted_lines) + strlen(OMISSION_SUFFIX));
+}
+
+/*
+ * Sizes a sliced entry and keeps its line index on the plan, so the render
+ * pass only reads the ranges it emits.
+ */
+static int count_sliced_entry(const ExportEntry* entry,
+                              RenderEntryInfo* entry_info,
+                              const ExportRenderContext* ctx,
+                              size_t* total) {
+    LineIndex* index = &entry_info->line_index;
+    size_t prefix_length = line_number_prefix_length(entry_info, ctx);
+    size_t previous_end = 0;
+
+    if (entry_info->range_count == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (count_entry_heading(entry, total) != 0) {
+        return -1;
+    }
+    free_line_index(index);
+    if (build_line_index(entry->buf, entry->buf_len, index) != 0) {
+        return -1;
+    }
+    if (index->line_count != entry_line_count(entry)) {
+        free_line_index(index);
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (size_t i = 0; i < entry_info->range_count; i++) {
+        const RenderLineRange* range = &entry_info->ranges[i];
+        size_t start;
+        size_t end;
+
+        if (range->start_line == 0 || range->end_line < range->start_line || range->end_line > index->line_count) {
+            errno = EINVAL;
+            return -1;
+        }
+        start = line_index_start(index, entry->buf, range->start_line);
+        end = line_index_start(index, entry->buf, range->end_line + 1);
+        if ((range->start_line > previous_end + 1 &&
+             count_omission_marker(range->start_line - previous_end - 1, total) != 0) ||
+            count_fence_bytes(total, entry_info->fence_length, entry->lang) != 0 ||
+            add_size(total, end - start) != 0 ||
+            (range->end_line == index->line_count && !entry->ends_with_newline && add_size(total, 1) != 0) ||
+            add_size_product(total, range->end_line - range->start_line + 1, prefix_length) != 0 ||
+            count_fence_bytes(total, entry_info->fence_length, NULL) != 0 ||
+            add_size(total, strlen("\n\n")) != 0) {
+            return -1;
+        }
+        previous_end = range->end_line;
+    }
+
+    if (entry_info->total_lines > previous_end &&
+        count_omission_marker(entry_info->total_lines - previous_end, total) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int count_entry(const ExportEntry* entry,
+                       RenderEntryInfo* entry_info,
+                       const ExportRenderContext* ctx,
+                       size_t* total) {
+    ExportEntry loaded;
+    int status;
 
     switch (entry_info->mode) {
         case RENDER_ENTRY_FULL:
-            return emit_full_entry(sink, entry, entry_info, ctx);
+            return count_full_entry(entry, entry_info, ctx, total);
         case RENDER_ENTRY_SLICED:
-            return emit_sliced_entry(sink, entry, entry_info, ctx);
+            break;
         case RENDER_ENTRY_OMIT:
             return 0;
         default:
             errno = EINVAL;
             return -1;
     }
+    if (entry->buf || entry->buf_len == 0) {
+        return count_sliced_entry(entry, entry_info, ctx, total);
+    }
+    if (load_export_entry_body(entry, &loaded) != 0) {
+        return -1;
+    }
+    status = count_sliced_entry(&loaded, entry_info, ctx, total);
+    release_export_entry_body(&loaded);
+    return status;
 }
 
 static int initialize_render_plan_info(const ExportPlan* plan, RenderPlanInfo* info) {
@@ -876,34 +1144,17 @@ static int initialize_render_plan_info(const ExportPlan* plan, RenderPlanInfo* i
 
 static int collect_render_hunks(const ExportPlan* plan,
                                 const ExportRenderContext* ctx,
-                                GitFileHunks** hunks_out,
-                                size_t* hunk_count_out) {
-    if (!plan || !ctx || !hunks_out || !hunk_count_out) {
+                                GitFileHunks** hunks_out) {
+    if (!plan || !ctx || !hunks_out) {
         errno = EINVAL;
         return -1;
     }
-    if (ctx->selected_count != plan->count) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    if (collect_git_hunks(ctx->mode,
-                          ctx->diff_range,
-                          ctx->selected_paths,
-                          ctx->selected_count,
-                          hunks_out,
-                          hunk_count_out) != 0) {
-        return -1;
-    }
-    if (*hunk_count_out != plan->count) {
-        free_git_hunks(*hunks_out, *hunk_count_out);
-        *hunks_out = NULL;
-        *hunk_count_out = 0;
+    if (ctx->selected_paths && ctx->selected_count != plan->count) {
         errno = EINVAL;
         return -1;
     }
 
-    return 0;
+    return collect_export_hunks(plan, ctx->selected_paths, ctx->baseline_dir, hunks_out);
 }
 
 static int prepare_hunk_render_entry(const ExportEntry* entry,
@@ -913,16 +1164,16 @@ static int prepare_hunk_render_entry(const ExportEntry* entry,
                                      RenderEntryInfo* entry_info,
                                      unsigned char* include_mask,
                                      size_t* visible_count) {
-    if (!entry || !path || !file_hunks || !entry_info || !include_mask || !visible_count) {
+    if (!entry || !file_hunks || !entry_info || !include_mask || !visible_count) {
         errno = EINVAL;
         return -1;
     }
-    if (strcmp(entry->open_path, path->open_path) != 0) {
+    if (path && strcmp(entry->open_path, path->open_path) != 0) {
         errno = EINVAL;
         return -1;
     }
 
-    if (path->change_type == SELECTED_PATH_CHANGE_ADDED) {
+    if (file_hunks->whole_file || (path && path->change_type == SELECTED_PATH_CHANGE_ADDED)) {
         entry_info->mode = RENDER_ENTRY_FULL;
         *include_mask = 1;
         (*visible_count)++;
@@ -949,17 +1200,16 @@ static int prepare_hunk_render_plan(const ExportPlan* plan,
                                     const ExportRenderContext* ctx,
                                     RenderPlanInfo* info) {
     GitFileHunks* hunks = NULL;
-    size_t hunk_count = 0;
     int status = -1;
 
-    if (collect_render_hunks(plan, ctx, &hunks, &hunk_count) != 0) {
+    if (collect_render_hunks(plan, ctx, &hunks) != 0) {
         return -1;
     }
 
     info->visible_count = 0;
     for (size_t i = 0; i < plan->count; i++) {
         if (prepare_hunk_render_entry(&plan->entries[i],
-                                      &ctx->selected_paths[i],
+                                      ctx->selected_paths ? &ctx->selected_paths[i] : NULL,
                                       &hunks[i],
                                       ctx->hunk_context_lines,
                                       &info->entries[i],
@@ -972,7 +1222,7 @@ static int prepare_hunk_render_plan(const ExportPlan* plan,
     status = 0;
 
 cleanup:
-    free_git_hunks(hunks, hunk_count);
+    free_git_hunks(hunks, plan->count);
     return status;
 }
 
@@ -1008,6 +1258,7 @@ void free_render_plan_info(RenderPlanInfo* info) {
     if (info->entries) {
         for (size_t i = 0; i < info->count; i++) {
             free(info->entries[i].ranges);
+            free_line_index(&info->entries[i].line_index);
         }
     }
     free(info->entries);
@@ -1019,7 +1270,7 @@ void free_render_plan_info(RenderPlanInfo* info) {
 }
 
 int calculate_export_metrics(const ExportPlan* plan,
-                             const RenderPlanInfo* info,
+                             RenderPlanInfo* info,
                              const ExportRenderContext* ctx,
                              ExportMetrics* metrics) {
     size_t total = 0;
@@ -1044,12 +1295,16 @@ int calculate_export_metrics(const ExportPlan* plan,
     }
 
     for (size_t i = 0; i < plan->count; i++) {
+        size_t before = total;
+
+        info->entries[i].output_length = 0;
         if (!info->include_mask[i]) {
             continue;
         }
-        if (emit_entry(&sink, &plan->entries[i], &info->entries[i], ctx) != 0) {
+        if (count_entry(&plan->entries[i], &info->entries[i], ctx, &total) != 0) {
             return -1;
         }
+        info->entries[i].output_length = total - before;
     }
     if (emit_file_entries_end_marker(&sink, info->visible_count) != 0 ||
         emit_unpacker_appendix(&sink, ctx) != 0) {
@@ -1062,7 +1317,7 @@ int calculate_export_metrics(const ExportPlan* plan,
     return 0;
 }
 
-int render_export_plan(FILE* out,
+int render_export_plan(OutputWriter* out,
                        const ExportPlan* plan,
                        const RenderPlanInfo* info,
                        const ExportRenderContext* ctx,
@@ -1100,3 +1355,299 @@ int render_export_plan(FILE* out,
     }
     return 0;
 }
+
+/* Aim for about this much output per batch, so each pwritev() stays large. */
+#define RENDER_BATCH_BYTES (4 * 1024 * 1024)
+
+/* A run of consecutive plan entries that renders to [offset, end_offset). */
+typedef struct {
+    size_t first;
+    size_t end;
+    off_t offset;
+    off_t end_offset;
+} RenderBatch;
+
+typedef struct {
+    int fd;
+    const ExportPlan* plan;
+    const RenderPlanInfo* info;
+    const ExportRenderContext* ctx;
+    RenderBatch* batches;
+    size_t batch_count;
+    size_t next;
+    int failed;
+    int error;
+    OutputWriterStats stats;
+    pthread_mutex_t lock;
+} RenderPool;
+
+static int add_offset(off_t* offset, size_t amount) {
+    if ((uintmax_t)amount > (uintmax_t)INTMAX_MAX - (uintmax_t)*offset ||
+        (off_t)((uintmax_t)*offset + amount) < *offset) {
+        errno = EFBIG;
+        return -1;
+    }
+    *offset += (off_t)amount;
+    return 0;
+}
+
+/*
+ * Splits the visible entries into batches laid out from offset on and
+ * returns the batches' end offset in *end_out.
+ */
+static int plan_render_batches(const ExportPlan* plan,
+                               const RenderPlanInfo* info,
+                               off_t offset,
+                               size_t workers,
+                               RenderBatch** batches_out,
+                               size_t* batch_count_out,
+                               off_t* end_out) {
+    RenderBatch* batches = NULL;
+    size_t batch_count = 0;
+    size_t capacity = 0;
+    size_t total = 0;
+    size_t target;
+
+    for (size_t i = 0; i < plan->count; i++) {
+        if (add_size(&total, info->entries[i].output_length) != 0) {
+            return -1;
+        }
+    }
+    /* Smaller batches when the export is small, so every worker gets some. */
+    target = total / (workers * 4);
+    if (target > RENDER_BATCH_BYTES) {
+        target = RENDER_BATCH_BYTES;
+    }
+
+    for (size_t i = 0; i < plan->count;) {
+        RenderBatch* batch;
+        size_t batch_bytes = 0;
+
+        if (batch_count == capacity) {
+            size_t new_capacity = capacity ? capacity * 2 : 64;
+            RenderBatch* grown = realloc(batches, new_capacity * sizeof(*batches));
+            if (!grown) {
+                free(batches);
+                return -1;
+            }
+            batches = grown;
+            capacity = new_capacity;
+        }
+        batch = &batches[batch_count++];
+        batch->first = i;
+        batch->offset = offset;
+        while (i < plan->count && (batch_bytes == 0 || batch_bytes < target)) {
+            batch_bytes += info->entries[i].output_length;
+            i++;
+        }
+        batch->end = i;
+        if (add_offset(&offset, batch_bytes) != 0) {
+            free(batches);
+            return -1;
+        }
+        batch->end_offset = offset;
+    }
+
+    *batches_out = batches;
+    *batch_count_out = batch_count;
+    *end_out = offset;
+    return 0;
+}
+
+static int render_batch(RenderPool* pool, OutputWriter* out, const RenderBatch* batch) {
+    RenderSink sink = {.out = out, .total = NULL};
+
+    if (output_writer_seek(out, batch->offset) != 0) {
+        return -1;
+    }
+    for (size_t i = batch->first; i < batch->end; i++) {
+        if (!pool->info->include_mask[i]) {
+            continue;
+        }
+#ifdef FUORI_TESTING
+        if (maybe_inject_render_failure(i) != 0) {
+            return -1;
+        }
+#endif
+        if (emit_entry(&sink, &pool->plan->entries[i], &pool->info->entries[i], pool->ctx) != 0) {
+            return -1;
+        }
+    }
+    if (output_writer_flush(out) != 0) {
+        return -1;
+    }
+    /* A batch that missed its slot would leave a gap or overwrite its neighbour. */
+    if (output_writer_offset(out) != batch->end_offset) {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
+
+static void* render_worker(void* arg) {
+    RenderPool* pool = arg;
+    OutputWriter* out = NULL;
+    OutputWriterStats stats;
+    int status = open_output_writer_at(pool->fd, 0, &out);
+
+    while (status == 0) {
+        size_t index;
+
+        pthread_mutex_lock(&pool->lock);
+        index = pool->failed ? pool->batch_count : pool->next;
+        if (index < pool->batch_count) {
+            pool->next++;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        if (index >= pool->batch_count) {
+            break;
+        }
+        status = render_batch(pool, out, &pool->batches[index]);
+    }
+
+    output_writer_stats(out, &stats);
+    pthread_mutex_lock(&pool->lock);
+    if (status != 0 && !pool->failed) {
+        pool->failed = 1;
+        pool->error = errno;
+    }
+    pool->stats.write_calls += stats.write_calls;
+    pool->stats.kernel_copy_calls += stats.kernel_copy_calls;
+    pool->stats.bytes_written += stats.bytes_written;
+    pthread_mutex_unlock(&pool->lock);
+    close_output_writer(out);
+    return NULL;
+}
+
+/* Runs the batches on `workers` threads, the calling thread included. */
+static int run_render_pool(RenderPool* pool, size_t workers) {
+    pthread_t* threads = NULL;
+    size_t started = 0;
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        return -1;
+    }
+    if (workers > 1) {
+        threads = malloc((workers - 1) * sizeof(*threads));
+    }
+    /* Threads are an optimization; without them the calling thread renders every batch. */
+    for (size_t i = 0; threads && i + 1 < workers; i++) {
+        if (pthread_create(&threads[i], NULL, render_worker, pool) != 0) {
+            break;
+        }
+        started++;
+    }
+    render_worker(pool);
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(threads);
+
+    if (pool->failed) {
+        errno = pool->error;
+        return -1;
+    }
+    return 0;
+}
+
+int render_export_plan_parallel(int fd,
+                                off_t offset,
+                                const ExportPlan* plan,
+                                const RenderPlanInfo* info,
+                                const ExportRenderContext* ctx,
+                                size_t workers,
+                                int verbose,
+                                OutputWriterStats* stats) {
+    RenderPool pool = {0};
+    OutputWriter* out = NULL;
+    RenderSink edge = {.out = NULL, .total = NULL};
+    OutputWriterStats edge_stats;
+    size_t head_length = 0;
+    size_t tail_length = 0;
+    off_t entries_offset = offset;
+    off_t tail_offset;
+    off_t end_offset;
+    int error;
+    int status = -1;
+
+    if (fd < 0 || offset < 0 || !plan || !info || !ctx || info->count != plan->count || workers == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    edge.total = &head_length;
+    if (emit_file_entries_marker(&edge, info->visible_count) != 0) {
+        return -1;
+    }
+    edge.total = &tail_length;
+    if (emit_file_entries_end_marker(&edge, info->visible_count) != 0 ||
+        emit_unpacker_appendix(&edge, ctx) != 0 ||
+        add_offset(&entries_offset, head_length) != 0) {
+        return -1;
+    }
+    edge.total = NULL;
+    if (plan_render_batches(plan, info, entries_offset, workers, &pool.batches, &pool.batch_count, &tail_offset) != 0) {
+        return -1;
+    }
+    end_offset = tail_offset;
+    if (add_offset(&end_offset, tail_length) != 0) {
+        goto cleanup;
+    }
+
+    /* Reserve the whole file up front; filesystems without fallocate just grow it with each write. */
+    error = posix_fallocate(fd, offset, end_offset - offset);
+    if (error != 0 && error != EINVAL && error != EOPNOTSUPP) {
+        errno = error;
+        goto cleanup;
+    }
+
+    /* The section markers and appendix around the entries are written here. */
+    if (open_output_writer_at(fd, offset, &out) != 0) {
+        goto cleanup;
+    }
+    edge.out = out;
+    if (emit_file_entries_marker(&edge, info->visible_count) != 0 ||
+        output_writer_seek(out, tail_offset) != 0 ||
+        emit_file_entries_end_marker(&edge, info->visible_count) != 0 ||
+        emit_unpacker_appendix(&edge, ctx) != 0 ||
+        output_writer_flush(out) != 0) {
+        goto cleanup;
+    }
+    if (output_writer_offset(out) != end_offset) {
+        errno = EIO;
+        goto cleanup;
+    }
+
+    pool.fd = fd;
+    pool.plan = plan;
+    pool.info = info;
+    pool.ctx = ctx;
+    /* Listed up front so the order matches the serial renderer's. */
+    if (verbose) {
+        for (size_t i = 0; i < plan->count; i++) {
+            if (info->include_mask[i]) {
+                fprintf(stderr, "Processing file: %s\n", plan->entries[i].display_path);
+            }
+        }
+    }
+    if (run_render_pool(&pool, resolve_worker_count(workers, pool.batch_count)) != 0) {
+        goto cleanup;
+    }
+    status = 0;
+
+cleanup:
+    error = errno;
+    if (stats) {
+        output_writer_stats(out, &edge_stats);
+        *stats = pool.stats;
+        stats->write_calls += edge_stats.write_calls;
+        stats->kernel_copy_calls += edge_stats.kernel_copy_calls;
+        stats->bytes_written += edge_stats.bytes_written;
+    }
+    close_output_writer(out);
+    free(pool.batches);
+    errno = error;
+    return status;
+}
@@ -1,11 +1,11 @@
 #ifndef RENDER_H
 #define RENDER_H
 
-#include <stdio.h>
-
 #include "app.h"
 #include "collect.h"
 #include "git_paths.h"
+#include "line_index.h"
+#include "output_writer.h"
 
 typedef struct {
     size_t files_exported;
@@ -30,6 +30,8 @@ typedef struct {
     size_t total_lines;
     RenderLineRange* ranges;
     size_t range_count;
+    size_t output_length;  // Rendered bytes, recorded by calculate_export_metrics().
+    LineIndex line_index;  // Sliced entries: built by calculate_export_metrics() for the render pass.
 } RenderEntryInfo;
 
 typedef struct {
@@ -46,6 +48,8 @@ typedef struct {
     const SelectedPath* selected_paths;
     size_t selected_count;
     const char* diff_range;
+    const char* revision;
+    const char* baseline_dir;  // --baseline: directory holding the prior version of exported paths.
     int show_line_numbers;
     int show_hunks;
     int show_unpacker;
@@ -59,15 +63,30 @@ int prepare_render_plan(const ExportPlan* plan,
                         RenderPlanInfo* info);
 void free_render_plan_info(RenderPlanInfo* info);
 int calculate_export_metrics(const ExportPlan* plan,
-                             const RenderPlanInfo* info,
+                             RenderPlanInfo* info,
                              const ExportRenderContext* ctx,
                              ExportMetrics* metrics);
-int write_export_header(FILE* out, const ExportRenderContext* ctx);
-int write_change_context(FILE* out, const ExportRenderContext* ctx);
-int render_export_plan(FILE* out,
+int write_export_header(OutputWriter* out, const ExportRenderContext* ctx);
+int write_change_context(OutputWriter* out, const ExportRenderContext* ctx);
+int render_export_plan(OutputWriter* out,
                        const ExportPlan* plan,
                        const RenderPlanInfo* info,
                        const ExportRenderContext* ctx,
                        int verbose);
+/*
+ * Same output as render_export_plan(), written at offset of the regular file
+ * fd by up to `workers` threads. The file is preallocated to its final size,
+ * and each thread pwrite()s runs of consecutive entries at offsets taken from
+ * the lengths calculate_export_metrics() recorded, so that must run first.
+ * Leaves fd's file offset alone. stats, if given, receives the writers' totals.
+ */
+int render_export_plan_parallel(int fd,
+                                off_t offset,
+                                const ExportPlan* plan,
+                                const RenderPlanInfo* info,
+                                const ExportRenderContext* ctx,
+                                size_t workers,
+                                int verbose,
+                                OutputWriterStats* stats);
 
 #endif
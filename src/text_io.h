@@ -3,12 +3,13 @@
 
 #include <errno.h>
 #include <limits.h>
-#include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 
-static inline int fuori_write_text(FILE* out, const char* text) {
-    return (fputs(text, out) == EOF) ? -1 : 0;
+#include "output_writer.h"
+
+static inline int fuori_write_text(OutputWriter* out, const char* text) {
+    return output_writer_write_text(out, text);
 }
 
 static inline int fuori_count_text_bytes(size_t* total, const char* text) {
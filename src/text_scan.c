@@ -0,0 +1,268 @@
+#include "text_scan.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FUORI_TEXT_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+typedef size_t (*PlainPrefixFn)(const unsigned char* buf, size_t len);
+
+/*
+ * A "plain" byte is printable ASCII other than '`' (0x20-0x7F minus 0x60):
+ * it cannot end a line, start a UTF-8 sequence, count as a control byte, or
+ * extend a backtick run, so the scan may skip it without looking closer.
+ */
+static size_t scalar_plain_prefix(const unsigned char* buf, size_t len) {
+    size_t i = 0;
+
+    while (i < len && buf[i] >= 0x20 && buf[i] < 0x80 && buf[i] != '`') {
+        i++;
+    }
+    return i;
+}
+
+#ifdef FUORI_TEXT_SCAN_X86
+__attribute__((target("sse2")))
+static size_t sse2_plain_prefix(const unsigned char* buf, size_t len) {
+    const __m128i below_space = _mm_set1_epi8(0x1F);
+    const __m128i backtick = _mm_set1_epi8('`');
+    size_t i = 0;
+
+    while (i + 16 <= len) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(const void*)(buf + i));
+        /* Signed compare: bytes >= 0x80 are negative, so only 0x20-0x7F pass. */
+        __m128i plain = _mm_andnot_si128(_mm_cmpeq_epi8(bytes, backtick),
+                                         _mm_cmpgt_epi8(bytes, below_space));
+        unsigned int stop_mask = ~(unsigned int)_mm_movemask_epi8(plain) & 0xFFFFu;
+        if (stop_mask != 0) {
+            return i + (size_t)__builtin_ctz(stop_mask);
+        }
+        i += 16;
+    }
+    return i + scalar_plain_prefix(buf + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2_plain_prefix(const unsigned char* buf, size_t len) {
+    const __m256i below_space = _mm256_set1_epi8(0x1F);
+    const __m256i backtick = _mm256_set1_epi8('`');
+    size_t i = 0;
+
+    while (i + 32 <= len) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)(const void*)(buf + i));
+        __m256i plain = _mm256_andnot_si256(_mm256_cmpeq_epi8(bytes, backtick),
+                                            _mm256_cmpgt_epi8(bytes, below_space));
+        unsigned int stop_mask = ~(unsigned int)_mm256_movemask_epi8(plain);
+        if (stop_mask != 0) {
+            return i + (size_t)__builtin_ctz(stop_mask);
+        }
+        i += 32;
+    }
+    return i + sse2_plain_prefix(buf + i, len - i);
+}
+#endif
+
+int fuori_text_scan_kernel_supported(TextScanKernel kernel) {
+    switch (kernel) {
+        case TEXT_SCAN_KERNEL_AUTO:
+        case TEXT_SCAN_KERNEL_SCALAR:
+            return 1;
+#ifdef FUORI_TEXT_SCAN_X86
+        case TEXT_SCAN_KERNEL_SSE2:
+            return __builtin_cpu_supports("sse2") ? 1 : 0;
+        case TEXT_SCAN_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+        default:
+            return 0;
+    }
+}
+
+static PlainPrefixFn resolve_plain_prefix(TextScanKernel kernel) {
+#ifdef FUORI_TEXT_SCAN_X86
+    if (kernel == TEXT_SCAN_KERNEL_AUTO) {
+        kernel = fuori_text_scan_kernel_supported(TEXT_SCAN_KERNEL_AVX2) ? TEXT_SCAN_KERNEL_AVX2 :
+                 fuori_text_scan_kernel_supported(TEXT_SCAN_KERNEL_SSE2) ? TEXT_SCAN_KERNEL_SSE2 :
+                 TEXT_SCAN_KERNEL_SCALAR;
+    }
+    if (kernel == TEXT_SCAN_KERNEL_AVX2) {
+        return avx2_plain_prefix;
+    }
+    if (kernel == TEXT_SCAN_KERNEL_SSE2) {
+        return sse2_plain_prefix;
+    }
+#else
+    (void)kernel;
+#endif
+    return scalar_plain_prefix;
+}
+
+/* Returns the length of the valid UTF-8 sequence at s, or 0 if it is malformed. */
+static size_t utf8_sequence_length(const unsigned char* s, size_t remaining) {
+    unsigned char c = s[0];
+
+    if ((c & 0xE0) == 0xC0) {
+        if (remaining < 2) return 0;
+        if ((s[1] & 0xC0) != 0x80) return 0;
+        if (c < 0xC2) return 0;
+        return 2;
+    }
+    if ((c & 0xF0) == 0xE0) {
+        if (remaining < 3) return 0;
+        if ((s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80) return 0;
+        if (c == 0xE0 && s[1] < 0xA0) return 0;
+        if (c == 0xED && s[1] >= 0xA0) return 0;
+        return 3;
+    }
+    if ((c & 0xF8) == 0xF0) {
+        if (remaining < 4) return 0;
+        if ((s[1] & 0xC0) != 0x80 ||
+            (s[2] & 0xC0) != 0x80 ||
+            (s[3] & 0xC0) != 0x80) {
+            return 0;
+        }
+        if (c == 0xF0 && s[1] < 0x90) return 0;
+        if (c > 0xF4) return 0;
+        if (c == 0xF4 && s[1] >= 0x90) return 0;
+        return 4;
+    }
+    return 0;
+}
+
+static int append_line_start(TextScan* scan, size_t* capacity, size_t offset) {
+    if (scan->line_count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 64 : *capacity * 2;
+        size_t* new_starts;
+
+        if (new_capacity > SIZE_MAX / sizeof(*new_starts)) {
+            errno = EOVERFLOW;
+            return -1;
+        }
+        new_starts = realloc(scan->line_starts, new_capacity * sizeof(*new_starts));
+        if (!new_starts) {
+            return -1;
+        }
+        scan->line_starts = new_starts;
+        *capacity = new_capacity;
+    }
+    scan->line_starts[scan->line_count] = offset;
+    return 0;
+}
+
+int fuori_scan_text(const unsigned char* buf, size_t len, int record_lines, TextScan* scan) {
+    return fuori_scan_text_with_kernel(TEXT_SCAN_KERNEL_AUTO, buf, len, record_lines, scan);
+}
+
+/*
+ * Single pass over buf: NUL and UTF-8 verdicts, control-byte count, line
+ * count (an unterminated tail counts as a line), the longest run of '`',
+ * and optionally the start offset of every line. Runs of plain ASCII are
+ * skipped by the kernel; every other byte goes through the scalar logic.
+ */
+int fuori_scan_text_with_kernel(TextScanKernel kernel,
+                                const unsigned char* buf,
+                                size_t len,
+                                int record_lines,
+                                TextScan* scan) {
+    PlainPrefixFn plain_prefix;
+    size_t line_capacity = 0;
+    size_t current_run = 0;
+    size_t line_start = 0;
+    size_t i = 0;
+
+    if (!scan || (!buf && len > 0) || !fuori_text_scan_kernel_supported(kernel)) {
+        errno = EINVAL;
+        return -1;
+    }
+    plain_prefix = resolve_plain_prefix(kernel);
+
+    memset(scan, 0, sizeof(*scan));
+    scan->valid_utf8 = 1;
+
+    while (i < len) {
+        size_t plain = plain_prefix(buf + i, len - i);
+        unsigned char c;
+
+        if (plain > 0) {
+            current_run = 0;
+            i += plain;
+            if (i == len) {
+                break;
+            }
+        }
+        c = buf[i];
+
+        if (c >= 0x80) {
+            size_t sequence_length = utf8_sequence_length(buf + i, len - i);
+            if (sequence_length == 0) {
+                scan->valid_utf8 = 0;
+                return 0;
+            }
+            current_run = 0;
+            i += sequence_length;
+            continue;
+        }
+
+        if (c == '`') {
+            current_run++;
+            if (current_run > scan->max_backtick_run) {
+                scan->max_backtick_run = current_run;
+            }
+            i++;
+            continue;
+        }
+        current_run = 0;
+
+        if (c == '\n') {
+            if (record_lines && append_line_start(scan, &line_capacity, line_start) != 0) {
+                fuori_free_text_scan(scan);
+                return -1;
+            }
+            scan->line_count++;
+            line_start = i + 1;
+        } else if (c < 0x20 && c != '\r' && c != '\t') {
+            if (c == '\0') {
+                scan->has_nul = 1;
+                return 0;
+            }
+            scan->control_count++;
+        }
+        i++;
+    }
+
+    if (line_start < len) {
+        if (record_lines && append_line_start(scan, &line_capacity, line_start) != 0) {
+            fuori_free_text_scan(scan);
+            return -1;
+        }
+        scan->line_count++;
+    }
+    return 0;
+}
+
+/* Binary when the body has a NUL, is not UTF-8, or at least 3% control bytes (rounded up). */
+int fuori_text_scan_is_binary(const TextScan* scan, size_t len) {
+    size_t whole_hundreds;
+    size_t remainder;
+    size_t threshold;
+
+    /* Empty files are filtered by the caller; this helper only classifies non-empty content. */
+    if (!scan || len == 0) return 0;
+    if (scan->has_nul || !scan->valid_utf8) return 1;
+
+    whole_hundreds = len / 100;
+    remainder = len % 100;
+    threshold = whole_hundreds * 3 + ((remainder * 3 + 99) / 100);
+    return scan->control_count >= threshold;
+}
+
+void fuori_free_text_scan(TextScan* scan) {
+    if (!scan) return;
+    free(scan->line_starts);
+    scan->line_starts = NULL;
+}
@@ -0,0 +1,41 @@
+#ifndef TEXT_SCAN_H
+#define TEXT_SCAN_H
+
+#include <stddef.h>
+
+/*
+ * Result of one fused pass over a file body. The scan stops at the first
+ * byte that makes the body binary (a NUL or an invalid UTF-8 sequence), so
+ * counts are only meaningful when fuori_text_scan_is_binary() is false.
+ */
+typedef struct {
+    int has_nul;
+    int valid_utf8;
+    size_t control_count;
+    size_t line_count;
+    size_t max_backtick_run;
+    size_t* line_starts;  // Byte offset of each line; NULL unless requested.
+} TextScan;
+
+/*
+ * Byte-skipping kernels for the scan's plain-ASCII fast path. AUTO picks the
+ * widest one the CPU supports; the others exist for differential testing.
+ */
+typedef enum {
+    TEXT_SCAN_KERNEL_AUTO = 0,
+    TEXT_SCAN_KERNEL_SCALAR,
+    TEXT_SCAN_KERNEL_SSE2,
+    TEXT_SCAN_KERNEL_AVX2
+} TextScanKernel;
+
+int fuori_text_scan_kernel_supported(TextScanKernel kernel);
+int fuori_scan_text(const unsigned char* buf, size_t len, int record_lines, TextScan* scan);
+int fuori_scan_text_with_kernel(TextScanKernel kernel,
+                                const unsigned char* buf,
+                                size_t len,
+                                int record_lines,
+                                TextScan* scan);
+int fuori_text_scan_is_binary(const TextScan* scan, size_t len);
+void fuori_free_text_scan(TextScan* scan);
+
+#endif
@@ -2,6 +2,7 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -79,9 +80,20 @@ static int append_prefix_segment(TreePrefixBuffer* prefix, const char* segment)
     return 0;
 }
 
-static int write_visible_text(FILE* out, const char* text) {
+static int write_visible_text(OutputWriter* out, const char* text) {
     for (const unsigned char* p = (const unsigned char*)text; *p != '\0'; p++) {
         unsigned char c = *p;
+        size_t run = 0;
+
+        /* Pass plain runs through in one write. */
+        while (p[run] >= 0x20 && p[run] != 0x7f) {
+            run++;
+        }
+        if (run > 0) {
+            if (output_writer_write(out, p, run) != 0) return -1;
+            p += run - 1;
+            continue;
+        }
         if (c == '\n') {
             if (fuori_write_text(out, "\\n") != 0) return -1;
             continue;
@@ -102,9 +114,6 @@ static int write_visible_text(FILE* out, const char* text) {
             }
             continue;
         }
-        if (fputc(c, out) == EOF) {
-            return -1;
-        }
     }
     return 0;
 }
@@ -297,20 +306,16 @@ static size_t compute_tree_fence_length(const TreeNode* node) {
     return (max_run >= 3) ? max_run + 1 : 3;
 }
 
-static int write_tree_open_fence(FILE* out, size_t fence_len) {
-    for (size_t i = 0; i < fence_len; i++) {
-        if (fputc('`', out) == EOF) {
-            return -1;
-        }
+static int write_tree_open_fence(OutputWriter* out, size_t fence_len) {
+    if (output_writer_fill(out, '`', fence_len) != 0) {
+        return -1;
     }
     return fuori_write_text(out, "text\n");
 }
 
-static int write_tree_close_fence(FILE* out, size_t fence_len) {
-    for (size_t i = 0; i < fence_len; i++) {
-        if (fputc('`', out) == EOF) {
-            return -1;
-        }
+static int write_tree_close_fence(OutputWriter* out, size_t fence_len) {
+    if (output_writer_fill(out, '`', fence_len) != 0) {
+        return -1;
     }
     return fuori_write_text(out, "\n\n");
 }
@@ -329,7 +334,7 @@ static int count_tree_close_fence_bytes(size_t* total, size_t fence_len) {
     return add_size(total, 2);
 }
 
-static int write_tree_children(FILE* out,
+static int write_tree_children(OutputWriter* out,
                                const TreeNode* node,
                                TreePrefixBuffer* prefix,
                                size_t depth,
@@ -402,7 +407,7 @@ static int count_tree_children_bytes(const TreeNode* node,
     return 0;
 }
 
-int write_project_tree_filtered(FILE* out,
+int write_project_tree_filtered(OutputWriter* out,
                                 const ExportPlan* plan,
                                 const unsigned char* include_mask,
                                 size_t max_depth) {
@@ -496,7 +501,7 @@ int count_project_tree_bytes_filtered(const ExportPlan* plan,
     return count_tree_close_fence_bytes(total, fence_len);
 }
 
-int write_project_tree(FILE* out, const ExportPlan* plan, size_t max_depth) {
+int write_project_tree(OutputWriter* out, const ExportPlan* plan, size_t max_depth) {
     return write_project_tree_filtered(out, plan, NULL, max_depth);
 }
 
@@ -2,13 +2,12 @@
 #define TREE_H
 
 #include <stddef.h>
-#include <stdio.h>
-
 #include "collect.h"
+#include "output_writer.h"
 
-int write_project_tree(FILE* out, const ExportPlan* plan, size_t max_depth);
+int write_project_tree(OutputWriter* out, const ExportPlan* plan, size_t max_depth);
 int count_project_tree_bytes(const ExportPlan* plan, size_t max_depth, size_t* total);
-int write_project_tree_filtered(FILE* out,
+int write_project_tree_filtered(OutputWriter* out,
                                 const ExportPlan* plan,
                                 const unsigned char* include_mask,
                                 size_t max_depth);
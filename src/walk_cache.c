@@ -0,0 +1,184 @@
+#include "walk_cache.h"
+
+#include "cache_file.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WALK_CACHE_VERSION 2u
+#define WALK_CACHE_MAX_RECORDS ((size_t)1 << 17)
+
+/*
+ * A record's listing lives in the file's blob block as entry_count runs of a
+ * kind byte, the entry name, and a NUL.
+ */
+typedef struct {
+    CacheRecordKey key;
+    CacheBlobRef names;
+    int64_t mtime;
+    int64_t ctime;
+    uint64_t entry_count;
+} WalkCacheRecord;
+
+static const CacheRecordFormat WALK_CACHE_FORMAT = {
+    {'f', 'u', 'o', 'r', 'i', 'w', 'c', '\n'},
+    WALK_CACHE_VERSION,
+    sizeof(WalkCacheRecord),
+    WALK_CACHE_MAX_RECORDS,
+    1
+};
+
+struct WalkCache {
+    CacheRecordFile* records;
+};
+
+int open_walk_cache(const char* path, WalkCache** cache_out) {
+    WalkCache* cache;
+
+    if (!path || !cache_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *cache_out = NULL;
+
+    cache = calloc(1, sizeof(*cache));
+    if (!cache) {
+        return -1;
+    }
+    if (open_cache_record_file(path, &WALK_CACHE_FORMAT, &cache->records) != 0) {
+        free(cache);
+        return -1;
+    }
+
+    *cache_out = cache;
+    return 0;
+}
+
+/*
+ * Splits a stored listing into entries. Listings that are malformed or not in
+ * strictly ascending name order count as misses, since the walker replays
+ * them as if they came from a sorted readdir().
+ */
+static int parse_listing(const char* names, size_t length, size_t entry_count, WalkCacheEntry* entries) {
+    const char* cursor = names;
+    const char* end = names + length;
+
+    for (size_t i = 0; i < entry_count; i++) {
+        const char* name;
+        const char* terminator;
+
+        if (end - cursor < 3) {
+            return -1;
+        }
+        if (cursor[0] != WALK_CACHE_FILE && cursor[0] != WALK_CACHE_DIRECTORY && cursor[0] != WALK_CACHE_SYMLINK) {
+            return -1;
+        }
+        name = cursor + 1;
+        terminator = memchr(name, '\0', (size_t)(end - name));
+        if (!terminator || terminator == name || memchr(name, '/', (size_t)(terminator - name)) != NULL ||
+            strcmp(name, ".") == 0 || strcmp(name, "..") == 0 ||
+            (i > 0 && strcmp(entries[i - 1].name, name) >= 0)) {
+            return -1;
+        }
+        entries[i].kind = (WalkCacheKind)cursor[0];
+        entries[i].name = name;
+        cursor = terminator + 1;
+    }
+    return (cursor == end) ? 0 : -1;
+}
+
+int lookup_walk_cache(WalkCache* cache, const struct stat* dir_st, WalkCacheEntry** entries_out, size_t* count_out) {
+    const WalkCacheRecord* record;
+    const char* names;
+    WalkCacheEntry* entries;
+
+    if (!entries_out || !count_out) {
+        errno = EINVAL;
+        return -1;
+    }
+    *entries_out = NULL;
+    *count_out = 0;
+    if (!cache || !dir_st) {
+        return 0;
+    }
+
+    record = find_cache_record(cache->records, dir_st, &names);
+    if (!record || record->mtime != (int64_t)dir_st->st_mtime || record->ctime != (int64_t)dir_st->st_ctime ||
+        record->entry_count > record->names.length / 3) {
+        return 0;
+    }
+
+    entries = malloc(((size_t)record->entry_count + 1) * sizeof(*entries));
+    if (!entries) {
+        return -1;
+    }
+    if (parse_listing(names, (size_t)record->names.length, (size_t)record->entry_count, entries) != 0) {
+        free(entries);
+        return 0;
+    }
+
+    count_cache_record_hit(cache->records);
+    *entries_out = entries;
+    *count_out = (size_t)record->entry_count;
+    return 1;
+}
+
+int store_walk_cache(WalkCache* cache, const struct stat* dir_st, const WalkCacheEntry* entries, size_t count) {
+    WalkCacheRecord record;
+    char* names;
+    char* cursor;
+    size_t names_length = 0;
+    int status;
+
+    if (!cache || !dir_st || (!entries && count > 0)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!cache_stamp_settled(cache->records, dir_st)) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        names_length += strlen(entries[i].name) + 2;
+    }
+    names = malloc(names_length + 1);
+    if (!names) {
+        return -1;
+    }
+    cursor = names;
+    for (size_t i = 0; i < count; i++) {
+        size_t name_len = strlen(entries[i].name);
+        *cursor++ = (char)entries[i].kind;
+        memcpy(cursor, entries[i].name, name_len + 1);
+        cursor += name_len + 1;
+    }
+
+    memset(&record, 0, sizeof(record));
+    fill_cache_record_key(&record.key, dir_st);
+    record.mtime = (int64_t)dir_st->st_mtime;
+    record.ctime = (int64_t)dir_st->st_ctime;
+    record.entry_count = (uint64_t)count;
+
+    status = queue_cache_record(cache->records, &record, names, names_length);
+    free(names);
+    return status;
+}
+
+void walk_cache_counts(WalkCache* cache, size_t* hits_out, size_t* stored_out) {
+    cache_record_counts(cache ? cache->records : NULL, hits_out, stored_out);
+}
+
+int save_walk_cache(WalkCache* cache) {
+    if (!cache) {
+        errno = EINVAL;
+        return -1;
+    }
+    return save_cache_record_file(cache->records);
+}
+
+void close_walk_cache(WalkCache* cache) {
+    if (!cache) return;
+    close_cache_record_file(cache->records);
+    free(cache);
+}
@@ -0,0 +1,51 @@
+#ifndef WALK_CACHE_H
+#define WALK_CACHE_H
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+typedef enum {
+    WALK_CACHE_FILE = 'f',
+    WALK_CACHE_DIRECTORY = 'd',
+    WALK_CACHE_SYMLINK = 'l'
+} WalkCacheKind;
+
+/* One directory entry the walker acts on; other file types are not recorded. */
+typedef struct {
+    const char* name;
+    WalkCacheKind kind;
+} WalkCacheEntry;
+
+/*
+ * On-disk directory listings keyed by directory identity (dev, ino) and
+ * checked against the directory's mtime and ctime, which change whenever an
+ * entry is added, removed, or renamed. Entries are kept in walk order. The
+ * file is stored through cache_file.h; a missing, foreign, or damaged file
+ * reads as an empty cache.
+ *
+ * Only listings are cached: file stats and ignore verdicts are recomputed,
+ * since editing a file or a .gitignore leaves the directory's mtime alone.
+ *
+ * Lookups and stores may run on any thread.
+ */
+typedef struct WalkCache WalkCache;
+
+int open_walk_cache(const char* path, WalkCache** cache_out);
+/*
+ * Returns 1 and a malloc'd entry array when dir_st still matches a cached
+ * listing, 0 on a miss, and -1 on allocation failure. Entry names point into
+ * the cache and stay valid until it is closed.
+ */
+int lookup_walk_cache(WalkCache* cache, const struct stat* dir_st, WalkCacheEntry** entries_out, size_t* count_out);
+/*
+ * Queues a listing for the next save. Directories whose mtime or ctime is not
+ * older than the second the cache was opened are skipped, like
+ * store_classify_cache().
+ */
+int store_walk_cache(WalkCache* cache, const struct stat* dir_st, const WalkCacheEntry* entries, size_t count);
+void walk_cache_counts(WalkCache* cache, size_t* hits_out, size_t* stored_out);
+/* Merges queued listings into the file; does nothing when none were queued. */
+int save_walk_cache(WalkCache* cache);
+void close_walk_cache(WalkCache* cache);
+
+#endif
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cache_file.h"
+#include "test_check.h"
+
+/* A record with one value and a string in the blob block. */
+typedef struct {
+    CacheRecordKey key;
+    CacheBlobRef text;
+    uint64_t value;
+} TestRecord;
+
+static const CacheRecordFormat TEST_FORMAT = {
+    {'f', 'u', 'o', 'r', 'i', 't', 't', '\n'},
+    1u,
+    sizeof(TestRecord),
+    4,
+    1
+};
+
+static struct stat make_stamp(unsigned long ino, time_t mtime) {
+    struct stat st;
+
+    memset(&st, 0, sizeof(st));
+    st.st_dev = 7;
+    st.st_ino = (ino_t)ino;
+    st.st_mtime = mtime;
+    st.st_ctime = mtime;
+    return st;
+}
+
+static CacheRecordFile* reopen(const char* path) {
+    CacheRecordFile* file = NULL;
+
+    if (open_cache_record_file(path, &TEST_FORMAT, &file) != 0) {
+        perror("open_cache_record_file");
+        exit(1);
+    }
+    return file;
+}
+
+static int store(CacheRecordFile* file, unsigned long ino, uint64_t value, const char* text) {
+    struct stat st = make_stamp(ino, 0);
+    TestRecord record;
+
+    memset(&record, 0, sizeof(record));
+    fill_cache_record_key(&record.key, &st);
+    record.value = value;
+    return queue_cache_record(file, &record, text, strlen(text));
+}
+
+/* Returns 1 when ino has a stored record holding value and text. */
+static int has_record(CacheRecordFile* file, unsigned long ino, uint64_t value, const char* text) {
+    struct stat st = make_stamp(ino, 0);
+    const TestRecord* record;
+    const char* blob;
+
+    record = find_cache_record(file, &st, &blob);
+    return record && record->value == value && record->text.length == strlen(text) &&
+           memcmp(blob, text, strlen(text)) == 0;
+}
+
+static int has_key(CacheRecordFile* file, unsigned long ino) {
+    struct stat st = make_stamp(ino, 0);
+
+    return find_cache_record(file, &st, NULL) != NULL;
+}
+
+int main(void) {
+    char path[] = "/tmp/fuori-cache-file.XXXXXX";
+    CacheRecordFile* file;
+    size_t hits;
+    size_t stored;
+    FILE* stream;
+    int fd = mkstemp(path);
+
+    if (fd == -1) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+    unlink(path);
+
+    /* A missing file is empty, and only stamps older than the open second settle. */
+    file = reopen(path);
+    CHECK(!has_key(file, 10), "empty file reports a record");
+    {
+        struct stat settled = make_stamp(1, time(NULL) - 100);
+        struct stat fresh = make_stamp(1, time(NULL) + 1);
+        struct stat fresh_ctime = settled;
+        fresh_ctime.st_ctime = fresh.st_ctime;
+        CHECK(cache_stamp_settled(file, &settled), "old stamp is not settled");
+        CHECK(!cache_stamp_settled(file, &fresh), "fresh stamp is settled");
+        CHECK(!cache_stamp_settled(file, &fresh_ctime), "fresh ctime is settled");
+    }
+    CHECK(store(file, 30, 3, "thirty") == 0, "store 30 failed");
+    CHECK(store(file, 10, 1, "ten") == 0, "store 10 failed");
+    CHECK(store(file, 20, 2, "") == 0, "store 20 failed");
+    CHECK(store(file, 10, 11, "ten again") == 0, "store duplicate failed");
+    cache_record_counts(file, &hits, &stored);
+    CHECK(hits == 0 && stored == 4, "unexpected queued count");
+    CHECK(save_cache_record_file(file) == 0, "save failed");
+    close_cache_record_file(file);
+
+    /* Records come back sorted for bisection, one per key. */
+    file = reopen(path);
+    CHECK(has_record(file, 10, 1, "ten") || has_record(file, 10, 11, "ten again"), "duplicate key lost");
+    CHECK(has_record(file, 20, 2, ""), "empty blob did not round-trip");
+    CHECK(has_record(file, 30, 3, "thirty"), "record did not round-trip");
+    CHECK(!has_key(file, 15), "missing key found");
+    count_cache_record_hit(file);
+    cache_record_counts(file, &hits, &stored);
+    CHECK(hits == 1 && stored == 0, "unexpected hit count");
+
+    /* New records replace old ones with the same key; blobs are re-based. */
+    CHECK(store(file, 30, 33, "thirty-three") == 0, "store rewrite failed");
+    CHECK(store(file, 5, 0, "five") == 0, "store added failed");
+    CHECK(save_cache_record_file(file) == 0, "second save failed");
+    close_cache_record_file(file);
+    file = reopen(path);
+    CHECK(has_record(file, 30, 33, "thirty-three"), "rewritten record missing");
+    CHECK(has_record(file, 5, 0, "five"), "added record missing");
+    CHECK(has_record(file, 20, 2, ""), "old record dropped by merge");
+    CHECK(save_cache_record_file(file) == 0, "save without records failed");
+
+    /* Past max_records, old records go before new ones. */
+    CHECK(store(file, 40, 4, "forty") == 0, "store 40 failed");
+    CHECK(store(file, 50, 5, "fifty") == 0, "store 50 failed");
+    CHECK(store(file, 60, 6, "sixty") == 0, "store 60 failed");
+    CHECK(save_cache_record_file(file) == 0, "capped save failed");
+    close_cache_record_file(file);
+    file = reopen(path);
+    CHECK(has_record(file, 40, 4, "forty") && has_record(file, 50, 5, "fifty") && has_record(file, 60, 6, "sixty"),
+          "new record dropped at the cap");
+    CHECK(has_key(file, 5) + has_key(file, 10) + has_key(file, 20) + has_key(file, 30) == 1,
+          "cap did not hold");
+    close_cache_record_file(file);
+
+    /* Another format's file, a damaged file, or a foreign one reads as empty. */
+    {
+        CacheRecordFormat other = TEST_FORMAT;
+        other.version++;
+        CHECK(open_cache_record_file(path, &other, &file) == 0, "open with another version failed");
+        CHECK(!has_key(file, 40), "record read under another version");
+        close_cache_record_file(file);
+    }
+    if (truncate(path, 60) != 0) {
+        perror("truncate");
+        return 1;
+    }
+    file = reopen(path);
+    CHECK(!has_key(file, 40), "truncated file reports a record");
+    close_cache_record_file(file);
+    stream = fopen(path, "w");
+    if (stream) {
+        fputs("not a cache\n", stream);
+        fclose(stream);
+    }
+    file = reopen(path);
+    CHECK(!has_key(file, 40), "foreign file reports a record");
+    close_cache_record_file(file);
+    unlink(path);
+
+    return finish_checks("cache file");
+}
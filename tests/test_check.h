@@ -0,0 +1,27 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+/* Failed CHECKs so far; finish_checks() reports them once main() is done. */
+static int check_failures = 0;
+
+#define CHECK(cond, message)                          \
+    do {                                              \
+        if (!(cond)) {                                \
+            fprintf(stderr, "FAIL: %s\n", message);   \
+            check_failures++;                         \
+        }                                             \
+    } while (0)
+
+/* Prints the summary line for suite and returns main()'s exit status. */
+static int finish_checks(const char* suite) {
+    if (check_failures != 0) {
+        fprintf(stderr, "%d %s test(s) failed\n", check_failures, suite);
+        return 1;
+    }
+    printf("%s tests passed\n", suite);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "classify_cache.h"
+#include "test_check.h"
+
+static struct stat make_stamp(unsigned long ino, off_t size, time_t mtime) {
+    struct stat st;
+
+    memset(&st, 0, sizeof(st));
+    st.st_dev = 7;
+    st.st_ino = (ino_t)ino;
+    st.st_size = size;
+    st.st_mtime = mtime;
+    st.st_ctime = mtime;
+    return st;
+}
+
+static ClassifyResult make_text(const char* lang, size_t lines, ClassifySensitivity sensitivity) {
+    ClassifyResult result;
+
+    memset(&result, 0, sizeof(result));
+    result.sensitivity = sensitivity;
+    strcpy(result.lang, lang);
+    result.line_count = lines;
+    result.max_backtick_run = 3;
+    return result;
+}
+
+static ClassifyCache* reopen(const char* path) {
+    ClassifyCache* cache = NULL;
+
+    if (open_classify_cache(path, &cache) != 0) {
+        perror("open_classify_cache");
+        exit(1);
+    }
+    return cache;
+}
+
+int main(void) {
+    char path[] = "/tmp/fuori-classify-cache.XXXXXX";
+    time_t old = time(NULL) - 100;
+    struct stat text_st = make_stamp(10, 120, old);
+    struct stat binary_st = make_stamp(20, 4096, old);
+    struct stat secret_st = make_stamp(30, 64, old);
+    struct stat long_lang_st = make_stamp(40, 10, old);
+    ClassifyResult binary = {0};
+    ClassifyResult found;
+    ClassifyCache* cache;
+    size_t hits;
+    size_t stored;
+    int fd = mkstemp(path);
+
+    if (fd == -1) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+    unlink(path);
+
+    cache = reopen(path);
+    binary.binary = 1;
+    {
+        ClassifyResult text = make_text("c", 4, CLASSIFY_SENSITIVITY_CLEAN);
+        ClassifyResult secret = make_text("", 2, CLASSIFY_SENSITIVITY_FOUND);
+        ClassifyResult long_lang = make_text("objective-cpp", 1, CLASSIFY_SENSITIVITY_CLEAN);
+        CHECK(store_classify_cache(cache, &text_st, &text) == 0, "store text failed");
+        CHECK(store_classify_cache(cache, &binary_st, &binary) == 0, "store binary failed");
+        CHECK(store_classify_cache(cache, &secret_st, &secret) == 0, "store secret failed");
+        CHECK(store_classify_cache(cache, &long_lang_st, &long_lang) == 0, "store long lang failed");
+    }
+    classify_cache_counts(cache, &hits, &stored);
+    CHECK(stored == 3, "record with an oversized lang was queued");
+    CHECK(save_classify_cache(cache) == 0, "save failed");
+    close_classify_cache(cache);
+
+    cache = reopen(path);
+    CHECK(lookup_classify_cache(cache, &text_st, &found) && !found.binary &&
+              found.sensitivity == CLASSIFY_SENSITIVITY_CLEAN && strcmp(found.lang, "c") == 0 &&
+              found.line_count == 4 && found.max_backtick_run == 3,
+          "text record did not round-trip");
+    CHECK(lookup_classify_cache(cache, &binary_st, &found) && found.binary, "binary record did not round-trip");
+    CHECK(lookup_classify_cache(cache, &secret_st, &found) &&
+              found.sensitivity == CLASSIFY_SENSITIVITY_FOUND && found.lang[0] == '\0',
+          "sensitive record did not round-trip");
+    CHECK(!lookup_classify_cache(cache, &long_lang_st, &found), "record with an oversized lang was saved");
+    {
+        struct stat touched = text_st;
+        struct stat changed = text_st;
+        struct stat resized = text_st;
+        touched.st_mtime++;
+        changed.st_ctime++;
+        resized.st_size++;
+        CHECK(!lookup_classify_cache(cache, &touched, &found), "changed mtime still hits");
+        CHECK(!lookup_classify_cache(cache, &changed, &found), "changed ctime still hits");
+        CHECK(!lookup_classify_cache(cache, &resized, &found), "changed size still hits");
+    }
+    classify_cache_counts(cache, &hits, &stored);
+    CHECK(hits == 3 && stored == 0, "unexpected hit count");
+    close_classify_cache(cache);
+    unlink(path);
+
+    return finish_checks("classification cache");
+}
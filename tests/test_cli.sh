@@ -257,6 +257,7 @@ assert_not_contains "$TMPDIR/sensitive_content_allow_stderr.txt" "Warning: Skipp
 (cd "$OUTSIDE" && "$BIN" -v -o verbose_export.md >verbose_file_stdout.txt 2>verbose_file_stderr.txt)
 assert_file_equals "$OUTSIDE/verbose_file_stdout.txt" ""
 assert_contains "$OUTSIDE/verbose_file_stderr.txt" "Codebase exported to verbose_export.md successfully!"
+assert_contains "$OUTSIDE/verbose_file_stderr.txt" "kernel copy call(s) for 1 MiB"
 
 cat >"$OUTSIDE/existing.txt" <<'EOF_EXISTING'
 keep me
@@ -322,6 +323,12 @@ fi
 assert_contains "$RENDER_FAIL_DIR/render_failure_stderr.txt" "Error processing export files"
 assert_file_equals "$RENDER_FAIL_DIR/export.md" "original artifact"
 assert_no_temp_outputs "$RENDER_FAIL_DIR"
+if (cd "$RENDER_FAIL_DIR" && FUORI_TEST_FAIL_RENDER_AT=1 "$BIN" -j 2 -o export.md >/dev/null 2>render_failure_parallel_stderr.txt); then
+    fail "expected render failure to abort a parallel export"
+fi
+assert_contains "$RENDER_FAIL_DIR/render_failure_parallel_stderr.txt" "Error processing export files"
+assert_file_equals "$RENDER_FAIL_DIR/export.md" "original artifact"
+assert_no_temp_outputs "$RENDER_FAIL_DIR"
 
 PERM_DIR="$TMPDIR/permissions"
 mkdir -p "$PERM_DIR"
@@ -463,17 +470,17 @@ assert_not_contains "$STDIN_DIR/stdin_none_stdout.txt" "## "
 if printf 'alpha.c\n' | (cd "$STDIN_DIR" && "$BIN" --from-stdin --staged >/dev/null 2>stdin_conflict_staged.txt); then
     fail "expected --from-stdin --staged to fail"
 fi
-assert_contains "$STDIN_DIR/stdin_conflict_staged.txt" "--from-stdin, --staged, --unstaged, and --diff are mutually exclusive"
+assert_contains "$STDIN_DIR/stdin_conflict_staged.txt" "--from-stdin, --staged, --unstaged, --diff, and --rev are mutually exclusive"
 
 if printf 'alpha.c\n' | (cd "$STDIN_DIR" && "$BIN" --from-stdin --diff HEAD >/dev/null 2>stdin_conflict_diff.txt); then
     fail "expected --from-stdin --diff to fail"
 fi
-assert_contains "$STDIN_DIR/stdin_conflict_diff.txt" "--from-stdin, --staged, --unstaged, and --diff are mutually exclusive"
+assert_contains "$STDIN_DIR/stdin_conflict_diff.txt" "--from-stdin, --staged, --unstaged, --diff, and --rev are mutually exclusive"
 
 if printf 'alpha.c\n' | (cd "$STDIN_DIR" && "$BIN" --from-stdin --no-git >/dev/null 2>stdin_conflict_no_git.txt); then
     fail "expected --from-stdin --no-git to fail"
 fi
-assert_contains "$STDIN_DIR/stdin_conflict_no_git.txt" "--no-git cannot be combined with --from-stdin, --staged, --unstaged, or --diff"
+assert_contains "$STDIN_DIR/stdin_conflict_no_git.txt" "--no-git cannot be combined with --from-stdin, --staged, --unstaged, --diff, or --rev"
 
 if printf 'alpha.c\n' | (cd "$STDIN_DIR" && "$BIN" --from-stdin --no-default-ignore >/dev/null 2>stdin_conflict_no_default_ignore.txt); then
     fail "expected --from-stdin --no-default-ignore to fail"
@@ -483,7 +490,7 @@ assert_contains "$STDIN_DIR/stdin_conflict_no_default_ignore.txt" "--no-default-
 if printf 'alpha.c\n' | (cd "$STDIN_DIR" && "$BIN" --from-stdin --hunks >/dev/null 2>stdin_conflict_hunks.txt); then
     fail "expected --from-stdin --hunks to fail"
 fi
-assert_contains "$STDIN_DIR/stdin_conflict_hunks.txt" "--hunks can only be used with --staged, --unstaged, or --diff"
+assert_contains "$STDIN_DIR/stdin_conflict_hunks.txt" "--hunks can only be used with --staged, --unstaged, --diff, or --baseline"
 
 if (cd "$STDIN_DIR" && "$BIN" -0 >/dev/null 2>stdin_null_without_mode_stderr.txt); then
     fail "expected -0 without --from-stdin to fail"
@@ -577,7 +584,7 @@ assert_contains "$REPO/stdout_no_git.txt" "This document contains all the source
 if (cd "$REPO" && "$BIN" --no-git --staged >/dev/null 2>stderr_invalid.txt); then
     fail "expected --no-git --staged to fail"
 fi
-assert_contains "$REPO/stderr_invalid.txt" "--no-git cannot be combined with --from-stdin, --staged, --unstaged, or --diff"
+assert_contains "$REPO/stderr_invalid.txt" "--no-git cannot be combined with --from-stdin, --staged, --unstaged, --diff, or --rev"
 
 if (cd "$REPO" && "$BIN" --staged --no-default-ignore >/dev/null 2>stderr_no_default_ignore_invalid.txt); then
     fail "expected --staged --no-default-ignore to fail"
@@ -592,7 +599,7 @@ assert_contains "$REPO/stderr_no_default_ignore_auto_invalid.txt" "--no-default-
 if (cd "$REPO" && "$BIN" --hunks >/dev/null 2>stderr_hunks_default_invalid.txt); then
     fail "expected bare --hunks to fail"
 fi
-assert_contains "$REPO/stderr_hunks_default_invalid.txt" "--hunks can only be used with --staged, --unstaged, or --diff"
+assert_contains "$REPO/stderr_hunks_default_invalid.txt" "--hunks can only be used with --staged, --unstaged, --diff, or --baseline"
 
 if (cd "$REPO" && "$BIN" --staged --hunks --unpacker >/dev/null 2>stderr_unpacker_hunks_invalid.txt); then
     fail "expected --staged --hunks --unpacker to fail"
@@ -602,7 +609,7 @@ assert_contains "$REPO/stderr_unpacker_hunks_invalid.txt" "--unpacker cannot be
 if (cd "$REPO" && "$BIN" --no-git --hunks >/dev/null 2>stderr_hunks_no_git_invalid.txt); then
     fail "expected --no-git --hunks to fail"
 fi
-assert_contains "$REPO/stderr_hunks_no_git_invalid.txt" "--hunks can only be used with --staged, --unstaged, or --diff"
+assert_contains "$REPO/stderr_hunks_no_git_invalid.txt" "--hunks can only be used with --staged, --unstaged, --diff, or --baseline"
 
 if (cd "$REPO" && "$BIN" --staged --hunks=-1 >/dev/null 2>stderr_hunks_negative_invalid.txt); then
     fail "expected --staged --hunks=-1 to fail"
@@ -670,6 +677,54 @@ assert_contains "$STAGED_REPO/unstaged_stdout.txt" "- M beta.c"
 assert_contains "$STAGED_REPO/unstaged_stdout.txt" "## beta.c"
 assert_not_contains "$STAGED_REPO/unstaged_stdout.txt" "- A added.c"
 
+cat >"$STAGED_REPO/alpha.c" <<'EOF_STAGED_ALPHA_WORKTREE'
+int alpha(void) { return 99; }
+EOF_STAGED_ALPHA_WORKTREE
+(cd "$STAGED_REPO" && "$BIN" --staged --no-tree -o - >staged_blob_stdout.txt 2>staged_blob_stderr.txt)
+assert_contains "$STAGED_REPO/staged_blob_stdout.txt" "int alpha(void) { return 10; }"
+assert_not_contains "$STAGED_REPO/staged_blob_stdout.txt" "return 99"
+
+(cd "$STAGED_REPO" && "$BIN" --rev HEAD --no-tree -o - >rev_stdout.txt 2>rev_stderr.txt)
+assert_contains "$STAGED_REPO/rev_stdout.txt" "Mode: rev"
+assert_contains "$STAGED_REPO/rev_stdout.txt" "Revision: HEAD"
+assert_contains "$STAGED_REPO/rev_stdout.txt" "int alpha(void) { return 1; }"
+assert_contains "$STAGED_REPO/rev_stdout.txt" "int beta(void) { return 2; }"
+assert_contains "$STAGED_REPO/rev_stdout.txt" "## old_name.c"
+assert_not_contains "$STAGED_REPO/rev_stdout.txt" "## added.c"
+assert_not_contains "$STAGED_REPO/rev_stdout.txt" "## Change Context"
+
+# cat-file starts while the ls-tree listing is still streaming; it must not
+# inherit the listing pipe or its own pipes' other ends, or an aborted listing
+# could keep git waiting on a reader that never goes away.
+if [ -d /proc/self/fd ]; then
+    GIT_WRAPPER_DIR="$TMPDIR/git_wrapper"
+    REAL_GIT=$(command -v git)
+    mkdir -p "$GIT_WRAPPER_DIR"
+    cat >"$GIT_WRAPPER_DIR/git" <<EOF_GIT_WRAPPER
+#!/bin/sh
+case " \$* " in
+*" cat-file "*) ls -l /proc/self/fd >"$GIT_WRAPPER_DIR/cat_file_fds.txt" ;;
+esac
+exec "$REAL_GIT" "\$@"
+EOF_GIT_WRAPPER
+    chmod +x "$GIT_WRAPPER_DIR/git"
+    (cd "$STAGED_REPO" && PATH="$GIT_WRAPPER_DIR:$PATH" "$BIN" --rev HEAD --no-tree -o - >rev_wrapped_stdout.txt 2>rev_wrapped_stderr.txt)
+    assert_contains "$STAGED_REPO/rev_wrapped_stdout.txt" "int alpha(void) { return 1; }"
+    assert_contains "$GIT_WRAPPER_DIR/cat_file_fds.txt" " 0 -> pipe:"
+    if awk '$(NF - 2) + 0 > 1 && $NF ~ /^pipe:/' "$GIT_WRAPPER_DIR/cat_file_fds.txt" | grep . >/dev/null; then
+        fail "expected git cat-file to inherit no pipes beyond its stdin and stdout"
+    fi
+fi
+
+if (cd "$STAGED_REPO" && "$BIN" --rev does-not-exist -o - >/dev/null 2>rev_invalid_stderr.txt); then
+    fail "expected --rev with an unknown revision to fail"
+fi
+assert_contains "$STAGED_REPO/rev_invalid_stderr.txt" "git ls-tree failed for the requested file-selection mode"
+if (cd "$STAGED_REPO" && "$BIN" --rev HEAD --hunks >/dev/null 2>rev_hunks_stderr.txt); then
+    fail "expected --rev --hunks to fail"
+fi
+assert_contains "$STAGED_REPO/rev_hunks_stderr.txt" "--hunks can only be used with --staged, --unstaged, --diff, or --baseline"
+
 HUNKS_REPO="$TMPDIR/hunks_repo"
 mkdir -p "$HUNKS_REPO/sub"
 (cd "$HUNKS_REPO" && git init -q)
@@ -771,6 +826,89 @@ assert_contains "$HUNKS_REPO/sub/nested_hunks_stdout.txt" "## nested.c"
 assert_contains "$HUNKS_REPO/sub/nested_hunks_stdout.txt" "nested_two"
 assert_not_contains "$HUNKS_REPO/sub/nested_hunks_stdout.txt" "## review.c"
 
+BATCH_HUNKS_REPO="$TMPDIR/batch_hunks_repo"
+mkdir -p "$BATCH_HUNKS_REPO"
+(cd "$BATCH_HUNKS_REPO" && git init -q)
+awk 'BEGIN { for (i = 1; i <= 30; i++) printf "moved line %d\n", i; }' >"$BATCH_HUNKS_REPO/before.txt"
+awk 'BEGIN { for (i = 1; i <= 30; i++) printf "spaced line %d\n", i; }' >"$BATCH_HUNKS_REPO/with space.txt"
+awk 'BEGIN { for (i = 1; i <= 30; i++) printf "plain line %d\n", i; }' >"$BATCH_HUNKS_REPO/plain.txt"
+(cd "$BATCH_HUNKS_REPO" && git add -A && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qm base)
+(cd "$BATCH_HUNKS_REPO" && git mv before.txt after.txt)
+sed 's/^moved line 25$/moved line twenty-five/' "$BATCH_HUNKS_REPO/after.txt" >"$BATCH_HUNKS_REPO/after.tmp"
+mv "$BATCH_HUNKS_REPO/after.tmp" "$BATCH_HUNKS_REPO/after.txt"
+sed 's/^spaced line 4$/spaced line four/' "$BATCH_HUNKS_REPO/with space.txt" >"$BATCH_HUNKS_REPO/space.tmp"
+mv "$BATCH_HUNKS_REPO/space.tmp" "$BATCH_HUNKS_REPO/with space.txt"
+sed 's/^plain line 15$/plain line fifteen/' "$BATCH_HUNKS_REPO/plain.txt" >"$BATCH_HUNKS_REPO/plain.tmp"
+mv "$BATCH_HUNKS_REPO/plain.tmp" "$BATCH_HUNKS_REPO/plain.txt"
+(cd "$BATCH_HUNKS_REPO" && git add -A)
+
+(cd "$BATCH_HUNKS_REPO" && "$BIN" --staged --hunks=0 --line-numbers --no-tree -o - >"$TMPDIR/batch_hunks_stdout.txt" 2>"$TMPDIR/batch_hunks_stderr.txt")
+assert_contains "$TMPDIR/batch_hunks_stdout.txt" "- R before.txt -> after.txt"
+awk '/^## after.txt$/{flag=1; next} /^## /{flag=0} flag { print }' "$TMPDIR/batch_hunks_stdout.txt" >"$TMPDIR/batch_after_section.txt"
+assert_contains "$TMPDIR/batch_after_section.txt" "25 | moved line twenty-five"
+assert_not_contains "$TMPDIR/batch_after_section.txt" "moved line 24"
+awk '/^## with space.txt$/{flag=1; next} /^## /{flag=0} flag { print }' "$TMPDIR/batch_hunks_stdout.txt" >"$TMPDIR/batch_space_section.txt"
+assert_contains "$TMPDIR/batch_space_section.txt" "4 | spaced line four"
+assert_not_contains "$TMPDIR/batch_space_section.txt" "spaced line 5"
+awk '/^## plain.txt$/{flag=1; next} /^## /{flag=0} flag { print }' "$TMPDIR/batch_hunks_stdout.txt" >"$TMPDIR/batch_plain_section.txt"
+assert_contains "$TMPDIR/batch_plain_section.txt" "15 | plain line fifteen"
+assert_not_contains "$TMPDIR/batch_plain_section.txt" "plain line 14"
+
+SLIDER_REPO="$TMPDIR/slider_repo"
+mkdir -p "$SLIDER_REPO"
+(cd "$SLIDER_REPO" && git init -q)
+cat >"$SLIDER_REPO/slider.c" <<'EOF_SLIDER_BASE'
+#include <stdio.h>
+
+static int one(void) {
+    return 1;
+}
+
+static int two(void) {
+    return 2;
+}
+
+int main(void) {
+    printf("%d\n", one() + two());
+    return 0;
+}
+EOF_SLIDER_BASE
+(cd "$SLIDER_REPO" && git add slider.c && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qm base)
+cat >"$SLIDER_REPO/slider.c" <<'EOF_SLIDER_MOD'
+#include <stdlib.h>
+
+static int one(void) {
+    return 1;
+}
+
+static int half(void) {
+    return 0;
+}
+
+static int two(void) {
+    return 2;
+}
+
+int main(void) {
+    printf("%d\n", one() + two());
+    return 0;
+}
+EOF_SLIDER_MOD
+(cd "$SLIDER_REPO" && git add slider.c)
+# The inserted function can also be read as starting at the "}" above it; the
+# rendered lines must be the ones git picks.
+(cd "$SLIDER_REPO" && "$BIN" --staged --hunks=0 --line-numbers --no-tree -o - >slider_stdout.txt 2>slider_stderr.txt)
+sed -n 's/^ *\([0-9][0-9]*\) | .*/\1/p' "$SLIDER_REPO/slider_stdout.txt" >"$SLIDER_REPO/slider_fuori_lines.txt"
+(cd "$SLIDER_REPO" && git diff --cached -U0 -- slider.c) |
+    sed -n 's/^@@ -[0-9,]* +\([0-9][0-9]*\)\(,\([0-9][0-9]*\)\)\{0,1\} @@.*/\1 \3/p' |
+    awk '{ count = ($2 == "") ? 1 : $2; for (i = 0; i < count; i++) print $1 + i; }' >"$SLIDER_REPO/slider_git_lines.txt"
+if ! cmp -s "$SLIDER_REPO/slider_fuori_lines.txt" "$SLIDER_REPO/slider_git_lines.txt"; then
+    fail "expected --hunks=0 to render the lines git diff -U0 reports for slider.c"
+fi
+assert_contains "$SLIDER_REPO/slider_stdout.txt" " 7 | static int half(void) {"
+
 SENSITIVE_STAGED_REPO="$TMPDIR/sensitive_staged_repo"
 mkdir -p "$SENSITIVE_STAGED_REPO"
 (cd "$SENSITIVE_STAGED_REPO" && git init -q)
@@ -828,4 +966,273 @@ assert_contains "$DIFF_REPO/diff_stdout.txt" "## fresh.c"
 assert_contains "$DIFF_REPO/diff_stdout.txt" "## renamed.c"
 assert_contains "$DIFF_REPO/diff_stdout.txt" "## shared.c"
 
+JOBS_DIR="$TMPDIR/jobs"
+mkdir -p "$JOBS_DIR/src/nested" "$JOBS_DIR/docs"
+for n in 1 2 3 4 5 6 7 8; do
+    printf 'int f%s(void) { return %s; }\n' "$n" "$n" >"$JOBS_DIR/src/file$n.c"
+    printf '# note %s\n' "$n" >"$JOBS_DIR/docs/note$n.md"
+done
+printf 'x\000y' >"$JOBS_DIR/src/nested/blob.bin"
+printf 'print("nested")\n' >"$JOBS_DIR/src/nested/script.py"
+mkdir -p "$JOBS_DIR/vendor/keep/deep" "$JOBS_DIR/vendor/drop"
+printf 'keep\n' >"$JOBS_DIR/vendor/keep/deep/kept.txt"
+printf 'drop\n' >"$JOBS_DIR/vendor/drop/dropped.txt"
+printf 'vendor/*\n!vendor/keep/\n' >"$JOBS_DIR/.gitignore"
+(cd "$JOBS_DIR" && "$BIN" --no-git -v -j 1 -o - 2>"$TMPDIR/jobs_serial_stderr.txt" | grep -v '^Generated: ' >"$TMPDIR/jobs_serial.txt")
+(cd "$JOBS_DIR" && "$BIN" --no-git -v --jobs=4 -o - 2>"$TMPDIR/jobs_parallel_stderr.txt" | grep -v '^Generated: ' >"$TMPDIR/jobs_parallel.txt")
+cmp -s "$TMPDIR/jobs_serial.txt" "$TMPDIR/jobs_parallel.txt" || fail "expected identical output for -j 1 and --jobs=4"
+cmp -s "$TMPDIR/jobs_serial_stderr.txt" "$TMPDIR/jobs_parallel_stderr.txt" || fail "expected identical diagnostics for -j 1 and --jobs=4"
+assert_contains "$TMPDIR/jobs_parallel_stderr.txt" "Skipping binary/empty file: ./src/nested/blob.bin"
+assert_contains "$TMPDIR/jobs_parallel.txt" "## vendor/keep/deep/kept.txt"
+assert_not_contains "$TMPDIR/jobs_parallel.txt" "dropped.txt"
+(cd "$JOBS_DIR" && "$BIN" --no-git --unpacker -v -j 1 -o "$TMPDIR/jobs_serial.md" 2>"$TMPDIR/jobs_serial_file_stderr.txt")
+(cd "$JOBS_DIR" && "$BIN" --no-git --unpacker -v -j 4 -o "$TMPDIR/jobs_parallel.md" 2>"$TMPDIR/jobs_parallel_file_stderr.txt")
+grep '^Processing file: ' "$TMPDIR/jobs_serial_file_stderr.txt" >"$TMPDIR/jobs_serial_files.txt"
+grep '^Processing file: ' "$TMPDIR/jobs_parallel_file_stderr.txt" >"$TMPDIR/jobs_parallel_files.txt"
+assert_occurrences "$TMPDIR/jobs_parallel_files.txt" "Processing file: " 19
+cmp -s "$TMPDIR/jobs_serial_files.txt" "$TMPDIR/jobs_parallel_files.txt" || fail "expected -j 4 to list rendered files in plan order"
+grep -v '^Generated: ' "$TMPDIR/jobs_serial.md" >"$TMPDIR/jobs_serial_file.txt"
+grep -v '^Generated: ' "$TMPDIR/jobs_parallel.md" >"$TMPDIR/jobs_parallel_file.txt"
+cmp -s "$TMPDIR/jobs_serial_file.txt" "$TMPDIR/jobs_parallel_file.txt" || fail "expected identical output files for -j 1 and -j 4"
+if (cd "$JOBS_DIR" && "$BIN" --no-git -j 0 -o - >/dev/null 2>"$TMPDIR/jobs_invalid.txt"); then
+    fail "expected -j 0 to be rejected"
+fi
+
+MMAP_DIR="$TMPDIR/mmap"
+mkdir -p "$MMAP_DIR"
+i=0
+while [ "$i" -lt 1200 ]; do
+    printf 'int mapped_line_%s = %s; /* padding for a file above the mapping threshold */\n' "$i" "$i"
+    i=$((i + 1))
+done >"$MMAP_DIR/large.c"
+printf 'int small = 1;\n' >"$MMAP_DIR/small.c"
+(cd "$MMAP_DIR" && "$BIN" --no-git --line-numbers -o - 2>/dev/null | grep -v '^Generated: ' >"$TMPDIR/mmap_read.txt")
+(cd "$MMAP_DIR" && "$BIN" --no-git --line-numbers --mmap -o - 2>/dev/null | grep -v '^Generated: ' >"$TMPDIR/mmap_mapped.txt")
+cmp -s "$TMPDIR/mmap_read.txt" "$TMPDIR/mmap_mapped.txt" || fail "expected identical output with --mmap"
+assert_contains "$TMPDIR/mmap_mapped.txt" "int mapped_line_1199 = 1199;"
+printf 'fence ```` inside\n' >"$MMAP_DIR/fenced.md"
+(cd "$MMAP_DIR" && "$BIN" --no-git --line-numbers -o - 2>/dev/null | grep -v '^Generated: ' >"$TMPDIR/stream_buffered.txt")
+(cd "$MMAP_DIR" && "$BIN" --no-git --line-numbers --stream -o - 2>/dev/null | grep -v '^Generated: ' >"$TMPDIR/stream_streamed.txt")
+cmp -s "$TMPDIR/stream_buffered.txt" "$TMPDIR/stream_streamed.txt" || fail "expected identical output with --stream"
+assert_contains "$TMPDIR/stream_streamed.txt" '`````markdown'
+
+LINKED_MAIN="$TMPDIR/linked_main"
+LINKED_WT="$TMPDIR/linked_wt"
+mkdir -p "$LINKED_MAIN/pkg/inner"
+(cd "$LINKED_MAIN" && git init -q)
+printf 'int top(void) { return 1; }\n' >"$LINKED_MAIN/top.c"
+printf 'int inner(void) { return 2; }\n' >"$LINKED_MAIN/pkg/inner/inner.c"
+(cd "$LINKED_MAIN" && git add -A && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qm base && \
+    git worktree add -q "$LINKED_WT" 2>/dev/null)
+printf 'int untracked(void) { return 3; }\n' >"$LINKED_WT/pkg/inner/untracked.c"
+(cd "$LINKED_WT/pkg" && "$BIN" --no-tree -o - >"$TMPDIR/linked_stdout.txt" 2>"$TMPDIR/linked_stderr.txt")
+assert_contains "$TMPDIR/linked_stdout.txt" "Repository: linked_wt"
+assert_contains "$TMPDIR/linked_stdout.txt" "Mode: worktree"
+assert_contains "$TMPDIR/linked_stdout.txt" "## inner/inner.c"
+assert_contains "$TMPDIR/linked_stdout.txt" "## inner/untracked.c"
+assert_not_contains "$TMPDIR/linked_stdout.txt" "top.c"
+(cd "$LINKED_WT/pkg/inner" && "$BIN" --unstaged --no-tree -o - >"$TMPDIR/linked_unstaged.txt" 2>&1)
+assert_contains "$TMPDIR/linked_unstaged.txt" "Mode: unstaged"
+
+INDEX_REPO="$TMPDIR/index_repo"
+mkdir -p "$INDEX_REPO/src/deep"
+(cd "$INDEX_REPO" && git init -q)
+printf 'int one;\n' >"$INDEX_REPO/src/one.c"
+printf 'int two;\n' >"$INDEX_REPO/src/deep/two_with_a_longer_name.c"
+printf 'int three;\n' >"$INDEX_REPO/src/deep/two_with_a_longer_name_too.c"
+printf 'skip.log\n' >"$INDEX_REPO/.gitignore"
+(cd "$INDEX_REPO" && git add -A && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qm base)
+printf 'int untracked;\n' >"$INDEX_REPO/src/untracked.c"
+printf 'ignored\n' >"$INDEX_REPO/skip.log"
+printf 'int intent;\n' >"$INDEX_REPO/src/intent.c"
+(cd "$INDEX_REPO" && git add -N src/intent.c)
+# GIT_DIR makes fuori defer repository discovery to git, which lists paths with ls-files.
+(cd "$INDEX_REPO/src" && GIT_DIR="$INDEX_REPO/.git" GIT_WORK_TREE="$INDEX_REPO" "$BIN" -o - 2>&1 | grep -v '^Generated: ' >"$TMPDIR/index_ls_files.txt")
+(cd "$INDEX_REPO/src" && "$BIN" -o - 2>&1 | grep -v '^Generated: ' >"$TMPDIR/index_v2.txt")
+cmp -s "$TMPDIR/index_ls_files.txt" "$TMPDIR/index_v2.txt" || fail "expected index v2 listing to match git ls-files"
+assert_contains "$TMPDIR/index_v2.txt" "## deep/two_with_a_longer_name_too.c"
+assert_contains "$TMPDIR/index_v2.txt" "## untracked.c"
+assert_contains "$TMPDIR/index_v2.txt" "## intent.c"
+(cd "$INDEX_REPO" && git update-index --index-version 4)
+(cd "$INDEX_REPO/src" && "$BIN" -o - 2>&1 | grep -v '^Generated: ' >"$TMPDIR/index_v4.txt")
+cmp -s "$TMPDIR/index_ls_files.txt" "$TMPDIR/index_v4.txt" || fail "expected index v4 listing to match git ls-files"
+(cd "$INDEX_REPO" && git checkout -qb side && printf 'int side;\n' >src/one.c && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qam side && \
+    git checkout -q - && printf 'int main_side;\n' >src/one.c && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qam main && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' merge -q side >/dev/null 2>&1) || true
+(cd "$INDEX_REPO" && "$BIN" --no-tree -o - >"$TMPDIR/index_conflict.txt" 2>&1) || fail "expected a conflicted index to export"
+(cd "$INDEX_REPO" && GIT_DIR="$INDEX_REPO/.git" GIT_WORK_TREE="$INDEX_REPO" "$BIN" --no-tree -o - >"$TMPDIR/index_conflict_ls_files.txt" 2>&1) || \
+    fail "expected a conflicted ls-files listing to export"
+assert_occurrences "$TMPDIR/index_conflict.txt" "## src/one.c" 1
+assert_occurrences "$TMPDIR/index_conflict.txt" "<<<<<<<" 1
+assert_occurrences "$TMPDIR/index_conflict_ls_files.txt" "## src/one.c" 1
+
+# Hooks run by `git commit <paths>` see a temporary index through GIT_INDEX_FILE.
+ALT_INDEX_REPO="$TMPDIR/alt_index_repo"
+mkdir -p "$ALT_INDEX_REPO"
+(cd "$ALT_INDEX_REPO" && git init -q)
+printf 'int a;\n' >"$ALT_INDEX_REPO/a.c"
+printf 'int b;\n' >"$ALT_INDEX_REPO/b.c"
+printf 'b.c\n' >"$ALT_INDEX_REPO/.gitignore"
+(cd "$ALT_INDEX_REPO" && git add a.c .gitignore && \
+    git -c user.name='fuori tests' -c user.email='fuori@example.com' commit -qm base && \
+    cp .git/index "$TMPDIR/alt_index" && GIT_INDEX_FILE="$TMPDIR/alt_index" git add -f b.c)
+(cd "$ALT_INDEX_REPO" && GIT_INDEX_FILE="$TMPDIR/alt_index" "$BIN" --no-tree -o - >"$TMPDIR/alt_index.txt" 2>&1) || \
+    fail "expected an alternate index to export"
+assert_contains "$TMPDIR/alt_index.txt" "## a.c"
+assert_contains "$TMPDIR/alt_index.txt" "## b.c"
+(cd "$ALT_INDEX_REPO" && "$BIN" --no-tree -o - >"$TMPDIR/default_index.txt" 2>&1)
+assert_not_contains "$TMPDIR/default_index.txt" "## b.c"
+
+BASELINE_DIR="$TMPDIR/baseline_export"
+mkdir -p "$BASELINE_DIR/current" "$BASELINE_DIR/previous"
+: >"$BASELINE_DIR/current/long.c"
+i=1
+while [ "$i" -le 40 ]; do
+    printf 'int line_%d;\n' "$i" >>"$BASELINE_DIR/current/long.c"
+    i=$((i + 1))
+done
+cp "$BASELINE_DIR/current/long.c" "$BASELINE_DIR/previous/long.c"
+sed 's/^int line_20;$/int line_twenty;/' "$BASELINE_DIR/previous/long.c" >"$BASELINE_DIR/current/long.c"
+printf 'int same(void) { return 0; }\n' >"$BASELINE_DIR/current/same.c"
+cp "$BASELINE_DIR/current/same.c" "$BASELINE_DIR/previous/same.c"
+printf 'int fresh(void) { return 1; }\n' >"$BASELINE_DIR/current/fresh.c"
+(cd "$BASELINE_DIR/current" && "$BIN" --no-git --no-tree --hunks=1 --baseline ../previous -o - >baseline_stdout.txt 2>baseline_stderr.txt)
+assert_contains "$BASELINE_DIR/current/baseline_stdout.txt" "Baseline: ../previous"
+assert_contains "$BASELINE_DIR/current/baseline_stdout.txt" "int line_twenty;"
+assert_contains "$BASELINE_DIR/current/baseline_stdout.txt" "int line_19;"
+assert_not_contains "$BASELINE_DIR/current/baseline_stdout.txt" "int line_5;"
+assert_contains "$BASELINE_DIR/current/baseline_stdout.txt" "int fresh(void) { return 1; }"
+assert_not_contains "$BASELINE_DIR/current/baseline_stdout.txt" "## same.c"
+
+printf 'same.c\nlong.c\n' | (cd "$BASELINE_DIR/current" && "$BIN" --from-stdin --no-tree --hunks=0 --baseline="$BASELINE_DIR/previous" -o - >baseline_stdin_stdout.txt 2>baseline_stdin_stderr.txt)
+assert_contains "$BASELINE_DIR/current/baseline_stdin_stdout.txt" "int line_twenty;"
+assert_not_contains "$BASELINE_DIR/current/baseline_stdin_stdout.txt" "int line_19;"
+assert_not_contains "$BASELINE_DIR/current/baseline_stdin_stdout.txt" "## same.c"
+
+if (cd "$BASELINE_DIR/current" && "$BIN" --no-git --baseline ../previous >/dev/null 2>baseline_no_hunks.txt); then
+    fail "expected --baseline without --hunks to fail"
+fi
+assert_contains "$BASELINE_DIR/current/baseline_no_hunks.txt" "--baseline requires --hunks"
+
+if (cd "$STAGED_REPO" && "$BIN" --staged --hunks --baseline "$BASELINE_DIR/previous" >/dev/null 2>baseline_staged.txt); then
+    fail "expected --staged --baseline to fail"
+fi
+assert_contains "$STAGED_REPO/baseline_staged.txt" "--baseline cannot be combined with --staged, --unstaged, or --diff"
+
+NESTED_IGNORE_DIR="$TMPDIR/nested_ignore"
+mkdir -p "$NESTED_IGNORE_DIR/sub/gen" "$NESTED_IGNORE_DIR/other/gen" "$NESTED_IGNORE_DIR/.git/info"
+printf 'secret.txt\n' >"$NESTED_IGNORE_DIR/.git/info/exclude"
+printf '*.log\n!/sub/local.c\n' >"$NESTED_IGNORE_DIR/.gitignore"
+printf '/gen/\nlocal.c\n' >"$NESTED_IGNORE_DIR/sub/.gitignore"
+printf 'int top;\n' >"$NESTED_IGNORE_DIR/top.c"
+printf 'secret\n' >"$NESTED_IGNORE_DIR/secret.txt"
+printf 'int generated;\n' >"$NESTED_IGNORE_DIR/sub/gen/out.c"
+printf 'int other;\n' >"$NESTED_IGNORE_DIR/other/gen/other.c"
+printf 'int local;\n' >"$NESTED_IGNORE_DIR/sub/local.c"
+printf 'int main(void) { return 0; }\n' >"$NESTED_IGNORE_DIR/sub/main.c"
+printf 'log\n' >"$NESTED_IGNORE_DIR/sub/app.log"
+(cd "$NESTED_IGNORE_DIR" && "$BIN" --no-git --no-tree -v -o - >nested_ignore_stdout.txt 2>nested_ignore_stderr.txt)
+assert_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## top.c"
+assert_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## sub/main.c"
+assert_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## other/gen/other.c"
+assert_not_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## sub/gen/out.c"
+assert_not_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## sub/local.c"
+assert_not_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## sub/app.log"
+assert_not_contains "$NESTED_IGNORE_DIR/nested_ignore_stdout.txt" "## secret.txt"
+assert_contains "$NESTED_IGNORE_DIR/nested_ignore_stderr.txt" "Skipping ignored directory: ./sub/gen"
+assert_not_contains "$NESTED_IGNORE_DIR/nested_ignore_stderr.txt" "Processing directory: ./sub/gen"
+
+CACHE_DIR="$TMPDIR/classify_cache"
+CACHE_STORE="$TMPDIR/cache_store"
+mkdir -p "$CACHE_DIR"
+printf 'int main(void) { return 0; }\n' >"$CACHE_DIR/main.c"
+printf 'bin\000ary\n' >"$CACHE_DIR/blob.bin"
+printf 'sk-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\n' >"$CACHE_DIR/token.txt"
+LINK_CACHE_DIR="$TMPDIR/classify_cache_links"
+mkdir -p "$LINK_CACHE_DIR"
+printf '#!/usr/bin/env python3\nprint(1)\n' >"$LINK_CACHE_DIR/tool.rb"
+ln "$LINK_CACHE_DIR/tool.rb" "$LINK_CACHE_DIR/tool.sh"
+ln "$LINK_CACHE_DIR/tool.rb" "$LINK_CACHE_DIR/tool"
+COPY_DIR="$TMPDIR/kernel_copy"
+mkdir -p "$COPY_DIR"
+i=0
+while [ "$i" -lt 400 ]; do
+    printf 'int copied_line_%s = %s; /* long enough to take the kernel copy path */\n' "$i" "$i"
+    i=$((i + 1))
+done >"$COPY_DIR/terminated.c"
+{ cat "$COPY_DIR/terminated.c"; printf 'fence ```` and no newline'; } >"$COPY_DIR/unterminated.md"
+FRESH_COPY_DIR="$TMPDIR/kernel_copy_fresh"
+mkdir -p "$FRESH_COPY_DIR"
+# Files touched in the second a run starts are never cached, nor copied without a re-check.
+sleep 1
+(cd "$COPY_DIR" && "$BIN" --no-git -o - 2>/dev/null | grep -v '^Generated: ' >"$TMPDIR/copy_buffered.txt")
+(cd "$COPY_DIR" && "$BIN" --no-git --stream -o - 2>/dev/null | grep -v '^Generated: ' >"$TMPDIR/copy_piped.txt")
+(cd "$COPY_DIR" && "$BIN" --no-git --stream -v -o "$TMPDIR/copy_file.md" 2>"$TMPDIR/copy_file_stderr.txt")
+grep -v '^Generated: ' "$TMPDIR/copy_file.md" >"$TMPDIR/copy_file.txt"
+cmp -s "$TMPDIR/copy_buffered.txt" "$TMPDIR/copy_piped.txt" || fail "expected identical output when streaming bodies to a pipe"
+cmp -s "$TMPDIR/copy_buffered.txt" "$TMPDIR/copy_file.txt" || fail "expected identical output when streaming bodies to a file"
+(cd "$COPY_DIR" && "$BIN" --no-git --stream -j 3 -o "$TMPDIR/copy_parallel.md" 2>/dev/null)
+grep -v '^Generated: ' "$TMPDIR/copy_parallel.md" >"$TMPDIR/copy_parallel.txt"
+cmp -s "$TMPDIR/copy_buffered.txt" "$TMPDIR/copy_parallel.txt" || fail "expected identical output when rendering streamed bodies in parallel"
+assert_contains "$TMPDIR/copy_file.txt" 'fence ```` and no newline'
+if [ "$(uname -s)" = Linux ]; then
+    assert_not_contains "$TMPDIR/copy_file_stderr.txt" ", 0 kernel copy call(s)"
+fi
+# A file changed in the second collection starts could change again unseen, so it is loaded and re-checked.
+cp "$COPY_DIR/terminated.c" "$FRESH_COPY_DIR/fresh.c"
+(cd "$FRESH_COPY_DIR" && "$BIN" --no-git --stream -v -o "$TMPDIR/copy_fresh.md" 2>"$TMPDIR/copy_fresh_stderr.txt")
+assert_contains "$TMPDIR/copy_fresh.md" "int copied_line_399 = 399;"
+assert_contains "$TMPDIR/copy_fresh_stderr.txt" ", 0 kernel copy call(s)"
+(cd "$CACHE_DIR" && "$BIN" --no-git -v --cache="$CACHE_STORE" -o - 2>"$TMPDIR/cache_cold_stderr.txt" | grep -v '^Generated: ' >"$TMPDIR/cache_cold.txt")
+assert_contains "$TMPDIR/cache_cold_stderr.txt" "Classification cache: 0 hit(s), 3 new record(s)"
+(cd "$CACHE_DIR" && "$BIN" --no-git -v --cache "$CACHE_STORE" -o - 2>"$TMPDIR/cache_warm_stderr.txt" | grep -v '^Generated: ' >"$TMPDIR/cache_warm.txt")
+assert_contains "$TMPDIR/cache_warm_stderr.txt" "Classification cache: 3 hit(s), 0 new record(s)"
+assert_contains "$TMPDIR/cache_warm_stderr.txt" "Warning: Skipping sensitive file ./token.txt"
+assert_contains "$TMPDIR/cache_warm_stderr.txt" "Skipping binary/empty file: ./blob.bin"
+cmp -s "$TMPDIR/cache_cold.txt" "$TMPDIR/cache_warm.txt" || fail "cached run changed the export"
+(cd "$CACHE_DIR" && "$BIN" --no-git --stream --allow-sensitive --cache="$CACHE_STORE" -o - >"$TMPDIR/cache_allow.txt" 2>/dev/null)
+assert_contains "$TMPDIR/cache_allow.txt" "## token.txt"
+assert_contains "$TMPDIR/cache_allow.txt" "## main.c"
+if "$BIN" --cache= -o - >/dev/null 2>"$TMPDIR/cache_empty_path.txt"; then
+    fail "expected --cache= to fail"
+fi
+assert_contains "$TMPDIR/cache_empty_path.txt" "Invalid cache path: empty string"
+# Hard links share a cache record but take their language from their own names.
+(cd "$LINK_CACHE_DIR" && "$BIN" --no-git --no-tree --cache="$CACHE_STORE" -o - >/dev/null 2>&1)
+(cd "$LINK_CACHE_DIR" && "$BIN" --no-git --no-tree --stream -v --cache="$CACHE_STORE" -o - \
+    2>"$TMPDIR/cache_links_stderr.txt" >"$TMPDIR/cache_links.txt")
+assert_contains "$TMPDIR/cache_links_stderr.txt" "Classification cache: 3 hit(s), 0 new record(s)"
+assert_contains "$TMPDIR/cache_links.txt" '```ruby'
+assert_contains "$TMPDIR/cache_links.txt" '```bash'
+assert_contains "$TMPDIR/cache_links.txt" '```python'
+
+WALK_CACHE_DIR="$TMPDIR/walk_cache"
+mkdir -p "$WALK_CACHE_DIR/sub"
+printf 'int main(void) { return 0; }\n' >"$WALK_CACHE_DIR/main.c"
+printf 'int lib(void) { return 1; }\n' >"$WALK_CACHE_DIR/sub/lib.c"
+printf 'log line\n' >"$WALK_CACHE_DIR/sub/skip.txt"
+printf '*.txt\n' >"$WALK_CACHE_DIR/sub/.gitignore"
+# Directories changed in the second a run starts are never cached.
+sleep 1
+(cd "$WALK_CACHE_DIR" && "$BIN" --no-git -v --cache="$CACHE_STORE" -o - 2>"$TMPDIR/walk_cold_stderr.txt" | grep -v '^Generated: ' >"$TMPDIR/walk_cold.txt")
+assert_contains "$TMPDIR/walk_cold_stderr.txt" "Directory cache: 0 hit(s), 2 new record(s)"
+(cd "$WALK_CACHE_DIR" && "$BIN" --no-git -v --cache="$CACHE_STORE" -o - 2>"$TMPDIR/walk_warm_stderr.txt" | grep -v '^Generated: ' >"$TMPDIR/walk_warm.txt")
+assert_contains "$TMPDIR/walk_warm_stderr.txt" "Directory cache: 2 hit(s), 0 new record(s)"
+assert_contains "$TMPDIR/walk_warm_stderr.txt" "Skipping ignored file: ./sub/skip.txt"
+cmp -s "$TMPDIR/walk_cold.txt" "$TMPDIR/walk_warm.txt" || fail "cached listing changed the export"
+# Rewriting a .gitignore leaves the directory mtime alone; its rules still apply.
+printf '*.c\n' >"$WALK_CACHE_DIR/sub/.gitignore"
+(cd "$WALK_CACHE_DIR" && "$BIN" --no-git -v --cache="$CACHE_STORE" -o - 2>"$TMPDIR/walk_rules_stderr.txt" >"$TMPDIR/walk_rules.txt")
+assert_contains "$TMPDIR/walk_rules_stderr.txt" "Directory cache: 2 hit(s), 0 new record(s)"
+assert_contains "$TMPDIR/walk_rules.txt" "## sub/skip.txt"
+assert_not_contains "$TMPDIR/walk_rules.txt" "## sub/lib.c"
+printf 'new\n' >"$WALK_CACHE_DIR/sub/new.md"
+(cd "$WALK_CACHE_DIR" && "$BIN" --no-git -v --cache="$CACHE_STORE" -o - 2>"$TMPDIR/walk_added_stderr.txt" >"$TMPDIR/walk_added.txt")
+assert_contains "$TMPDIR/walk_added_stderr.txt" "Directory cache: 1 hit(s), 0 new record(s)"
+assert_contains "$TMPDIR/walk_added.txt" "## sub/new.md"
+
 printf 'cli tests passed\n'
@@ -1,6 +1,8 @@
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "ignore.h"
@@ -14,23 +16,20 @@ typedef struct {
     const char* patterns[8];
 } IgnoreCase;
 
-static int run_case(const IgnoreCase* test_case) {
-    IgnorePattern* patterns = NULL;
-    size_t count = 0;
+/* Writes lines to a temporary ignore file and loads it back. */
+static int load_pattern_lines(const char* const* lines,
+                              size_t line_count,
+                              int include_default_ignores,
+                              IgnorePattern** patterns,
+                              size_t* count) {
     int fd = -1;
     FILE* file = NULL;
     char template[] = "/tmp/fuori-ignore-test.XXXXXX";
-    int actual;
-    int failed = 0;
-
-    while (count < 8 && test_case->patterns[count] != NULL) {
-        count++;
-    }
 
     fd = mkstemp(template);
     if (fd < 0) {
         perror("mkstemp");
-        return 1;
+        return -1;
     }
 
     file = fdopen(fd, "w");
@@ -38,30 +37,54 @@ static int run_case(const IgnoreCase* test_case) {
         perror("fdopen");
         close(fd);
         unlink(template);
-        return 1;
+        return -1;
     }
-    fd = -1;
 
-    for (size_t i = 0; i < count; i++) {
-        if (fprintf(file, "%s\n", test_case->patterns[i]) < 0) {
+    for (size_t i = 0; i < line_count; i++) {
+        if (fprintf(file, "%s\n", lines[i]) < 0) {
             perror("fprintf");
             fclose(file);
             unlink(template);
-            return 1;
+            return -1;
         }
     }
     if (fclose(file) != 0) {
         perror("fclose");
         unlink(template);
-        return 1;
+        return -1;
     }
 
-    if (load_ignore_patterns(template, 0, &patterns, &count) != 0) {
+    if (load_ignore_patterns(template, include_default_ignores, patterns, count) != 0) {
         perror("load_ignore_patterns");
         unlink(template);
+        return -1;
+    }
+    unlink(template);
+    return 0;
+}
+
+static int run_case(const IgnoreCase* test_case) {
+    IgnorePattern* patterns = NULL;
+    IgnoreMatcher* matcher = NULL;
+    size_t count = 0;
+    int actual;
+    int compiled;
+    int failed = 0;
+
+    while (count < 8 && test_case->patterns[count] != NULL) {
+        count++;
+    }
+
+    if (load_pattern_lines(test_case->patterns, count, 0, &patterns, &count) != 0) {
+        return 1;
+    }
+    if (compile_ignore_matcher(patterns, count, &matcher) != 0) {
+        perror("compile_ignore_matcher");
+        free_ignore_patterns(patterns, count);
         return 1;
     }
 
+    compiled = ignore_matcher_resolve(matcher, test_case->path, test_case->is_dir, test_case->initial_ignored);
     actual = resolve_ignore_state(test_case->path,
                                   patterns,
                                   count,
@@ -76,12 +99,227 @@ static int run_case(const IgnoreCase* test_case) {
                 actual);
         failed = 1;
     }
+    if (compiled != actual) {
+        fprintf(stderr,
+                "FAIL %-28s path=%s compiled=%d reference=%d\n",
+                test_case->name,
+                test_case->path,
+                compiled,
+                actual);
+        failed = 1;
+    }
 
+    free_ignore_matcher(matcher);
     free_ignore_patterns(patterns, count);
-    unlink(template);
     return failed;
 }
 
+static const char* const random_pattern_pool[] = {
+    "build/", "/build/", "src/", "!src/", "*.o", "!*.o", "*.c", "*.tar.gz", "*.md", "!*.md",
+    "keep.txt", "!keep.txt", "keep.txt/", "src/*.c", "/src/main.c", "!src/main.c", "**/node_modules/",
+    "lib/**/x.o", "a/b/", "!a/b/keep.txt", "**/keep.txt", "b*", "?.o", "[ab]", "!lib/", "lib/a",
+    "!/a/", "src/lib/**", "a/**/b/*.c", "\\*.o", "*", "!**/b/", "/a/b", "a/*/main.c", "*.gz",
+    "node_modules", "!build/keep.txt", "**", "main.c", "!a/", ".o",
+};
+
+static const char* const random_segment_pool[] = {
+    "src", "lib", "build", "a", "b", "node_modules", "main.c", "x.o", "keep.txt", "notes.md",
+    "archive.tar.gz", ".o", "ab",
+};
+
+static unsigned next_random(unsigned* seed) {
+    *seed = *seed * 1103515245U + 12345U;
+    return (*seed >> 16) & 0x7fffU;
+}
+
+/*
+ * Differential check of the compiled matcher against the reference loop on
+ * random pattern lists (optionally on top of the defaults) and random paths.
+ */
+static int run_random_differential(unsigned seed, size_t rounds, size_t* checks_out) {
+    size_t pool_size = sizeof(random_pattern_pool) / sizeof(random_pattern_pool[0]);
+    size_t segment_pool_size = sizeof(random_segment_pool) / sizeof(random_segment_pool[0]);
+    int failures = 0;
+
+    for (size_t round = 0; round < rounds; round++) {
+        const char* lines[12];
+        size_t line_count = 1 + next_random(&seed) % 12;
+        IgnorePattern* patterns = NULL;
+        IgnoreMatcher* matcher = NULL;
+        size_t count = 0;
+
+        for (size_t i = 0; i < line_count; i++) {
+            lines[i] = random_pattern_pool[next_random(&seed) % pool_size];
+        }
+        if (load_pattern_lines(lines, line_count, (int)(next_random(&seed) % 2), &patterns, &count) != 0) {
+            return failures + 1;
+        }
+        if (compile_ignore_matcher(patterns, count, &matcher) != 0) {
+            perror("compile_ignore_matcher");
+            free_ignore_patterns(patterns, count);
+            return failures + 1;
+        }
+
+        for (size_t probe = 0; probe < 40; probe++) {
+            char path[256];
+            const char* segments[4];
+            size_t depth = 1 + next_random(&seed) % 4;
+            size_t used = 0;
+
+            if (next_random(&seed) % 3 == 0) {
+                used += (size_t)snprintf(path + used, sizeof(path) - used, "./");
+            }
+            for (size_t d = 0; d < depth; d++) {
+                segments[d] = random_segment_pool[next_random(&seed) % segment_pool_size];
+                used += (size_t)snprintf(path + used, sizeof(path) - used, "%s%s", (d == 0) ? "" : "/", segments[d]);
+            }
+
+            for (int variant = 0; variant < 4; variant++) {
+                int is_dir = variant & 1;
+                int initial_ignored = (variant >> 1) & 1;
+                int expected = resolve_ignore_state(path, patterns, count, is_dir, initial_ignored);
+                int actual = ignore_matcher_resolve(matcher, path, is_dir, initial_ignored);
+                int from_segments = ignore_matcher_resolve_segments(matcher, segments, depth, is_dir, initial_ignored);
+
+                if (expected != actual || expected != from_segments) {
+                    fprintf(stderr,
+                            "FAIL random resolve path=%s is_dir=%d initial=%d expected=%d actual=%d segments=%d patterns:",
+                            path, is_dir, initial_ignored, expected, actual, from_segments);
+                    for (size_t i = 0; i < line_count; i++) {
+                        fprintf(stderr, " %s", lines[i]);
+                    }
+                    fprintf(stderr, "\n");
+                    failures++;
+                }
+                (*checks_out)++;
+            }
+            int may_include = ignored_directory_may_have_included_descendants(path, patterns, count);
+            if (may_include != ignore_matcher_may_have_included_descendants(matcher, path) ||
+                may_include != ignore_matcher_segments_may_have_included_descendants(matcher, segments, depth)) {
+                fprintf(stderr, "FAIL random descendants path=%s patterns:", path);
+                for (size_t i = 0; i < line_count; i++) {
+                    fprintf(stderr, " %s", lines[i]);
+                }
+                fprintf(stderr, "\n");
+                failures++;
+            }
+            (*checks_out)++;
+        }
+
+        free_ignore_matcher(matcher);
+        free_ignore_patterns(patterns, count);
+    }
+    return failures;
+}
+
+typedef struct {
+    const char* segments[4];
+    size_t segment_count;
+    int is_dir;
+    int expected;
+} ScopeCase;
+
+static int write_text_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    if (fputs(text, file) == EOF) {
+        perror(path);
+        fclose(file);
+        return -1;
+    }
+    return fclose(file);
+}
+
+/* Nested ignore files: the innermost scope with a match decides, and rules stay relative to their directory. */
+static int run_scope_cases(void) {
+    const ScopeCase cases[] = {
+        {{"app.log"}, 1, 0, 1},
+        {{"sub", "app.log"}, 2, 0, 1},
+        {{"sub", "keep.log"}, 2, 0, 0},
+        {{"sub", "gen"}, 2, 1, 1},
+        {{"gen"}, 1, 1, 0},
+        {{"sub", "local.c"}, 2, 0, 1},
+        {{"local.c"}, 1, 0, 0},
+        {{"sub", "main.c"}, 2, 0, 0},
+    };
+    char root_template[] = "/tmp/fuori-ignore-scope.XXXXXX";
+    char path[256];
+    IgnoreScope* root_scope = NULL;
+    IgnoreScope* sub_scope = NULL;
+    IgnoreScope* missing_scope = NULL;
+    int root_fd = -1;
+    int sub_fd = -1;
+    int failures = 0;
+
+    if (!mkdtemp(root_template)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    snprintf(path, sizeof(path), "%s/sub", root_template);
+    if (mkdir(path, 0700) != 0) {
+        perror("mkdir");
+        rmdir(root_template);
+        return 1;
+    }
+    snprintf(path, sizeof(path), "%s/.gitignore", root_template);
+    if (write_text_file(path, "*.log\n!/sub/local.c\n") != 0) {
+        failures++;
+        goto cleanup;
+    }
+    snprintf(path, sizeof(path), "%s/sub/.gitignore", root_template);
+    if (write_text_file(path, "/gen/\n!keep.log\nlocal.c\n") != 0) {
+        failures++;
+        goto cleanup;
+    }
+
+    root_fd = open(root_template, O_RDONLY | O_DIRECTORY);
+    snprintf(path, sizeof(path), "%s/sub", root_template);
+    sub_fd = open(path, O_RDONLY | O_DIRECTORY);
+    if (root_fd == -1 || sub_fd == -1 ||
+        load_ignore_scope(root_fd, ".gitignore", NULL, 0, &root_scope) != 0 ||
+        load_ignore_scope(sub_fd, ".gitignore", root_scope, 1, &sub_scope) != 0 ||
+        load_ignore_scope(sub_fd, "missing", sub_scope, 1, &missing_scope) != 0) {
+        perror("load_ignore_scope");
+        failures++;
+        goto cleanup;
+    }
+    if (!root_scope || !sub_scope || missing_scope) {
+        fprintf(stderr, "FAIL scope loading produced unexpected scopes\n");
+        failures++;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const ScopeCase* test_case = &cases[i];
+        int actual = ignore_scope_resolve_segments(test_case->segment_count > 1 ? sub_scope : root_scope,
+                                                   test_case->segments,
+                                                   test_case->segment_count,
+                                                   test_case->is_dir,
+                                                   0);
+        if (actual != test_case->expected) {
+            fprintf(stderr, "FAIL scope case %zu expected=%d actual=%d\n", i, test_case->expected, actual);
+            failures++;
+        }
+    }
+
+cleanup:
+    free_ignore_scope(sub_scope);
+    free_ignore_scope(root_scope);
+    if (sub_fd != -1) close(sub_fd);
+    if (root_fd != -1) close(root_fd);
+    snprintf(path, sizeof(path), "%s/sub/.gitignore", root_template);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/.gitignore", root_template);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/sub", root_template);
+    rmdir(path);
+    rmdir(root_template);
+    return failures;
+}
+
 int main(void) {
     const IgnoreCase cases[] = {
         {
@@ -163,10 +401,14 @@ int main(void) {
         failures += run_case(&cases[i]);
     }
 
+    size_t random_checks = 0;
+    failures += run_random_differential(11, 400, &random_checks);
+    failures += run_scope_cases();
+
     if (failures != 0) {
         return 1;
     }
 
-    printf("ignore tests passed (%zu cases)\n", count);
+    printf("ignore tests passed (%zu cases, %zu differential checks)\n", count, random_checks);
     return 0;
 }
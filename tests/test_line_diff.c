@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_diff.h"
+
+typedef struct {
+    const char* name;
+    const char* old_text;
+    const char* new_text;
+    size_t expected_count;
+    GitHunkRange expected[4];
+} DiffCase;
+
+static const DiffCase cases[] = {
+    {"identical", "a\nb\nc\n", "a\nb\nc\n", 0, {{0, 0}}},
+    {"both empty", "", "", 0, {{0, 0}}},
+    {"modify middle", "a\nb\nc\n", "a\nB\nc\n", 1, {{2, 1}}},
+    {"insert top", "b\nc\n", "a\nb\nc\n", 1, {{1, 1}}},
+    {"append", "a\n", "a\nb\nc\n", 1, {{2, 2}}},
+    {"delete top", "a\nb\nc\n", "b\nc\n", 1, {{0, 0}}},
+    {"delete middle", "a\nb\nc\n", "a\nc\n", 1, {{1, 0}}},
+    {"delete all", "a\nb\n", "", 1, {{0, 0}}},
+    {"create", "", "a\nb\n", 1, {{1, 2}}},
+    {"missing final newline", "a\nb\n", "a\nb", 1, {{2, 1}}},
+    {"two hunks", "a\nb\nc\nd\ne\n", "A\nb\nc\nd\nE\n", 2, {{1, 1}, {5, 1}}},
+    {"replace grows", "a\nb\nc\n", "a\nx\ny\nz\nc\n", 1, {{2, 3}}},
+};
+
+static int check_case(const DiffCase* test_case) {
+    GitFileHunks hunks = {NULL, 0, 0};
+    int ok = 1;
+
+    if (compute_line_hunks((const unsigned char*)test_case->old_text,
+                           strlen(test_case->old_text),
+                           (const unsigned char*)test_case->new_text,
+                           strlen(test_case->new_text),
+                           &hunks) != 0) {
+        fprintf(stderr, "FAIL: %s: compute_line_hunks failed\n", test_case->name);
+        return 0;
+    }
+    if (hunks.count != test_case->expected_count) {
+        ok = 0;
+    }
+    for (size_t i = 0; ok && i < hunks.count; i++) {
+        if (hunks.ranges[i].new_start != test_case->expected[i].new_start ||
+            hunks.ranges[i].new_count != test_case->expected[i].new_count) {
+            ok = 0;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s: got %zu hunk(s):", test_case->name, hunks.count);
+        for (size_t i = 0; i < hunks.count; i++) {
+            fprintf(stderr, " +%zu,%zu", hunks.ranges[i].new_start, hunks.ranges[i].new_count);
+        }
+        fprintf(stderr, "\n");
+    }
+    free(hunks.ranges);
+    return ok;
+}
+
+/* Builds a text of count single-letter lines drawn from a small alphabet. */
+static char* random_text(unsigned* seed, size_t count, int alphabet, size_t* len_out) {
+    char* text = malloc(count * 2 + 1);
+    if (!text) {
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        *seed = *seed * 1103515245U + 12345U;
+        text[i * 2] = (char)('a' + (int)((*seed >> 16) % (unsigned)alphabet));
+        text[i * 2 + 1] = '\n';
+    }
+    text[count * 2] = '\0';
+    *len_out = count * 2;
+    return text;
+}
+
+static size_t lcs_length(const char* a, size_t n, const char* b, size_t m) {
+    size_t* row = calloc(m + 1, sizeof(*row));
+    size_t result;
+
+    if (!row) {
+        return 0;
+    }
+    for (size_t i = 1; i <= n; i++) {
+        size_t diagonal = 0;
+        for (size_t j = 1; j <= m; j++) {
+            size_t above = row[j];
+            if (a[(i - 1) * 2] == b[(j - 1) * 2]) {
+                row[j] = diagonal + 1;
+            } else if (row[j - 1] > row[j]) {
+                row[j] = row[j - 1];
+            }
+            diagonal = above;
+        }
+    }
+    result = row[m];
+    free(row);
+    return result;
+}
+
+/*
+ * The ranges must describe a valid edit (new lines outside them are an
+ * in-order subsequence of the old text). Small inputs stay below the cost
+ * cap and the patience threshold, so there the edit must also be minimal:
+ * exactly m - LCS new lines are marked as changed.
+ */
+static int check_random(unsigned seed, size_t n, size_t m, int alphabet, int require_minimal) {
+    size_t old_len;
+    size_t new_len;
+    char* old_text = random_text(&seed, n, alphabet, &old_len);
+    char* new_text = random_text(&seed, m, alphabet, &new_len);
+    GitFileHunks hunks = {NULL, 0, 0};
+    size_t changed = 0;
+    size_t old_pos = 0;
+    char* marked = NULL;
+    int ok = 1;
+
+    if (!old_text || !new_text ||
+        compute_line_hunks((const unsigned char*)old_text, old_len,
+                           (const unsigned char*)new_text, new_len, &hunks) != 0) {
+        free(old_text);
+        free(new_text);
+        fprintf(stderr, "FAIL: random seed %u: compute_line_hunks failed\n", seed);
+        return 0;
+    }
+
+    marked = calloc(m + 1, 1);
+    if (!marked) {
+        ok = 0;
+    }
+    for (size_t i = 0; ok && i < hunks.count; i++) {
+        for (size_t line = hunks.ranges[i].new_start; line < hunks.ranges[i].new_start + hunks.ranges[i].new_count; line++) {
+            if (line == 0 || line > m || marked[line]) {
+                ok = 0;
+                break;
+            }
+            marked[line] = 1;
+            changed++;
+        }
+    }
+    for (size_t line = 1; ok && line <= m; line++) {
+        if (marked[line]) {
+            continue;
+        }
+        while (old_pos < n && old_text[old_pos * 2] != new_text[(line - 1) * 2]) {
+            old_pos++;
+        }
+        if (old_pos == n) {
+            ok = 0;
+            break;
+        }
+        old_pos++;
+    }
+    free(marked);
+    if (ok && require_minimal && changed != m - lcs_length(old_text, n, new_text, m)) {
+        ok = 0;
+    }
+    for (size_t i = 1; ok && i < hunks.count; i++) {
+        if (hunks.ranges[i].new_start < hunks.ranges[i - 1].new_start) {
+            ok = 0;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "FAIL: random n=%zu m=%zu alphabet=%d: invalid or non-minimal hunks\n", n, m, alphabet);
+    }
+
+    free(hunks.ranges);
+    free(old_text);
+    free(new_text);
+    return ok;
+}
+
+int main(void) {
+    size_t failures = 0;
+    size_t random_runs = 0;
+    size_t case_count = sizeof(cases) / sizeof(cases[0]);
+    unsigned seed = 7;
+
+    for (size_t i = 0; i < case_count; i++) {
+        if (!check_case(&cases[i])) {
+            failures++;
+        }
+    }
+    for (size_t n = 0; n <= 40; n += 5) {
+        for (size_t m = 0; m <= 40; m += 5) {
+            for (int alphabet = 2; alphabet <= 8; alphabet += 3) {
+                seed = seed * 31U + 17U;
+                if (!check_random(seed, n, m, alphabet, 1)) {
+                    failures++;
+                }
+                random_runs++;
+            }
+        }
+    }
+    /* Large enough to exercise the patience anchors and the cost cap. */
+    for (int round = 0; round < 4; round++) {
+        seed = seed * 31U + 17U;
+        if (!check_random(seed, 200, 180, 20, 0)) {
+            failures++;
+        }
+        seed = seed * 31U + 17U;
+        if (!check_random(seed, 3000, 2800, 2, 0)) {
+            failures++;
+        }
+        random_runs += 2;
+    }
+
+    if (failures != 0) {
+        fprintf(stderr, "%zu line diff test(s) failed\n", failures);
+        return 1;
+    }
+    printf("line diff tests passed (%zu cases, %zu randomized)\n", case_count, random_runs);
+    return 0;
+}
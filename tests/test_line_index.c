@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_index.h"
+#include "test_check.h"
+
+/* Compares every lookup against a linear walk over the body. */
+static void check_body(const char* name, const unsigned char* buf, size_t len) {
+    LineIndex index;
+    size_t line_no = 1;
+    int mismatched = 0;
+
+    if (build_line_index(buf, len, &index) != 0) {
+        fprintf(stderr, "FAIL: %s: build_line_index failed\n", name);
+        check_failures++;
+        return;
+    }
+
+    for (size_t offset = 0; offset < len; line_no++) {
+        const unsigned char* newline = memchr(buf + offset, '\n', len - offset);
+
+        if (line_index_start(&index, buf, line_no) != offset) {
+            mismatched = 1;
+        }
+        offset = newline ? (size_t)(newline - buf) + 1 : len;
+    }
+    if (index.line_count != line_no - 1 || line_index_start(&index, buf, line_no) != len || mismatched) {
+        fprintf(stderr, "FAIL: %s: index disagrees with a linear walk\n", name);
+        check_failures++;
+    }
+    if (len > 0 && index.checkpoint_count != (index.line_count + LINE_INDEX_STRIDE - 1) / LINE_INDEX_STRIDE) {
+        fprintf(stderr, "FAIL: %s: unexpected checkpoint count\n", name);
+        check_failures++;
+    }
+    free_line_index(&index);
+}
+
+int main(void) {
+    const size_t big_len = 200000;
+    unsigned char* big = malloc(big_len);
+    LineIndex index;
+
+    if (!big) {
+        perror("malloc");
+        return 1;
+    }
+
+    check_body("empty", (const unsigned char*)"", 0);
+    check_body("newline", (const unsigned char*)"\n", 1);
+    check_body("unterminated", (const unsigned char*)"one", 3);
+    check_body("blank lines", (const unsigned char*)"\n\n\na\n\n", 6);
+    check_body("tail", (const unsigned char*)"a\nbb\nccc", 8);
+
+    /* Line lengths vary so checkpoints land at uneven offsets. */
+    for (size_t i = 0; i < big_len; i++) {
+        big[i] = (i * 2654435761u) % 37 == 0 ? '\n' : (unsigned char)('a' + i % 26);
+    }
+    check_body("varied", big, big_len);
+    big[big_len - 1] = '\n';
+    check_body("varied terminated", big, big_len);
+    memset(big, '\n', big_len);
+    check_body("all newlines", big, big_len);
+
+    /* A zeroed index is not built; a built one is 32-bit for small bodies. */
+    memset(&index, 0, sizeof(index));
+    CHECK(!line_index_is_built(&index), "zeroed index reports built");
+    CHECK(build_line_index(big, 1000, &index) == 0, "build failed");
+    CHECK(line_index_is_built(&index) && index.starts32 && !index.starts, "small body is not indexed in 32 bits");
+    CHECK(line_index_start(&index, big, 0) == 0, "line 0 does not map to the start");
+    CHECK(line_index_start(&index, big, 5000) == 1000, "lines past the end do not map to the end");
+    free_line_index(&index);
+    CHECK(!line_index_is_built(&index), "freed index reports built");
+
+    free(big);
+    return finish_checks("line index");
+}
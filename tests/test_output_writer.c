@@ -0,0 +1,265 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "output_writer.h"
+#include "test_check.h"
+
+/* Growable copy of everything the test asked the writer to emit. */
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} Expected;
+
+static void expect_bytes(Expected* expected, const void* data, size_t len) {
+    if (expected->len + len > expected->cap) {
+        size_t new_cap = expected->cap ? expected->cap : 4096;
+        char* grown;
+
+        while (new_cap < expected->len + len) {
+            new_cap *= 2;
+        }
+        grown = realloc(expected->data, new_cap);
+        if (!grown) {
+            perror("realloc");
+            exit(1);
+        }
+        expected->data = grown;
+        expected->cap = new_cap;
+    }
+    memcpy(expected->data + expected->len, data, len);
+    expected->len += len;
+}
+
+/* Returns 1 when the file holds exactly the expected bytes. */
+static int file_matches(FILE* file, const Expected* expected) {
+    char* actual;
+    long size;
+    int matches;
+
+    if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        return 0;
+    }
+    if ((size_t)size != expected->len) {
+        return 0;
+    }
+    actual = malloc(expected->len + 1);
+    if (!actual) {
+        return 0;
+    }
+    matches = fread(actual, 1, expected->len, file) == expected->len &&
+              memcmp(actual, expected->data, expected->len) == 0;
+    free(actual);
+    return matches;
+}
+
+static char* make_pattern(size_t len, unsigned seed) {
+    char* data = malloc(len);
+
+    if (!data) {
+        perror("malloc");
+        exit(1);
+    }
+    for (size_t i = 0; i < len; i++) {
+        data[i] = (char)('a' + (i * 7 + seed) % 26);
+    }
+    return data;
+}
+
+static FILE* make_source(const char* data, size_t len) {
+    FILE* source = tmpfile();
+
+    if (!source || fwrite(data, 1, len, source) != len || fflush(source) != 0 || fseek(source, 0, SEEK_SET) != 0) {
+        perror("make_source");
+        exit(1);
+    }
+    return source;
+}
+
+/* Copies file bodies into a regular file, a pipe, and from a pipe (the buffered fallback). */
+static void check_copy_file(const char* data, size_t len) {
+    FILE* source = make_source(data, len);
+    FILE* file = tmpfile();
+    OutputWriter* writer = NULL;
+    OutputWriterStats stats;
+    Expected expected = {0};
+    int fds[2];
+    char piped[40000];
+    size_t piped_len = 0;
+    ssize_t got;
+
+    if (!file || open_output_writer(fileno(file), &writer) != 0) {
+        perror("open_output_writer");
+        exit(1);
+    }
+    CHECK(output_writer_write_text(writer, "before\n") == 0, "write before copy failed");
+    expect_bytes(&expected, "before\n", 7);
+    CHECK(output_writer_copy_file(writer, fileno(source), len) == 0, "copy into file failed");
+    expect_bytes(&expected, data, len);
+    CHECK(output_writer_write_text(writer, "after\n") == 0, "write after copy failed");
+    expect_bytes(&expected, "after\n", 6);
+
+    /* Copying past the end of the source means it changed. */
+    CHECK(fseek(source, 0, SEEK_SET) == 0, "rewind failed");
+    errno = 0;
+    CHECK(output_writer_copy_file(writer, fileno(source), len + 1) != 0 && errno == ESTALE, "short source was not stale");
+
+    output_writer_stats(writer, &stats);
+    CHECK(stats.bytes_written == expected.len + len, "copy stats miscount bytes");
+#ifdef __linux__
+    CHECK(stats.kernel_copy_calls > 0, "copy into a file never used the kernel");
+#endif
+    close_output_writer(writer);
+    /* The stale copy still wrote the bytes that existed. */
+    expect_bytes(&expected, data, len);
+    CHECK(file_matches(file, &expected), "copied output does not match");
+    fclose(file);
+
+    /* Into a pipe. */
+    if (pipe(fds) != 0 || open_output_writer(fds[1], &writer) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    CHECK(fseek(source, 0, SEEK_SET) == 0, "rewind failed");
+    CHECK(output_writer_write(writer, "<", 1) == 0, "write into pipe failed");
+    CHECK(output_writer_copy_file(writer, fileno(source), len) == 0, "copy into pipe failed");
+    CHECK(output_writer_write(writer, ">", 1) == 0 && output_writer_flush(writer) == 0, "pipe flush failed");
+    close_output_writer(writer);
+    close(fds[1]);
+    while ((got = read(fds[0], piped + piped_len, sizeof(piped) - piped_len)) > 0) {
+        piped_len += (size_t)got;
+    }
+    close(fds[0]);
+    CHECK(piped_len == len + 2 && piped[0] == '<' && piped[len + 1] == '>' && memcmp(piped + 1, data, len) == 0,
+          "piped copy does not match");
+
+    /* From a pipe, which no kernel copy accepts as a source. */
+    if (pipe(fds) != 0 || write(fds[1], data, len) != (ssize_t)len) {
+        perror("pipe");
+        exit(1);
+    }
+    close(fds[1]);
+    file = tmpfile();
+    if (!file || open_output_writer(fileno(file), &writer) != 0) {
+        perror("open_output_writer");
+        exit(1);
+    }
+    expected.len = 0;
+    CHECK(output_writer_write(writer, "#", 1) == 0, "write before fallback failed");
+    expect_bytes(&expected, "#", 1);
+    CHECK(output_writer_copy_file(writer, fds[0], len) == 0, "buffered copy failed");
+    expect_bytes(&expected, data, len);
+    CHECK(output_writer_flush(writer) == 0, "flush after fallback failed");
+    CHECK(file_matches(file, &expected), "buffered copy does not match");
+    close_output_writer(writer);
+    close(fds[0]);
+    fclose(file);
+    fclose(source);
+    free(expected.data);
+}
+
+/* Two positional writers fill the halves of one file, back half first. */
+static void check_positional(const char* data, size_t len) {
+    FILE* source = make_source(data, len);
+    FILE* file = tmpfile();
+    OutputWriter* front = NULL;
+    OutputWriter* back = NULL;
+    Expected expected = {0};
+    off_t half = (off_t)(len + 6);
+
+    if (!file || open_output_writer_at(fileno(file), 0, &front) != 0 ||
+        open_output_writer_at(fileno(file), half, &back) != 0) {
+        perror("open_output_writer_at");
+        exit(1);
+    }
+    expect_bytes(&expected, "front\n", 6);
+    expect_bytes(&expected, data, len);
+    expect_bytes(&expected, "back\n", 5);
+    expect_bytes(&expected, data, len);
+
+    CHECK(output_writer_write_text(back, "back\n") == 0, "positional write failed");
+    CHECK(output_writer_reference(back, data, len) == 0, "positional reference failed");
+    CHECK(output_writer_flush(back) == 0, "positional flush failed");
+    CHECK(output_writer_offset(back) == half + 5 + (off_t)len, "positional offset is wrong");
+    CHECK(output_writer_write_text(front, "front\n") == 0, "positional write failed");
+    CHECK(output_writer_copy_file(front, fileno(source), len) == 0, "positional copy failed");
+    CHECK(output_writer_flush(front) == 0 && output_writer_offset(front) == half, "positional copy offset is wrong");
+    CHECK(lseek(fileno(file), 0, SEEK_CUR) == 0, "positional writes moved the file offset");
+    CHECK(file_matches(file, &expected), "positional output does not match");
+
+    /* Seeking back rewrites in place. */
+    CHECK(output_writer_seek(front, 0) == 0 && output_writer_write_text(front, "FRONT\n") == 0 &&
+          output_writer_flush(front) == 0, "positional rewrite failed");
+    memcpy(expected.data, "FRONT\n", 6);
+    CHECK(file_matches(file, &expected), "rewritten output does not match");
+
+    close_output_writer(front);
+    close_output_writer(back);
+    fclose(file);
+    fclose(source);
+    free(expected.data);
+}
+
+int main(void) {
+    const size_t big_len = 3 * 1024 * 1024 + 17;
+    FILE* file = tmpfile();
+    OutputWriter* writer = NULL;
+    OutputWriterStats stats;
+    Expected expected = {0};
+    char* big = make_pattern(big_len, 3);
+    char* body = make_pattern(4096, 11);
+    char fill[300];
+
+    if (!file || open_output_writer(fileno(file), &writer) != 0) {
+        perror("open_output_writer");
+        return 1;
+    }
+
+    /* Staged fragments, fills and references interleave in order. */
+    CHECK(output_writer_write_text(writer, "# header\n") == 0, "write text failed");
+    expect_bytes(&expected, "# header\n", 9);
+    CHECK(output_writer_fill(writer, '`', sizeof(fill)) == 0, "fill failed");
+    memset(fill, '`', sizeof(fill));
+    expect_bytes(&expected, fill, sizeof(fill));
+    CHECK(output_writer_reference(writer, body, 4096) == 0, "reference failed");
+    expect_bytes(&expected, body, 4096);
+    CHECK(output_writer_reference(writer, "short", 5) == 0, "short reference failed");
+    expect_bytes(&expected, "short", 5);
+    CHECK(output_writer_write(writer, "\n", 1) == 0, "write failed");
+    expect_bytes(&expected, "\n", 1);
+
+    /* Writes larger than the staging buffer are split across flushes. */
+    CHECK(output_writer_write(writer, big, big_len) == 0, "large write failed");
+    expect_bytes(&expected, big, big_len);
+    CHECK(output_writer_reference(writer, big, big_len) == 0, "large reference failed");
+    expect_bytes(&expected, big, big_len);
+
+    /* More references than one writev() accepts. */
+    for (size_t i = 0; i < 3000; i++) {
+        size_t offset = (i * 4099) % (big_len - 8192);
+        CHECK(output_writer_reference(writer, big + offset, 2048 + i % 4096) == 0, "many references failed");
+        expect_bytes(&expected, big + offset, 2048 + i % 4096);
+        CHECK(output_writer_write(writer, "|", 1) == 0, "separator write failed");
+        expect_bytes(&expected, "|", 1);
+    }
+
+    CHECK(output_writer_flush(writer) == 0, "flush failed");
+    CHECK(output_writer_flush(writer) == 0, "empty flush failed");
+    output_writer_stats(writer, &stats);
+    CHECK(stats.bytes_written == expected.len, "stats miscount bytes");
+    CHECK(stats.write_calls > 0 && stats.write_calls < 64, "unexpected writev call count");
+    CHECK(file_matches(file, &expected), "output does not match");
+
+    close_output_writer(writer);
+    fclose(file);
+    check_copy_file(big, 30000);
+    check_positional(big, 30000);
+    free(expected.data);
+    free(big);
+    free(body);
+
+    return finish_checks("output writer");
+}
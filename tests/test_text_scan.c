@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_scan.h"
+
+typedef struct {
+    const char* name;
+    const char* data;
+    size_t len;
+    int expected_binary;
+    size_t expected_lines;
+    size_t expected_backtick_run;
+} ScanCase;
+
+/* The original three-pass classifier, kept verbatim as the oracle for every kernel. */
+static int reference_is_likely_utf8(const unsigned char* s, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        unsigned char c = s[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        if ((c & 0xE0) == 0xC0) {
+            if (i + 1 >= n) return 0;
+            if ((s[i + 1] & 0xC0) != 0x80) return 0;
+            if (c < 0xC2) return 0;
+            i += 2;
+            continue;
+        }
+        if ((c & 0xF0) == 0xE0) {
+            unsigned char b1;
+            unsigned char b2;
+            if (i + 2 >= n) return 0;
+            b1 = s[i + 1];
+            b2 = s[i + 2];
+            if ((b1 & 0xC0) != 0x80 || (b2 & 0xC0) != 0x80) return 0;
+            if (c == 0xE0 && b1 < 0xA0) return 0;
+            if (c == 0xED && b1 >= 0xA0) return 0;
+            i += 3;
+            continue;
+        }
+        if ((c & 0xF8) == 0xF0) {
+            unsigned char b1;
+            unsigned char b2;
+            unsigned char b3;
+            if (i + 3 >= n) return 0;
+            b1 = s[i + 1];
+            b2 = s[i + 2];
+            b3 = s[i + 3];
+            if ((b1 & 0xC0) != 0x80 ||
+                (b2 & 0xC0) != 0x80 ||
+                (b3 & 0xC0) != 0x80) {
+                return 0;
+            }
+            if (c == 0xF0 && b1 < 0x90) return 0;
+            if (c > 0xF4) return 0;
+            if (c == 0xF4 && b1 >= 0x90) return 0;
+            i += 4;
+            continue;
+        }
+        return 0;
+    }
+    return 1;
+}
+
+static int reference_is_binary(const unsigned char* buffer, size_t bytes_read) {
+    if (bytes_read == 0) return 0;
+
+    for (size_t i = 0; i < bytes_read; i++) {
+        if (buffer[i] == '\0') {
+            return 1;
+        }
+    }
+
+    if (!reference_is_likely_utf8(buffer, bytes_read)) {
+        return 1;
+    }
+
+    size_t ctrl = 0;
+    for (size_t i = 0; i < bytes_read; i++) {
+        unsigned char c = buffer[i];
+        if (c < 0x20 && c != '\n' && c != '\r' && c != '\t') {
+            ctrl++;
+        }
+    }
+    size_t whole_hundreds = bytes_read / 100;
+    size_t remainder = bytes_read % 100;
+    size_t threshold = whole_hundreds * 3 + ((remainder * 3 + 99) / 100);
+    return ctrl >= threshold;
+}
+
+static void reference_measure(const unsigned char* buf, size_t len, size_t* lines, size_t* max_run) {
+    size_t current_run = 0;
+
+    *lines = 0;
+    *max_run = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] == '\n') {
+            (*lines)++;
+        }
+        if (buf[i] == '`') {
+            current_run++;
+            if (current_run > *max_run) {
+                *max_run = current_run;
+            }
+        } else {
+            current_run = 0;
+        }
+    }
+    if (len > 0 && buf[len - 1] != '\n') {
+        (*lines)++;
+    }
+}
+
+static unsigned int next_random(unsigned int* state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFFu;
+}
+
+/*
+ * Mostly long ASCII runs sprinkled with newlines, fences, and UTF-8. Every
+ * fourth buffer also gets controls, NULs, and malformed sequences.
+ */
+static size_t fill_random_text(unsigned char* buf, size_t capacity, int with_junk, unsigned int* state) {
+    static const char* const clean_pieces[] = {
+        "\n", "```", "`", "\t", "\r\n", "\x7F", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80"
+    };
+    static const char* const junk_pieces[] = {
+        "\x01", "\x1B", "\xC0\xAF", "\xED\xA0\x80", "\xE2\x82", "\xFF", "\xF4\x90\x80\x80"
+    };
+    size_t clean_count = sizeof(clean_pieces) / sizeof(clean_pieces[0]);
+    size_t junk_count = sizeof(junk_pieces) / sizeof(junk_pieces[0]);
+    size_t len = next_random(state) % capacity;
+    size_t i = 0;
+
+    while (i < len) {
+        unsigned int roll = next_random(state) % 1000;
+        const char* piece;
+
+        if (roll < 850) {
+            buf[i++] = (unsigned char)(0x20 + next_random(state) % 0x5F);
+            continue;
+        }
+        if (with_junk && roll < 852) {
+            buf[i++] = '\0';
+            continue;
+        }
+        if (with_junk && roll < 870) {
+            piece = junk_pieces[next_random(state) % junk_count];
+        } else {
+            piece = clean_pieces[next_random(state) % clean_count];
+        }
+        for (size_t j = 0; piece[j] != '\0' && i < len; j++) {
+            buf[i++] = (unsigned char)piece[j];
+        }
+    }
+    return len;
+}
+
+static int compare_kernel(TextScanKernel kernel, const unsigned char* buf, size_t len, size_t round) {
+    TextScan scan;
+    size_t lines;
+    size_t max_run;
+    int expected_binary = reference_is_binary(buf, len);
+
+    if (fuori_scan_text_with_kernel(kernel, buf, len, 1, &scan) != 0) {
+        fprintf(stderr, "FAIL: kernel %d round %zu (scan error)\n", (int)kernel, round);
+        return 1;
+    }
+    if (fuori_text_scan_is_binary(&scan, len) != expected_binary) {
+        fprintf(stderr, "FAIL: kernel %d round %zu (binary verdict)\n", (int)kernel, round);
+        fuori_free_text_scan(&scan);
+        return 1;
+    }
+    if (!expected_binary) {
+        reference_measure(buf, len, &lines, &max_run);
+        if (scan.line_count != lines || scan.max_backtick_run != max_run) {
+            fprintf(stderr, "FAIL: kernel %d round %zu (lines or fence)\n", (int)kernel, round);
+            fuori_free_text_scan(&scan);
+            return 1;
+        }
+        for (size_t i = 0, line = 0; i < len; i++) {
+            if ((i == 0 || buf[i - 1] == '\n') && scan.line_starts[line++] != i) {
+                fprintf(stderr, "FAIL: kernel %d round %zu (line %zu offset)\n", (int)kernel, round, line);
+                fuori_free_text_scan(&scan);
+                return 1;
+            }
+        }
+    }
+
+    fuori_free_text_scan(&scan);
+    return 0;
+}
+
+static int run_differential(size_t rounds) {
+    const TextScanKernel kernels[] = {
+        TEXT_SCAN_KERNEL_SCALAR, TEXT_SCAN_KERNEL_SSE2, TEXT_SCAN_KERNEL_AVX2, TEXT_SCAN_KERNEL_AUTO
+    };
+    unsigned char storage[1024 + 32];
+    unsigned int state = 12345u;
+    int failures = 0;
+
+    for (size_t round = 0; round < rounds && failures == 0; round++) {
+        /* Vary the start offset so vector loads see every alignment. */
+        unsigned char* buf = storage + (round % 32);
+        size_t len = fill_random_text(buf, 1024, round % 4 == 0, &state);
+
+        for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+            if (fuori_text_scan_kernel_supported(kernels[k])) {
+                failures += compare_kernel(kernels[k], buf, len, round);
+            }
+        }
+    }
+    return failures;
+}
+
+static int run_case(const ScanCase* test_case) {
+    TextScan scan;
+    const unsigned char* data = (const unsigned char*)test_case->data;
+    int binary;
+
+    if (fuori_scan_text(data, test_case->len, 1, &scan) != 0) {
+        fprintf(stderr, "FAIL: %s (scan error)\n", test_case->name);
+        return 1;
+    }
+
+    binary = fuori_text_scan_is_binary(&scan, test_case->len);
+    if (binary != test_case->expected_binary) {
+        fprintf(stderr, "FAIL: %s (binary %d, expected %d)\n",
+                test_case->name, binary, test_case->expected_binary);
+        fuori_free_text_scan(&scan);
+        return 1;
+    }
+    if (!binary &&
+        (scan.line_count != test_case->expected_lines ||
+         scan.max_backtick_run != test_case->expected_backtick_run)) {
+        fprintf(stderr, "FAIL: %s (lines %zu, backticks %zu)\n",
+                test_case->name, scan.line_count, scan.max_backtick_run);
+        fuori_free_text_scan(&scan);
+        return 1;
+    }
+
+    /* Every recorded line must start at offset 0 or right after a newline. */
+    for (size_t i = 0; !binary && i < scan.line_count; i++) {
+        size_t start = scan.line_starts[i];
+        if ((i == 0 && start != 0) ||
+            (i > 0 && (start == 0 || data[start - 1] != '\n'))) {
+            fprintf(stderr, "FAIL: %s (line %zu starts at %zu)\n", test_case->name, i + 1, start);
+            fuori_free_text_scan(&scan);
+            return 1;
+        }
+    }
+
+    fuori_free_text_scan(&scan);
+    return 0;
+}
+
+int main(void) {
+    const ScanCase cases[] = {
+        {"plain lines", "a\nb\n", 4, 0, 2, 0},
+        {"unterminated tail", "a\nb", 3, 0, 2, 0},
+        {"single newline", "\n", 1, 0, 1, 0},
+        {"backtick runs", "``x````y`\n", 10, 0, 1, 4},
+        {"utf-8 text", "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\n", 15, 0, 1, 0},
+        {"nul byte", "ab\0cd\n", 6, 1, 0, 0},
+        {"overlong encoding", "\xC0\xAF\n", 3, 1, 0, 0},
+        {"surrogate half", "\xED\xA0\x80\n", 4, 1, 0, 0},
+        {"truncated sequence", "ok\xE2\x82", 4, 1, 0, 0},
+        {"above max code point", "\xF4\x90\x80\x80", 4, 1, 0, 0},
+        {"control below threshold", "\x01" "bcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                                    "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwx\n", 100, 0, 1, 0},
+        {"control at threshold", "\x01\x02\x03" "defghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                                 "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwx\n", 100, 1, 0, 0},
+        {"short control run", "\x1b", 1, 1, 0, 0},
+        {"tabs and carriage returns", "a\tb\r\n", 5, 0, 1, 0}
+    };
+
+    int failures = 0;
+    size_t count = sizeof(cases) / sizeof(cases[0]);
+    for (size_t i = 0; i < count; i++) {
+        failures += run_case(&cases[i]);
+    }
+
+    failures += run_differential(20000);
+
+    if (failures != 0) {
+        return 1;
+    }
+
+    printf("text scan tests passed (%zu cases, differential kernels)\n", count);
+    return 0;
+}
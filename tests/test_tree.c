@@ -65,15 +65,22 @@ static char* capture_tree_output(const ExportPlan* plan, size_t max_depth) {
     FILE* out = tmpfile();
     long size = 0;
     char* buffer = NULL;
+    OutputWriter* writer = NULL;
 
     if (!out) {
         return NULL;
     }
-    if (write_project_tree(out, plan, max_depth) != 0) {
+    if (open_output_writer(fileno(out), &writer) != 0) {
         fclose(out);
         return NULL;
     }
-    if (fflush(out) != 0 || fseek(out, 0, SEEK_END) != 0) {
+    if (write_project_tree(writer, plan, max_depth) != 0 || output_writer_flush(writer) != 0) {
+        close_output_writer(writer);
+        fclose(out);
+        return NULL;
+    }
+    close_output_writer(writer);
+    if (fseek(out, 0, SEEK_END) != 0) {
         fclose(out);
         return NULL;
     }
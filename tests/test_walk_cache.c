@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "walk_cache.h"
+#include "test_check.h"
+
+static struct stat make_stamp(unsigned long ino, time_t mtime) {
+    struct stat st;
+
+    memset(&st, 0, sizeof(st));
+    st.st_dev = 7;
+    st.st_ino = (ino_t)ino;
+    st.st_mtime = mtime;
+    st.st_ctime = mtime;
+    return st;
+}
+
+static WalkCache* reopen(const char* path) {
+    WalkCache* cache = NULL;
+
+    if (open_walk_cache(path, &cache) != 0) {
+        perror("open_walk_cache");
+        exit(1);
+    }
+    return cache;
+}
+
+/* Returns 1 when the cached listing for st equals expected. */
+static int listing_matches(WalkCache* cache, const struct stat* st, const WalkCacheEntry* expected, size_t count) {
+    WalkCacheEntry* entries = NULL;
+    size_t entry_count = 0;
+    int matches;
+
+    if (lookup_walk_cache(cache, st, &entries, &entry_count) != 1) {
+        return 0;
+    }
+    matches = (entry_count == count);
+    for (size_t i = 0; matches && i < count; i++) {
+        matches = entries[i].kind == expected[i].kind && strcmp(entries[i].name, expected[i].name) == 0;
+    }
+    free(entries);
+    return matches;
+}
+
+static int has_listing(WalkCache* cache, const struct stat* st) {
+    WalkCacheEntry* entries = NULL;
+    size_t entry_count = 0;
+    int rc = lookup_walk_cache(cache, st, &entries, &entry_count);
+
+    free(entries);
+    return rc == 1;
+}
+
+int main(void) {
+    char path[] = "/tmp/fuori-walk-cache.XXXXXX";
+    time_t old = time(NULL) - 100;
+    struct stat root_st = make_stamp(10, old);
+    struct stat empty_st = make_stamp(20, old);
+    struct stat slash_st = make_stamp(30, old);
+    const WalkCacheEntry root_entries[] = {
+        {".gitignore", WALK_CACHE_FILE},
+        {"link", WALK_CACHE_SYMLINK},
+        {"main.c", WALK_CACHE_FILE},
+        {"src", WALK_CACHE_DIRECTORY}
+    };
+    const WalkCacheEntry slash_entries[] = {
+        {"a/b.c", WALK_CACHE_FILE}
+    };
+    WalkCache* cache;
+    size_t hits;
+    size_t stored;
+    int fd = mkstemp(path);
+
+    if (fd == -1) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+    unlink(path);
+
+    cache = reopen(path);
+    CHECK(store_walk_cache(cache, &root_st, root_entries, 4) == 0, "store root failed");
+    CHECK(store_walk_cache(cache, &empty_st, NULL, 0) == 0, "store empty failed");
+    CHECK(store_walk_cache(cache, &slash_st, slash_entries, 1) == 0, "store slash failed");
+    CHECK(save_walk_cache(cache) == 0, "save failed");
+    close_walk_cache(cache);
+
+    cache = reopen(path);
+    CHECK(listing_matches(cache, &root_st, root_entries, 4), "root listing did not round-trip");
+    CHECK(listing_matches(cache, &empty_st, NULL, 0), "empty listing did not round-trip");
+    /* The walker replays listings as readdir() output, so names must be plain entries. */
+    CHECK(!has_listing(cache, &slash_st), "listing with a path separator hits");
+    {
+        struct stat touched = root_st;
+        struct stat changed = root_st;
+        touched.st_mtime++;
+        changed.st_ctime++;
+        CHECK(!has_listing(cache, &touched), "changed mtime still hits");
+        CHECK(!has_listing(cache, &changed), "changed ctime still hits");
+    }
+    walk_cache_counts(cache, &hits, &stored);
+    CHECK(hits == 2 && stored == 0, "unexpected hit count");
+    close_walk_cache(cache);
+    unlink(path);
+
+    return finish_checks("directory cache");
+}